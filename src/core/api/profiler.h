@@ -63,6 +63,12 @@ class Profiler {
     TELEMETRY_DELEGATE_EVENT = 1 << 7,
     // A telemetry event that reports delegate settings.
     TELEMETRY_DELEGATE_REPORT_SETTINGS = 1 << 8,
+
+    // The event records memory allocated or released by the runtime, e.g. the
+    // growth of an arena or the allocation of a dynamic tensor. It's only
+    // reported w/ AddEventWithData, whose tag is the name of the tensor or of
+    // the arena, and whose data is a const ProfiledMemoryAllocation*.
+    MEMORY_ALLOCATION_EVENT = 1 << 9,
   };
 
   virtual ~Profiler() {}
@@ -120,7 +126,8 @@ class Profiler {
 
   // Adds a profiler event with data.
   // Data will be a const TelemetrySettings* for TELEMETRY_REPORT_SETTINGS
-  // and TELEMETRY_DELEGATE_REPORT_SETTINGS.
+  // and TELEMETRY_DELEGATE_REPORT_SETTINGS, and a const
+  // ProfiledMemoryAllocation* for MEMORY_ALLOCATION_EVENT.
   // If the concrete profiler does not provide an implementation, does nothing.
   // TODO(b/241982974): Clean up dependencies and make it pure virtual.
   virtual void AddEventWithData(const char* tag, EventType event_type,
@@ -130,6 +137,22 @@ class Profiler {
   friend class ScopedProfile;
 };
 
+// The data of a MEMORY_ALLOCATION_EVENT.
+struct ProfiledMemoryAllocation {
+  // The TfLiteAllocationType of the memory: kTfLiteArenaRw and
+  // kTfLiteArenaRwPersistent for the growth of the arenas, kTfLiteDynamic and
+  // kTfLitePersistentRo for the heap allocations of tensors.
+  int32_t allocation_type;
+  // The number of bytes allocated, negative when released.
+  int64_t bytes;
+  int64_t subgraph_index;
+  // The tensor allocated, or -1 for the arenas.
+  int64_t tensor_index;
+  // The node whose tensors caused the allocation, or -1 for the operator being
+  // initialized, prepared or invoked when it happened, if any.
+  int64_t node_index;
+};
+
 // Adds a profile event to `profiler` that begins with the construction
 // of the object and ends when the object goes out of scope.
 // The lifetime of tag should be at least the lifetime of `profiler`.
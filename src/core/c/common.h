@@ -1299,7 +1299,16 @@ typedef enum TfLiteDelegateFlags {
   /// operator information using `Profiler::EventType::OPERATOR_INVOKE_EVENT`
   /// and the results will appear in the operator-wise Profiling section and not
   /// in the Delegate internal section.
-  kTfLiteDelegateFlagsPerOperatorProfiling = 4
+  kTfLiteDelegateFlagsPerOperatorProfiling = 4,
+
+  /// This flag can be used by delegates whose kernel `init` callback may be
+  /// called concurrently for different partitions. The interpreter will then
+  /// initialize the kernels of all the partitions of the delegate on as many
+  /// threads as it uses to run the model, which speeds up
+  /// `ModifyGraphWithDelegate` for delegates that build their backend graphs
+  /// (e.g. pack weights) in `init`. The resulting execution plan is the same
+  /// as with sequential initialization.
+  kTfLiteDelegateFlagsThreadSafeKernelInit = 8
 } TfLiteDelegateFlags;
 
 /// WARNING: This is an experimental interface that is subject to change.
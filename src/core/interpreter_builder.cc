@@ -40,6 +40,7 @@ limitations under the License.
 #include "internal/signature_def.h"
 #include "interpreter_options.h"
 #include "profiling/platform_profiler.h"
+#include "profiling/root_profiler.h"
 #include "profiling/telemetry/c/telemetry_setting.h"
 #include "profiling/telemetry/c/telemetry_setting_internal.h"
 #include "schema/conversion_metadata_generated.h"
@@ -780,9 +781,12 @@ TfLiteStatus InterpreterBuilder::operator()(
     return cleanup_and_error();
   }
 
-  if (BuildLocalIndexToRegistrationMapping() != kTfLiteOk) {
-    TF_LITE_REPORT_ERROR(error_reporter_, "Registration failed.\n");
-    return cleanup_and_error();
+  {
+    TFLITE_SCOPED_TAGGED_DEFAULT_PROFILE(profiler_, "ResolveOps");
+    if (BuildLocalIndexToRegistrationMapping() != kTfLiteOk) {
+      TF_LITE_REPORT_ERROR(error_reporter_, "Registration failed.\n");
+      return cleanup_and_error();
+    }
   }
 
   // Flatbuffer model schemas define a list of opcodes independent of the
@@ -825,52 +829,69 @@ TfLiteStatus InterpreterBuilder::operator()(
     telemetry_settings->subgraph_infos.resize(subgraphs->size());
   }
 
-  for (int subgraph_index = 0; subgraph_index < subgraphs->size();
-       ++subgraph_index) {
-    const tflite::SubGraph* subgraph = (*subgraphs)[subgraph_index];
-    tflite::Subgraph* modified_subgraph =
-        (*interpreter)->subgraph(subgraph_index);
-    modified_subgraph->allocation_ = allocation_;
-    auto* subgraph_info =
-        telemetry_registered
-            ? &telemetry_settings->subgraph_infos[subgraph_index]
-            : nullptr;
-    auto operators = subgraph->operators();
-    auto tensors = subgraph->tensors();
-    if (!tensors) {
-      TF_LITE_REPORT_ERROR(error_reporter_,
-                           "Did not get tensors in subgraph %d.\n",
-                           subgraph_index);
-      return cleanup_and_error();
+  // The subgraphs report to 'profiler_' too until the end of the build, so
+  // that it records e.g. the "OpInit" event of each node parsed.
+  tflite::profiling::RootProfiler build_profiler;
+  if (profiler_ != nullptr) {
+    build_profiler.AddProfiler(profiler_);
+    if ((*interpreter)->root_profiler_ != nullptr) {
+      build_profiler.AddProfiler((*interpreter)->root_profiler_.get());
     }
-    if (modified_subgraph->AddTensors(tensors->size()) != kTfLiteOk) {
-      return cleanup_and_error();
+    for (int i = 0; i < (*interpreter)->subgraphs_size(); ++i) {
+      (*interpreter)->subgraph(i)->SetProfiler(&build_profiler, i);
     }
-    // Parse inputs/outputs
-    modified_subgraph->SetInputs(
-        FlatBufferIntArrayToVector(subgraph->inputs()));
-    modified_subgraph->SetOutputs(
-        FlatBufferIntArrayToVector(subgraph->outputs()));
-
-    // Finally setup nodes and tensors
-    // Parse tensors before nodes as ParseNodes checks input tensors for the
-    // nodes.
-    if (ParseTensors(buffers, tensors, modified_subgraph, subgraph_info) !=
-        kTfLiteOk)
-      return cleanup_and_error();
-    if (operators && ParseNodes(operators, modified_subgraph) != kTfLiteOk)
-      return cleanup_and_error();
+  }
 
-    std::vector<int> variables;
-    for (int i = 0; i < modified_subgraph->tensors_size(); ++i) {
-      auto* tensor = modified_subgraph->tensor(i);
-      if (tensor->is_variable) {
-        variables.push_back(i);
+  {
+    // Times the parsing of all subgraphs, including the Init of the nodes.
+    TFLITE_SCOPED_TAGGED_DEFAULT_PROFILE(profiler_, "ParseSubgraphs");
+    for (int subgraph_index = 0; subgraph_index < subgraphs->size();
+         ++subgraph_index) {
+      const tflite::SubGraph* subgraph = (*subgraphs)[subgraph_index];
+      tflite::Subgraph* modified_subgraph =
+          (*interpreter)->subgraph(subgraph_index);
+      modified_subgraph->allocation_ = allocation_;
+      auto* subgraph_info =
+          telemetry_registered
+              ? &telemetry_settings->subgraph_infos[subgraph_index]
+              : nullptr;
+      auto operators = subgraph->operators();
+      auto tensors = subgraph->tensors();
+      if (!tensors) {
+        TF_LITE_REPORT_ERROR(error_reporter_,
+                             "Did not get tensors in subgraph %d.\n",
+                             subgraph_index);
+        return cleanup_and_error();
+      }
+      if (modified_subgraph->AddTensors(tensors->size()) != kTfLiteOk) {
+        return cleanup_and_error();
+      }
+      // Parse inputs/outputs
+      modified_subgraph->SetInputs(
+          FlatBufferIntArrayToVector(subgraph->inputs()));
+      modified_subgraph->SetOutputs(
+          FlatBufferIntArrayToVector(subgraph->outputs()));
+
+      // Finally setup nodes and tensors
+      // Parse tensors before nodes as ParseNodes checks input tensors for the
+      // nodes.
+      if (ParseTensors(buffers, tensors, modified_subgraph, subgraph_info) !=
+          kTfLiteOk)
+        return cleanup_and_error();
+      if (operators && ParseNodes(operators, modified_subgraph) != kTfLiteOk)
+        return cleanup_and_error();
+
+      std::vector<int> variables;
+      for (int i = 0; i < modified_subgraph->tensors_size(); ++i) {
+        auto* tensor = modified_subgraph->tensor(i);
+        if (tensor->is_variable) {
+          variables.push_back(i);
+        }
+      }
+      modified_subgraph->SetVariables(std::move(variables));
+      if (subgraph->name()) {
+        modified_subgraph->SetName(subgraph->name()->c_str());
       }
-    }
-    modified_subgraph->SetVariables(std::move(variables));
-    if (subgraph->name()) {
-      modified_subgraph->SetName(subgraph->name()->c_str());
     }
   }
 
@@ -895,7 +916,18 @@ TfLiteStatus InterpreterBuilder::operator()(
     (*interpreter)->ReportTelemetrySettings(kTelemetryBuilderEventName);
   }
 
-  TfLiteStatus status = ApplyDelegates(interpreter->get());
+  TfLiteStatus status;
+  {
+    TFLITE_SCOPED_TAGGED_DEFAULT_PROFILE(profiler_, "ApplyDelegates");
+    status = ApplyDelegates(interpreter->get());
+  }
+  if (profiler_ != nullptr) {
+    // Restores the profilers of the interpreter.
+    for (int i = 0; i < (*interpreter)->subgraphs_size(); ++i) {
+      (*interpreter)->subgraph(i)->SetProfiler(
+          (*interpreter)->root_profiler_.get(), i);
+    }
+  }
   if (status != kTfLiteOk) {
     interpreter->reset();
   }
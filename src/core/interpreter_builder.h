@@ -34,6 +34,7 @@ limitations under the License.
 #include "allocation.h"
 #include "core/api/error_reporter.h"
 #include "core/api/op_resolver.h"
+#include "core/api/profiler.h"
 #include "core/c/common.h"
 #include "core/interpreter.h"
 #include "core/model_builder.h"
@@ -127,6 +128,16 @@ class InterpreterBuilder {
     telemetry_profiler_ = std::move(profiler);
   }
 
+  /// Sets a profiler that records the phases of building an interpreter: the
+  /// op resolution ("ResolveOps"), the parsing of the subgraphs
+  /// ("ParseSubgraphs") and the application of the delegates added w/
+  /// AddDelegate ("ApplyDelegates"), along w/ the events the interpreter
+  /// reports meanwhile, e.g. "OpInit" for each node. It isn't installed on
+  /// the built interpreter. The caller retains ownership of the profiler and
+  /// must ensure its validity until operator() returns.
+  /// WARNING: This is an experimental API and subject to change.
+  void SetProfiler(Profiler* profiler) { profiler_ = profiler; }
+
  private:
   TfLiteStatus BuildLocalIndexToRegistrationMapping();
   TfLiteStatus ParseNodes(
@@ -169,6 +180,7 @@ class InterpreterBuilder {
   InterpreterOptions options_;
 
   std::unique_ptr<telemetry::TelemetryProfiler> telemetry_profiler_;
+  Profiler* profiler_ = nullptr;  // Not owned.
 };
 
 }  // namespace impl
@@ -38,6 +38,7 @@ limitations under the License.
 #include "core/kernels/register.h"
 #include "core/model_builder.h"
 #include "interpreter_test_util.h"
+#include "profiling/buffered_profiler.h"
 #include "schema/schema_generated.h"
 #include "string_type.h"
 #include "string_util.h"
@@ -301,6 +302,41 @@ TEST(BasicFlatBufferModel, TestWithNumThreads) {
                       reporter.error_messages());
 }
 
+TEST(BasicFlatBufferModel, TestBuilderProfilerRecordsNodeInit) {
+  auto model = FlatBufferModel::BuildFromFile("testdata/test_model.bin");
+  ASSERT_TRUE(model);
+  TrivialResolver resolver(&dummy_reg);
+  InterpreterBuilder builder(*model, resolver);
+  profiling::BufferedProfiler profiler(1024);
+  profiler.StartProfiling();
+  builder.SetProfiler(&profiler);
+
+  std::unique_ptr<Interpreter> interpreter;
+  ASSERT_EQ(builder(&interpreter), kTfLiteOk);
+  size_t num_nodes = 0;
+  for (int i = 0; i < interpreter->subgraphs_size(); ++i) {
+    num_nodes += interpreter->subgraph(i)->nodes_size();
+  }
+  ASSERT_GT(num_nodes, 0);
+  auto count_events = [&profiler](const std::string& tag) {
+    size_t count = 0;
+    for (const ProfileEvent* event : profiler.GetProfileEvents()) {
+      if (event->tag == tag) ++count;
+    }
+    return count;
+  };
+  EXPECT_EQ(count_events("OpInit"), num_nodes);
+  EXPECT_EQ(count_events("ParseSubgraphs"), 1);
+
+  // The profiler isn't installed on the built interpreter.
+  Profiler* subgraph_profiler = interpreter->subgraph(0)->GetProfiler();
+  if (subgraph_profiler != nullptr) {
+    subgraph_profiler->EndEvent(subgraph_profiler->BeginEvent(
+        "AfterBuild", Profiler::EventType::DEFAULT, 0, 0));
+  }
+  EXPECT_EQ(count_events("AfterBuild"), 0);
+}
+
 TEST(BasicFlatBufferModel, TestSetNumThreads) {
   TestErrorReporter reporter;
   auto model = FlatBufferModel::BuildFromFile(
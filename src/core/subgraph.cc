@@ -25,6 +25,7 @@ limitations under the License.
 #include <iterator>
 #include <memory>
 #include <string>
+#include <thread>  // NOLINT(build/c++11)
 #include <unordered_set>
 #include <utility>
 #include <vector>
@@ -45,6 +46,7 @@ limitations under the License.
 #include "memory_planner.h"
 #include "minimal_logging.h"
 #include "profiling/telemetry/telemetry.h"
+#include "pthreadpool.h"  // from @pthreadpool
 #include "schema/schema_generated.h"
 #include "tfutil.h"
 #ifdef TFLITE_USE_SIMPLE_MEMORY_PLANNER
@@ -564,6 +566,13 @@ TfLiteStatus Subgraph::ReplaceNodeSubsetsWithDelegateKernels(
                   nodes_to_replace->size, execution_plan_.size(),
                   GetDelegateKernalName(registration), node_subsets.size());
 
+  // Delegates with a thread-safe kernel init have the kernels of all their
+  // partitions initialized together once the nodes are added. The nodes are
+  // still added in partition order, so the graph does not depend on it.
+  const bool parallel_kernel_init =
+      (delegate->flags & kTfLiteDelegateFlagsThreadSafeKernelInit) != 0;
+  std::vector<int> delegate_node_indices;
+
   execution_plan_.clear();
 
   for (auto& node_subset : node_subsets) {
@@ -590,9 +599,11 @@ TfLiteStatus Subgraph::ReplaceNodeSubsetsWithDelegateKernels(
               CreateDelegateParams(delegate, node_subset);
           delegate_params = params;
         }
-        TF_LITE_ENSURE_STATUS(AddNodeWithParameters(
+        TF_LITE_ENSURE_STATUS(AddNodeWithParametersImpl(
             node_subset.input_tensors, node_subset.output_tensors, {}, nullptr,
-            0, delegate_params, &registration, &node_index));
+            0, delegate_params, &registration, parallel_kernel_init,
+            &node_index));
+        delegate_node_indices.push_back(node_index);
 
         // Initialize the output tensors's delegate-related fields.
         for (int tensor_index : node_subset.output_tensors) {
@@ -611,6 +622,9 @@ TfLiteStatus Subgraph::ReplaceNodeSubsetsWithDelegateKernels(
         break;
     }
   }
+  if (parallel_kernel_init) {
+    OpInitInParallel(delegate_node_indices);
+  }
   return kTfLiteOk;
 }
 
@@ -642,14 +656,20 @@ void Subgraph::SetExternalContext(struct TfLiteContext* context,
 
 // Gets an TfLiteIntArray* representing the execution plan. The interpreter owns
 // this memory and it is only guaranteed to exist during the invocation of the
-// delegate prepare.
+// delegate prepare. A cached plan that is still up to date is returned as is,
+// so that the kernels initialized by OpInitInParallel() only read it.
 TfLiteStatus Subgraph::GetExecutionPlan(TfLiteIntArray** execution_plan) {
-  plan_cache_.reset(TfLiteIntArrayCreate(execution_plan_.size()));
-  *execution_plan = plan_cache_.get();
   static_assert(sizeof(plan_cache_->data[0]) == sizeof(execution_plan_[0]),
                 "TfLiteIntArray and execution_plan do not contain same type.");
-  std::memcpy(plan_cache_->data, execution_plan_.data(),
-              sizeof(plan_cache_->data[0]) * execution_plan_.size());
+  if (!plan_cache_ || plan_cache_->size != execution_plan_.size() ||
+      std::memcmp(plan_cache_->data, execution_plan_.data(),
+                  sizeof(plan_cache_->data[0]) * execution_plan_.size()) !=
+          0) {
+    plan_cache_.reset(TfLiteIntArrayCreate(execution_plan_.size()));
+    std::memcpy(plan_cache_->data, execution_plan_.data(),
+                sizeof(plan_cache_->data[0]) * execution_plan_.size());
+  }
+  *execution_plan = plan_cache_.get();
   return kTfLiteOk;
 }
 
@@ -981,7 +1001,13 @@ TfLiteStatus Subgraph::AllocateTensors() {
   if (no_reallocations_necessary) {
     // If non-persistent memory was released, re-allocate it.
     if (memory_planner_ && !memory_planner_->HasNonPersistentMemory()) {
+      size_t arena_size = 0, arena_persist_size = 0;
+      if (profiler_) {
+        memory_planner_->GetAllocInfo(&arena_size, &arena_persist_size);
+      }
       memory_planner_->AcquireNonPersistentMemory();
+      ProfileArenaGrowth(arena_size, arena_persist_size, 0,
+                         static_cast<int>(execution_plan_.size()) - 1);
     }
     // Check custom allocations, which may have been modified since last
     // AllocateTensors() call.
@@ -1073,6 +1099,17 @@ TfLiteStatus Subgraph::AddNodeWithParameters(
     const std::vector<int>& intermediates, const char* init_data,
     size_t init_data_size, void* builtin_data,
     const TfLiteRegistration* registration, int* node_index) {
+  return AddNodeWithParametersImpl(inputs, outputs, intermediates, init_data,
+                                   init_data_size, builtin_data, registration,
+                                   /*defer_init=*/false, node_index);
+}
+
+TfLiteStatus Subgraph::AddNodeWithParametersImpl(
+    const std::vector<int>& inputs, const std::vector<int>& outputs,
+    const std::vector<int>& intermediates, const char* init_data,
+    size_t init_data_size, void* builtin_data,
+    const TfLiteRegistration* registration, bool defer_init,
+    int* node_index) {
   std::unique_ptr<void, decltype(free)*> builtin_data_deleter(builtin_data,
                                                               free);
   if (state_ == kStateInvokableAndImmutable) {
@@ -1110,11 +1147,21 @@ TfLiteStatus Subgraph::AddNodeWithParameters(
   node.outputs = ConvertVectorToTfLiteIntArray(outputs);
   node.intermediates = ConvertVectorToTfLiteIntArray(intermediates);
   node.temporaries = TfLiteIntArrayCreate(0);
-  if (init_data) {
-    node.user_data = OpInit(*registration, init_data, init_data_size);
+  if (defer_init) {
+    node.user_data = nullptr;
   } else {
-    node.user_data = OpInit(
-        *registration, static_cast<const char*>(builtin_data_deleter.get()), 0);
+    // Tagged as a DEFAULT event w/ the node index, like OpPrepare, so that the
+    // memory a kernel allocates on init, e.g. the buffers of a delegate, can be
+    // attributed to it.
+    ScopedProfile op_init_profile(profiler_.get(), "OpInit",
+                                  Profiler::EventType::DEFAULT, new_node_index);
+    if (init_data) {
+      node.user_data = OpInit(*registration, init_data, init_data_size);
+    } else {
+      node.user_data = OpInit(
+          *registration, static_cast<const char*>(builtin_data_deleter.get()),
+          0);
+    }
   }
 
   node.builtin_data = builtin_data_deleter.release();
@@ -1244,7 +1291,12 @@ TfLiteStatus Subgraph::ResizeInputTensorStrict(int tensor_index,
 TfLiteStatus Subgraph::ReleaseNonPersistentMemory() {
   state_ = kStateUninvokable;
   if (memory_planner_) {
+    size_t arena_size = 0, arena_persist_size = 0;
+    if (profiler_) {
+      memory_planner_->GetAllocInfo(&arena_size, &arena_persist_size);
+    }
     TF_LITE_ENSURE_STATUS(memory_planner_->ReleaseNonPersistentMemory());
+    ProfileArenaGrowth(arena_size, arena_persist_size, 0, -1);
   }
   return kTfLiteOk;
 }
@@ -1311,6 +1363,43 @@ void* Subgraph::OpInit(const TfLiteRegistration& op_reg, const char* buffer,
   return op_reg.init(&context_, buffer, length);
 }
 
+void Subgraph::OpInitInParallel(const std::vector<int>& node_indices) {
+  // Uses the threads of the interpreter, or all the cores if their number
+  // isn't set.
+  const size_t num_threads = std::min<size_t>(
+      context_.recommended_num_threads > 0
+          ? static_cast<size_t>(context_.recommended_num_threads)
+          : std::max(1u, std::thread::hardware_concurrency()),
+      node_indices.size());
+
+  // The kernels may read the execution plan while they are initialized, so it
+  // is cached before they start and GetExecutionPlan() doesn't rebuild it.
+  TfLiteIntArray* execution_plan;
+  GetExecutionPlan(&execution_plan);
+
+  // Each thread only writes the 'user_data' of the nodes it is given, and
+  // 'nodes_and_registration_' is not resized until all of them are done.
+  struct InitContext {
+    Subgraph* subgraph;
+    const std::vector<int>* node_indices;
+  } init_context{this, &node_indices};
+  const auto init_node = [](void* context, size_t i) {
+    const InitContext* init_context = static_cast<InitContext*>(context);
+    auto& node_and_reg =
+        init_context->subgraph
+            ->nodes_and_registration_[(*init_context->node_indices)[i]];
+    TfLiteNode& node = node_and_reg.first;
+    node.user_data = init_context->subgraph->OpInit(
+        node_and_reg.second, static_cast<const char*>(node.builtin_data), 0);
+  };
+  std::unique_ptr<pthreadpool, decltype(&pthreadpool_destroy)> threadpool(
+      num_threads > 1 ? pthreadpool_create(num_threads) : nullptr,
+      &pthreadpool_destroy);
+  // Without a threadpool, the nodes are initialized on the calling thread.
+  pthreadpool_parallelize_1d(threadpool.get(), init_node, &init_context,
+                             node_indices.size(), /*flags=*/0);
+}
+
 TfLiteStatus Subgraph::OpPrepare(const TfLiteRegistration& op_reg,
                                  TfLiteNode* node) {
   // Delegates that use the stable delegate API to iterate over the nodes and
@@ -1452,6 +1541,7 @@ TfLiteStatus Subgraph::MayAllocateOpOutput(TfLiteNode* node) {
       if (tensor->data.raw == nullptr &&
           tensor->allocation_type == kTfLiteDynamic) {
         TfLiteTensorRealloc(tensor->bytes, tensor);
+        ProfileTensorBufferBytes(kTfLiteDynamic, tensor_index, tensor->bytes);
       }
     }
   }
@@ -1479,7 +1569,15 @@ TfLiteStatus Subgraph::PrepareOpsStartingAt(
     tflite::OnTfLiteOpPrepare(GetTFLiteOpName(registration), subgraph_index_,
                               node_index);
 #endif  // TF_LITE_TENSORFLOW_PROFILER
-    const TfLiteStatus op_prepare_status = OpPrepare(registration, &node);
+    TfLiteStatus op_prepare_status;
+    {
+      // Tagged as a DEFAULT event w/ the node index, so that the prepare costs
+      // don't mix w/ the operator invoke stats.
+      ScopedProfile op_prepare_profile(profiler_.get(), "OpPrepare",
+                                       Profiler::EventType::DEFAULT,
+                                       node_index);
+      op_prepare_status = OpPrepare(registration, &node);
+    }
     if (op_prepare_status != kTfLiteOk) {
       ReportOpError(&context_, node, registration, node_index,
                     "failed to prepare");
@@ -1541,9 +1639,16 @@ TfLiteStatus Subgraph::PrepareOpsAndTensors() {
   }
 
   // Execute arena allocations.
+  size_t arena_size = 0, arena_persist_size = 0;
+  if (profiler_) {
+    memory_planner_->GetAllocInfo(&arena_size, &arena_persist_size);
+  }
   TF_LITE_ENSURE_STATUS(memory_planner_->ExecuteAllocations(
       next_execution_plan_index_to_plan_allocation_,
       last_exec_plan_index_prepared));
+  ProfileArenaGrowth(arena_size, arena_persist_size,
+                     next_execution_plan_index_to_plan_allocation_,
+                     last_exec_plan_index_prepared);
 
   if (!custom_allocations_.empty()) {
     // Verify custom allocations for output tensors from the ops that have just
@@ -1992,8 +2097,17 @@ TfLiteStatus Subgraph::ResizeTensorImpl(TfLiteTensor* tensor,
       }
 
       // Realloc space for heap-allocated tensors.
+      const bool reallocates =
+          (tensor->allocation_type == kTfLiteDynamic ||
+           tensor->allocation_type == kTfLitePersistentRo) &&
+          (tensor->data.raw == nullptr || bytes_required > tensor->bytes);
       TfLiteTensorResizeMaybeCopy(bytes_required, tensor, false);
       tensor->bytes = bytes_required;
+      if (reallocates) {
+        ProfileTensorBufferBytes(tensor->allocation_type,
+                                 static_cast<int>(tensor - context_.tensors),
+                                 bytes_required);
+      }
     }
     if (tensor->dims && tensor->dims != new_size) {
       TfLiteIntArrayFree(tensor->dims);
@@ -2461,6 +2575,7 @@ void Subgraph::MaybeReleaseDynamicTensors(const TfLiteNode& node,
     auto it = tensor_to_last_op_index_.find(input_tensor_index);
     if (it != tensor_to_last_op_index_.end() && it->second == node_index) {
       if (input_tensor->data.raw) {
+        ProfileTensorBufferBytes(kTfLiteDynamic, input_tensor_index, 0);
         TfLiteTensorDataFree(input_tensor);
       }
     }
@@ -2481,10 +2596,118 @@ void Subgraph::MaybeReleaseDynamicTensors(const TfLiteNode& node,
     auto it = tensor_to_last_op_index_.find(output_tensor_index);
     if (it != tensor_to_last_op_index_.end() && it->second == node_index) {
       if (output_tensor->data.raw) {
+        ProfileTensorBufferBytes(kTfLiteDynamic, output_tensor_index, 0);
         TfLiteTensorDataFree(output_tensor);
       }
     }
   }
 }
 
+void Subgraph::ProfileMemoryAllocation(TfLiteAllocationType allocation_type,
+                                       int64_t bytes, int tensor_index,
+                                       int node_index) {
+  if (!profiler_ || bytes == 0) return;
+  ProfiledMemoryAllocation allocation;
+  allocation.allocation_type = allocation_type;
+  allocation.bytes = bytes;
+  allocation.subgraph_index = subgraph_index_;
+  allocation.tensor_index = tensor_index;
+  allocation.node_index = node_index;
+  const char* tag = "";
+  if (tensor_index >= 0) {
+    if (context_.tensors[tensor_index].name) {
+      tag = context_.tensors[tensor_index].name;
+    }
+  } else {
+    tag = allocation_type == kTfLiteArenaRw ? "ArenaRw" : "ArenaRwPersistent";
+  }
+  profiler_->AddEventWithData(tag, Profiler::EventType::MEMORY_ALLOCATION_EVENT,
+                              &allocation);
+}
+
+void Subgraph::ProfileTensorBufferBytes(TfLiteAllocationType allocation_type,
+                                        int tensor_index, size_t bytes) {
+  if (!profiler_) return;
+  // The buffers allocated before the profiler was set aren't accounted for,
+  // so that the reported allocations and releases still add up.
+  auto it = profiled_tensor_buffer_bytes_.find(tensor_index);
+  const size_t held_bytes =
+      it == profiled_tensor_buffer_bytes_.end() ? 0 : it->second;
+  if (bytes == 0) {
+    if (it != profiled_tensor_buffer_bytes_.end()) {
+      profiled_tensor_buffer_bytes_.erase(it);
+    }
+  } else {
+    profiled_tensor_buffer_bytes_[tensor_index] = bytes;
+  }
+  ProfileMemoryAllocation(
+      allocation_type,
+      static_cast<int64_t>(bytes) - static_cast<int64_t>(held_bytes),
+      tensor_index);
+}
+
+void Subgraph::ProfileArenaGrowth(size_t arena_size, size_t arena_persist_size,
+                                  int first_execution_plan_index,
+                                  int last_execution_plan_index) {
+  if (!profiler_ || !memory_planner_) return;
+  // The arenas are as large as their highest allocation, so their growth is
+  // attributed to the node that allocates the tensor ending the highest.
+  auto find_peak_node = [this, first_execution_plan_index,
+                         last_execution_plan_index](
+                            TfLiteAllocationType allocation_type) {
+    int peak_tensor = -1;
+    uintptr_t peak_end = 0;
+    for (size_t i = 0; i < context_.tensors_size; ++i) {
+      const TfLiteTensor& tensor = context_.tensors[i];
+      if (tensor.allocation_type != allocation_type || !tensor.data.raw) {
+        continue;
+      }
+      const uintptr_t end =
+          reinterpret_cast<uintptr_t>(tensor.data.raw) + tensor.bytes;
+      if (end > peak_end) {
+        peak_end = end;
+        peak_tensor = static_cast<int>(i);
+      }
+    }
+    if (peak_tensor < 0) return -1;
+    auto contains = [peak_tensor](const TfLiteIntArray* tensors) {
+      for (int i = 0; i < tensors->size; ++i) {
+        if (tensors->data[i] == peak_tensor) return true;
+      }
+      return false;
+    };
+    for (int i = first_execution_plan_index;
+         i <= last_execution_plan_index &&
+         i < static_cast<int>(execution_plan_.size());
+         ++i) {
+      const TfLiteNode& node =
+          nodes_and_registration_[execution_plan_[i]].first;
+      if (contains(node.outputs) || contains(node.temporaries)) {
+        return execution_plan_[i];
+      }
+    }
+    return -1;
+  };
+
+  size_t new_arena_size = 0, new_arena_persist_size = 0;
+  memory_planner_->GetAllocInfo(&new_arena_size, &new_arena_persist_size);
+  if (new_arena_size != arena_size) {
+    ProfileMemoryAllocation(
+        kTfLiteArenaRw,
+        static_cast<int64_t>(new_arena_size) - static_cast<int64_t>(arena_size),
+        /*tensor_index=*/-1,
+        new_arena_size > arena_size ? find_peak_node(kTfLiteArenaRw) : -1);
+  }
+  if (new_arena_persist_size != arena_persist_size) {
+    ProfileMemoryAllocation(
+        kTfLiteArenaRwPersistent,
+        static_cast<int64_t>(new_arena_persist_size) -
+            static_cast<int64_t>(arena_persist_size),
+        /*tensor_index=*/-1,
+        new_arena_persist_size > arena_persist_size
+            ? find_peak_node(kTfLiteArenaRwPersistent)
+            : -1);
+  }
+}
+
 }  // namespace tflite
@@ -675,6 +675,11 @@ class Subgraph {
   // If registration_external is valid, use the 'free' callback from that.
   void OpFree(const TfLiteRegistration& op_reg, void* buffer);
 
+  // Calls OpInit() for the nodes at 'node_indices', which must have been added
+  // with deferred initialization, on up to 'context_.recommended_num_threads'
+  // threads.
+  void OpInitInParallel(const std::vector<int>& node_indices);
+
   // Prepare the given 'node' for execution.
   TfLiteStatus OpPrepare(const TfLiteRegistration& op_reg, TfLiteNode* node);
 
@@ -765,6 +770,16 @@ class Subgraph {
       TfLiteRegistration registration, const TfLiteIntArray* nodes_to_replace,
       TfLiteDelegate* delegate);
 
+  // Implementation of AddNodeWithParameters. If 'defer_init' is true, the
+  // node is added without calling OpInit(), and its 'user_data' must be set
+  // with OpInitInParallel() before the node is prepared.
+  TfLiteStatus AddNodeWithParametersImpl(
+      const std::vector<int>& inputs, const std::vector<int>& outputs,
+      const std::vector<int>& intermediates, const char* init_data,
+      size_t init_data_size, void* builtin_data,
+      const TfLiteRegistration* registration, bool defer_init,
+      int* node_index);
+
   // Helper method for PreviewDelegatePartitioning and
   // ReplaceNodeSubsetsWithDelegateKernels. Creates node subsets whose members
   // are either all present in or all absent from *nodes_to_replace.  The
@@ -940,6 +955,28 @@ class Subgraph {
   // tensors if configured.
   void MaybeReleaseDynamicTensors(const TfLiteNode& node, size_t node_index);
 
+  // Reports 'bytes' of memory of 'allocation_type' allocated, or released if
+  // negative, for 'tensor_index', or for the arenas if -1, to the profiler.
+  // See ProfiledMemoryAllocation for 'node_index'.
+  void ProfileMemoryAllocation(TfLiteAllocationType allocation_type,
+                               int64_t bytes, int tensor_index,
+                               int node_index = -1);
+
+  // Reports the heap buffer of 'tensor_index' as now holding 'bytes', or as
+  // released if 0, to the profiler, i.e. the change since it was last
+  // reported. A buffer isn't reallocated when its tensor shrinks, so it can
+  // hold more than the bytes of the tensor.
+  void ProfileTensorBufferBytes(TfLiteAllocationType allocation_type,
+                                int tensor_index, size_t bytes);
+
+  // Reports the change in the size of the arenas since they were
+  // 'arena_size' and 'arena_persist_size' bytes large, after the allocations
+  // of the nodes in the execution plan interval [first_execution_plan_index,
+  // last_execution_plan_index], to the profiler.
+  void ProfileArenaGrowth(size_t arena_size, size_t arena_persist_size,
+                          int first_execution_plan_index,
+                          int last_execution_plan_index);
+
   // The state of the Subgraph.
   enum State {
     // The Subgraph isn't ready to be invoked.
@@ -1127,6 +1164,10 @@ class Subgraph {
   // uses this tensor.
   std::map<int, int> tensor_to_last_op_index_;
 
+  // The bytes held by the heap buffers of the tensors, as last reported to the
+  // profiler by `ProfileTensorBufferBytes`.
+  std::map<int, size_t> profiled_tensor_buffer_bytes_;
+
   // `InterpreterOptions` object which is being used and owned by Interpreter.
   InterpreterOptions* options_;
 
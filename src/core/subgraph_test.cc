@@ -17,6 +17,7 @@ limitations under the License.
 
 #include <algorithm>
 #include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <numeric>
@@ -26,7 +27,9 @@ limitations under the License.
 #include <gtest/gtest.h>
 #include "absl/log/check.h"
 #include "c/c_api_types.h"
+#include "core/api/profiler.h"
 #include "core/interpreter.h"
+#include "interpreter_options.h"
 #include "stderr_reporter.h"
 #include "tfutil.h"
 
@@ -332,5 +335,89 @@ TEST_F(SubgraphResizeTensorTest,
   std::fill_n(tensor_.dims->data, tensor_.dims->size, 1);
 }
 
+// Sums up the heap allocations of a tensor reported to the profiler.
+class TensorMemoryProfiler : public Profiler {
+ public:
+  explicit TensorMemoryProfiler(int tensor_index)
+      : tensor_index_(tensor_index) {}
+
+  uint32_t BeginEvent(const char* tag, EventType event_type,
+                      int64_t event_metadata1,
+                      int64_t event_metadata2) override {
+    return 0;
+  }
+  void EndEvent(uint32_t event_handle) override {}
+
+  void AddEventWithData(const char* tag, EventType event_type,
+                        const void* data) override {
+    if (event_type != EventType::MEMORY_ALLOCATION_EVENT) return;
+    const auto* allocation = static_cast<const ProfiledMemoryAllocation*>(data);
+    if (allocation->tensor_index != tensor_index_) return;
+    total_bytes_ += allocation->bytes;
+    peak_bytes_ = std::max(peak_bytes_, total_bytes_);
+  }
+
+  int64_t total_bytes() const { return total_bytes_; }
+  int64_t peak_bytes() const { return peak_bytes_; }
+
+ private:
+  const int tensor_index_;
+  int64_t total_bytes_ = 0;
+  int64_t peak_bytes_ = 0;
+};
+
+TEST(SubgraphProfileMemoryTest, ReleasesTheBufferOfAShrunkDynamicTensor) {
+  // Node 0 resizes its dynamic output down and up, and node 1, the last one
+  // using it, counts its elements.
+  Interpreter interpreter;
+  interpreter.AddTensors(3);
+  interpreter.SetInputs({0});
+  interpreter.SetOutputs({2});
+  TfLiteQuantizationParams quant;
+  for (int tensor_index = 0; tensor_index < 3; ++tensor_index) {
+    interpreter.SetTensorParametersReadWrite(tensor_index, kTfLiteInt32, "",
+                                             {1}, quant);
+  }
+  TfLiteRegistration resize_op = {nullptr, nullptr, nullptr, nullptr};
+  resize_op.prepare = [](TfLiteContext* context, TfLiteNode* node) {
+    context->tensors[node->outputs->data[0]].allocation_type = kTfLiteDynamic;
+    return kTfLiteOk;
+  };
+  resize_op.invoke = [](TfLiteContext* context, TfLiteNode* node) {
+    TfLiteTensor* output = &context->tensors[node->outputs->data[0]];
+    for (int size : {100, 10, 50}) {
+      TF_LITE_ENSURE_OK(context,
+                        context->ResizeTensor(context, output,
+                                              ConvertVectorToTfLiteIntArray(
+                                                  {size})));
+      std::fill_n(output->data.i32, size, 1);
+    }
+    return kTfLiteOk;
+  };
+  TfLiteRegistration count_op = {nullptr, nullptr, nullptr, nullptr};
+  count_op.invoke = [](TfLiteContext* context, TfLiteNode* node) {
+    const TfLiteTensor& input = context->tensors[node->inputs->data[0]];
+    context->tensors[node->outputs->data[0]].data.i32[0] =
+        input.bytes / sizeof(int32_t);
+    return kTfLiteOk;
+  };
+  interpreter.AddNodeWithParameters({0}, {1}, nullptr, 0, nullptr, &resize_op);
+  interpreter.AddNodeWithParameters({1}, {2}, nullptr, 0, nullptr, &count_op);
+  InterpreterOptions options;
+  options.SetEnsureDynamicTensorsAreReleased();
+  interpreter.ApplyOptions(&options);
+  TensorMemoryProfiler profiler(/*tensor_index=*/1);
+  interpreter.SetProfiler(&profiler);
+  ASSERT_EQ(interpreter.AllocateTensors(), kTfLiteOk);
+
+  ASSERT_EQ(interpreter.Invoke(), kTfLiteOk);
+  EXPECT_EQ(interpreter.typed_tensor<int32_t>(2)[0], 50);
+  EXPECT_EQ(interpreter.tensor(1)->data.raw, nullptr);
+  // The 400 byte buffer isn't reallocated to shrink to 40 bytes, but is when
+  // growing back to 200 bytes.
+  EXPECT_EQ(profiler.peak_bytes(), 100 * sizeof(int32_t));
+  EXPECT_EQ(profiler.total_bytes(), 0);
+}
+
 }  // namespace
 }  // namespace tflite
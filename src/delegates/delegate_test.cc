@@ -18,7 +18,10 @@ limitations under the License.
 #include <string.h>
 
 #include <algorithm>
+#include <chrono>  // NOLINT(build/c++11)
+#include <condition_variable>  // NOLINT(build/c++11)
 #include <memory>
+#include <mutex>  // NOLINT(build/c++11)
 #include <utility>
 #include <vector>
 
@@ -107,6 +110,111 @@ TEST_F(TestDelegate, DelegateNodePrepareFailure) {
   }
 }
 
+// Builds a chain of three ADD nodes. Delegating the first and the last one
+// makes two partitions, whose kernels are initialized together.
+void AddChainOfThreeAdds(Subgraph* subgraph) {
+  subgraph->AddTensors(4);
+  subgraph->SetInputs({0});
+  subgraph->SetOutputs({3});
+  std::vector<int> dims({3});
+  TfLiteQuantization quant{kTfLiteNoQuantization, nullptr};
+  for (int t = 0; t < 4; ++t) {
+    subgraph->SetTensorParametersReadWrite(t, kTfLiteFloat32, "", dims.size(),
+                                           dims.data(), quant, false);
+  }
+  TfLiteRegistration reg = test_utils::AddOpRegistration();
+  int node_index_ignored;
+  for (int t = 0; t < 3; ++t) {
+    subgraph->AddNodeWithParameters({t, t}, {t + 1}, {}, nullptr, 0, nullptr,
+                                    &reg, &node_index_ignored);
+  }
+}
+
+TEST_F(TestDelegate, ThreadSafeKernelInit) {
+  interpreter_ = TestDelegation::NewInterpreterWithDefaultDelegates();
+  AddChainOfThreeAdds(&interpreter_->primary_subgraph());
+  interpreter_->SetNumThreads(2);
+
+  delegate_ = std::unique_ptr<SimpleDelegate>(
+      new SimpleDelegate({0, 2}, kTfLiteDelegateFlagsThreadSafeKernelInit));
+  ASSERT_EQ(
+      interpreter_->ModifyGraphWithDelegate(delegate_->get_tf_lite_delegate()),
+      kTfLiteOk);
+  // Deferring the kernel init does not change the execution plan, which the
+  // kernels see whole.
+  ASSERT_EQ(interpreter_->execution_plan().size(), 3);
+  for (int i : {0, 2}) {
+    const int node_index = interpreter_->execution_plan()[i];
+    const TfLiteNode& node =
+        interpreter_->node_and_registration(node_index)->first;
+    ASSERT_NE(node.user_data, nullptr) << i;
+    EXPECT_EQ(*static_cast<int*>(node.user_data), 3) << i;
+  }
+
+  std::vector<float> input = {1.0f, 2.0f, 3.0f};
+  memcpy(interpreter_->typed_tensor<float>(0), input.data(), 3 * sizeof(float));
+  ASSERT_EQ(interpreter_->Invoke(), kTfLiteOk);
+  std::vector<float> expected_output = {8.0f, 16.0f, 24.0f};
+  TfLiteTensor* tensor = interpreter_->tensor(interpreter_->outputs()[0]);
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_EQ(tensor->data.f[i], expected_output[i]) << i;
+  }
+}
+
+// Counts the delegate kernels being initialized.
+struct ConcurrentKernelInits {
+  std::mutex mutex;
+  std::condition_variable cv;
+  int num_running = 0;
+  int max_num_running = 0;
+  TfLiteRegistration registration;
+};
+
+TEST_F(TestDelegate, ThreadSafeKernelInitRunsPartitionsConcurrently) {
+  interpreter_ = TestDelegation::NewInterpreterWithDefaultDelegates();
+  AddChainOfThreeAdds(&interpreter_->primary_subgraph());
+  interpreter_->SetNumThreads(2);
+
+  ConcurrentKernelInits inits;
+  inits.registration = SimpleDelegate({0, 2}).FakeFusedRegistration();
+  // Waits for the kernel of the other partition, which only starts while this
+  // one is initialized if they are initialized concurrently.
+  inits.registration.init = [](TfLiteContext* context, const char* buffer,
+                               size_t length) -> void* {
+    const auto* params = reinterpret_cast<const TfLiteDelegateParams*>(buffer);
+    auto* inits = static_cast<ConcurrentKernelInits*>(params->delegate->data_);
+    std::unique_lock<std::mutex> lock(inits->mutex);
+    inits->max_num_running =
+        std::max(inits->max_num_running, ++inits->num_running);
+    inits->cv.notify_all();
+    inits->cv.wait_for(lock, std::chrono::seconds(10),
+                       [inits] { return inits->max_num_running > 1; });
+    --inits->num_running;
+    return nullptr;
+  };
+  inits.registration.free = nullptr;
+
+  TfLiteDelegate delegate = TfLiteDelegateCreate();
+  delegate.data_ = &inits;
+  delegate.flags = kTfLiteDelegateFlagsThreadSafeKernelInit;
+  delegate.Prepare = [](TfLiteContext* context,
+                        TfLiteDelegate* delegate) -> TfLiteStatus {
+    auto* inits = static_cast<ConcurrentKernelInits*>(delegate->data_);
+    TfLiteIntArray* nodes_to_replace = TfLiteIntArrayCreate(2);
+    nodes_to_replace->data[0] = 0;
+    nodes_to_replace->data[1] = 2;
+    const TfLiteStatus status = context->ReplaceNodeSubsetsWithDelegateKernels(
+        context, inits->registration, nodes_to_replace, delegate);
+    TfLiteIntArrayFree(nodes_to_replace);
+    return status;
+  };
+  ASSERT_EQ(interpreter_->ModifyGraphWithDelegate(&delegate), kTfLiteOk);
+  EXPECT_EQ(interpreter_->execution_plan().size(), 3);
+  EXPECT_EQ(inits.max_num_running, 2);
+  // The interpreter must not outlive the delegate.
+  interpreter_.reset();
+}
+
 TEST_F(TestDelegate, DelegateNodeInvokeFailure) {
   delegate_ = std::unique_ptr<SimpleDelegate>(new SimpleDelegate(
       {0, 1, 2}, kTfLiteDelegateFlagsNone, false /**fail_node_prepare**/,
@@ -356,6 +356,23 @@ TfLiteRegistration SimpleDelegate::FakeFusedRegistration() {
     };
   }
 
+  if ((delegate_.flags & kTfLiteDelegateFlagsThreadSafeKernelInit) != 0) {
+    // Like the kernels of real delegates, reads the execution plan, which
+    // the kernels of the other partitions may be reading at the same time.
+    // Keeps its size as the user data.
+    reg.init = [](TfLiteContext* context, const char* buffer,
+                  size_t length) -> void* {
+      TfLiteIntArray* execution_plan;
+      if (context->GetExecutionPlan(context, &execution_plan) != kTfLiteOk) {
+        return nullptr;
+      }
+      return new int(execution_plan->size);
+    };
+    reg.free = [](TfLiteContext* context, void* buffer) {
+      delete static_cast<int*>(buffer);
+    };
+  }
+
   return reg;
 }
 
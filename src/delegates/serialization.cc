@@ -157,6 +157,10 @@ TfLiteStatus SerializationEntry::SetData(TfLiteContext* context,
   return kTfLiteOk;
 }
 
+std::string SerializationEntry::GetFilePath() const {
+  return delegates::GetFilePath(cache_dir_, model_token_, fingerprint_);
+}
+
 TfLiteStatus SerializationEntry::GetData(TfLiteContext* context,
                                          std::string* data) const {
   if (!data) return kTfLiteError;
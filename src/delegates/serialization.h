@@ -119,6 +119,11 @@ class SerializationEntry {
   //   kTfLiteError for unexpected error.
   TfLiteStatus GetData(TfLiteContext* context, std::string* data) const;
 
+  // Returns the path of the file backing this entry, for delegates that write
+  // and map large data (such as packed weights) themselves instead of using
+  // SetData/GetData.
+  std::string GetFilePath() const;
+
   // Non-copyable.
   SerializationEntry(const SerializationEntry&) = delete;
   SerializationEntry& operator=(const SerializationEntry&) = delete;
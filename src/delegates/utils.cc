@@ -17,15 +17,23 @@ limitations under the License.
 
 #include <algorithm>
 #include <cstdint>
+#include <cstdlib>
 #include <cstring>
+#include <fstream>
+#include <limits>
+#include <map>
 #include <set>
+#include <sstream>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "builtin_ops.h"
 #include "context_util.h"
+#include "core/c/builtin_op_data.h"
 #include "core/subgraph.h"
 #include "kernels/kernel_util.h"
+#include "minimal_logging.h"
 
 namespace tflite {
 namespace delegates {
@@ -71,6 +79,169 @@ TfLiteStatus MarkSubgraphAsDelegationSkippable(const TfLiteContext* context,
       ->MarkSubgraphAsDelegationSkippable(subgraph_index);
 }
 
+PartitionCostModel::PartitionCostModel()
+    : default_cost_{1.0, 0.5},
+      partition_overhead_ns_(2000.0),
+      transfer_ns_per_byte_(0.05) {
+  // Multiply-add bound ops, whose work is counted in multiply-adds.
+  for (const char* op_name :
+       {"BATCH_MATMUL", "CONV_2D", "DEPTHWISE_CONV_2D", "FULLY_CONNECTED",
+        "TRANSPOSE_CONV"}) {
+    op_costs_[op_name] = {0.25, 0.1};
+  }
+}
+
+TfLiteStatus PartitionCostModel::ParseCalibration(const std::string& table) {
+  std::istringstream lines(table);
+  std::string line;
+  while (std::getline(lines, line)) {
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+    std::istringstream fields(line);
+    std::string name;
+    std::string first;
+    std::string second;
+    if (!std::getline(fields, name, ',') || !std::getline(fields, first, ',') ||
+        !std::getline(fields, second)) {
+      TFLITE_LOG(TFLITE_LOG_ERROR, "Invalid partition cost line: %s",
+                 line.c_str());
+      return kTfLiteError;
+    }
+    char* first_end = nullptr;
+    char* second_end = nullptr;
+    const double first_value = std::strtod(first.c_str(), &first_end);
+    const double second_value = std::strtod(second.c_str(), &second_end);
+    if (first_end == first.c_str() || second_end == second.c_str() ||
+        first_value < 0 || second_value < 0) {
+      TFLITE_LOG(TFLITE_LOG_ERROR, "Invalid partition cost line: %s",
+                 line.c_str());
+      return kTfLiteError;
+    }
+    if (name == "BOUNDARY") {
+      SetBoundaryCost(first_value, second_value);
+    } else {
+      SetOpCost(name, {first_value, second_value});
+    }
+  }
+  return kTfLiteOk;
+}
+
+TfLiteStatus PartitionCostModel::LoadCalibration(const std::string& path) {
+  std::ifstream file(path);
+  if (!file) {
+    TFLITE_LOG(TFLITE_LOG_ERROR, "Could not open partition cost table %s",
+               path.c_str());
+    return kTfLiteError;
+  }
+  std::stringstream table;
+  table << file.rdbuf();
+  return ParseCalibration(table.str());
+}
+
+std::string PartitionCostModel::ToCalibration() const {
+  const std::map<std::string, OpCost> sorted_op_costs(op_costs_.begin(),
+                                                       op_costs_.end());
+  std::ostringstream table;
+  table.precision(std::numeric_limits<double>::max_digits10);
+  for (const auto& [op_name, cost] : sorted_op_costs) {
+    table << op_name << "," << cost.cpu_ns_per_unit << ","
+          << cost.delegate_ns_per_unit << "\n";
+  }
+  table << "BOUNDARY," << partition_overhead_ns_ << "," << transfer_ns_per_byte_
+        << "\n";
+  return table.str();
+}
+
+PartitionCostModel::OpCost PartitionCostModel::GetOpCost(
+    const std::string& op_name) const {
+  const auto it = op_costs_.find(op_name);
+  return it != op_costs_.end() ? it->second : default_cost_;
+}
+
+double PartitionCostModel::NodeWork(const TfLiteContext* context,
+                                    const TfLiteNode* node,
+                                    const TfLiteRegistration* registration) {
+  const auto num_elements = [context](int tensor_index) -> double {
+    if (tensor_index < 0 || context->tensors[tensor_index].dims == nullptr) {
+      return 0;
+    }
+    return NumElements(&context->tensors[tensor_index]);
+  };
+  // Returns the dimension of the input, counting from the last one.
+  const auto input_dim = [context, node](int input, int from_last) -> double {
+    if (input >= node->inputs->size || node->inputs->data[input] < 0) {
+      return 1;
+    }
+    const TfLiteIntArray* dims =
+        context->tensors[node->inputs->data[input]].dims;
+    if (dims == nullptr || from_last >= dims->size) {
+      return 1;
+    }
+    return dims->data[dims->size - 1 - from_last];
+  };
+
+  double output_elements = 0;
+  for (int i = 0; i < node->outputs->size; ++i) {
+    output_elements += num_elements(node->outputs->data[i]);
+  }
+  switch (registration->builtin_code) {
+    case kTfLiteBuiltinConv2d:
+      // Filter is [output_channels, height, width, input_channels].
+      return output_elements * input_dim(1, 0) * input_dim(1, 1) *
+             input_dim(1, 2);
+    case kTfLiteBuiltinDepthwiseConv2d:
+      // Filter is [1, height, width, output_channels].
+      return output_elements * input_dim(1, 1) * input_dim(1, 2);
+    case kTfLiteBuiltinFullyConnected:
+      // Weights are [output_channels, input_channels].
+      return output_elements * input_dim(1, 0);
+    case kTfLiteBuiltinTransposeConv:
+      // Every input element is multiplied by a [output_channels, height,
+      // width] slice of the filter.
+      return (node->inputs->size > 2 ? num_elements(node->inputs->data[2])
+                                     : 0) *
+             input_dim(1, 1) * input_dim(1, 2) * input_dim(1, 3);
+    case kTfLiteBuiltinBatchMatmul: {
+      const auto* params =
+          static_cast<const TfLiteBatchMatMulParams*>(node->builtin_data);
+      const bool adj_x = params != nullptr && params->adj_x;
+      return output_elements * input_dim(0, adj_x ? 1 : 0);
+    }
+    default:
+      return output_elements;
+  }
+}
+
+double PartitionCostModel::EstimateSavingNs(
+    TfLiteContext* context, const TfLiteDelegateParams& partition) const {
+  double saving_ns = -partition_overhead_ns_;
+  for (int node_index : TfLiteIntArrayView(partition.nodes_to_replace)) {
+    TfLiteNode* node = nullptr;
+    TfLiteRegistration* registration = nullptr;
+    if (context->GetNodeAndRegistration(context, node_index, &node,
+                                        &registration) != kTfLiteOk) {
+      continue;
+    }
+    const OpCost cost = GetOpCost(GetOpNameByRegistration(*registration));
+    saving_ns += NodeWork(context, node, registration) *
+                 (cost.cpu_ns_per_unit - cost.delegate_ns_per_unit);
+  }
+  for (const TfLiteIntArray* tensors :
+       {partition.input_tensors, partition.output_tensors}) {
+    if (tensors == nullptr) {
+      continue;
+    }
+    for (int tensor_index : TfLiteIntArrayView(tensors)) {
+      const TfLiteTensor& tensor = context->tensors[tensor_index];
+      if (tensor.allocation_type != kTfLiteMmapRo) {
+        saving_ns -= tensor.bytes * transfer_ns_per_byte_;
+      }
+    }
+  }
+  return saving_ns;
+}
+
 TfLiteStatus GraphPartitionHelper::PartitionImpl(
     std::set<std::string>* unsupported_nodes_info, int start_node_index,
     int end_node_index) {
@@ -122,6 +293,34 @@ GraphPartitionHelper::GetFirstNLargestPartitions(
   return results;
 }
 
+std::vector<int> GraphPartitionHelper::GetNodesOfProfitablePartitions(
+    const PartitionCostModel& cost_model, int n) {
+  std::vector<std::pair<double, TfLiteDelegateParams*>> profitable_partitions;
+  for (TfLiteDelegateParams* p : partitions_) {
+    const double saving_ns = cost_model.EstimateSavingNs(context_, *p);
+    if (saving_ns > 0) {
+      profitable_partitions.emplace_back(saving_ns, p);
+    }
+  }
+  std::stable_sort(
+      profitable_partitions.begin(), profitable_partitions.end(),
+      [](const std::pair<double, TfLiteDelegateParams*>& left,
+         const std::pair<double, TfLiteDelegateParams*>& right) {
+        return left.first > right.first;
+      });
+  if (n >= 0 && profitable_partitions.size() > static_cast<size_t>(n)) {
+    profitable_partitions.resize(n);
+  }
+
+  std::vector<int> ops_to_replace;
+  for (const auto& partition : profitable_partitions) {
+    const TfLiteIntArray* nodes = partition.second->nodes_to_replace;
+    ops_to_replace.insert(ops_to_replace.end(), nodes->data,
+                          nodes->data + nodes->size);
+  }
+  return ops_to_replace;
+}
+
 std::vector<int> GraphPartitionHelper::GetNodesOfFirstNLargestPartitionsImpl(
     int n, int min_nodes_per_partition) {
   auto first_n_partitions =
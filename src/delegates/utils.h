@@ -96,6 +96,68 @@ using IsNodeSupportedFn =
     std::function<bool(TfLiteContext*, TfLiteNode*, TfLiteRegistration*,
                        std::string* unsupported_details)>;
 
+// Estimates whether a delegated partition runs faster than its nodes on the
+// TFLite CPU kernels, so that delegates can reject partitions too small to pay
+// for their boundaries.
+//
+// A node costs its work times a per-op cost per unit of work, on the CPU
+// kernels and in the delegate. The work is the number of multiply-adds for
+// convolutions, fully connected layers and batch matrix multiplications, and
+// the number of output elements for the other ops. Each partition also pays a
+// fixed overhead, and a cost per byte of its non-constant inputs and outputs.
+//
+// The default costs are rough estimates for CPU delegates. They can be
+// calibrated with a table of "OP_NAME,cpu_ns_per_unit,delegate_ns_per_unit"
+// lines, e.g. "CONV_2D,0.31,0.09", where the costs are the average op times
+// reported by benchmark_model --enable_op_profiling=true without and with the
+// delegate, divided by the work of the op. Op names are those of the profiles.
+// A "BOUNDARY,overhead_ns,ns_per_byte" line sets the partition costs.
+class PartitionCostModel {
+ public:
+  struct OpCost {
+    double cpu_ns_per_unit;
+    double delegate_ns_per_unit;
+  };
+
+  PartitionCostModel();
+
+  // Parses a calibration table as described above. Empty lines and lines
+  // starting with '#' are ignored, and ops missing from the table keep their
+  // costs.
+  TfLiteStatus ParseCalibration(const std::string& table);
+  // Reads and parses a calibration table file.
+  TfLiteStatus LoadCalibration(const std::string& path);
+  // Returns the costs as a calibration table, with the ops sorted by name, so
+  // that models with the same costs give the same table.
+  std::string ToCalibration() const;
+
+  void SetOpCost(const std::string& op_name, OpCost cost) {
+    op_costs_[op_name] = cost;
+  }
+  OpCost GetOpCost(const std::string& op_name) const;
+  void SetBoundaryCost(double partition_overhead_ns,
+                       double transfer_ns_per_byte) {
+    partition_overhead_ns_ = partition_overhead_ns;
+    transfer_ns_per_byte_ = transfer_ns_per_byte;
+  }
+
+  // Returns the work of the node, as described above.
+  static double NodeWork(const TfLiteContext* context, const TfLiteNode* node,
+                         const TfLiteRegistration* registration);
+
+  // Returns the estimated time saved by delegating the partition, negative
+  // when the delegated partition is slower.
+  double EstimateSavingNs(TfLiteContext* context,
+                          const TfLiteDelegateParams& partition) const;
+
+ private:
+  std::unordered_map<std::string, OpCost> op_costs_;
+  // Cost of the ops missing from op_costs_.
+  OpCost default_cost_;
+  double partition_overhead_ns_;
+  double transfer_ns_per_byte_;
+};
+
 // A utility class to help model graph parition.
 // Note the class *needs* to be used in TfLiteDelegate::Prepare.
 class GraphPartitionHelper {
@@ -160,6 +222,13 @@ class GraphPartitionHelper {
     return GetNodesOfFirstNLargestPartitionsImpl(n, min_nodes_per_partition);
   }
 
+  // Returns a list of node indices of the nodes of at most n partitions which
+  // the cost model estimates to run faster when delegated, taking the
+  // partitions saving the most time first.
+  std::vector<int> GetNodesOfProfitablePartitions(
+      const PartitionCostModel& cost_model,
+      int n = std::numeric_limits<int>::max());
+
   int num_total_nodes() const { return num_total_nodes_; }
   int num_supported_nodes() const { return num_supported_nodes_; }
   int num_partitions() const { return partitions_.size(); }
@@ -15,6 +15,7 @@ limitations under the License.
 #include "delegates/utils/dummy_delegate/dummy_delegate.h"
 
 #include <memory>
+#include <string>
 #include <utility>
 
 #include "delegates/utils/simple_delegate.h"
@@ -70,8 +71,12 @@ class DummyDelegate : public SimpleDelegateInterface {
   }
 
   SimpleDelegateInterface::Options DelegateOptions() const override {
-    // Use default options.
-    return SimpleDelegateInterface::Options();
+    // Use default partitioning options.
+    SimpleDelegateInterface::Options options;
+    options.serialization_dir = options_.serialization_dir;
+    options.model_token = options_.model_token;
+    options.settings = std::to_string(options_.allowed_builtin_code);
+    return options;
   }
 
  private:
@@ -33,6 +33,9 @@ typedef struct {
   bool error_during_prepare;
   // Report error during invoke.
   bool error_during_invoke;
+  // Serialize the delegated nodes, see SimpleDelegateInterface::Options.
+  const char* serialization_dir;
+  const char* model_token;
 } DummyDelegateOptions;
 
 // Returns a structure with the default delegate options.
@@ -25,6 +25,7 @@ limitations under the License.
 #include "array.h"
 #include "builtin_ops.h"
 #include "core/c/common.h"
+#include "delegates/serialization.h"
 #include "delegates/utils.h"
 #include "kernels/internal/compatibility.h"
 #include "logger.h"
@@ -88,6 +89,43 @@ TfLiteStatus DelegatePrepare(TfLiteContext* context,
     delegate_options.max_delegated_partitions = std::numeric_limits<int>::max();
 
   TF_LITE_ENSURE_STATUS(delegate->Initialize(context));
+  TfLiteRegistration delegate_kernel_registration =
+      GetDelegateKernelRegistration(delegate);
+
+  // Reuse the nodes delegated by a previous run if they were serialized.
+  std::unique_ptr<delegates::Serialization> serialization;
+  std::string settings =
+      std::to_string(delegate_options.max_delegated_partitions) + "," +
+      std::to_string(delegate_options.min_nodes_per_partition) + "," +
+      delegate_options.settings;
+  if (delegate_options.partition_cost_model != nullptr) {
+    settings += "," + delegate_options.partition_cost_model->ToCalibration();
+  }
+  const std::string delegate_id =
+      std::string(delegate->Name()) + "_" +
+      delegates::StrFingerprint(settings.data(), settings.size());
+  if (delegate_options.serialization_dir != nullptr &&
+      delegate_options.model_token != nullptr) {
+    delegates::SerializationParams params;
+    params.model_token = delegate_options.model_token;
+    params.cache_dir = delegate_options.serialization_dir;
+    serialization = std::make_unique<delegates::Serialization>(params);
+    TfLiteIntArray* cached_nodes = nullptr;
+    if (delegates::GetDelegatedNodes(context, serialization.get(), delegate_id,
+                                     &cached_nodes) == kTfLiteOk &&
+        cached_nodes != nullptr) {
+      TFLITE_LOG_PROD_ONCE(tflite::TFLITE_LOG_INFO,
+                           "%s delegate: %d serialized nodes delegated.\n",
+                           delegate->Name(), cached_nodes->size);
+      const TfLiteStatus status =
+          context->ReplaceNodeSubsetsWithDelegateKernels(
+              context, delegate_kernel_registration, cached_nodes,
+              base_delegate);
+      TfLiteIntArrayFree(cached_nodes);
+      return status;
+    }
+  }
+
   delegates::IsNodeSupportedFn node_supported_fn =
       [=](TfLiteContext* context, TfLiteNode* node,
           TfLiteRegistration* registration,
@@ -98,21 +136,33 @@ TfLiteStatus DelegatePrepare(TfLiteContext* context,
   delegates::GraphPartitionHelper helper(context, node_supported_fn);
   TF_LITE_ENSURE_STATUS(helper.Partition(nullptr));
 
-  std::vector<int> supported_nodes = helper.GetNodesOfFirstNLargestPartitions(
-      delegate_options.max_delegated_partitions,
-      delegate_options.min_nodes_per_partition);
+  std::vector<int> supported_nodes =
+      delegate_options.partition_cost_model != nullptr
+          ? helper.GetNodesOfProfitablePartitions(
+                *delegate_options.partition_cost_model,
+                delegate_options.max_delegated_partitions)
+          : helper.GetNodesOfFirstNLargestPartitions(
+                delegate_options.max_delegated_partitions,
+                delegate_options.min_nodes_per_partition);
 
   TFLITE_LOG_PROD_ONCE(tflite::TFLITE_LOG_INFO,
                        "%s delegate: %d nodes delegated out of %d nodes with "
                        "%d partitions.\n",
                        delegate->Name(), supported_nodes.size(),
                        helper.num_total_nodes(), helper.num_partitions());
-  TfLiteRegistration delegate_kernel_registration =
-      GetDelegateKernelRegistration(delegate);
+  auto supported_nodes_array = BuildTfLiteArray(supported_nodes);
+  if (serialization != nullptr &&
+      delegates::SaveDelegatedNodes(context, serialization.get(), delegate_id,
+                                    supported_nodes_array.get()) !=
+          kTfLiteOk) {
+    TFLITE_LOG_PROD(tflite::TFLITE_LOG_WARNING,
+                    "%s delegate: could not serialize the delegated nodes.",
+                    delegate->Name());
+  }
 
   return context->ReplaceNodeSubsetsWithDelegateKernels(
-      context, delegate_kernel_registration,
-      BuildTfLiteArray(supported_nodes).get(), base_delegate);
+      context, delegate_kernel_registration, supported_nodes_array.get(),
+      base_delegate);
 }
 }  // namespace
 
@@ -32,11 +32,15 @@ limitations under the License.
 #include <stdint.h>
 
 #include <memory>
+#include <string>
 #include <utility>
 
 #include "core/c/common.h"
 
 namespace tflite {
+namespace delegates {
+class PartitionCostModel;
+}  // namespace delegates
 
 using TfLiteDelegateUniquePtr =
     std::unique_ptr<TfLiteDelegate, void (*)(TfLiteDelegate*)>;
@@ -86,6 +90,27 @@ class SimpleDelegateInterface {
     // The minimum number of nodes allowed in a delegated graph, values <=0
     // means unlimited.
     int min_nodes_per_partition = 0;
+
+    // If set, only the partitions which the cost model estimates to run
+    // faster in the delegate are delegated, up to max_delegated_partitions,
+    // and min_nodes_per_partition is ignored.
+    std::shared_ptr<const delegates::PartitionCostModel> partition_cost_model;
+
+    // If both are set, the nodes chosen by the delegate are stored in
+    // 'serialization_dir' the first time it is applied to a graph, and later
+    // applications to the same graph, including in other processes, delegate
+    // these nodes without calling IsNodeSupportedByDelegate or partitioning
+    // the graph again. 'model_token' must identify the model. The nodes are
+    // only reused with the same 'settings', partitioning options and costs of
+    // 'partition_cost_model'. See delegates::Serialization. Kernels can use the
+    // same settings to cache their own data with
+    // Serialization::GetEntryForKernel.
+    const char* serialization_dir = nullptr;
+    const char* model_token = nullptr;
+
+    // The delegate settings which affect the supported nodes, e.g. the
+    // options it was created with, in any format.
+    std::string settings;
   };
 
   virtual ~SimpleDelegateInterface() = default;
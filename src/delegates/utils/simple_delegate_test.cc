@@ -15,13 +15,16 @@ limitations under the License.
 #include <stdlib.h>
 
 #include <memory>
+#include <string>
 #include <utility>
 
 #include <gtest/gtest.h>
 #include "builtin_ops.h"
 #include "core/c/common.h"
 #include "core/kernels/builtin_op_kernels.h"
+#include "delegates/utils.h"
 #include "delegates/utils/dummy_delegate/dummy_delegate.h"
+#include "delegates/utils/simple_delegate.h"
 #include "interpreter.h"
 
 namespace tflite {
@@ -99,6 +102,118 @@ TEST_F(TestDelegate, NoNodesToDelegate) {
   ASSERT_EQ(interpreter_->execution_plan().size(), 3);
 }
 
+TEST_F(TestDelegate, SerializedDelegatedNodes) {
+  const std::string serialization_dir = ::testing::TempDir();
+  DummyDelegateOptions options = TfLiteDummyDelegateOptionsDefault();
+  options.allowed_builtin_code = kTfLiteBuiltinAdd;
+  options.serialization_dir = serialization_dir.c_str();
+  options.model_token = "SerializedDelegatedNodes";
+  interpreter_->ModifyGraphWithDelegate(
+      TfLiteDummyDelegateCreateUnique(&options));
+  ASSERT_EQ(interpreter_->execution_plan().size(), 1);
+
+  // The nodes serialized with other delegate options are not reused.
+  SetUp();
+  options.allowed_builtin_code = kTfLiteBuiltinSub;
+  interpreter_->ModifyGraphWithDelegate(
+      TfLiteDummyDelegateCreateUnique(&options));
+  ASSERT_EQ(interpreter_->execution_plan().size(), 3);
+
+  SetUp();
+  options.allowed_builtin_code = kTfLiteBuiltinAdd;
+  options.model_token = "SerializedDelegatedNodesOtherToken";
+  interpreter_->ModifyGraphWithDelegate(
+      TfLiteDummyDelegateCreateUnique(&options));
+  ASSERT_EQ(interpreter_->execution_plan().size(), 1);
+}
+
+// Delegates the ADD nodes, counting the nodes it is asked about.
+class CountingDelegate : public SimpleDelegateInterface {
+ public:
+  CountingDelegate(const std::string& serialization_dir,
+                   std::shared_ptr<const delegates::PartitionCostModel>
+                       partition_cost_model,
+                   int* num_checked_nodes)
+      : serialization_dir_(serialization_dir),
+        partition_cost_model_(std::move(partition_cost_model)),
+        num_checked_nodes_(num_checked_nodes) {}
+
+  bool IsNodeSupportedByDelegate(const TfLiteRegistration* registration,
+                                 const TfLiteNode* node,
+                                 TfLiteContext* context) const override {
+    ++*num_checked_nodes_;
+    return registration->builtin_code == kTfLiteBuiltinAdd;
+  }
+  TfLiteStatus Initialize(TfLiteContext* context) override { return kTfLiteOk; }
+  const char* Name() const override { return "CountingDelegate"; }
+  std::unique_ptr<SimpleDelegateKernelInterface> CreateDelegateKernelInterface()
+      override {
+    return std::make_unique<Kernel>();
+  }
+  SimpleDelegateInterface::Options DelegateOptions() const override {
+    SimpleDelegateInterface::Options options;
+    options.partition_cost_model = partition_cost_model_;
+    options.serialization_dir = serialization_dir_.c_str();
+    options.model_token = "CountingDelegate";
+    return options;
+  }
+
+ private:
+  class Kernel : public SimpleDelegateKernelInterface {
+   public:
+    TfLiteStatus Init(TfLiteContext* context,
+                      const TfLiteDelegateParams* params) override {
+      return kTfLiteOk;
+    }
+    TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node) override {
+      return kTfLiteOk;
+    }
+    TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) override {
+      return kTfLiteOk;
+    }
+  };
+
+  const std::string serialization_dir_;
+  const std::shared_ptr<const delegates::PartitionCostModel>
+      partition_cost_model_;
+  int* const num_checked_nodes_;
+};
+
+TEST_F(TestDelegate, SerializedDelegatedNodesDependOnTheCosts) {
+  // A new directory, so that no nodes serialized by a previous run are reused.
+  std::string serialization_dir =
+      ::testing::TempDir() + "/SerializedDelegatedNodesXXXXXX";
+  ASSERT_NE(mkdtemp(&serialization_dir[0]), nullptr);
+  auto cheap_boundaries = std::make_shared<delegates::PartitionCostModel>();
+  cheap_boundaries->SetBoundaryCost(0.0, 0.0);
+  auto costly_boundaries = std::make_shared<delegates::PartitionCostModel>();
+  costly_boundaries->SetBoundaryCost(1e9, 0.0);
+
+  // Returns the number of nodes the delegate is asked about, none when it
+  // reuses serialized nodes.
+  auto apply_delegate =
+      [&](std::shared_ptr<const delegates::PartitionCostModel> costs) {
+        SetUp();
+        int num_checked_nodes = 0;
+        EXPECT_EQ(interpreter_->ModifyGraphWithDelegate(
+                      TfLiteDelegateFactory::Create(
+                          std::make_unique<CountingDelegate>(
+                              serialization_dir, costs, &num_checked_nodes))),
+                  kTfLiteOk);
+        return num_checked_nodes;
+      };
+
+  EXPECT_EQ(apply_delegate(nullptr), 3);
+  EXPECT_EQ(apply_delegate(nullptr), 0);
+  EXPECT_EQ(interpreter_->execution_plan().size(), 1);
+  EXPECT_EQ(apply_delegate(cheap_boundaries), 3);
+  EXPECT_EQ(apply_delegate(cheap_boundaries), 0);
+  EXPECT_EQ(apply_delegate(costly_boundaries), 3);
+  EXPECT_EQ(interpreter_->execution_plan().size(), 3);
+  EXPECT_EQ(apply_delegate(costly_boundaries), 0);
+  EXPECT_EQ(interpreter_->execution_plan().size(), 3);
+}
+
 TEST_F(TestDelegate, DelegateFailedPrepare) {
   DummyDelegateOptions options = TfLiteDummyDelegateOptionsDefault();
   options.allowed_builtin_code = kTfLiteBuiltinAdd;
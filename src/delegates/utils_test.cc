@@ -295,6 +295,210 @@ TEST(GraphPartitionHelper, CheckPartitionsWithSupportedNodeList) {
   EXPECT_THAT(nodes, testing::ElementsAreArray({0, 3, 7, 8, 2, 4, 9}));
 }
 
+TEST(PartitionCostModel, ParseCalibration) {
+  PartitionCostModel cost_model;
+  EXPECT_EQ(kTfLiteOk, cost_model.ParseCalibration(
+                           "# op,cpu_ns_per_unit,delegate_ns_per_unit\n"
+                           "\n"
+                           "ADD,2.5,0.5\n"
+                           "BOUNDARY,100,0\n"));
+  EXPECT_EQ(2.5, cost_model.GetOpCost("ADD").cpu_ns_per_unit);
+  EXPECT_EQ(0.5, cost_model.GetOpCost("ADD").delegate_ns_per_unit);
+
+  EXPECT_EQ(kTfLiteError, cost_model.ParseCalibration("ADD,fast,0.5\n"));
+  EXPECT_EQ(kTfLiteError, cost_model.ParseCalibration("ADD,1\n"));
+  EXPECT_EQ(kTfLiteError, cost_model.ParseCalibration("ADD,-1,1\n"));
+}
+
+TEST(PartitionCostModel, ToCalibration) {
+  PartitionCostModel cost_model;
+  ASSERT_EQ(kTfLiteOk, cost_model.ParseCalibration("SUB,0.1,0.3\n"
+                                                   "ADD,2.5,0.5\n"
+                                                   "BOUNDARY,100,0.25\n"));
+  const std::string table = cost_model.ToCalibration();
+
+  PartitionCostModel parsed_cost_model;
+  ASSERT_EQ(kTfLiteOk, parsed_cost_model.ParseCalibration(table));
+  EXPECT_EQ(table, parsed_cost_model.ToCalibration());
+  EXPECT_EQ(0.1, parsed_cost_model.GetOpCost("SUB").cpu_ns_per_unit);
+  EXPECT_LT(table.find("ADD,2.5,0.5\n"), table.find("SUB,"));
+  EXPECT_NE(table.find("BOUNDARY,100,0.25\n"), std::string::npos);
+
+  parsed_cost_model.SetOpCost("ADD", {2.5, 0.25});
+  EXPECT_NE(table, parsed_cost_model.ToCalibration());
+}
+
+// A context with a single ADD node, whose inputs and output are
+// [1, num_elements] FP32 tensors.
+class AddContext : public TfLiteContext {
+ public:
+  explicit AddContext(int num_elements) : TfLiteContext({0}) {
+    for (TfLiteTensor& tensor : tensors_) {
+      tensor.type = kTfLiteFloat32;
+      tensor.allocation_type = kTfLiteArenaRw;
+      tensor.dims = TfLiteIntArrayCreate(2);
+      tensor.dims->data[0] = 1;
+      tensor.dims->data[1] = num_elements;
+      tensor.bytes = num_elements * sizeof(float);
+    }
+    tensors = tensors_;
+    tensors_size = 3;
+    node_.inputs = TfLiteIntArrayCreate(2);
+    node_.inputs->data[0] = 0;
+    node_.inputs->data[1] = 1;
+    node_.outputs = TfLiteIntArrayCreate(1);
+    node_.outputs->data[0] = 2;
+    registration_.builtin_code = kTfLiteBuiltinAdd;
+
+    partition_.nodes_to_replace = TfLiteIntArrayCreate(1);
+    partition_.nodes_to_replace->data[0] = 0;
+    partition_.input_tensors = TfLiteIntArrayCopy(node_.inputs);
+    partition_.output_tensors = TfLiteIntArrayCopy(node_.outputs);
+    GetNodeAndRegistration = [](TfLiteContext* context, int node_index,
+                                TfLiteNode** node,
+                                TfLiteRegistration** registration) {
+      AddContext* add_context = reinterpret_cast<AddContext*>(context);
+      *node = &add_context->node_;
+      *registration = &add_context->registration_;
+      return kTfLiteOk;
+    };
+  }
+  ~AddContext() {
+    for (TfLiteTensor& tensor : tensors_) {
+      TfLiteIntArrayFree(tensor.dims);
+    }
+    TfLiteIntArrayFree(node_.inputs);
+    TfLiteIntArrayFree(node_.outputs);
+    TfLiteIntArrayFree(partition_.nodes_to_replace);
+    TfLiteIntArrayFree(partition_.input_tensors);
+    TfLiteIntArrayFree(partition_.output_tensors);
+  }
+
+  const TfLiteDelegateParams& partition() const { return partition_; }
+
+ private:
+  TfLiteTensor tensors_[3] = {};
+  TfLiteNode node_ = {};
+  TfLiteRegistration registration_ = {};
+  TfLiteDelegateParams partition_ = {};
+};
+
+TEST(PartitionCostModel, EstimateSaving) {
+  PartitionCostModel cost_model;
+  ASSERT_EQ(kTfLiteOk, cost_model.ParseCalibration("ADD,2,1\n"
+                                                   "BOUNDARY,100,0.25\n"));
+
+  // Each element saves 1ns, and the boundary costs 100ns plus 3 * 4 bytes *
+  // 0.25ns per element.
+  AddContext small_context(/*num_elements=*/10);
+  EXPECT_DOUBLE_EQ(10 - 100 - 30,
+                   cost_model.EstimateSavingNs(&small_context,
+                                               small_context.partition()));
+  AddContext large_context(/*num_elements=*/1000);
+  EXPECT_DOUBLE_EQ(1000 - 100 - 3000,
+                   cost_model.EstimateSavingNs(&large_context,
+                                               large_context.partition()));
+
+  ASSERT_EQ(kTfLiteOk, cost_model.ParseCalibration("BOUNDARY,100,0\n"));
+  EXPECT_DOUBLE_EQ(1000 - 100,
+                   cost_model.EstimateSavingNs(&large_context,
+                                               large_context.partition()));
+}
+
+// A context with one ADD node per element of 'num_elements', each in its own
+// partition, whose input and output are [1, num_elements[i]] FP32 tensors.
+class AddPartitionsContext : public TfLiteContext {
+ public:
+  explicit AddPartitionsContext(const std::vector<int>& num_elements)
+      : TfLiteContext({0}),
+        tensors_(2 * num_elements.size()),
+        nodes_(num_elements.size()),
+        partitions_(num_elements.size()) {
+    for (size_t i = 0; i < tensors_.size(); ++i) {
+      TfLiteTensor& tensor = tensors_[i];
+      tensor.type = kTfLiteFloat32;
+      tensor.allocation_type = kTfLiteArenaRw;
+      tensor.dims = TfLiteIntArrayCreate(2);
+      tensor.dims->data[0] = 1;
+      tensor.dims->data[1] = num_elements[i / 2];
+      tensor.bytes = num_elements[i / 2] * sizeof(float);
+    }
+    tensors = tensors_.data();
+    tensors_size = tensors_.size();
+    registration_.builtin_code = kTfLiteBuiltinAdd;
+    for (size_t i = 0; i < nodes_.size(); ++i) {
+      nodes_[i].inputs = TfLiteIntArrayCreate(1);
+      nodes_[i].inputs->data[0] = 2 * i;
+      nodes_[i].outputs = TfLiteIntArrayCreate(1);
+      nodes_[i].outputs->data[0] = 2 * i + 1;
+      partitions_[i].nodes_to_replace = TfLiteIntArrayCreate(1);
+      partitions_[i].nodes_to_replace->data[0] = i;
+      partitions_[i].input_tensors = TfLiteIntArrayCopy(nodes_[i].inputs);
+      partitions_[i].output_tensors = TfLiteIntArrayCopy(nodes_[i].outputs);
+    }
+    GetNodeAndRegistration = [](TfLiteContext* context, int node_index,
+                                TfLiteNode** node,
+                                TfLiteRegistration** registration) {
+      auto* add_context = reinterpret_cast<AddPartitionsContext*>(context);
+      *node = &add_context->nodes_[node_index];
+      *registration = &add_context->registration_;
+      return kTfLiteOk;
+    };
+    PreviewDelegatePartitioning =
+        [](TfLiteContext* context, const TfLiteIntArray* nodes_to_replace,
+           TfLiteDelegateParams** partition_params_array,
+           int* num_partitions) {
+          auto* add_context = reinterpret_cast<AddPartitionsContext*>(context);
+          *partition_params_array = add_context->partitions_.data();
+          *num_partitions = add_context->partitions_.size();
+          return kTfLiteOk;
+        };
+  }
+  ~AddPartitionsContext() {
+    for (TfLiteTensor& tensor : tensors_) {
+      TfLiteIntArrayFree(tensor.dims);
+    }
+    for (TfLiteNode& node : nodes_) {
+      TfLiteIntArrayFree(node.inputs);
+      TfLiteIntArrayFree(node.outputs);
+    }
+    for (TfLiteDelegateParams& partition : partitions_) {
+      TfLiteIntArrayFree(partition.nodes_to_replace);
+      TfLiteIntArrayFree(partition.input_tensors);
+      TfLiteIntArrayFree(partition.output_tensors);
+    }
+  }
+
+ private:
+  std::vector<TfLiteTensor> tensors_;
+  std::vector<TfLiteNode> nodes_;
+  TfLiteRegistration registration_ = {};
+  std::vector<TfLiteDelegateParams> partitions_;
+};
+
+TEST(GraphPartitionHelper, RejectsUnprofitablePartitions) {
+  PartitionCostModel cost_model;
+  ASSERT_EQ(kTfLiteOk, cost_model.ParseCalibration("ADD,2,1\n"
+                                                   "BOUNDARY,100,0\n"));
+
+  // Each element saves 1ns, so only the partitions with more than 100
+  // elements pay for their overhead.
+  AddPartitionsContext context({10, 1000, 50, 200});
+  GraphPartitionHelper helper(&context, std::vector<int>{0, 1, 2, 3});
+  ASSERT_EQ(kTfLiteOk, helper.Partition(nullptr));
+  EXPECT_EQ(4, helper.num_partitions());
+  EXPECT_THAT(helper.GetNodesOfProfitablePartitions(cost_model),
+              testing::ElementsAre(1, 3));
+  // The partitions saving the most come first.
+  EXPECT_THAT(helper.GetNodesOfProfitablePartitions(cost_model, /*n=*/1),
+              testing::ElementsAre(1));
+
+  // W/o boundary costs, every partition is profitable.
+  ASSERT_EQ(kTfLiteOk, cost_model.ParseCalibration("BOUNDARY,0,0\n"));
+  EXPECT_THAT(helper.GetNodesOfProfitablePartitions(cost_model),
+              testing::ElementsAre(1, 3, 2, 0));
+}
+
 }  // namespace
 }  // namespace delegates
 }  // namespace tflite
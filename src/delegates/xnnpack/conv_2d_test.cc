@@ -13,18 +13,50 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <algorithm>
 #include <cstdint>
 #include <functional>
 #include <memory>
 #include <random>
+#include <string>
+#include <vector>
 
 #include <gtest/gtest.h>
+#include "flatbuffers/vector.h"  // from @flatbuffers
+#include "core/interpreter_builder.h"
+#include "core/kernels/register.h"
 #include "delegates/xnnpack/conv_2d_tester.h"
 #include "delegates/xnnpack/xnnpack_delegate.h"
+#include "delegates/xnnpack/xnnpack_delegate_test.h"
+#include "interpreter.h"
+#include "schema/schema_generated.h"
 
 namespace tflite {
 namespace xnnpack {
 
+namespace {
+
+// Builds an interpreter for the model in 'buffer', which must outlive it, and
+// applies 'delegate' to it.
+std::unique_ptr<Interpreter> CreateDelegatedInterpreter(
+    const std::vector<char>& buffer, TfLiteDelegate* delegate) {
+  std::unique_ptr<Interpreter> interpreter;
+  EXPECT_EQ(
+      InterpreterBuilder(
+          GetModel(buffer.data()),
+          ::tflite::ops::builtin::BuiltinOpResolverWithoutDefaultDelegates())(
+          &interpreter),
+      kTfLiteOk);
+  if (interpreter == nullptr) {
+    return nullptr;
+  }
+  EXPECT_EQ(interpreter->AllocateTensors(), kTfLiteOk);
+  EXPECT_EQ(interpreter->ModifyGraphWithDelegate(delegate), kTfLiteOk);
+  return interpreter;
+}
+
+}  // namespace
+
 TEST(Conv2D, 1x1) {
   std::unique_ptr<TfLiteDelegate, decltype(&TfLiteXNNPackDelegateDelete)>
       xnnpack_delegate(TfLiteXNNPackDelegateCreate(nullptr),
@@ -816,6 +848,231 @@ TEST(Conv2D, TransientIndirectionBuffer) {
       .Test(xnnpack_delegate.get());
 }
 
+TEST(Conv2D, LazyWeightPacking) {
+  TfLiteXNNPackDelegateOptions xnnpack_options =
+      TfLiteXNNPackDelegateOptionsDefault();
+  xnnpack_options.num_threads = 2;
+  xnnpack_options.flags |=
+      TFLITE_XNNPACK_DELEGATE_FLAG_LAZY_WEIGHT_PACKING;
+  std::unique_ptr<TfLiteDelegate, decltype(&TfLiteXNNPackDelegateDelete)>
+      xnnpack_delegate(TfLiteXNNPackDelegateCreate(&xnnpack_options),
+                       TfLiteXNNPackDelegateDelete);
+
+  std::random_device random_device;
+  auto rng = std::mt19937(random_device());
+  auto batch_rng =
+      std::bind(std::uniform_int_distribution<int32_t>(2, 4), std::ref(rng));
+  auto input_rng =
+      std::bind(std::uniform_int_distribution<int32_t>(10, 25), std::ref(rng));
+  auto kernel_rng =
+      std::bind(std::uniform_int_distribution<int32_t>(3, 5), std::ref(rng));
+  auto stride_rng =
+      std::bind(std::uniform_int_distribution<int32_t>(2, 3), std::ref(rng));
+  auto channel_rng =
+      std::bind(std::uniform_int_distribution<int32_t>(2, 16), std::ref(rng));
+
+  Conv2DTester tester;
+  tester.BatchSize(batch_rng())
+      .InputHeight(input_rng())
+      .InputWidth(input_rng())
+      .InputChannels(channel_rng())
+      .OutputChannels(channel_rng())
+      .KernelHeight(kernel_rng())
+      .KernelWidth(kernel_rng())
+      .StrideHeight(stride_rng())
+      .StrideWidth(stride_rng());
+
+  // The weights are packed by the first invoke, not by the delegation.
+  const std::vector<char> buffer = tester.CreateTfLiteModel();
+  std::unique_ptr<Interpreter> interpreter =
+      CreateDelegatedInterpreter(buffer, xnnpack_delegate.get());
+  ASSERT_NE(interpreter, nullptr);
+  const void* delegate_data = xnnpack_delegate->data_;
+  EXPECT_EQ(GetNumPackedPartitions(delegate_data), 0);
+  ASSERT_EQ(interpreter->Invoke(), kTfLiteOk);
+  EXPECT_EQ(GetNumPackedPartitions(delegate_data), 1);
+  ASSERT_EQ(interpreter->Invoke(), kTfLiteOk);
+  EXPECT_EQ(GetNumPackedPartitions(delegate_data), 1);
+  interpreter.reset();
+
+  tester.Test(xnnpack_delegate.get());
+}
+
+TEST(Conv2D, BackgroundWeightPacking) {
+  TfLiteXNNPackDelegateOptions xnnpack_options =
+      TfLiteXNNPackDelegateOptionsDefault();
+  xnnpack_options.num_threads = 2;
+  xnnpack_options.flags |=
+      TFLITE_XNNPACK_DELEGATE_FLAG_LAZY_WEIGHT_PACKING |
+      TFLITE_XNNPACK_DELEGATE_FLAG_BACKGROUND_WEIGHT_PACKING;
+  std::unique_ptr<TfLiteDelegate, decltype(&TfLiteXNNPackDelegateDelete)>
+      xnnpack_delegate(TfLiteXNNPackDelegateCreate(&xnnpack_options),
+                       TfLiteXNNPackDelegateDelete);
+
+  std::random_device random_device;
+  auto rng = std::mt19937(random_device());
+  auto batch_rng =
+      std::bind(std::uniform_int_distribution<int32_t>(2, 4), std::ref(rng));
+  auto input_rng =
+      std::bind(std::uniform_int_distribution<int32_t>(10, 25), std::ref(rng));
+  auto kernel_rng =
+      std::bind(std::uniform_int_distribution<int32_t>(3, 5), std::ref(rng));
+  auto stride_rng =
+      std::bind(std::uniform_int_distribution<int32_t>(2, 3), std::ref(rng));
+  auto channel_rng =
+      std::bind(std::uniform_int_distribution<int32_t>(2, 16), std::ref(rng));
+
+  Conv2DTester tester;
+  tester.BatchSize(batch_rng())
+      .InputHeight(input_rng())
+      .InputWidth(input_rng())
+      .InputChannels(channel_rng())
+      .OutputChannels(channel_rng())
+      .KernelHeight(kernel_rng())
+      .KernelWidth(kernel_rng())
+      .StrideHeight(stride_rng())
+      .StrideWidth(stride_rng());
+
+  // The background thread packs the weights w/o any invoke.
+  const std::vector<char> buffer = tester.CreateTfLiteModel();
+  std::unique_ptr<Interpreter> interpreter =
+      CreateDelegatedInterpreter(buffer, xnnpack_delegate.get());
+  ASSERT_NE(interpreter, nullptr);
+  WaitForWeightPacking(xnnpack_delegate->data_);
+  EXPECT_EQ(GetNumPackedPartitions(xnnpack_delegate->data_), 1);
+  ASSERT_EQ(interpreter->Invoke(), kTfLiteOk);
+  EXPECT_EQ(GetNumPackedPartitions(xnnpack_delegate->data_), 1);
+  interpreter.reset();
+
+  tester.Test(xnnpack_delegate.get());
+}
+
+TEST(Conv2D, SerializedWeights) {
+  const std::string serialization_dir = ::testing::TempDir();
+  TfLiteXNNPackDelegateOptions xnnpack_options =
+      TfLiteXNNPackDelegateOptionsDefault();
+  xnnpack_options.num_threads = 2;
+  xnnpack_options.serialization_dir = serialization_dir.c_str();
+  xnnpack_options.model_token = "Conv2DSerializedWeights";
+
+  std::random_device random_device;
+  auto rng = std::mt19937(random_device());
+  auto input_rng =
+      std::bind(std::uniform_int_distribution<int32_t>(10, 25), std::ref(rng));
+  auto channel_rng =
+      std::bind(std::uniform_int_distribution<int32_t>(2, 16), std::ref(rng));
+
+  // The tester generates new weights for every model, so the second delegate
+  // rejects the weights file packed by the first one and packs it again.
+  for (int i = 0; i < 2; i++) {
+    std::unique_ptr<TfLiteDelegate, decltype(&TfLiteXNNPackDelegateDelete)>
+        xnnpack_delegate(TfLiteXNNPackDelegateCreate(&xnnpack_options),
+                         TfLiteXNNPackDelegateDelete);
+    Conv2DTester()
+        .InputHeight(input_rng())
+        .InputWidth(input_rng())
+        .InputChannels(channel_rng())
+        .OutputChannels(channel_rng())
+        .KernelHeight(3)
+        .KernelWidth(3)
+        .Test(xnnpack_delegate.get());
+  }
+}
+
+TEST(Conv2D, SerializedWeightsWarmStart) {
+  const std::string serialization_dir = ::testing::TempDir();
+  TfLiteXNNPackDelegateOptions xnnpack_options =
+      TfLiteXNNPackDelegateOptionsDefault();
+  xnnpack_options.num_threads = 2;
+  xnnpack_options.serialization_dir = serialization_dir.c_str();
+  xnnpack_options.model_token = "Conv2DSerializedWeightsWarmStart";
+
+  std::random_device random_device;
+  auto rng = std::mt19937(random_device());
+  auto input_rng =
+      std::bind(std::uniform_int_distribution<int32_t>(10, 25), std::ref(rng));
+  auto channel_rng =
+      std::bind(std::uniform_int_distribution<int32_t>(2, 16), std::ref(rng));
+
+  const std::vector<char> buffer = Conv2DTester()
+                                       .InputHeight(input_rng())
+                                       .InputWidth(input_rng())
+                                       .InputChannels(channel_rng())
+                                       .OutputChannels(channel_rng())
+                                       .KernelHeight(3)
+                                       .KernelWidth(3)
+                                       .CreateTfLiteModel();
+
+  // The first delegate packs the weights into the file on its first invoke,
+  // the second one maps them from the file as it is applied, and could not
+  // pack any more weights into it.
+  std::vector<float> outputs[2];
+  for (int i = 0; i < 2; i++) {
+    std::unique_ptr<TfLiteDelegate, decltype(&TfLiteXNNPackDelegateDelete)>
+        xnnpack_delegate(TfLiteXNNPackDelegateCreate(&xnnpack_options),
+                         TfLiteXNNPackDelegateDelete);
+    std::unique_ptr<Interpreter> interpreter =
+        CreateDelegatedInterpreter(buffer, xnnpack_delegate.get());
+    ASSERT_NE(interpreter, nullptr);
+    EXPECT_EQ(IsWeightCacheMapped(xnnpack_delegate->data_), i == 1);
+
+    TfLiteTensor* input = interpreter->input_tensor(0);
+    std::fill(input->data.f, input->data.f + input->bytes / sizeof(float),
+              0.5f);
+    ASSERT_EQ(interpreter->Invoke(), kTfLiteOk);
+    EXPECT_TRUE(IsWeightCacheMapped(xnnpack_delegate->data_));
+    const TfLiteTensor* output = interpreter->output_tensor(0);
+    outputs[i].assign(output->data.f,
+                      output->data.f + output->bytes / sizeof(float));
+  }
+  EXPECT_EQ(outputs[0], outputs[1]);
+}
+
+TEST(Conv2D, SerializedWeightsOfRetrainedModel) {
+  const std::string serialization_dir = ::testing::TempDir();
+  TfLiteXNNPackDelegateOptions xnnpack_options =
+      TfLiteXNNPackDelegateOptionsDefault();
+  xnnpack_options.num_threads = 2;
+  xnnpack_options.serialization_dir = serialization_dir.c_str();
+  xnnpack_options.model_token = "Conv2DSerializedWeightsOfRetrainedModel";
+
+  const std::vector<char> buffer = Conv2DTester()
+                                       .InputHeight(10)
+                                       .InputWidth(10)
+                                       .InputChannels(16)
+                                       .OutputChannels(16)
+                                       .KernelHeight(3)
+                                       .KernelWidth(3)
+                                       .CreateTfLiteModel();
+  // The retrained model has the same layout, and its largest buffer, the
+  // filter, only changes in the middle.
+  std::vector<char> retrained_buffer = buffer;
+  const flatbuffers::Vector<uint8_t>* filter = nullptr;
+  for (const Buffer* model_buffer : *GetModel(buffer.data())->buffers()) {
+    if (model_buffer->data() != nullptr &&
+        (filter == nullptr || model_buffer->data()->size() > filter->size())) {
+      filter = model_buffer->data();
+    }
+  }
+  ASSERT_NE(filter, nullptr);
+  const size_t middle = reinterpret_cast<const char*>(filter->data()) -
+                        buffer.data() + filter->size() / 2;
+  retrained_buffer[middle] ^= 1;
+
+  // The first delegate packs the weights into the file on its first invoke.
+  // The second one must not map them, and packs its own weights again.
+  for (const std::vector<char>* model_buffer : {&buffer, &retrained_buffer}) {
+    std::unique_ptr<TfLiteDelegate, decltype(&TfLiteXNNPackDelegateDelete)>
+        xnnpack_delegate(TfLiteXNNPackDelegateCreate(&xnnpack_options),
+                         TfLiteXNNPackDelegateDelete);
+    std::unique_ptr<Interpreter> interpreter =
+        CreateDelegatedInterpreter(*model_buffer, xnnpack_delegate.get());
+    ASSERT_NE(interpreter, nullptr);
+    EXPECT_FALSE(IsWeightCacheMapped(xnnpack_delegate->data_));
+    ASSERT_EQ(interpreter->Invoke(), kTfLiteOk);
+  }
+}
+
 TEST(Conv2D, AdaptiveAvxOptimization) {
   TfLiteXNNPackDelegateOptions xnnpack_options =
       TfLiteXNNPackDelegateOptionsDefault();
@@ -62,5 +62,52 @@ TEST(Delegate, GetThreadPool) {
   ASSERT_EQ(2, pthreadpool_get_threads_count(threadpool));
 }
 
+TEST(Delegate, ShareExternalThreadPool) {
+  std::unique_ptr<pthreadpool, decltype(&pthreadpool_destroy)> threadpool(
+      pthreadpool_create(3), pthreadpool_destroy);
+  ASSERT_TRUE(threadpool);
+
+  TfLiteXNNPackDelegateOptions delegate_options =
+      TfLiteXNNPackDelegateOptionsDefault();
+  delegate_options.num_threads = 2;
+  delegate_options.threadpool = threadpool.get();
+  std::unique_ptr<TfLiteDelegate, decltype(&TfLiteXNNPackDelegateDelete)>
+      xnnpack_delegate1(TfLiteXNNPackDelegateCreate(&delegate_options),
+                        TfLiteXNNPackDelegateDelete);
+  std::unique_ptr<TfLiteDelegate, decltype(&TfLiteXNNPackDelegateDelete)>
+      xnnpack_delegate2(TfLiteXNNPackDelegateCreate(&delegate_options),
+                        TfLiteXNNPackDelegateDelete);
+
+  EXPECT_EQ(threadpool.get(),
+            TfLiteXNNPackDelegateGetThreadPool(xnnpack_delegate1.get()));
+  EXPECT_EQ(threadpool.get(),
+            TfLiteXNNPackDelegateGetThreadPool(xnnpack_delegate2.get()));
+
+  // The delegates must not destroy the shared threadpool.
+  xnnpack_delegate1.reset();
+  xnnpack_delegate2.reset();
+  EXPECT_EQ(3, pthreadpool_get_threads_count(threadpool.get()));
+}
+
+TEST(Delegate, ShareWorkspace) {
+  std::unique_ptr<TfLiteXNNPackDelegateWorkspace,
+                  decltype(&TfLiteXNNPackDelegateWorkspaceDelete)>
+      workspace(TfLiteXNNPackDelegateWorkspaceCreate(),
+                TfLiteXNNPackDelegateWorkspaceDelete);
+  ASSERT_TRUE(workspace);
+
+  TfLiteXNNPackDelegateOptions delegate_options =
+      TfLiteXNNPackDelegateOptionsDefault();
+  delegate_options.workspace = workspace.get();
+  std::unique_ptr<TfLiteDelegate, decltype(&TfLiteXNNPackDelegateDelete)>
+      xnnpack_delegate1(TfLiteXNNPackDelegateCreate(&delegate_options),
+                        TfLiteXNNPackDelegateDelete);
+  std::unique_ptr<TfLiteDelegate, decltype(&TfLiteXNNPackDelegateDelete)>
+      xnnpack_delegate2(TfLiteXNNPackDelegateCreate(&delegate_options),
+                        TfLiteXNNPackDelegateDelete);
+  EXPECT_TRUE(xnnpack_delegate1);
+  EXPECT_TRUE(xnnpack_delegate2);
+}
+
 }  // namespace xnnpack
 }  // namespace tflite
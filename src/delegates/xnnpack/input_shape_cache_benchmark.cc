@@ -0,0 +1,82 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+// Times invokes alternating the sequence length of the input between two
+// values, with XNNPACK runtimes reshaped for up to 'cached_shapes' input
+// shapes kept, e.g.
+//
+//   input_shape_cache_benchmark --benchmark_filter='seq_a:16/'
+//
+// 'cached_shapes:1' reshapes the runtime on every invoke.
+
+#include <memory>
+#include <vector>
+
+#include "benchmark/benchmark.h"  // from @com_google_benchmark
+#include "core/interpreter_builder.h"
+#include "core/kernels/register.h"
+#include "core/model_builder.h"
+#include "delegates/xnnpack/input_shape_cache_tester.h"
+#include "interpreter.h"
+#include "schema/schema_generated.h"
+
+namespace tflite {
+namespace xnnpack {
+namespace {
+
+// Alternates the sequence length of the input between state.range(0) and
+// state.range(1), keeping up to state.range(2) reshaped runtimes.
+void BM_AlternatingInputShapes(benchmark::State& state) {
+  const int sequence_lengths[2] = {static_cast<int>(state.range(0)),
+                                   static_cast<int>(state.range(1))};
+  const std::vector<char> buffer = CreateAddChainModel(sequence_lengths[0]);
+  std::unique_ptr<Interpreter> interpreter;
+  InterpreterBuilder(
+      GetModel(buffer.data()),
+      ::tflite::ops::builtin::BuiltinOpResolverWithoutDefaultDelegates())(
+      &interpreter);
+  auto xnnpack_delegate = CreateReshapingDelegate(state.range(2));
+  if (interpreter == nullptr ||
+      interpreter->ModifyGraphWithDelegate(xnnpack_delegate.get()) !=
+          kTfLiteOk) {
+    state.SkipWithError("Failed to apply the XNNPACK delegate");
+    return;
+  }
+
+  int i = 0;
+  for (auto _ : state) {
+    const int sequence_length = sequence_lengths[i++ % 2];
+    if (interpreter->ResizeInputTensor(interpreter->inputs()[0],
+                                       {1, sequence_length, kChannels}) !=
+            kTfLiteOk ||
+        interpreter->AllocateTensors() != kTfLiteOk ||
+        interpreter->Invoke() != kTfLiteOk) {
+      state.SkipWithError("Failed to run the model");
+      return;
+    }
+  }
+}
+
+BENCHMARK(BM_AlternatingInputShapes)
+    ->ArgNames({"seq_a", "seq_b", "cached_shapes"})
+    ->Args({16, 128, 1})
+    ->Args({16, 128, 2})
+    ->Args({64, 65, 1})
+    ->Args({64, 65, 2});
+
+}  // namespace
+}  // namespace xnnpack
+}  // namespace tflite
+
+BENCHMARK_MAIN();
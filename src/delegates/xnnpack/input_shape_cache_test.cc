@@ -0,0 +1,87 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "core/interpreter_builder.h"
+#include "core/kernels/register.h"
+#include "core/model_builder.h"
+#include "delegates/xnnpack/input_shape_cache_tester.h"
+#include "delegates/xnnpack/xnnpack_delegate.h"
+#include "interpreter.h"
+#include "schema/schema_generated.h"
+
+namespace tflite {
+namespace xnnpack {
+
+namespace {
+
+// Resizes the input to the sequence length, runs the model and checks the
+// output.
+void RunWithSequenceLength(Interpreter* interpreter, int sequence_length) {
+  ASSERT_EQ(interpreter->ResizeInputTensor(interpreter->inputs()[0],
+                                           {1, sequence_length, kChannels}),
+            kTfLiteOk);
+  ASSERT_EQ(interpreter->AllocateTensors(), kTfLiteOk);
+
+  float* input = interpreter->typed_input_tensor<float>(0);
+  const int size = sequence_length * kChannels;
+  for (int i = 0; i < size; i++) {
+    input[i] = static_cast<float>(i % 17);
+  }
+  ASSERT_EQ(interpreter->Invoke(), kTfLiteOk);
+
+  const TfLiteTensor* output = interpreter->output_tensor(0);
+  ASSERT_EQ(output->dims->size, 3);
+  ASSERT_EQ(output->dims->data[1], sequence_length);
+  const float* output_data = interpreter->typed_output_tensor<float>(0);
+  for (int i = 0; i < size; i++) {
+    ASSERT_EQ(output_data[i], static_cast<float>((i % 17) << kNumAdds))
+        << "at index " << i << " / " << size;
+  }
+}
+
+void TestAlternatingShapes(int max_cached_input_shapes) {
+  const std::vector<char> buffer = CreateAddChainModel(/*sequence_length=*/4);
+  const Model* model = GetModel(buffer.data());
+  std::unique_ptr<Interpreter> interpreter;
+  ASSERT_EQ(
+      InterpreterBuilder(
+          model,
+          ::tflite::ops::builtin::BuiltinOpResolverWithoutDefaultDelegates())(
+          &interpreter),
+      kTfLiteOk);
+  auto xnnpack_delegate = CreateReshapingDelegate(max_cached_input_shapes);
+  ASSERT_EQ(interpreter->ModifyGraphWithDelegate(xnnpack_delegate.get()),
+            kTfLiteOk);
+
+  for (int sequence_length : {4, 7, 4, 7, 12, 4, 12, 1, 7, 7, 4}) {
+    RunWithSequenceLength(interpreter.get(), sequence_length);
+  }
+}
+
+TEST(InputShapeCache, Disabled) { TestAlternatingShapes(0); }
+
+TEST(InputShapeCache, SmallerThanShapeCount) { TestAlternatingShapes(2); }
+
+TEST(InputShapeCache, LargerThanShapeCount) { TestAlternatingShapes(8); }
+
+}  // namespace
+
+}  // namespace xnnpack
+}  // namespace tflite
@@ -0,0 +1,94 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "delegates/xnnpack/input_shape_cache_tester.h"
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "flatbuffers/buffer.h"  // from @flatbuffers
+#include "flatbuffers/flatbuffer_builder.h"  // from @flatbuffers
+#include "flatbuffers/string.h"  // from @flatbuffers
+#include "delegates/xnnpack/xnnpack_delegate.h"
+#include "schema/schema_generated.h"
+#include "version.h"
+
+namespace tflite {
+namespace xnnpack {
+
+std::vector<char> CreateAddChainModel(int sequence_length) {
+  flatbuffers::FlatBufferBuilder builder;
+  const std::array<flatbuffers::Offset<OperatorCode>, 1> operator_codes{
+      {CreateOperatorCode(builder, BuiltinOperator_ADD)}};
+  const std::array<flatbuffers::Offset<Buffer>, 1> buffers{
+      {CreateBuffer(builder, builder.CreateVector({}))}};
+
+  const std::array<int32_t, 3> shape{{1, sequence_length, kChannels}};
+  std::vector<flatbuffers::Offset<Tensor>> tensors;
+  std::vector<flatbuffers::Offset<Operator>> operators;
+  for (int i = 0; i <= kNumAdds; i++) {
+    tensors.push_back(CreateTensor(
+        builder, builder.CreateVector<int32_t>(shape.data(), shape.size()),
+        TensorType_FLOAT32));
+    if (i != 0) {
+      const std::array<int32_t, 2> op_inputs{{i - 1, i - 1}};
+      const std::array<int32_t, 1> op_outputs{{i}};
+      operators.push_back(CreateOperator(
+          builder, /*opcode_index=*/0,
+          builder.CreateVector<int32_t>(op_inputs.data(), op_inputs.size()),
+          builder.CreateVector<int32_t>(op_outputs.data(), op_outputs.size()),
+          BuiltinOptions_AddOptions, CreateAddOptions(builder).Union()));
+    }
+  }
+
+  const std::array<int32_t, 1> subgraph_inputs{{0}};
+  const std::array<int32_t, 1> subgraph_outputs{{kNumAdds}};
+  flatbuffers::Offset<SubGraph> subgraph = CreateSubGraph(
+      builder, builder.CreateVector(tensors),
+      builder.CreateVector<int32_t>(subgraph_inputs.data(),
+                                    subgraph_inputs.size()),
+      builder.CreateVector<int32_t>(subgraph_outputs.data(),
+                                    subgraph_outputs.size()),
+      builder.CreateVector(operators));
+
+  flatbuffers::Offset<Model> model_buffer = CreateModel(
+      builder, TFLITE_SCHEMA_VERSION,
+      builder.CreateVector(operator_codes.data(), operator_codes.size()),
+      builder.CreateVector(&subgraph, 1),
+      builder.CreateString("Add chain model"),
+      builder.CreateVector(buffers.data(), buffers.size()));
+  builder.Finish(model_buffer);
+
+  return std::vector<char>(builder.GetBufferPointer(),
+                           builder.GetBufferPointer() + builder.GetSize());
+}
+
+std::unique_ptr<TfLiteDelegate, decltype(&TfLiteXNNPackDelegateDelete)>
+CreateReshapingDelegate(int max_cached_input_shapes) {
+  TfLiteXNNPackDelegateOptions xnnpack_options =
+      TfLiteXNNPackDelegateOptionsDefault();
+  xnnpack_options.flags |=
+      TFLITE_XNNPACK_DELEGATE_FLAG_ENABLE_SUBGRAPH_RESHAPING;
+  xnnpack_options.max_cached_input_shapes = max_cached_input_shapes;
+  return std::unique_ptr<TfLiteDelegate,
+                         decltype(&TfLiteXNNPackDelegateDelete)>(
+      TfLiteXNNPackDelegateCreate(&xnnpack_options),
+      TfLiteXNNPackDelegateDelete);
+}
+
+}  // namespace xnnpack
+}  // namespace tflite
@@ -0,0 +1,43 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_LITE_DELEGATES_XNNPACK_INPUT_SHAPE_CACHE_TESTER_H_
+#define TENSORFLOW_LITE_DELEGATES_XNNPACK_INPUT_SHAPE_CACHE_TESTER_H_
+
+#include <memory>
+#include <vector>
+
+#include "core/c/common.h"
+#include "delegates/xnnpack/xnnpack_delegate.h"
+
+namespace tflite {
+namespace xnnpack {
+
+constexpr int kNumAdds = 4;
+constexpr int kChannels = 64;
+
+// Creates a model doubling its [1, sequence_length, kChannels] input kNumAdds
+// times, which the XNNPACK delegate takes as a single partition.
+std::vector<char> CreateAddChainModel(int sequence_length);
+
+// Creates an XNNPACK delegate that reshapes its runtimes on input resizes,
+// keeping up to 'max_cached_input_shapes' of them.
+std::unique_ptr<TfLiteDelegate, decltype(&TfLiteXNNPackDelegateDelete)>
+CreateReshapingDelegate(int max_cached_input_shapes);
+
+}  // namespace xnnpack
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_DELEGATES_XNNPACK_INPUT_SHAPE_CACHE_TESTER_H_
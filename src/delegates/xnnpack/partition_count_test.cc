@@ -0,0 +1,484 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "flatbuffers/buffer.h"  // from @flatbuffers
+#include "flatbuffers/flatbuffer_builder.h"  // from @flatbuffers
+#include "flatbuffers/string.h"  // from @flatbuffers
+#include "core/interpreter_builder.h"
+#include "core/kernels/register.h"
+#include "core/model_builder.h"
+#include "delegates/xnnpack/xnnpack_delegate.h"
+#include "interpreter.h"
+#include "schema/schema_generated.h"
+#include "version.h"
+
+namespace tflite {
+namespace xnnpack {
+
+namespace {
+
+struct PartitionCount {
+  // Number of XNNPACK delegate kernels in the execution plan.
+  int delegated = 0;
+  // Number of nodes left to the TFLite kernels.
+  int not_delegated = 0;
+};
+
+PartitionCount CountPartitions(const Interpreter& interpreter) {
+  PartitionCount count;
+  for (int node_index : interpreter.execution_plan()) {
+    const TfLiteRegistration& registration =
+        interpreter.node_and_registration(node_index)->second;
+    if (registration.builtin_code == kTfLiteBuiltinDelegate) {
+      count.delegated++;
+    } else {
+      count.not_delegated++;
+    }
+  }
+  return count;
+}
+
+struct SandwichedOp {
+  BuiltinOperator op;
+  std::vector<int32_t> input_shape;
+  // Number of times the op reads the output of the leading ADD.
+  int num_inputs = 1;
+  // Contents of a static INT32 second input (multiples, shape, size), if any.
+  std::vector<int32_t> static_input;
+  std::vector<std::vector<int32_t>> output_shapes;
+  BuiltinOptions options_type = BuiltinOptions_NONE;
+  std::function<flatbuffers::Offset<void>(flatbuffers::FlatBufferBuilder&)>
+      options;
+};
+
+// Builds the graph ADD -> op -> ADD. The leading ADD doubles the model input
+// and feeds the op under test; the trailing ADD sums the first and the last
+// output of the op. ADD is always delegated, so the op under test alone
+// decides whether the graph is a single XNNPACK partition or is split in
+// three.
+std::vector<char> CreateSandwichModel(const SandwichedOp& sandwiched) {
+  flatbuffers::FlatBufferBuilder builder;
+  const std::array<flatbuffers::Offset<OperatorCode>, 2> operator_codes{
+      {CreateOperatorCode(builder, BuiltinOperator_ADD),
+       CreateOperatorCode(builder, sandwiched.op)}};
+
+  std::vector<flatbuffers::Offset<Buffer>> buffers{
+      CreateBuffer(builder, builder.CreateVector({}))};
+  if (!sandwiched.static_input.empty()) {
+    buffers.push_back(CreateBuffer(
+        builder, builder.CreateVector(reinterpret_cast<const uint8_t*>(
+                                          sandwiched.static_input.data()),
+                                      sizeof(int32_t) *
+                                          sandwiched.static_input.size())));
+  }
+
+  std::vector<flatbuffers::Offset<Tensor>> tensors;
+  const int32_t input_id = tensors.size();
+  tensors.push_back(CreateTensor(
+      builder, builder.CreateVector<int32_t>(sandwiched.input_shape),
+      TensorType_FLOAT32));
+  const int32_t doubled_id = tensors.size();
+  tensors.push_back(CreateTensor(
+      builder, builder.CreateVector<int32_t>(sandwiched.input_shape),
+      TensorType_FLOAT32));
+  std::vector<int32_t> op_inputs(sandwiched.num_inputs, doubled_id);
+  if (!sandwiched.static_input.empty()) {
+    op_inputs.push_back(tensors.size());
+    tensors.push_back(CreateTensor(
+        builder,
+        builder.CreateVector<int32_t>(
+            {static_cast<int32_t>(sandwiched.static_input.size())}),
+        TensorType_INT32, /*buffer=*/1));
+  }
+  std::vector<int32_t> op_outputs;
+  for (const std::vector<int32_t>& output_shape : sandwiched.output_shapes) {
+    op_outputs.push_back(tensors.size());
+    tensors.push_back(CreateTensor(
+        builder, builder.CreateVector<int32_t>(output_shape),
+        TensorType_FLOAT32));
+  }
+  const int32_t output_id = tensors.size();
+  tensors.push_back(CreateTensor(
+      builder, builder.CreateVector<int32_t>(sandwiched.output_shapes.front()),
+      TensorType_FLOAT32));
+
+  const std::array<int32_t, 2> head_inputs{{input_id, input_id}};
+  const std::array<int32_t, 1> head_outputs{{doubled_id}};
+  const std::array<int32_t, 2> tail_inputs{
+      {op_outputs.front(), op_outputs.back()}};
+  const std::array<int32_t, 1> tail_outputs{{output_id}};
+  const std::array<flatbuffers::Offset<Operator>, 3> operators{{
+      CreateOperator(
+          builder, /*opcode_index=*/0,
+          builder.CreateVector<int32_t>(head_inputs.data(),
+                                        head_inputs.size()),
+          builder.CreateVector<int32_t>(head_outputs.data(),
+                                        head_outputs.size()),
+          BuiltinOptions_AddOptions, CreateAddOptions(builder).Union()),
+      CreateOperator(builder, /*opcode_index=*/1,
+                     builder.CreateVector<int32_t>(op_inputs),
+                     builder.CreateVector<int32_t>(op_outputs),
+                     sandwiched.options_type,
+                     sandwiched.options ? sandwiched.options(builder) : 0),
+      CreateOperator(
+          builder, /*opcode_index=*/0,
+          builder.CreateVector<int32_t>(tail_inputs.data(),
+                                        tail_inputs.size()),
+          builder.CreateVector<int32_t>(tail_outputs.data(),
+                                        tail_outputs.size()),
+          BuiltinOptions_AddOptions, CreateAddOptions(builder).Union()),
+  }};
+
+  const std::array<int32_t, 1> subgraph_inputs{{input_id}};
+  const std::array<int32_t, 1> subgraph_outputs{{output_id}};
+  flatbuffers::Offset<SubGraph> subgraph = CreateSubGraph(
+      builder, builder.CreateVector(tensors),
+      builder.CreateVector<int32_t>(subgraph_inputs.data(),
+                                    subgraph_inputs.size()),
+      builder.CreateVector<int32_t>(subgraph_outputs.data(),
+                                    subgraph_outputs.size()),
+      builder.CreateVector(operators.data(), operators.size()));
+
+  flatbuffers::Offset<Model> model_buffer = CreateModel(
+      builder, TFLITE_SCHEMA_VERSION,
+      builder.CreateVector(operator_codes.data(), operator_codes.size()),
+      builder.CreateVector(&subgraph, 1),
+      builder.CreateString("Partition count model"),
+      builder.CreateVector(buffers));
+  builder.Finish(model_buffer);
+
+  return std::vector<char>(builder.GetBufferPointer(),
+                           builder.GetBufferPointer() + builder.GetSize());
+}
+
+// Checks that the graph w/ the sandwiched op is split into the expected
+// partitions by a delegate w/ 'xnnpack_options', or the default ones if null,
+// and that the delegated graph computes the same result as the TFLite
+// kernels.
+void TestPartitions(
+    const SandwichedOp& sandwiched, int expected_delegated,
+    int expected_not_delegated,
+    const TfLiteXNNPackDelegateOptions* xnnpack_options = nullptr) {
+  std::unique_ptr<TfLiteDelegate, decltype(&TfLiteXNNPackDelegateDelete)>
+      xnnpack_delegate(TfLiteXNNPackDelegateCreate(xnnpack_options),
+                       TfLiteXNNPackDelegateDelete);
+
+  const std::vector<char> buffer = CreateSandwichModel(sandwiched);
+  const Model* model = GetModel(buffer.data());
+
+  std::unique_ptr<Interpreter> delegate_interpreter;
+  ASSERT_EQ(
+      InterpreterBuilder(
+          model,
+          ::tflite::ops::builtin::BuiltinOpResolverWithoutDefaultDelegates())(
+          &delegate_interpreter),
+      kTfLiteOk);
+  std::unique_ptr<Interpreter> default_interpreter;
+  ASSERT_EQ(
+      InterpreterBuilder(
+          model,
+          ::tflite::ops::builtin::BuiltinOpResolverWithoutDefaultDelegates())(
+          &default_interpreter),
+      kTfLiteOk);
+
+  ASSERT_EQ(delegate_interpreter->AllocateTensors(), kTfLiteOk);
+  ASSERT_EQ(default_interpreter->AllocateTensors(), kTfLiteOk);
+  ASSERT_EQ(delegate_interpreter->ModifyGraphWithDelegate(
+                xnnpack_delegate.get()),
+            kTfLiteOk);
+
+  const PartitionCount count = CountPartitions(*delegate_interpreter);
+  EXPECT_EQ(count.delegated, expected_delegated)
+      << EnumNameBuiltinOperator(sandwiched.op);
+  EXPECT_EQ(count.not_delegated, expected_not_delegated)
+      << EnumNameBuiltinOperator(sandwiched.op);
+
+  std::random_device random_device;
+  auto rng = std::mt19937(random_device());
+  auto input_rng = std::bind(
+      std::uniform_real_distribution<float>(-5.0f, 5.0f), std::ref(rng));
+  const TfLiteTensor* input_tensor = default_interpreter->input_tensor(0);
+  const int input_size = input_tensor->bytes / sizeof(float);
+  float* default_input_data = default_interpreter->typed_input_tensor<float>(0);
+  std::generate_n(default_input_data, input_size, std::ref(input_rng));
+  std::copy_n(default_input_data, input_size,
+              delegate_interpreter->typed_input_tensor<float>(0));
+
+  ASSERT_EQ(default_interpreter->Invoke(), kTfLiteOk);
+  ASSERT_EQ(delegate_interpreter->Invoke(), kTfLiteOk);
+
+  const TfLiteTensor* output_tensor = default_interpreter->output_tensor(0);
+  const int output_size = output_tensor->bytes / sizeof(float);
+  const float* default_output_data =
+      default_interpreter->typed_output_tensor<float>(0);
+  const float* delegate_output_data =
+      delegate_interpreter->typed_output_tensor<float>(0);
+  for (int i = 0; i < output_size; i++) {
+    ASSERT_NEAR(default_output_data[i], delegate_output_data[i],
+                1.0e-5f * std::max(std::abs(default_output_data[i]), 1.0f))
+        << "element " << i << " / " << output_size;
+  }
+}
+
+// Checks that the sandwiched op is delegated together with its neighbours.
+void TestSinglePartition(const SandwichedOp& sandwiched) {
+  TestPartitions(sandwiched, /*expected_delegated=*/1,
+                 /*expected_not_delegated=*/0);
+}
+
+}  // namespace
+
+TEST(PartitionCount, TestdataModels) {
+  struct {
+    const char* path;
+    int delegated;
+    int not_delegated;
+  } const kExpectedPartitions[] = {
+      {"testdata/add.bin", 1, 0},
+      {"testdata/add_shared_tensors.bin", 1, 0},
+      {"testdata/multi_add.bin", 1, 0},
+      {"testdata/sub.bin", 1, 0},
+  };
+
+  for (const auto& expected : kExpectedPartitions) {
+    std::unique_ptr<TfLiteDelegate, decltype(&TfLiteXNNPackDelegateDelete)>
+        xnnpack_delegate(TfLiteXNNPackDelegateCreate(nullptr),
+                         TfLiteXNNPackDelegateDelete);
+
+    auto model = FlatBufferModel::BuildFromFile(expected.path);
+    ASSERT_TRUE(model) << expected.path;
+
+    std::unique_ptr<Interpreter> interpreter;
+    ASSERT_EQ(
+        InterpreterBuilder(
+            *model,
+            ::tflite::ops::builtin::BuiltinOpResolverWithoutDefaultDelegates())(
+            &interpreter),
+        kTfLiteOk);
+    ASSERT_EQ(interpreter->AllocateTensors(), kTfLiteOk);
+    ASSERT_EQ(interpreter->ModifyGraphWithDelegate(xnnpack_delegate.get()),
+              kTfLiteOk);
+
+    const PartitionCount count = CountPartitions(*interpreter);
+    EXPECT_EQ(count.delegated, expected.delegated) << expected.path;
+    EXPECT_EQ(count.not_delegated, expected.not_delegated) << expected.path;
+  }
+}
+
+TEST(PartitionCount, BroadcastTo) {
+  SandwichedOp sandwiched;
+  sandwiched.op = BuiltinOperator_BROADCAST_TO;
+  sandwiched.input_shape = {1, 3};
+  sandwiched.static_input = {2, 4, 3};
+  sandwiched.output_shapes = {{2, 4, 3}};
+  sandwiched.options_type = BuiltinOptions_BroadcastToOptions;
+  sandwiched.options = [](flatbuffers::FlatBufferBuilder& builder) {
+    return CreateBroadcastToOptions(builder).Union();
+  };
+  TestSinglePartition(sandwiched);
+}
+
+TEST(PartitionCount, BroadcastToUnsupportedFactor) {
+  SandwichedOp sandwiched;
+  sandwiched.op = BuiltinOperator_BROADCAST_TO;
+  sandwiched.input_shape = {1, 3};
+  // 7 isn't a product of 2, 3 and 5, so the op is left to TFLite and splits
+  // the ADDs into two partitions.
+  sandwiched.static_input = {7, 3};
+  sandwiched.output_shapes = {{7, 3}};
+  sandwiched.options_type = BuiltinOptions_BroadcastToOptions;
+  sandwiched.options = [](flatbuffers::FlatBufferBuilder& builder) {
+    return CreateBroadcastToOptions(builder).Union();
+  };
+  TestPartitions(sandwiched, /*expected_delegated=*/2,
+                 /*expected_not_delegated=*/1);
+}
+
+TEST(PartitionCount, Gelu) {
+  SandwichedOp sandwiched;
+  sandwiched.op = BuiltinOperator_GELU;
+  sandwiched.input_shape = {2, 3, 5};
+  sandwiched.output_shapes = {{2, 3, 5}};
+  sandwiched.options_type = BuiltinOptions_GeluOptions;
+  sandwiched.options = [](flatbuffers::FlatBufferBuilder& builder) {
+    return CreateGeluOptions(builder, /*approximate=*/true).Union();
+  };
+  TestSinglePartition(sandwiched);
+}
+
+TEST(PartitionCount, ExactGelu) {
+  SandwichedOp sandwiched;
+  sandwiched.op = BuiltinOperator_GELU;
+  sandwiched.input_shape = {2, 3, 5};
+  sandwiched.output_shapes = {{2, 3, 5}};
+  sandwiched.options_type = BuiltinOptions_GeluOptions;
+  // Only the tanh approximation is delegated.
+  sandwiched.options = [](flatbuffers::FlatBufferBuilder& builder) {
+    return CreateGeluOptions(builder, /*approximate=*/false).Union();
+  };
+  TestPartitions(sandwiched, /*expected_delegated=*/2,
+                 /*expected_not_delegated=*/1);
+}
+
+TEST(PartitionCount, Pack) {
+  SandwichedOp sandwiched;
+  sandwiched.op = BuiltinOperator_PACK;
+  sandwiched.input_shape = {2, 3};
+  sandwiched.num_inputs = 3;
+  sandwiched.output_shapes = {{2, 3, 3}};
+  sandwiched.options_type = BuiltinOptions_PackOptions;
+  sandwiched.options = [](flatbuffers::FlatBufferBuilder& builder) {
+    return CreatePackOptions(builder, /*values_count=*/3, /*axis=*/1)
+        .Union();
+  };
+  TestSinglePartition(sandwiched);
+}
+
+TEST(PartitionCount, ResizeNearestNeighbor) {
+  SandwichedOp sandwiched;
+  sandwiched.op = BuiltinOperator_RESIZE_NEAREST_NEIGHBOR;
+  sandwiched.input_shape = {1, 3, 4, 2};
+  sandwiched.static_input = {6, 8};
+  sandwiched.output_shapes = {{1, 6, 8, 2}};
+  sandwiched.options_type = BuiltinOptions_ResizeNearestNeighborOptions;
+  sandwiched.options = [](flatbuffers::FlatBufferBuilder& builder) {
+    return CreateResizeNearestNeighborOptions(builder,
+                                              /*align_corners=*/false,
+                                              /*half_pixel_centers=*/true)
+        .Union();
+  };
+  TestSinglePartition(sandwiched);
+}
+
+TEST(PartitionCount, Tile) {
+  SandwichedOp sandwiched;
+  sandwiched.op = BuiltinOperator_TILE;
+  sandwiched.input_shape = {2, 3};
+  sandwiched.static_input = {2, 6};
+  sandwiched.output_shapes = {{4, 18}};
+  sandwiched.options_type = BuiltinOptions_TileOptions;
+  sandwiched.options = [](flatbuffers::FlatBufferBuilder& builder) {
+    return CreateTileOptions(builder).Union();
+  };
+  TestSinglePartition(sandwiched);
+}
+
+TEST(PartitionCount, Unpack) {
+  SandwichedOp sandwiched;
+  sandwiched.op = BuiltinOperator_UNPACK;
+  sandwiched.input_shape = {3, 2, 4};
+  sandwiched.output_shapes = {{3, 4}, {3, 4}};
+  sandwiched.options_type = BuiltinOptions_UnpackOptions;
+  sandwiched.options = [](flatbuffers::FlatBufferBuilder& builder) {
+    return CreateUnpackOptions(builder, /*num=*/2, /*axis=*/1).Union();
+  };
+  TestSinglePartition(sandwiched);
+}
+
+TEST(PartitionCount, CostModelRejectsSmallPartitions) {
+  // Each delegated ADD element saves 1ns, and each partition costs 100ns.
+  const std::string cost_table_path =
+      ::testing::TempDir() + "/partition_count_cost_table.csv";
+  {
+    std::ofstream cost_table(cost_table_path);
+    cost_table << "ADD,2,1\nBOUNDARY,100,0\n";
+    ASSERT_TRUE(cost_table.good());
+  }
+  TfLiteXNNPackDelegateOptions xnnpack_options =
+      TfLiteXNNPackDelegateOptionsDefault();
+  xnnpack_options.flags |= TFLITE_XNNPACK_DELEGATE_FLAG_COST_MODEL_PARTITIONING;
+  xnnpack_options.partition_cost_table = cost_table_path.c_str();
+
+  // The exact GELU isn't delegated, so each ADD is a partition of its own.
+  SandwichedOp sandwiched;
+  sandwiched.op = BuiltinOperator_GELU;
+  sandwiched.options_type = BuiltinOptions_GeluOptions;
+  sandwiched.options = [](flatbuffers::FlatBufferBuilder& builder) {
+    return CreateGeluOptions(builder, /*approximate=*/false).Union();
+  };
+
+  // 16 elements don't pay for the partition overhead.
+  sandwiched.input_shape = {2, 8};
+  sandwiched.output_shapes = {{2, 8}};
+  TestPartitions(sandwiched, /*expected_delegated=*/0,
+                 /*expected_not_delegated=*/3, &xnnpack_options);
+  TestPartitions(sandwiched, /*expected_delegated=*/2,
+                 /*expected_not_delegated=*/1);
+
+  // 1024 elements do.
+  sandwiched.input_shape = {4, 256};
+  sandwiched.output_shapes = {{4, 256}};
+  TestPartitions(sandwiched, /*expected_delegated=*/2,
+                 /*expected_not_delegated=*/1, &xnnpack_options);
+}
+
+TEST(PartitionCount, MixedPrecisionSplitsSensitiveOps) {
+  TfLiteXNNPackDelegateOptions xnnpack_options =
+      TfLiteXNNPackDelegateOptionsDefault();
+  xnnpack_options.flags |= TFLITE_XNNPACK_DELEGATE_FLAG_MIXED_PRECISION_FP16;
+  std::unique_ptr<TfLiteDelegate, decltype(&TfLiteXNNPackDelegateDelete)>
+      xnnpack_delegate(TfLiteXNNPackDelegateCreate(&xnnpack_options),
+                       TfLiteXNNPackDelegateDelete);
+
+  SandwichedOp sandwiched;
+  sandwiched.op = BuiltinOperator_SOFTMAX;
+  sandwiched.input_shape = {2, 8};
+  sandwiched.output_shapes = {{2, 8}};
+  sandwiched.options_type = BuiltinOptions_SoftmaxOptions;
+  sandwiched.options = [](flatbuffers::FlatBufferBuilder& builder) {
+    return CreateSoftmaxOptions(builder, /*beta=*/1.0f).Union();
+  };
+  const std::vector<char> buffer = CreateSandwichModel(sandwiched);
+
+  std::unique_ptr<Interpreter> interpreter;
+  ASSERT_EQ(
+      InterpreterBuilder(
+          GetModel(buffer.data()),
+          ::tflite::ops::builtin::BuiltinOpResolverWithoutDefaultDelegates())(
+          &interpreter),
+      kTfLiteOk);
+  ASSERT_EQ(interpreter->AllocateTensors(), kTfLiteOk);
+  ASSERT_EQ(interpreter->ModifyGraphWithDelegate(xnnpack_delegate.get()),
+            kTfLiteOk);
+
+  // The FP16 ADDs and the FP32 SOFTMAX are delegated as separate partitions.
+  const PartitionCount count = CountPartitions(*interpreter);
+  EXPECT_EQ(count.delegated, 3);
+  EXPECT_EQ(count.not_delegated, 0);
+
+  std::fill_n(interpreter->typed_input_tensor<float>(0), 2 * 8, 0.5f);
+  ASSERT_EQ(interpreter->Invoke(), kTfLiteOk);
+  // Every row of the softmax of a constant sums to one, so the trailing ADD
+  // doubles 1 / 8.
+  const float* output_data = interpreter->typed_output_tensor<float>(0);
+  for (int i = 0; i < 2 * 8; i++) {
+    EXPECT_NEAR(output_data[i], 0.25f, 1.0e-3f) << "element " << i;
+  }
+}
+
+}  // namespace xnnpack
+}  // namespace tflite
@@ -19,22 +19,28 @@ limitations under the License.
 
 #if defined(_MSC_VER)
 #include <io.h>
+#include <process.h>
 #define F_OK 0
+#define getpid _getpid
 #else
+#include <sys/file.h>
 #include <sys/mman.h>
 #include <unistd.h>
 #endif
 
 #include <algorithm>
 #include <cerrno>
+#include <cinttypes>
 #include <cstddef>
 #include <cstdint>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 
 #include "tfl-xnnpack.h"  // from @XNNPACK
@@ -83,8 +89,133 @@ bool FileExists(const char* path) {
   return access(path, F_OK) != -1;
 }
 
+// Paths locked by this process with a `FileLock`.
+//
+// `flock` locks belong to open file descriptions: a second lock on the same
+// file from this process would wait for the first one forever.
+struct LockedPaths {
+  std::mutex mutex;
+  std::unordered_set<std::string> paths;
+};
+
+LockedPaths& GetLockedPaths() {
+  static auto* locked_paths = new LockedPaths;
+  return *locked_paths;
+}
+
 }  // namespace
 
+uint64_t WeightCacheChecksum(const void* data, size_t size) {
+  // FNV-1a, consuming 8 bytes per step to keep up with the disk bandwidth.
+  constexpr uint64_t kPrime = 0x100000001b3;
+  const uint8_t* bytes = static_cast<const uint8_t*>(data);
+  uint64_t checksum = 0xcbf29ce484222325;
+  size_t i = 0;
+  for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+    uint64_t word;
+    std::memcpy(&word, bytes + i, sizeof(word));
+    checksum = (checksum ^ word) * kPrime;
+  }
+  for (; i < size; ++i) {
+    checksum = (checksum ^ bytes[i]) * kPrime;
+  }
+  return checksum;
+}
+
+void swap(FileLock& a, FileLock& b) {
+  using std::swap;
+  swap(a.fd_, b.fd_);
+  swap(a.path_, b.path_);
+}
+
+FileLock::~FileLock() { Unlock(); }
+
+FileLock::FileLock(FileLock&& other) { swap(*this, other); }
+
+FileLock& FileLock::operator=(FileLock&& other) {
+  swap(*this, other);
+  return *this;
+}
+
+bool FileLock::Lock(const char* path) {
+  Unlock();
+#if defined(_MSC_VER)
+  // Advisory file locks are not available. Concurrent builders still never
+  // see partial files because cache files are renamed into place.
+  return false;
+#else
+  LockedPaths& locked_paths = GetLockedPaths();
+  {
+    std::lock_guard<std::mutex> guard(locked_paths.mutex);
+    if (!locked_paths.paths.insert(path).second) {
+      return false;
+    }
+  }
+  const auto unregister_path = [&] {
+    std::lock_guard<std::mutex> guard(locked_paths.mutex);
+    locked_paths.paths.erase(path);
+  };
+
+  while (true) {
+    const int fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd == -1) {
+      TFLITE_LOG_PROD(tflite::TFLITE_LOG_WARNING,
+                      "XNNPack weight cache: could not open lock file ('%s'): "
+                      "%s.",
+                      path, strerror(errno));
+      unregister_path();
+      return false;
+    }
+    while (flock(fd, LOCK_EX) == -1) {
+      if (errno != EINTR) {
+        TFLITE_LOG_PROD(tflite::TFLITE_LOG_WARNING,
+                        "XNNPack weight cache: could not lock file ('%s'): "
+                        "%s.",
+                        path, strerror(errno));
+        close(fd);
+        unregister_path();
+        return false;
+      }
+    }
+    // The previous owner may have removed the file while we were waiting, in
+    // which case the lock is held on a file other processes can't see.
+    struct stat locked_stat;
+    struct stat path_stat;
+    if (fstat(fd, &locked_stat) == 0 && stat(path, &path_stat) == 0 &&
+        locked_stat.st_dev == path_stat.st_dev &&
+        locked_stat.st_ino == path_stat.st_ino) {
+      fd_ = fd;
+      path_ = path;
+      return true;
+    }
+    close(fd);
+  }
+#endif
+}
+
+void FileLock::RemoveAndUnlock() {
+  if (fd_ >= 0) {
+#if !defined(_MSC_VER)
+    unlink(path_.c_str());
+#endif
+    Unlock();
+  }
+}
+
+void FileLock::Unlock() {
+  if (fd_ >= 0) {
+#if !defined(_MSC_VER)
+    flock(fd_, LOCK_UN);
+    LockedPaths& locked_paths = GetLockedPaths();
+    std::lock_guard<std::mutex> guard(locked_paths.mutex);
+    locked_paths.paths.erase(path_);
+#endif
+    close(fd_);
+    fd_ = -1;
+    path_.clear();
+  }
+}
+
 void swap(MMapHandle& a, MMapHandle& b) {
   using std::swap;
   swap(a.size_, b.size_);
@@ -228,6 +359,7 @@ bool WriteData(const int fd, const uint8_t* data, size_t size,
           tflite::TFLITE_LOG_ERROR,
           "XNNPack weight cache: file write incomplete (%s). %s: %s.",
           file_path, step_description, strerror(errno))
+      return false;
     }
     bytes += written_bytes;
   }
@@ -238,13 +370,17 @@ bool WriteData(const int fd, const uint8_t* data, size_t size,
 }  // namespace
 
 bool WeightCacheBuilder::Write(const char* path) {
-  const int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  // Other processes may be mapping the cache file: build it under a temporary
+  // name and atomically rename it once complete.
+  const std::string tmp_path =
+      std::string(path) + ".tmp" + std::to_string(getpid());
+  int fd = open(tmp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
   if (fd == -1) {
     TFLITE_LOG_PROD(
         tflite::TFLITE_LOG_ERROR,
         "XNNPack weight cache: could not open cache file ('%s') for "
         "writing: %s.",
-        path, strerror(errno))
+        tmp_path.c_str(), strerror(errno))
     return false;
   }
 
@@ -253,12 +389,17 @@ bool WeightCacheBuilder::Write(const char* path) {
       close(fd);
     }
   });
+  ScopeGuard remove_tmp_file_on_error(
+      [&tmp_path] { std::remove(tmp_path.c_str()); });
 
   flatbuffers::FlatBufferBuilder builder;
   // Add a fake size and the base offset to mutate them afterwards. Otherwise
   // space for it won't be added to the flatbuffer.
   schema_.flatbuffer_size = 1;
   schema_.base_offset = 1;
+  schema_.version = kWeightCacheVersion;
+  schema_.data_checksum =
+      WeightCacheChecksum(buffer_data_.data(), buffer_data_.size());
   FinishPackedWeightsBuffer(
       builder, cache::schema::PackedWeights::Pack(builder, &schema_));
 
@@ -273,21 +414,36 @@ bool WeightCacheBuilder::Write(const char* path) {
 
   // Write the flatbuffer which serves as a header to index the following
   // data.
-  if (!WriteData(fd, builder.GetBufferPointer(), builder.GetSize(), path,
-                 "Header")) {
+  if (!WriteData(fd, builder.GetBufferPointer(), builder.GetSize(),
+                 tmp_path.c_str(), "Header")) {
     return false;
   }
   // Add some padding so that the cache file can be mmaped and the buffers
   // stay aligned correctly.
   const uint8_t fill[kMinAlignment] = {0};
-  if (!WriteData(fd, fill, alignment_offset, path, "Alignment padding")) {
+  if (!WriteData(fd, fill, alignment_offset, tmp_path.c_str(),
+                 "Alignment padding")) {
     return false;
   }
   // Write the actual buffer data.
-  if (!WriteData(fd, buffer_data_.data(), buffer_data_.size(), path,
-                 "Buffer data")) {
+  if (!WriteData(fd, buffer_data_.data(), buffer_data_.size(),
+                 tmp_path.c_str(), "Buffer data")) {
     return false;
   }
+  close(fd);
+  fd = -1;
+
+#if defined(_MSC_VER)
+  // `rename` doesn't replace existing files on Windows.
+  std::remove(path);
+#endif
+  if (std::rename(tmp_path.c_str(), path) != 0) {
+    TFLITE_LOG_PROD(tflite::TFLITE_LOG_ERROR,
+                    "XNNPack weight cache: could not rename '%s' to '%s': %s.",
+                    tmp_path.c_str(), path, strerror(errno))
+    return false;
+  }
+  remove_tmp_file_on_error.Deactivate();
   TFLITE_LOG_PROD(tflite::TFLITE_LOG_INFO,
                   "XNNPack weight cache: written to '%s'.", path);
   return true;
@@ -311,6 +467,9 @@ MMapWeightCacheProvider& MMapWeightCacheProvider::operator=(
   swap(mmap_handle_, other.mmap_handle_);
   swap(mmap_buffer_base_offset_, other.mmap_buffer_base_offset_);
   swap(builder_, other.builder_);
+  swap(model_fingerprint_, other.model_fingerprint_);
+  swap(verify_checksum_on_load_, other.verify_checksum_on_load_);
+  swap(build_lock_, other.build_lock_);
   return *this;
 }
 
@@ -325,6 +484,14 @@ void MMapWeightCacheProvider::SetFilePath(const char* path) {
   }
 }
 
+void MMapWeightCacheProvider::SetModelFingerprint(uint64_t fingerprint) {
+  XNNPACK_ABORT_CHECK(!IsFinalized(),
+                      "Cannot change the model fingerprint of a cache that "
+                      "has already been loaded.");
+  model_fingerprint_ = fingerprint;
+  builder_.SetModelFingerprint(fingerprint);
+}
+
 bool MMapWeightCacheProvider::Load(const std::string& path) {
   SetFilePath(path.c_str());
   return Load();
@@ -333,19 +500,40 @@ bool MMapWeightCacheProvider::Load(const std::string& path) {
 bool MMapWeightCacheProvider::Load() {
   XNNPACK_ABORT_CHECK(!file_path_.empty(),
                       "Path wasn't provided to weight cache provider.");
-  mmap_buffer_base_offset_ = 0;
-  cache_key_to_offset_.clear();
-
+  if (FileExists(file_path_.c_str()) && LoadFile(verify_checksum_on_load_)) {
+    return true;
+  }
+  // The file is missing or stale. If another process is building it, wait
+  // until it is done and try again. Otherwise keep the lock: the caller is
+  // expected to build the cache and other processes will wait for it.
+  if (!build_lock_.IsLocked() && build_lock_.Lock(GetLockFilePath().c_str())) {
+    if (FileExists(file_path_.c_str()) && LoadFile(verify_checksum_on_load_)) {
+      build_lock_.RemoveAndUnlock();
+      return true;
+    }
+  }
   if (!FileExists(file_path_.c_str())) {
     TFLITE_LOG_PROD(tflite::TFLITE_LOG_WARNING,
                     "XNNPack weight cache: could not load '%s': %s.",
                     file_path_.c_str(), strerror(errno));
-    return false;
   }
+  return false;
+}
+
+bool MMapWeightCacheProvider::LoadFile(const bool verify_checksum) {
+  mmap_buffer_base_offset_ = 0;
+  cache_key_to_offset_.clear();
 
   if (!mmap_handle_.Map(file_path_.c_str())) {
     return false;
   }
+  // A rejected file must not be left mapped: this would mark the cache as
+  // finalized.
+  ScopeGuard unmap_on_error([this] {
+    mmap_handle_.UnMap();
+    cache_key_to_offset_.clear();
+    mmap_buffer_base_offset_ = 0;
+  });
 
   // Verifiy the flabuffer part of the file.
   const size_t verifier_size =
@@ -367,6 +555,34 @@ bool MMapWeightCacheProvider::Load() {
         "XNNPack weight cache: could not get packed weights from flatbuffer.");
     return false;
   }
+  if (packed_weights->version() != kWeightCacheVersion) {
+    TFLITE_LOG_PROD(tflite::TFLITE_LOG_WARNING,
+                    "XNNPack weight cache: '%s' has version %" PRIu64
+                    " instead of %" PRIu64 ", it will be rebuilt.",
+                    file_path_.c_str(), packed_weights->version(),
+                    kWeightCacheVersion);
+    return false;
+  }
+  if (model_fingerprint_ != 0 &&
+      packed_weights->model_fingerprint() != model_fingerprint_) {
+    TFLITE_LOG_PROD(tflite::TFLITE_LOG_WARNING,
+                    "XNNPack weight cache: '%s' was built for another model, "
+                    "it will be rebuilt.",
+                    file_path_.c_str());
+    return false;
+  }
+  if (packed_weights->base_offset() > mmap_handle_.size() ||
+      (verify_checksum &&
+       WeightCacheChecksum(
+           mmap_handle_.data() + packed_weights->base_offset(),
+           mmap_handle_.size() - packed_weights->base_offset()) !=
+           packed_weights->data_checksum())) {
+    TFLITE_LOG_PROD(tflite::TFLITE_LOG_ERROR,
+                    "XNNPack weight cache: '%s' is corrupted, it will be "
+                    "rebuilt.",
+                    file_path_.c_str());
+    return false;
+  }
   mmap_buffer_base_offset_ = packed_weights->base_offset();
   if (const auto buffers = packed_weights->buffers(); buffers) {
     for (auto* buffer : *buffers) {
@@ -383,6 +599,7 @@ bool MMapWeightCacheProvider::Load() {
           BufferLocation{.offset = buffer->offset(), .size = buffer->size()});
     }
   }
+  unmap_on_error.Deactivate();
   return true;
 }
 
@@ -396,6 +613,11 @@ void MMapWeightCacheProvider::MapTensorIdentifiers(
   }
 }
 
+void MMapWeightCacheProvider::MapBufferIdentifier(const void* buffer,
+                                                  const uint64_t identifier) {
+  buffer_address_to_identifier_[buffer] = identifier;
+}
+
 size_t MMapWeightCacheProvider::LookUp(
     const xnn_weights_cache_look_up_key* cache_key) {
   if (!cache_key) {
@@ -450,6 +672,8 @@ void MMapWeightCacheProvider::Release() {
   mmap_handle_ = MMapHandle();
   mmap_buffer_base_offset_ = 0;
   builder_ = WeightCacheBuilder();
+  builder_.SetModelFingerprint(model_fingerprint_);
+  build_lock_.Unlock();
 }
 
 bool MMapWeightCacheProvider::Finalize() {
@@ -462,12 +686,41 @@ bool MMapWeightCacheProvider::Finalize() {
                     "finalize the cache.");
     return false;
   }
+  // Hold the lock while writing and mapping the file: this guarantees that
+  // the mapped file is the one that was just written, and lets the processes
+  // waiting in `Load` map it afterwards. The lock file isn't needed anymore
+  // once they are done waiting.
+  if (!build_lock_.IsLocked() &&
+      !build_lock_.Lock(GetLockFilePath().c_str())) {
+    TFLITE_LOG_PROD(tflite::TFLITE_LOG_WARNING,
+                    "XNNPack weight cache: building '%s' without a lock.",
+                    file_path_.c_str());
+  }
+  const ScopeGuard unlock_on_return([this] { build_lock_.RemoveAndUnlock(); });
   if (!builder_.Write(file_path_.c_str())) {
     return false;
   }
+  const uint64_t data_checksum = builder_.DataChecksum();
   builder_ = WeightCacheBuilder();
+  builder_.SetModelFingerprint(model_fingerprint_);
 
-  return Load();
+  // The data is checked once here, where it is written, instead of every
+  // time the file is loaded.
+  if (!LoadFile(/*verify_checksum=*/true)) {
+    return false;
+  }
+  // Without the lock, another builder may have replaced the file in the
+  // meantime and its buffers may be laid out differently.
+  if (cache::schema::GetPackedWeights(mmap_handle_.data())->data_checksum() !=
+      data_checksum) {
+    TFLITE_LOG_PROD(tflite::TFLITE_LOG_ERROR,
+                    "XNNPack weight cache: '%s' was concurrently replaced.",
+                    file_path_.c_str());
+    mmap_handle_.UnMap();
+    cache_key_to_offset_.clear();
+    return false;
+  }
+  return true;
 }
 
 bool MMapWeightCacheProvider::IsFinalized() const {
@@ -34,6 +34,17 @@ limitations under the License.
 namespace tflite {
 namespace xnnpack {
 
+// Version of the cache file format and of the XNNPack weight packing. Cache
+// files written with another version are rebuilt instead of being loaded, so
+// this must be bumped whenever either of them changes.
+inline constexpr uint64_t kWeightCacheVersion = 1;
+
+// Computes the checksum that protects the data of a cache file.
+//
+// This can also be used to compute a model fingerprint for
+// `MMapWeightCacheProvider::SetModelFingerprint`.
+uint64_t WeightCacheChecksum(const void* data, size_t size);
+
 struct PackIdentifier {
   enum { kNoId = SIZE_MAX };
   uint64_t pack_algorithm_id = kNoId;
@@ -110,6 +121,48 @@ class MMapHandle {
   uint8_t* data_ = nullptr;
 };
 
+// Holds an exclusive advisory lock on a file.
+//
+// The lock is released when the object is destroyed or when the process
+// exits, even abnormally.
+//
+// WARNING: the interface in this file is still under experimentation and WILL
+// CHANGE. Do not rely on it.
+class FileLock {
+ public:
+  FileLock() = default;
+  ~FileLock();
+  FileLock(const FileLock&) = delete;
+  FileLock& operator=(const FileLock&) = delete;
+  FileLock(FileLock&&);
+  FileLock& operator=(FileLock&&);
+
+  // Creates the file at the given path if needed and locks it, waiting for
+  // other processes to release it.
+  //
+  // Fails immediately if the file is already locked in this process, as
+  // waiting could dead-lock.
+  [[nodiscard /*Locking a file can fail.*/]]
+  bool Lock(const char* path);
+
+  // Releases the lock.
+  void Unlock();
+
+  // Removes the locked file and releases the lock.
+  //
+  // Processes waiting for the lock notice the removal and lock a new file.
+  void RemoveAndUnlock();
+
+  // Returns true if the lock is held.
+  bool IsLocked() const { return fd_ >= 0; }
+
+  friend void swap(FileLock& a, FileLock& b);
+
+ private:
+  int fd_ = -1;
+  std::string path_;
+};
+
 // Provides storage to write the packed buffers to and saves those to disk.
 //
 // WARNING: the interface in this file is still under experimentation and WILL
@@ -136,10 +189,21 @@ class WeightCacheBuilder {
   // Checks whether this builder has data that needs to be written to disk.
   bool ShouldWrite() const;
 
+  // Sets the fingerprint of the model the weights are packed from.
+  void SetModelFingerprint(uint64_t fingerprint) {
+    schema_.model_fingerprint = fingerprint;
+  }
+
   // Writes the flatbuffer to disk.
+  //
+  // The file is written to a temporary path and renamed to `path`, so that
+  // other processes never see a partially written cache.
   [[nodiscard /*Writing the weight cache can fail.*/]]
   bool Write(const char* path);
 
+  // Returns the checksum of the data saved by the last call to `Write`.
+  uint64_t DataChecksum() const { return schema_.data_checksum; }
+
   // Helper for testing.
   //
   // WARNING: this exposes class implementation details for testing purposes and
@@ -166,6 +230,11 @@ class WeightCacheBuilder {
 //  - Load the cache file.
 //  - Finalize the cache before calling the run functions of XNNPack (setup and
 //    reshape are ok).
+//
+// The cache file is mapped read-only and shared, so that all the processes
+// using the same file share one physical copy of the packed weights. When
+// several processes need to build the same cache file, the first one builds it
+// while the others wait in `Load` and then map the result.
 class MMapWeightCacheProvider {
  public:
   MMapWeightCacheProvider() = default;
@@ -181,11 +250,36 @@ class MMapWeightCacheProvider {
 
   const std::string& GetFilePath() const { return file_path_; }
 
+  // Sets the fingerprint of the model the weights are packed from.
+  //
+  // When set, cache files built from a different model are rejected by `Load`
+  // and rebuilt.
+  //
+  // WARNING: Can only be called if the cache isn't finalized.
+  void SetModelFingerprint(uint64_t fingerprint);
+
+  // Makes `Load` verify the checksum of the data of existing cache files.
+  //
+  // Cache files are always verified when they are built. Checking them again
+  // reads the whole file on every load, so this is off by default.
+  void SetVerifyChecksumOnLoad(bool verify) {
+    verify_checksum_on_load_ = verify;
+  }
+
   // Set the weight file path and loads it.
   [[nodiscard /*Loading a cache file may fail.*/]]
   bool Load(const std::string& path);
 
   // Loads the weight cache previouslt set with `SetFilePath`.
+  //
+  // Cache files that are malformed, that were written with another
+  // `kWeightCacheVersion` or for another model are rejected, as well as
+  // corrupted ones if `SetVerifyChecksumOnLoad` was set.
+  //
+  // If the file cannot be loaded, waits for any other process building it and
+  // tries again. If it still fails, this provider holds the build lock until
+  // `Finalize` so that other processes wait for it to build the cache. The
+  // lock file is removed once the cache file is ready.
   [[nodiscard /*Loading cache data may fail.*/]]
   bool Load();
 
@@ -194,6 +288,10 @@ class MMapWeightCacheProvider {
       const TfLiteTensor* tensors, size_t size,
       const std::unordered_map<size_t, size_t>& tensor_index_to_identifier);
 
+  // Maps a static buffer that isn't the data of a tensor, e.g. weights
+  // unpacked by the delegate, to its identifier.
+  void MapBufferIdentifier(const void* buffer, uint64_t identifier);
+
   // Returns the offset of the buffer identified by `cache_key`.
   //
   // If the buffer isn't found, return SIZE_MAX.
@@ -268,6 +366,15 @@ class MMapWeightCacheProvider {
   static enum xnn_status delete_cache(void* context);
 
  private:
+  // Maps and validates the cache file.
+  //
+  // The data checksum is only verified if `verify_checksum` is true.
+  [[nodiscard /*Loading cache data may fail.*/]]
+  bool LoadFile(bool verify_checksum);
+
+  // Returns the path of the file used to synchronize cache builders.
+  std::string GetLockFilePath() const { return file_path_ + ".lock"; }
+
   // Hashes a cache key to lookup in `cache_key_to_identifier_`.
   PackIdentifier BuildPackIdentifier(const xnn_weights_cache_look_up_key& key);
 
@@ -299,6 +406,15 @@ class MMapWeightCacheProvider {
 
   // Used to build the cache.
   WeightCacheBuilder builder_;
+
+  // Fingerprint of the model, 0 if unknown.
+  uint64_t model_fingerprint_ = 0;
+
+  // Whether `Load` verifies the data checksum of existing cache files.
+  bool verify_checksum_on_load_ = false;
+
+  // Held while this provider builds the cache file.
+  FileLock build_lock_;
 };
 
 }  // namespace xnnpack
@@ -160,6 +160,9 @@ struct PackedWeightsT : public ::flatbuffers::NativeTable {
   std::vector<std::unique_ptr<tflite::xnnpack::cache::schema::BufferT>> buffers{};
   uint64_t flatbuffer_size = 0;
   uint64_t base_offset = 0;
+  uint64_t version = 0;
+  uint64_t model_fingerprint = 0;
+  uint64_t data_checksum = 0;
   PackedWeightsT() = default;
   PackedWeightsT(const PackedWeightsT &o);
   PackedWeightsT(PackedWeightsT&&) FLATBUFFERS_NOEXCEPT = default;
@@ -172,7 +175,10 @@ struct PackedWeights FLATBUFFERS_FINAL_CLASS : private ::flatbuffers::Table {
   enum FlatBuffersVTableOffset FLATBUFFERS_VTABLE_UNDERLYING_TYPE {
     VT_BUFFERS = 4,
     VT_FLATBUFFER_SIZE = 6,
-    VT_BASE_OFFSET = 8
+    VT_BASE_OFFSET = 8,
+    VT_VERSION = 10,
+    VT_MODEL_FINGERPRINT = 12,
+    VT_DATA_CHECKSUM = 14
   };
   /// A list of buffers.
   const ::flatbuffers::Vector<::flatbuffers::Offset<tflite::xnnpack::cache::schema::Buffer>> *buffers() const {
@@ -197,6 +203,28 @@ struct PackedWeights FLATBUFFERS_FINAL_CLASS : private ::flatbuffers::Table {
   bool mutate_base_offset(uint64_t _base_offset = 0) {
     return SetField<uint64_t>(VT_BASE_OFFSET, _base_offset, 0);
   }
+  /// Version of the cache format and of the packing code that produced the
+  /// buffers. A cache with a different version must be rebuilt.
+  uint64_t version() const {
+    return GetField<uint64_t>(VT_VERSION, 0);
+  }
+  bool mutate_version(uint64_t _version = 0) {
+    return SetField<uint64_t>(VT_VERSION, _version, 0);
+  }
+  /// Fingerprint of the model the weights were packed from. 0 if unknown.
+  uint64_t model_fingerprint() const {
+    return GetField<uint64_t>(VT_MODEL_FINGERPRINT, 0);
+  }
+  bool mutate_model_fingerprint(uint64_t _model_fingerprint = 0) {
+    return SetField<uint64_t>(VT_MODEL_FINGERPRINT, _model_fingerprint, 0);
+  }
+  /// Checksum of the buffer content appended after the flatbuffer.
+  uint64_t data_checksum() const {
+    return GetField<uint64_t>(VT_DATA_CHECKSUM, 0);
+  }
+  bool mutate_data_checksum(uint64_t _data_checksum = 0) {
+    return SetField<uint64_t>(VT_DATA_CHECKSUM, _data_checksum, 0);
+  }
   bool Verify(::flatbuffers::Verifier &verifier) const {
     return VerifyTableStart(verifier) &&
            VerifyOffset(verifier, VT_BUFFERS) &&
@@ -204,6 +232,9 @@ struct PackedWeights FLATBUFFERS_FINAL_CLASS : private ::flatbuffers::Table {
            verifier.VerifyVectorOfTables(buffers()) &&
            VerifyField<uint64_t>(verifier, VT_FLATBUFFER_SIZE, 8) &&
            VerifyField<uint64_t>(verifier, VT_BASE_OFFSET, 8) &&
+           VerifyField<uint64_t>(verifier, VT_VERSION, 8) &&
+           VerifyField<uint64_t>(verifier, VT_MODEL_FINGERPRINT, 8) &&
+           VerifyField<uint64_t>(verifier, VT_DATA_CHECKSUM, 8) &&
            verifier.EndTable();
   }
   PackedWeightsT *UnPack(const ::flatbuffers::resolver_function_t *_resolver = nullptr) const;
@@ -224,6 +255,15 @@ struct PackedWeightsBuilder {
   void add_base_offset(uint64_t base_offset) {
     fbb_.AddElement<uint64_t>(PackedWeights::VT_BASE_OFFSET, base_offset, 0);
   }
+  void add_version(uint64_t version) {
+    fbb_.AddElement<uint64_t>(PackedWeights::VT_VERSION, version, 0);
+  }
+  void add_model_fingerprint(uint64_t model_fingerprint) {
+    fbb_.AddElement<uint64_t>(PackedWeights::VT_MODEL_FINGERPRINT, model_fingerprint, 0);
+  }
+  void add_data_checksum(uint64_t data_checksum) {
+    fbb_.AddElement<uint64_t>(PackedWeights::VT_DATA_CHECKSUM, data_checksum, 0);
+  }
   explicit PackedWeightsBuilder(::flatbuffers::FlatBufferBuilder &_fbb)
         : fbb_(_fbb) {
     start_ = fbb_.StartTable();
@@ -239,8 +279,14 @@ inline ::flatbuffers::Offset<PackedWeights> CreatePackedWeights(
     ::flatbuffers::FlatBufferBuilder &_fbb,
     ::flatbuffers::Offset<::flatbuffers::Vector<::flatbuffers::Offset<tflite::xnnpack::cache::schema::Buffer>>> buffers = 0,
     uint64_t flatbuffer_size = 0,
-    uint64_t base_offset = 0) {
+    uint64_t base_offset = 0,
+    uint64_t version = 0,
+    uint64_t model_fingerprint = 0,
+    uint64_t data_checksum = 0) {
   PackedWeightsBuilder builder_(_fbb);
+  builder_.add_data_checksum(data_checksum);
+  builder_.add_model_fingerprint(model_fingerprint);
+  builder_.add_version(version);
   builder_.add_base_offset(base_offset);
   builder_.add_flatbuffer_size(flatbuffer_size);
   builder_.add_buffers(buffers);
@@ -251,13 +297,19 @@ inline ::flatbuffers::Offset<PackedWeights> CreatePackedWeightsDirect(
     ::flatbuffers::FlatBufferBuilder &_fbb,
     const std::vector<::flatbuffers::Offset<tflite::xnnpack::cache::schema::Buffer>> *buffers = nullptr,
     uint64_t flatbuffer_size = 0,
-    uint64_t base_offset = 0) {
+    uint64_t base_offset = 0,
+    uint64_t version = 0,
+    uint64_t model_fingerprint = 0,
+    uint64_t data_checksum = 0) {
   auto buffers__ = buffers ? _fbb.CreateVector<::flatbuffers::Offset<tflite::xnnpack::cache::schema::Buffer>>(*buffers) : 0;
   return tflite::xnnpack::cache::schema::CreatePackedWeights(
       _fbb,
       buffers__,
       flatbuffer_size,
-      base_offset);
+      base_offset,
+      version,
+      model_fingerprint,
+      data_checksum);
 }
 
 ::flatbuffers::Offset<PackedWeights> CreatePackedWeights(::flatbuffers::FlatBufferBuilder &_fbb, const PackedWeightsT *_o, const ::flatbuffers::rehasher_function_t *_rehasher = nullptr);
@@ -302,7 +354,10 @@ inline ::flatbuffers::Offset<Buffer> CreateBuffer(::flatbuffers::FlatBufferBuild
 
 inline PackedWeightsT::PackedWeightsT(const PackedWeightsT &o)
       : flatbuffer_size(o.flatbuffer_size),
-        base_offset(o.base_offset) {
+        base_offset(o.base_offset),
+        version(o.version),
+        model_fingerprint(o.model_fingerprint),
+        data_checksum(o.data_checksum) {
   buffers.reserve(o.buffers.size());
   for (const auto &buffers_ : o.buffers) { buffers.emplace_back((buffers_) ? new tflite::xnnpack::cache::schema::BufferT(*buffers_) : nullptr); }
 }
@@ -311,6 +366,9 @@ inline PackedWeightsT &PackedWeightsT::operator=(PackedWeightsT o) FLATBUFFERS_N
   std::swap(buffers, o.buffers);
   std::swap(flatbuffer_size, o.flatbuffer_size);
   std::swap(base_offset, o.base_offset);
+  std::swap(version, o.version);
+  std::swap(model_fingerprint, o.model_fingerprint);
+  std::swap(data_checksum, o.data_checksum);
   return *this;
 }
 
@@ -326,6 +384,9 @@ inline void PackedWeights::UnPackTo(PackedWeightsT *_o, const ::flatbuffers::res
   { auto _e = buffers(); if (_e) { _o->buffers.resize(_e->size()); for (::flatbuffers::uoffset_t _i = 0; _i < _e->size(); _i++) { if(_o->buffers[_i]) { _e->Get(_i)->UnPackTo(_o->buffers[_i].get(), _resolver); } else { _o->buffers[_i] = std::unique_ptr<tflite::xnnpack::cache::schema::BufferT>(_e->Get(_i)->UnPack(_resolver)); }; } } else { _o->buffers.resize(0); } }
   { auto _e = flatbuffer_size(); _o->flatbuffer_size = _e; }
   { auto _e = base_offset(); _o->base_offset = _e; }
+  { auto _e = version(); _o->version = _e; }
+  { auto _e = model_fingerprint(); _o->model_fingerprint = _e; }
+  { auto _e = data_checksum(); _o->data_checksum = _e; }
 }
 
 inline ::flatbuffers::Offset<PackedWeights> PackedWeights::Pack(::flatbuffers::FlatBufferBuilder &_fbb, const PackedWeightsT* _o, const ::flatbuffers::rehasher_function_t *_rehasher) {
@@ -339,11 +400,17 @@ inline ::flatbuffers::Offset<PackedWeights> CreatePackedWeights(::flatbuffers::F
   auto _buffers = _o->buffers.size() ? _fbb.CreateVector<::flatbuffers::Offset<tflite::xnnpack::cache::schema::Buffer>> (_o->buffers.size(), [](size_t i, _VectorArgs *__va) { return CreateBuffer(*__va->__fbb, __va->__o->buffers[i].get(), __va->__rehasher); }, &_va ) : 0;
   auto _flatbuffer_size = _o->flatbuffer_size;
   auto _base_offset = _o->base_offset;
+  auto _version = _o->version;
+  auto _model_fingerprint = _o->model_fingerprint;
+  auto _data_checksum = _o->data_checksum;
   return tflite::xnnpack::cache::schema::CreatePackedWeights(
       _fbb,
       _buffers,
       _flatbuffer_size,
-      _base_offset);
+      _base_offset,
+      _version,
+      _model_fingerprint,
+      _data_checksum);
 }
 
 inline const tflite::xnnpack::cache::schema::PackedWeights *GetPackedWeights(const void *buf) {
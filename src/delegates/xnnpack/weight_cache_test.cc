@@ -304,6 +304,157 @@ TEST(WeightCacheBuilderTest, NonExistingPathFails) {
   EXPECT_FALSE(builder.Write("/selkt/jdsljf"));
 }
 
+TEST(WeightCacheBuilderTest, WriteSavesVersionFingerprintAndChecksum) {
+  using std::size;
+
+  const std::string payload = "This is some data in the file.";
+  const PackIdentifier dummy_id{1, 2, 3};
+
+  WeightCacheBuilder builder;
+  builder.SetModelFingerprint(42);
+  auto loc = builder.Append(dummy_id, payload.c_str(), size(payload));
+  EXPECT_EQ(loc.size, size(payload));
+
+  TempFileDesc tmp_file(TempFileDesc::kAutoCLose);
+  ASSERT_TRUE(builder.Write(tmp_file.GetCPath()));
+
+  MMapHandle handle;
+  ASSERT_TRUE(handle.Map(tmp_file.GetCPath()));
+  const cache::schema::PackedWeights* const packed_weights =
+      cache::schema::GetPackedWeights(handle.data());
+  ASSERT_NE(packed_weights, nullptr);
+  EXPECT_EQ(packed_weights->version(), kWeightCacheVersion);
+  EXPECT_EQ(packed_weights->model_fingerprint(), 42);
+  EXPECT_EQ(packed_weights->data_checksum(),
+            WeightCacheChecksum(payload.c_str(), size(payload)));
+  EXPECT_EQ(packed_weights->data_checksum(), builder.DataChecksum());
+}
+
+// Writes a cache file holding a single buffer.
+[[nodiscard]]
+bool WriteTestCacheFile(const char* path, uint64_t model_fingerprint) {
+  using std::size;
+  const std::string payload = "This is some data in the file.";
+  WeightCacheBuilder builder;
+  builder.SetModelFingerprint(model_fingerprint);
+  auto loc = builder.Append(PackIdentifier{1, 2, 3}, payload.c_str(),
+                            size(payload));
+  return loc.size == size(payload) && builder.Write(path);
+}
+
+std::vector<uint8_t> ReadFile(const char* path) {
+  std::vector<uint8_t> data;
+  if (FILE* file = std::fopen(path, "rb")) {
+    for (int c = std::fgetc(file); c != EOF; c = std::fgetc(file)) {
+      data.push_back(static_cast<uint8_t>(c));
+    }
+    std::fclose(file);
+  }
+  return data;
+}
+
+bool FileExists(const std::string& path) {
+  if (FILE* file = std::fopen(path.c_str(), "rb")) {
+    std::fclose(file);
+    return true;
+  }
+  return false;
+}
+
+bool WriteFile(const char* path, const std::vector<uint8_t>& data) {
+  FILE* file = std::fopen(path, "wb");
+  if (!file) {
+    return false;
+  }
+  const bool success =
+      std::fwrite(data.data(), 1, data.size(), file) == data.size();
+  return std::fclose(file) == 0 && success;
+}
+
+TEST(MMapWeightCacheProviderTest, LoadRejectsCorruptedFileIfVerifying) {
+  TempFileDesc tmp_file(TempFileDesc::kAutoCLose);
+  ASSERT_TRUE(WriteTestCacheFile(tmp_file.GetCPath(), /*model_fingerprint=*/0));
+
+  std::vector<uint8_t> data = ReadFile(tmp_file.GetCPath());
+  ASSERT_FALSE(data.empty());
+  data.back() ^= 0xFF;
+  ASSERT_TRUE(WriteFile(tmp_file.GetCPath(), data));
+
+  {  // The data isn't read by default.
+    MMapWeightCacheProvider cache_provider;
+    EXPECT_TRUE(cache_provider.Load(tmp_file.GetPath()));
+  }
+  {
+    MMapWeightCacheProvider cache_provider;
+    cache_provider.SetVerifyChecksumOnLoad(true);
+    EXPECT_FALSE(cache_provider.Load(tmp_file.GetPath()));
+    EXPECT_FALSE(cache_provider.IsFinalized());
+  }
+}
+
+TEST(MMapWeightCacheProviderTest, LoadRejectsOtherVersion) {
+  TempFileDesc tmp_file(TempFileDesc::kAutoCLose);
+  ASSERT_TRUE(WriteTestCacheFile(tmp_file.GetCPath(), /*model_fingerprint=*/0));
+
+  std::vector<uint8_t> data = ReadFile(tmp_file.GetCPath());
+  ASSERT_TRUE(cache::schema::GetMutablePackedWeights(data.data())
+                  ->mutate_version(kWeightCacheVersion + 1));
+  ASSERT_TRUE(WriteFile(tmp_file.GetCPath(), data));
+
+  MMapWeightCacheProvider cache_provider;
+  EXPECT_FALSE(cache_provider.Load(tmp_file.GetPath()));
+  EXPECT_FALSE(cache_provider.IsFinalized());
+}
+
+TEST(MMapWeightCacheProviderTest, LoadChecksModelFingerprint) {
+  TempFileDesc tmp_file(TempFileDesc::kAutoCLose);
+  ASSERT_TRUE(WriteTestCacheFile(tmp_file.GetCPath(), /*model_fingerprint=*/1));
+
+  {
+    MMapWeightCacheProvider cache_provider;
+    cache_provider.SetModelFingerprint(2);
+    EXPECT_FALSE(cache_provider.Load(tmp_file.GetPath()));
+  }
+  {
+    MMapWeightCacheProvider cache_provider;
+    cache_provider.SetModelFingerprint(1);
+    EXPECT_TRUE(cache_provider.Load(tmp_file.GetPath()));
+  }
+  {  // An unknown fingerprint matches any model.
+    MMapWeightCacheProvider cache_provider;
+    EXPECT_TRUE(cache_provider.Load(tmp_file.GetPath()));
+  }
+}
+
+#if !defined(_MSC_VER)
+TEST(FileLockTest, LockingTwiceInTheSameProcessFails) {
+  TempFileDesc tmp_file(TempFileDesc::kAutoCLose);
+  FileLock lock_1;
+  FileLock lock_2;
+  ASSERT_TRUE(lock_1.Lock(tmp_file.GetCPath()));
+  EXPECT_TRUE(lock_1.IsLocked());
+  EXPECT_FALSE(lock_2.Lock(tmp_file.GetCPath()));
+  EXPECT_FALSE(lock_2.IsLocked());
+
+  lock_1.Unlock();
+  EXPECT_FALSE(lock_1.IsLocked());
+  EXPECT_TRUE(lock_2.Lock(tmp_file.GetCPath()));
+}
+
+TEST(FileLockTest, RemoveAndUnlockRemovesTheFile) {
+  TempFileDesc tmp_file(TempFileDesc::kAutoCLose);
+  FileLock lock;
+  ASSERT_TRUE(lock.Lock(tmp_file.GetCPath()));
+  lock.RemoveAndUnlock();
+  EXPECT_FALSE(lock.IsLocked());
+  EXPECT_FALSE(FileExists(tmp_file.GetPath()));
+
+  // The next lock creates the file again.
+  ASSERT_TRUE(lock.Lock(tmp_file.GetCPath()));
+  EXPECT_TRUE(FileExists(tmp_file.GetPath()));
+}
+#endif  // !defined(_MSC_VER)
+
 struct FakeContext {
   // Adds a new tensor and it's backing buffer to the context.
   //
@@ -518,6 +669,7 @@ TEST_F(BuildMMapWeightCacheProviderTest, FinalizeWorks) {
   ASSERT_TRUE(cache_provider.Finalize());
 
   ASSERT_TRUE(cache_provider.IsFinalized());
+  EXPECT_FALSE(FileExists(tmp_file.GetPath() + ".lock"));
 }
 
 struct LoadMMapWeightCacheProviderTest : BuildMMapWeightCacheProviderTest {
@@ -17,15 +17,20 @@ limitations under the License.
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <cinttypes>
 #include <cmath>
+#include <condition_variable>
 #include <cstdint>
 #include <cstring>
+#include <deque>
 #include <limits>
+#include <list>
 #include <map>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <unordered_set>
 #include <utility>
@@ -38,7 +43,10 @@ limitations under the License.
 #include "core/api/profiler.h"
 #include "core/c/builtin_op_data.h"
 #include "core/c/common.h"
+#include "delegates/serialization.h"
+#include "delegates/utils.h"
 #include "delegates/xnnpack/quantization_util.h"
+#include "delegates/xnnpack/weight_cache.h"
 #include "kernels/cpu_backend_context.h"
 #include "kernels/internal/compatibility.h"
 #include "kernels/internal/tensor_ctypes.h"
@@ -48,9 +56,19 @@ limitations under the License.
 #include "minimal_logging.h"
 #include "schema/schema_generated.h"
 #include "tools/optimize/reduced_precision_support.h"
+#include <farmhash.h>
 
 struct TfLiteXNNPackDelegateWeightsCache;
 
+struct TfLiteXNNPackDelegateWorkspace {
+  // XNNPACK workspace with smart-pointer for lifetime management.
+  std::unique_ptr<xnn_workspace, decltype(&xnn_release_workspace)> workspace{
+      nullptr, &xnn_release_workspace};
+  // Serializes setup and invocation of the XNNPACK runtimes which use the
+  // workspace.
+  std::mutex mutex;
+};
+
 namespace tflite {
 namespace xnnpack {
 namespace {
@@ -496,16 +514,18 @@ class Delegate {
                     TfLiteContext* context = nullptr) {
 #if !defined(__EMSCRIPTEN__) || defined(__EMSCRIPTEN_PTHREADS__)
     pthreadpool_t threadpool = nullptr;
-    if (context != nullptr) {
+    if (options != nullptr && options->threadpool != nullptr) {
+      threadpool = static_cast<pthreadpool_t>(options->threadpool);
+    } else if (context != nullptr) {
       threadpool =
           CpuBackendContext::GetFromContext(context)->get_xnnpack_threadpool();
     }
     if (threadpool != nullptr) {
-      // Note that by passing a valid threadpool via context, your xnnpack
-      // threadpool will have the same number of threads as
-      // CpuBackendContext::max_num_threads_. If this is not desired behavior,
-      // pass a null threadpool, and then set num_threads through
-      // TfLiteXNNPackDelegateOptions.
+      // Note that by passing a valid threadpool via options or context, your
+      // xnnpack threadpool will have the same number of threads as the
+      // external threadpool (CpuBackendContext::max_num_threads_ for the
+      // context). If this is not desired behavior, pass a null threadpool, and
+      // then set num_threads through TfLiteXNNPackDelegateOptions.
       threadpool_.reset(threadpool);
       own_threadpool_ = false;
     } else {
@@ -524,12 +544,91 @@ class Delegate {
     options_ =
         options != nullptr ? *options : TfLiteXNNPackDelegateOptionsDefault();
     delegate_.flags = GetXNNPackDelegateFlags();
-    workspace_.reset(workspace);
+    if (options_.workspace != nullptr) {
+      workspace_ = options_.workspace;
+    } else {
+      owned_workspace_.workspace.reset(workspace);
+      workspace_ = &owned_workspace_;
+    }
+    if ((options_.flags &
+         TFLITE_XNNPACK_DELEGATE_FLAG_COST_MODEL_PARTITIONING) != 0) {
+      partition_cost_model_ = std::make_unique<delegates::PartitionCostModel>();
+      if (options_.partition_cost_table != nullptr) {
+        delegates::PartitionCostModel calibrated_model;
+        if (calibrated_model.LoadCalibration(options_.partition_cost_table) ==
+            kTfLiteOk) {
+          *partition_cost_model_ = std::move(calibrated_model);
+        } else {
+          TFLITE_LOG_PROD(tflite::TFLITE_LOG_WARNING,
+                          "Using the default XNNPACK partition costs.");
+        }
+      }
+    }
+    if (options_.serialization_dir != nullptr &&
+        options_.model_token != nullptr && options_.weights_cache == nullptr) {
+      if (force_fp16() || mixed_precision_fp16()) {
+        // XNNPACK packs converted copies of the weights, which the cache file
+        // cannot identify.
+        TFLITE_LOG_PROD(tflite::TFLITE_LOG_WARNING,
+                        "XNNPACK weights are not serialized with FP16 "
+                        "inference.");
+      } else {
+        delegates::SerializationParams params;
+        params.model_token = options_.model_token;
+        params.cache_dir = options_.serialization_dir;
+        delegates::Serialization serialization(params);
+        weight_cache_provider_.SetFilePath(
+            serialization
+                .GetEntryForDelegate(
+                    "xnnpack_weights_" + std::to_string(options_.flags),
+                    /*context=*/nullptr)
+                .GetFilePath()
+                .c_str());
+      }
+    }
+  }
+
+  ~Delegate() {
+    if (weight_packing_thread_.joinable()) {
+      {
+        std::lock_guard<std::mutex> lock(weight_packing_mutex_);
+        stop_weight_packing_ = true;
+      }
+      weight_packing_cv_.notify_all();
+      weight_packing_thread_.join();
+    }
   }
 
   TfLiteIntArray* PrepareOpsToDelegate(TfLiteContext* context);
   TfLiteDelegate* tflite_delegate() { return &delegate_; }
 
+  // Queues the subgraph to create its runtime, and thus pack its weights, on
+  // the background weight packing thread.
+  void ScheduleWeightPacking(Subgraph* subgraph);
+
+  // Writes and maps the serialized weights file once all the partitions have
+  // packed their weights into it. Must be called before running any runtime,
+  // with the workspace mutex held.
+  TfLiteStatus FinalizeWeightCache(TfLiteContext* logging_context);
+
+  // Removes the subgraph from the background weight packing queue, waiting
+  // for its packing to finish if it is in progress.
+  void CancelWeightPacking(Subgraph* subgraph);
+
+  // Waits until the background weight packing thread has packed all the
+  // queued subgraphs.
+  void WaitForWeightPacking();
+
+  // Returns the number of partitions which have created their runtime, and
+  // thus packed their weights.
+  int num_packed_partitions() const { return num_packed_partitions_; }
+
+  // Returns whether the packed weights are mapped from the serialized weights
+  // file, which then no longer accepts new packed weights.
+  bool weight_cache_mapped() const {
+    return weight_cache_provider_.IsFinalized();
+  }
+
   bool support_signed_8bit_quantization() const {
     return (options_.flags & TFLITE_XNNPACK_DELEGATE_FLAG_QS8) != 0;
   }
@@ -556,6 +655,22 @@ class Delegate {
 #endif
   }
 
+  bool mixed_precision_fp16() const {
+    return !force_fp16() &&
+           (options_.flags &
+            TFLITE_XNNPACK_DELEGATE_FLAG_MIXED_PRECISION_FP16) != 0;
+  }
+
+  // With TFLITE_XNNPACK_DELEGATE_FLAG_MIXED_PRECISION_FP16, the delegated nodes
+  // of the last prepared TFLite subgraph which must run in FP32.
+  const std::unordered_set<int>& fp32_nodes() const { return fp32_nodes_; }
+
+  // With TFLITE_XNNPACK_DELEGATE_FLAG_COST_MODEL_PARTITIONING, the model
+  // deciding which partitions to delegate, null otherwise.
+  const delegates::PartitionCostModel* partition_cost_model() const {
+    return partition_cost_model_.get();
+  }
+
   bool enable_latest_operators() const {
 #ifdef XNNPACK_DELEGATE_USE_LATEST_OPS
     return true;
@@ -574,6 +689,29 @@ class Delegate {
 #endif
   }
 
+  int max_cached_input_shapes() const {
+    return std::max(options_.max_cached_input_shapes, 1);
+  }
+
+  bool lazy_weight_packing() const {
+    // A weights cache is finalized after delegation, and cannot accept new
+    // packed weights afterwards.
+    return (options_.flags &
+            TFLITE_XNNPACK_DELEGATE_FLAG_LAZY_WEIGHT_PACKING) != 0 &&
+           options_.weights_cache == nullptr &&
+           !weight_cache_provider_.IsActive();
+  }
+
+  bool background_weight_packing() const {
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+    return false;
+#else
+    return lazy_weight_packing() &&
+           (options_.flags &
+            TFLITE_XNNPACK_DELEGATE_FLAG_BACKGROUND_WEIGHT_PACKING) != 0;
+#endif
+  }
+
   bool support_variable_ops() const {
     if (options_.flags & TFLITE_XNNPACK_DELEGATE_FLAG_VARIABLE_OPERATORS) {
       return true;
@@ -610,15 +748,45 @@ class Delegate {
 #endif
   }
 
-  xnn_weights_cache_t weights_cache() const {
-    if (options_.weights_cache == nullptr) {
+  xnn_weights_cache_t weights_cache() {
+    if (weight_cache_provider_.IsActive()) {
+      return &weight_cache_provider_.GetCacheProvider();
+    } else if (options_.weights_cache == nullptr) {
       return nullptr;
     } else {
       return reinterpret_cast<xnn_weights_cache_t>(options_.weights_cache);
     }
   }
 
-  xnn_workspace_t workspace() const { return workspace_.get(); }
+  xnn_workspace_t workspace() const { return workspace_->workspace.get(); }
+
+  // Whether the partitions create their first runtime on a workspace of their
+  // own, see Subgraph::Create. The interpreter only creates the partitions
+  // concurrently if it runs on more than one thread, and the workspace from
+  // the options is always shared.
+  bool own_workspace_per_partition(const TfLiteContext* context) const {
+    return (delegate_.flags & kTfLiteDelegateFlagsThreadSafeKernelInit) != 0 &&
+           options_.workspace == nullptr &&
+           context->recommended_num_threads != 1;
+  }
+
+  // Creates a runtime of 'subgraph' which packs its weights into
+  // 'weights_cache'. Unlike the XNNPACK weights cache, the serialized one is
+  // not thread safe, so the runtimes packing into it are created one at a
+  // time.
+  xnn_status CreateXNNPackRuntime(xnn_subgraph_t subgraph,
+                                  xnn_weights_cache_t weights_cache,
+                                  xnn_workspace_t workspace,
+                                  pthreadpool_t threadpool, uint32_t flags,
+                                  xnn_runtime_t* runtime) {
+    std::unique_lock<std::mutex> lock(weight_cache_provider_mutex_,
+                                      std::defer_lock);
+    if (weights_cache != nullptr && weight_cache_provider_.IsActive()) {
+      lock.lock();
+    }
+    return xnn_create_runtime_v4(subgraph, weights_cache, workspace,
+                                 threadpool, flags, runtime);
+  }
 
   TfLiteStatus AssociateVariableWithTensor(int local_id,
                                            const TfLiteTensor* tensor,
@@ -667,12 +835,18 @@ class Delegate {
   TfLiteXNNPackDelegateOptions options() const { return options_; }
 
   int64_t GetXNNPackDelegateFlags() {
+    int64_t flags = kTfLiteDelegateFlagsPerOperatorProfiling;
     if (enable_subgraph_reshaping()) {
-      return kTfLiteDelegateFlagsPerOperatorProfiling |
-             kTfLiteDelegateFlagsAllowDynamicTensors;
-    } else {
-      return kTfLiteDelegateFlagsPerOperatorProfiling;
+      flags |= kTfLiteDelegateFlagsAllowDynamicTensors;
     }
+    // Partitions only read the delegate state set up in DelegatePrepare, and
+    // pack their weights into runtimes on workspaces of their own or under the
+    // workspace mutex, except for variables, which are associated with tensors
+    // while the partitions are created.
+    if (!support_variable_ops()) {
+      flags |= kTfLiteDelegateFlagsThreadSafeKernelInit;
+    }
+    return flags;
   }
 
  private:
@@ -691,6 +865,9 @@ class Delegate {
   // Mapping from a tensor index for a quasi-static tensor to the offset to
   // its unpacked data within static_unpacked_data_.
   std::unordered_map<int, size_t> static_unpacked_data_map_;
+  // Mapping from a tensor index for a quasi-static tensor to the index of the
+  // tensor it is unpacked from.
+  std::unordered_map<int, int> static_unpacked_input_map_;
   // Set of indices of nodes which unpack static data, e.g. Dequantize
   // operators which convert FP16 static weights to FP32. These nodes are simply
   // ignored in the delegate implementation, because their outputs are
@@ -698,6 +875,10 @@ class Delegate {
   std::unordered_set<int> static_unpack_nodes_;
   // Set of indices of tensors with unpacked static sparse weights.
   std::unordered_set<int> static_sparse_weights_;
+  // Set of indices of delegated nodes kept in FP32 with
+  // TFLITE_XNNPACK_DELEGATE_FLAG_MIXED_PRECISION_FP16.
+  std::unordered_set<int> fp32_nodes_;
+  std::unique_ptr<delegates::PartitionCostModel> partition_cost_model_;
 #if !defined(__EMSCRIPTEN__) || defined(__EMSCRIPTEN_PTHREADS__)
   // Thread pool with smart-pointer for lifetime management.
   std::unique_ptr<pthreadpool, decltype(&pthreadpool_destroy)> threadpool_{
@@ -705,12 +886,49 @@ class Delegate {
   // Boolean that indicates if threadpool_ was created by xnnpack_delegate.
   bool own_threadpool_;
 #endif
-  std::unique_ptr<xnn_workspace, decltype(&xnn_release_workspace)> workspace_{
-      nullptr, &xnn_release_workspace};
+  // Workspace used when no shared workspace is passed in the options.
+  TfLiteXNNPackDelegateWorkspace owned_workspace_;
+  // Either owned_workspace_ or the shared workspace from the options.
+  TfLiteXNNPackDelegateWorkspace* workspace_ = nullptr;
 
   TfLiteXNNPackDelegateOptions options_{};
   VariableHolder variable_holder_;
-  std::mutex workspace_mutex_;
+
+  // Fills fp32_nodes_ with the delegated nodes which are sensitive to FP16
+  // rounding, and the nodes unpacking their static inputs.
+  void SelectFP32Nodes(TfLiteContext* context,
+                       const TfLiteIntArray* nodes_to_delegate);
+
+  // Packs the weights of the subgraphs in weight_packing_queue_.
+  void WeightPackingLoop();
+
+  // Identifies the static buffers of the subgraph being prepared to
+  // weight_cache_provider_, and loads the weights file when preparing the
+  // first subgraph.
+  void MapWeightCacheIdentifiers(TfLiteContext* context);
+
+  // Serialized packed weights, set up from the serialization_dir and
+  // model_token options.
+  MMapWeightCacheProvider weight_cache_provider_;
+  bool weight_cache_loaded_ = false;
+  // The lowest address of a static buffer of the first subgraph prepared,
+  // which the static buffers are identified by their offsets from.
+  const char* weight_cache_model_start_ = nullptr;
+  // Serializes the runtimes packing weights into weight_cache_provider_.
+  std::mutex weight_cache_provider_mutex_;
+
+  // Thread packing weights in the background, started on first use. See
+  // TFLITE_XNNPACK_DELEGATE_FLAG_BACKGROUND_WEIGHT_PACKING.
+  std::thread weight_packing_thread_;
+  // Protects the fields below.
+  std::mutex weight_packing_mutex_;
+  std::condition_variable weight_packing_cv_;
+  std::deque<Subgraph*> weight_packing_queue_;
+  Subgraph* subgraph_being_packed_ = nullptr;
+  bool stop_weight_packing_ = false;
+
+  // Incremented by each partition when it creates its runtime.
+  std::atomic<int> num_packed_partitions_{0};
 };
 
 class Subgraph {
@@ -834,16 +1052,20 @@ class Subgraph {
       }
 
       switch (registration->builtin_code) {
+        case kTfLiteBuiltinBroadcastTo:
         case kTfLiteBuiltinMean:
         case kTfLiteBuiltinPad:
         case kTfLiteBuiltinSum:
         case kTfLiteBuiltinReshape:
         case kTfLiteBuiltinResizeBilinear:
+        case kTfLiteBuiltinResizeNearestNeighbor:
         case kTfLiteBuiltinStridedSlice:
         case kTfLiteBuiltinSlice:
+        case kTfLiteBuiltinTile:
           // Ignore all but the first input (axes, static padding, new shape,
-          // begins/offsets, sizes), because other inputs are represented as
-          // parameters of the XNNPACK operator rather than extra input.
+          // begins/offsets, sizes, multiples), because other inputs are
+          // represented as parameters of the XNNPACK operator rather than
+          // extra input.
           {
             const int t = node->inputs->data[0];
             tensors[t] = t;
@@ -931,6 +1153,7 @@ class Subgraph {
     std::unordered_map<int, uint32_t> tflite_tensor_to_xnnpack;
     std::vector<int> external_inputs;
     std::vector<int> external_outputs;
+    bool uses_static_unpacked_data = false;
     for (int t : tensors) {
       if (context->tensors[t].type == kTfLiteResource) {
         // We should never see a resource tensor if we are not handling variable
@@ -978,6 +1201,7 @@ class Subgraph {
         const auto it = delegate.static_unpacked_data_map_.find(t);
         if (it != delegate.static_unpacked_data_map_.end()) {
           data = delegate.static_unpacked_data_.data() + it->second;
+          uses_static_unpacked_data = true;
         }
       }
       if (inputs.count(t) != 0) {
@@ -1071,7 +1295,6 @@ class Subgraph {
       }
     }
 
-    xnn_runtime_t runtime_ptr = nullptr;
     uint32_t flags = XNN_FLAG_YIELD_WORKERS;
     if (has_sparse_weights) {
       flags |= XNN_FLAG_HINT_SPARSE_INFERENCE;
@@ -1084,6 +1307,13 @@ class Subgraph {
     }
     if (delegate.force_fp16()) {
       flags |= XNN_FLAG_FORCE_FP16_INFERENCE;
+    } else if (delegate.mixed_precision_fp16()) {
+      // Partitions never mix FP16 and FP32 nodes, see DelegatePrepare. The
+      // hint falls back to FP32 on CPUs without native FP16 arithmetic.
+      if (delegate.fp32_nodes().count(params->nodes_to_replace->data[0]) ==
+          0) {
+        flags |= XNN_FLAG_HINT_FP16_INFERENCE;
+      }
     } else {
       const char* precision_metadata_ptr = nullptr;
       size_t precision_metadata_size = 0;
@@ -1106,22 +1336,81 @@ class Subgraph {
     if (context->profiler) {
       flags |= XNN_FLAG_BASIC_PROFILING;
     }
-    status = xnn_create_runtime_v4(subgraph.get(), delegate.weights_cache(),
-                                   delegate.workspace(), delegate.threadpool(),
-                                   flags, &runtime_ptr);
-    if (status != xnn_status_success) {
-      TF_LITE_KERNEL_LOG(context, "failed to create XNNPACK runtime");
-      return nullptr;
+
+    std::unique_ptr<Subgraph> result(
+        new Subgraph(delegate, std::move(subgraph), flags, externals,
+                     external_inputs, external_outputs,
+                     tflite_tensor_to_xnnpack));
+    // Quasi-static tensors live in the delegate and are overwritten when it is
+    // applied to the next TFLite subgraph, and variables must be shared across
+    // partitions from the first invoke, so those partitions are packed now.
+    if (!delegate.lazy_weight_packing() || uses_static_unpacked_data ||
+        result->has_variables_) {
+      // XNNPACK adds a runtime to the users of its workspace while creating
+      // it, so the runtimes sharing a workspace are created one at a time.
+      // When the interpreter may create the partitions concurrently, each one
+      // creates its first runtime on a workspace of its own instead, so that
+      // their weights are packed in parallel.
+      if (delegate.own_workspace_per_partition(context)) {
+        if (result->CreateRuntime(context, /*workspace=*/nullptr) !=
+            kTfLiteOk) {
+          return nullptr;
+        }
+      } else {
+        std::lock_guard<std::mutex> lock(delegate.workspace_->mutex);
+        if (result->CreateRuntime(context, delegate.workspace()) !=
+            kTfLiteOk) {
+          return nullptr;
+        }
+      }
+    } else if (delegate.background_weight_packing()) {
+      delegate.ScheduleWeightPacking(result.get());
     }
+    return result.release();
+  }
 
-    return new Subgraph(delegate, runtime_ptr, externals, external_inputs,
-                        external_outputs, tflite_tensor_to_xnnpack);
+  // Creates the XNNPACK runtime on 'workspace', packing the weights of the
+  // partition, unless it was already created. Must be called with the
+  // workspace mutex held if 'workspace' is shared. Errors are logged only if
+  // logging_context is not null.
+  TfLiteStatus CreateRuntime(TfLiteContext* logging_context,
+                             xnn_workspace_t workspace) {
+    if (runtime_ != nullptr) {
+      return kTfLiteOk;
+    }
+    xnn_runtime_t runtime_ptr = nullptr;
+    const xnn_status status = delegate_->CreateXNNPackRuntime(
+        subgraph_.get(), delegate_->weights_cache(), workspace,
+        delegate_->threadpool(), runtime_flags_, &runtime_ptr);
+    if (status != xnn_status_success) {
+      if (logging_context != nullptr) {
+        TF_LITE_KERNEL_LOG(logging_context, "failed to create XNNPACK runtime");
+      }
+      return kTfLiteError;
+    }
+    runtime_.reset(runtime_ptr);
+    delegate_->num_packed_partitions_++;
+    // The runtime keeps what it needs from the subgraph, which is only needed
+    // to create the runtimes of other input shapes.
+    if (max_cached_input_shapes_ == 1) {
+      subgraph_.reset();
+    }
+    return kTfLiteOk;
   }
 
   TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node,
                        bool enable_subgraph_reshaping, Delegate* delegate) {
-    std::lock_guard<std::mutex> lock(delegate->workspace_mutex_);
-    if (enable_subgraph_reshaping) {
+    std::lock_guard<std::mutex> lock(delegate->workspace_->mutex);
+    if (!enable_subgraph_reshaping) {
+      return kTfLiteOk;
+    }
+    TF_LITE_ENSURE_STATUS(CreateRuntime(context, delegate->workspace()));
+
+    std::vector<size_t> input_dims = GetInputDims(context);
+    if (input_dims != input_dims_ && !ActivateCachedRuntime(input_dims)) {
+      TF_LITE_ENSURE_STATUS(SwitchToUncachedRuntime(context));
+      // Until the reshape succeeds, the runtime matches no input shape.
+      input_dims_.clear();
       xnn_status status = xnn_status_invalid_state;
       for (int i = 0; i < inputs_.size(); ++i) {
         const TfLiteTensor* tensor = &context->tensors[inputs_[i]];
@@ -1147,8 +1436,8 @@ class Subgraph {
         return kTfLiteError;
       }
 
+      output_dims_.resize(outputs_.size());
       for (int i = 0; i < outputs_.size(); ++i) {
-        TfLiteTensor* tensor = &context->tensors[outputs_[i]];
         size_t num_out_dims;
         size_t out_dims[XNN_MAX_TENSOR_DIMS];
         status = xnn_get_external_value_shape(
@@ -1160,25 +1449,101 @@ class Subgraph {
               context, "XNNPack delegate failed to get external value shape");
           return kTfLiteError;
         }
-        TfLiteIntArray* output_shape = TfLiteIntArrayCreate(num_out_dims);
-        for (int k = 0; k < num_out_dims; ++k) {
-          output_shape->data[k] = out_dims[k];
-        }
-        if (context->ResizeTensor(context, tensor, output_shape) != kTfLiteOk) {
-          TF_LITE_KERNEL_LOG(
-              context, "XNNPack delegate failed to get resize output tensor");
-          return kTfLiteError;
-        }
+        output_dims_[i].assign(&out_dims[0], &out_dims[num_out_dims]);
+      }
+      input_dims_ = std::move(input_dims);
+    }
+
+    for (int i = 0; i < outputs_.size(); ++i) {
+      TfLiteTensor* tensor = &context->tensors[outputs_[i]];
+      const std::vector<size_t>& out_dims = output_dims_[i];
+      TfLiteIntArray* output_shape = TfLiteIntArrayCreate(out_dims.size());
+      for (int k = 0; k < out_dims.size(); ++k) {
+        output_shape->data[k] = out_dims[k];
       }
+      if (context->ResizeTensor(context, tensor, output_shape) != kTfLiteOk) {
+        TF_LITE_KERNEL_LOG(
+            context, "XNNPack delegate failed to get resize output tensor");
+        return kTfLiteError;
+      }
+    }
+    return kTfLiteOk;
+  }
+
+  // Returns the shapes of the partition inputs, as the number of inputs
+  // followed by the rank and dimensions of every input.
+  std::vector<size_t> GetInputDims(TfLiteContext* context) const {
+    std::vector<size_t> input_dims{inputs_.size()};
+    for (int t : inputs_) {
+      const TfLiteIntArray* dims = context->tensors[t].dims;
+      input_dims.push_back(dims->size);
+      input_dims.insert(input_dims.end(), &dims->data[0],
+                        &dims->data[dims->size]);
+    }
+    return input_dims;
+  }
+
+  // Makes the cached runtime reshaped for input_dims the current one, if any.
+  // Its external values are still set up from its last invoke, so it is only
+  // set up again if the tensors moved since.
+  bool ActivateCachedRuntime(const std::vector<size_t>& input_dims) {
+    for (auto it = cached_runtimes_.begin(); it != cached_runtimes_.end();
+         ++it) {
+      if (it->input_dims == input_dims) {
+        CachedRuntime current = StashRuntime();
+        runtime_ = std::move(it->runtime);
+        externals_ = std::move(it->externals);
+        input_dims_ = std::move(it->input_dims);
+        output_dims_ = std::move(it->output_dims);
+        cached_runtimes_.erase(it);
+        cached_runtimes_.push_front(std::move(current));
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Makes room for a new input shape: keeps the current runtime in the cache
+  // and continues with a new runtime, or the least recently used one when the
+  // cache is full. The caller reshapes it.
+  TfLiteStatus SwitchToUncachedRuntime(TfLiteContext* context) {
+    if (max_cached_input_shapes_ == 1 || input_dims_.empty()) {
+      // The current runtime is not reshaped for any input shape yet.
       return kTfLiteOk;
+    }
+    if (cached_runtimes_.size() + 1 < max_cached_input_shapes_) {
+      xnn_runtime_t runtime_ptr = nullptr;
+      const xnn_status status = delegate_->CreateXNNPackRuntime(
+          subgraph_.get(), delegate_->weights_cache(), delegate_->workspace(),
+          delegate_->threadpool(), runtime_flags_, &runtime_ptr);
+      if (status != xnn_status_success) {
+        TF_LITE_KERNEL_LOG(context, "failed to create XNNPACK runtime");
+        return kTfLiteError;
+      }
+      cached_runtimes_.push_front(StashRuntime());
+      runtime_.reset(runtime_ptr);
+      for (auto& io_info : externals_) {
+        io_info.second = nullptr;
+      }
+      if (cached_runtimes_.size() + 1 == max_cached_input_shapes_) {
+        // All the runtimes exist.
+        subgraph_.reset();
+      }
     } else {
-      return kTfLiteOk;
+      CachedRuntime current = StashRuntime();
+      runtime_ = std::move(cached_runtimes_.back().runtime);
+      externals_ = std::move(cached_runtimes_.back().externals);
+      cached_runtimes_.pop_back();
+      cached_runtimes_.push_front(std::move(current));
     }
+    return kTfLiteOk;
   }
 
   TfLiteStatus Invoke(TfLiteContext* context, bool enable_subgraph_reshaping,
                       Delegate* delegate) {
-    std::lock_guard<std::mutex> lock(delegate->workspace_mutex_);
+    std::lock_guard<std::mutex> lock(delegate->workspace_->mutex);
+    TF_LITE_ENSURE_STATUS(CreateRuntime(context, delegate->workspace()));
+    TF_LITE_ENSURE_STATUS(delegate->FinalizeWeightCache(context));
     bool any_pointers_changed = false;
     for (std::pair<int, void*> io_info : externals_) {
       const TfLiteTensor& tensor = context->tensors[io_info.first];
@@ -2575,6 +2940,213 @@ class Subgraph {
     return kTfLiteOk;
   }
 
+  static TfLiteStatus CheckTensorsQuantizationMatch(
+      TfLiteContext* context, const TfLiteTensor& input_tensor,
+      const TfLiteTensor& output_tensor, BuiltinOperator op_type,
+      int node_index) {
+    if (output_tensor.type != kTfLiteInt8 &&
+        output_tensor.type != kTfLiteUInt8) {
+      return kTfLiteOk;
+    }
+    if (input_tensor.params.zero_point != output_tensor.params.zero_point) {
+      TF_LITE_MAYBE_KERNEL_LOG(
+          context,
+          "Mismatching quantization zero point across the input "
+          "(%" PRId32 ") and the output (%" PRId32 ") for %s operator #%d",
+          input_tensor.params.zero_point, output_tensor.params.zero_point,
+          EnumNameBuiltinOperator(op_type), node_index);
+      return kTfLiteError;
+    }
+    if (input_tensor.params.scale != output_tensor.params.scale) {
+      TF_LITE_MAYBE_KERNEL_LOG(
+          context,
+          "Mismatching quantization scale across the input (%f) "
+          "and the output (%f) for %s operator #%d",
+          input_tensor.params.scale, output_tensor.params.scale,
+          EnumNameBuiltinOperator(op_type), node_index);
+      return kTfLiteError;
+    }
+    return kTfLiteOk;
+  }
+
+  // Reads the static int32 or int64 tensor holding per-dimension parameters
+  // (tile multiples, broadcast shape) of an operator.
+  static std::vector<int64_t> GetStaticDimensionParams(
+      const TfLiteTensor& tensor) {
+    std::vector<int64_t> values(NumElements(&tensor));
+    for (size_t i = 0; i < values.size(); i++) {
+      values[i] = tensor.type == kTfLiteInt64
+                      ? GetTensorData<int64_t>(&tensor)[i]
+                      : GetTensorData<int32_t>(&tensor)[i];
+    }
+    return values;
+  }
+
+  // Decomposes tiling by |multiples| into a sequence of (axis, factor) steps,
+  // each of which is a single Concatenate node of at most 5 copies of its
+  // input. Returns false if some multiple has a prime factor larger than 5.
+  static bool GetTileSteps(const std::vector<int64_t>& multiples,
+                           std::vector<std::pair<size_t, size_t>>* steps) {
+    steps->clear();
+    for (size_t axis = 0; axis < multiples.size(); axis++) {
+      int64_t multiple = multiples[axis];
+      if (multiple <= 0) {
+        return false;
+      }
+      for (const int64_t factor : {5, 4, 3, 2}) {
+        while (multiple % factor == 0) {
+          steps->emplace_back(axis, static_cast<size_t>(factor));
+          multiple /= factor;
+        }
+      }
+      if (multiple != 1) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Defines an XNNPACK value for an intermediate result of an operator that is
+  // lowered to several XNNPACK nodes. The value inherits the datatype and the
+  // quantization parameters of |like_tensor|.
+  static TfLiteStatus DefineInternalValue(xnn_subgraph_t subgraph,
+                                          TfLiteContext* logging_context,
+                                          const TfLiteTensor& like_tensor,
+                                          const std::vector<size_t>& dims,
+                                          uint32_t* value_id) {
+    *value_id = XNN_INVALID_VALUE_ID;
+    xnn_status status = xnn_status_invalid_parameter;
+    switch (like_tensor.type) {
+      case kTfLiteFloat32:
+        status = xnn_define_tensor_value(
+            subgraph, xnn_datatype_fp32, dims.size(), dims.data(),
+            /*data=*/nullptr, XNN_INVALID_VALUE_ID, /*flags=*/0, value_id);
+        break;
+      case kTfLiteInt8:
+      case kTfLiteUInt8:
+        status = xnn_define_quantized_tensor_value(
+            subgraph,
+            like_tensor.type == kTfLiteInt8 ? xnn_datatype_qint8
+                                            : xnn_datatype_quint8,
+            like_tensor.params.zero_point, like_tensor.params.scale,
+            dims.size(), dims.data(), /*data=*/nullptr, XNN_INVALID_VALUE_ID,
+            /*flags=*/0, value_id);
+        break;
+      default:
+        break;
+    }
+    if (status != xnn_status_success) {
+      TF_LITE_KERNEL_LOG(logging_context,
+                         "failed to create XNNPACK Value for an intermediate "
+                         "tensor of type %s",
+                         TfLiteTypeGetName(like_tensor.type));
+      return kTfLiteError;
+    }
+    return kTfLiteOk;
+  }
+
+  static xnn_status DefineConcatenate(xnn_subgraph_t subgraph, size_t axis,
+                                      const std::vector<uint32_t>& input_ids,
+                                      uint32_t output_id) {
+    switch (input_ids.size()) {
+      case 2:
+        return xnn_define_concatenate2(subgraph, axis, input_ids[0],
+                                       input_ids[1], output_id, /*flags=*/0);
+      case 3:
+        return xnn_define_concatenate3(subgraph, axis, input_ids[0],
+                                       input_ids[1], input_ids[2], output_id,
+                                       /*flags=*/0);
+      case 4:
+        return xnn_define_concatenate4(subgraph, axis, input_ids[0],
+                                       input_ids[1], input_ids[2],
+                                       input_ids[3], output_id, /*flags=*/0);
+      case 5:
+        return xnn_define_concatenate5(
+            subgraph, axis, input_ids[0], input_ids[1], input_ids[2],
+            input_ids[3], input_ids[4], output_id, /*flags=*/0);
+      default:
+        return xnn_status_invalid_parameter;
+    }
+  }
+
+  // Tiles |input_id| with dimensions |dims| by |multiples| into |output_id|.
+  // Every step of GetTileSteps becomes one Concatenate node that repeats the
+  // previous result along the step's axis.
+  static TfLiteStatus DefineTile(xnn_subgraph_t subgraph,
+                                 TfLiteContext* logging_context,
+                                 const TfLiteTensor& like_tensor,
+                                 std::vector<size_t> dims,
+                                 const std::vector<int64_t>& multiples,
+                                 uint32_t input_id, uint32_t output_id,
+                                 BuiltinOperator op_type, int node_index) {
+    std::vector<std::pair<size_t, size_t>> steps;
+    if (!GetTileSteps(multiples, &steps)) {
+      return kTfLiteError;
+    }
+    if (steps.empty()) {
+      if (xnn_define_copy(subgraph, input_id, output_id, /*flags=*/0) !=
+          xnn_status_success) {
+        TF_LITE_KERNEL_LOG(logging_context, "failed to delegate %s node #%d",
+                           EnumNameBuiltinOperator(op_type), node_index);
+        return kTfLiteError;
+      }
+      return kTfLiteOk;
+    }
+    uint32_t current_id = input_id;
+    for (size_t i = 0; i < steps.size(); i++) {
+      const size_t axis = steps[i].first;
+      const size_t factor = steps[i].second;
+      dims[axis] *= factor;
+      uint32_t step_output_id = output_id;
+      if (i + 1 != steps.size()) {
+        TF_LITE_ENSURE_STATUS(DefineInternalValue(
+            subgraph, logging_context, like_tensor, dims, &step_output_id));
+      }
+      const std::vector<uint32_t> input_ids(factor, current_id);
+      if (DefineConcatenate(subgraph, axis, input_ids, step_output_id) !=
+          xnn_status_success) {
+        TF_LITE_KERNEL_LOG(logging_context, "failed to delegate %s node #%d",
+                           EnumNameBuiltinOperator(op_type), node_index);
+        return kTfLiteError;
+      }
+      current_id = step_output_id;
+    }
+    return kTfLiteOk;
+  }
+
+  // Returns true if RESIZE_NEAREST_NEIGHBOR maps every output coordinate o
+  // along a dimension to the input coordinate o / (output_size / input_size),
+  // i.e. if the resize is an integer-factor upsampling that is equivalent to
+  // repeating every input element. The mapping mirrors the reference kernel.
+  static bool IsNearestNeighborUpsampling(int32_t input_size,
+                                          int32_t output_size,
+                                          bool align_corners,
+                                          bool half_pixel_centers) {
+    if (input_size <= 0 || output_size % input_size != 0) {
+      return false;
+    }
+    const int32_t factor = output_size / input_size;
+    const float scale =
+        (align_corners && output_size > 1)
+            ? (input_size - 1) / static_cast<float>(output_size - 1)
+            : input_size / static_cast<float>(output_size);
+    const float offset = half_pixel_centers ? 0.5f : 0.0f;
+    for (int32_t o = 0; o < output_size; o++) {
+      const float source = (o + offset) * scale;
+      int32_t i = std::min(
+          align_corners ? static_cast<int32_t>(std::round(source))
+                        : static_cast<int32_t>(std::floor(source)),
+          input_size - 1);
+      if (half_pixel_centers) {
+        i = std::max<int32_t>(0, i);
+      }
+      if (i != o / factor) {
+        return false;
+      }
+    }
+    return true;
+  }
+
   static TfLiteStatus VisitNode(
       xnn_subgraph_t subgraph, Delegate& delegate, TfLiteContext* context,
       TfLiteRegistration* registration, TfLiteNode* node, int node_index,
@@ -2622,6 +3194,10 @@ class Subgraph {
                                     node_index, node, context->tensors,
                                     batchmatmul_params, input_output_tensors);
       }
+      case kTfLiteBuiltinBroadcastTo:
+        return VisitBroadcastToNode(subgraph, delegate, logging_context,
+                                    node_index, node, context->tensors,
+                                    input_output_tensors);
       case kTfLiteBuiltinCeil:
         return VisitCeilNode(subgraph, delegate, logging_context, node_index,
                              node, context->tensors, input_output_tensors);
@@ -2693,6 +3269,14 @@ class Subgraph {
       case kTfLiteBuiltinFloor:
         return VisitFloorNode(subgraph, delegate, logging_context, node_index,
                               node, context->tensors, input_output_tensors);
+      case kTfLiteBuiltinGelu: {
+        const TfLiteGeluParams* gelu_params =
+            static_cast<const TfLiteGeluParams*>(node->builtin_data);
+
+        return VisitGeluNode(subgraph, delegate, logging_context, node_index,
+                             node, context->tensors, gelu_params,
+                             input_output_tensors);
+      }
       case kTfLiteBuiltinHardSwish:
         return VisitHardSwishNode(subgraph, delegate, logging_context,
                                   node_index, node, context->tensors,
@@ -2750,6 +3334,14 @@ class Subgraph {
       case kTfLiteBuiltinNeg:
         return VisitNegNode(subgraph, delegate, logging_context, node_index,
                             node, context->tensors, input_output_tensors);
+      case kTfLiteBuiltinPack: {
+        const TfLitePackParams* pack_params =
+            static_cast<const TfLitePackParams*>(node->builtin_data);
+
+        return VisitPackNode(subgraph, delegate, logging_context, node_index,
+                             node, context->tensors, pack_params,
+                             input_output_tensors);
+      }
       case kTfLiteBuiltinPad:
         return VisitPadNode(subgraph, delegate, logging_context, node_index,
                             node, context->tensors, input_output_tensors);
@@ -2794,6 +3386,15 @@ class Subgraph {
                                        node_index, node, context->tensors,
                                        resize_params, input_output_tensors);
       }
+      case kTfLiteBuiltinResizeNearestNeighbor: {
+        const TfLiteResizeNearestNeighborParams* resize_params =
+            static_cast<const TfLiteResizeNearestNeighborParams*>(
+                node->builtin_data);
+
+        return VisitResizeNearestNeighborNode(
+            subgraph, delegate, logging_context, node_index, node,
+            context->tensors, resize_params, input_output_tensors);
+      }
       case kTfLiteBuiltinRound:
         return VisitRoundNode(subgraph, delegate, logging_context, node_index,
                               node, context->tensors, input_output_tensors);
@@ -2854,6 +3455,9 @@ class Subgraph {
       case kTfLiteBuiltinTanh:
         return VisitTanhNode(subgraph, delegate, logging_context, node_index,
                              node, context->tensors, input_output_tensors);
+      case kTfLiteBuiltinTile:
+        return VisitTileNode(subgraph, delegate, logging_context, node_index,
+                             node, context->tensors, input_output_tensors);
       case kTfLiteBuiltinTranspose: {
         return VisitTransposeNode(subgraph, delegate, logging_context,
                                   node_index, node, context->tensors,
@@ -2868,6 +3472,14 @@ class Subgraph {
                                       deconv_params, quasi_static_tensors,
                                       input_output_tensors);
       }
+      case kTfLiteBuiltinUnpack: {
+        const TfLiteUnpackParams* unpack_params =
+            static_cast<const TfLiteUnpackParams*>(node->builtin_data);
+
+        return VisitUnpackNode(subgraph, delegate, logging_context, node_index,
+                               node, context->tensors, unpack_params,
+                               input_output_tensors);
+      }
       case kTfLiteBuiltinVarHandle:
         return VisitVarHandleNode(subgraph, delegate, logging_context,
                                   node_index, node);
@@ -3349,6 +3961,123 @@ class Subgraph {
     return kTfLiteOk;
   }
 
+  static TfLiteStatus VisitBroadcastToNode(
+      xnn_subgraph_t subgraph, const Delegate& delegate,
+      TfLiteContext* logging_context, int node_index, TfLiteNode* node,
+      const TfLiteTensor* tensors,
+      const std::unordered_map<int, uint32_t>& input_output_tensors) {
+    TF_LITE_ENSURE_STATUS(CheckNumInputsAndOutputs(
+        logging_context, node, 2, 1, BuiltinOperator_BROADCAST_TO,
+        node_index));
+
+    const int input_tensor_index = node->inputs->data[0];
+    const TfLiteTensor& input_tensor = tensors[input_tensor_index];
+    TF_LITE_ENSURE_STATUS(CheckTensorFloat32OrQUInt8Type(
+        delegate, logging_context, input_tensor, input_tensor_index,
+        node_index));
+    TF_LITE_ENSURE_STATUS(CheckTensorNonDynamicAllocation(
+        delegate, logging_context, input_tensor, input_tensor_index,
+        node_index));
+
+    const int shape_tensor_index = node->inputs->data[1];
+    const TfLiteTensor& shape_tensor = tensors[shape_tensor_index];
+    TF_LITE_ENSURE_STATUS(CheckTensorInt32OrInt64Type(
+        logging_context, shape_tensor, shape_tensor_index, node_index));
+    TF_LITE_ENSURE_STATUS(CheckShapeTensorShape(
+        logging_context, shape_tensor, /*squeeze_dims=*/false,
+        shape_tensor_index, BuiltinOperator_BROADCAST_TO, node_index));
+    TF_LITE_ENSURE_STATUS(CheckTensorStaticAllocation(
+        logging_context, shape_tensor, shape_tensor_index,
+        BuiltinOperator_BROADCAST_TO, node_index));
+
+    const int output_tensor_index = node->outputs->data[0];
+    const TfLiteTensor& output_tensor = tensors[output_tensor_index];
+    TF_LITE_ENSURE_STATUS(CheckTensorFloat32OrQUInt8Type(
+        delegate, logging_context, output_tensor, output_tensor_index,
+        node_index));
+    TF_LITE_ENSURE_STATUS(CheckTensorShape(
+        logging_context, output_tensor, 1, XNN_MAX_TENSOR_DIMS,
+        output_tensor_index, BuiltinOperator_BROADCAST_TO, node_index));
+    TF_LITE_ENSURE_STATUS(CheckTensorNonDynamicAllocation(
+        delegate, logging_context, output_tensor, output_tensor_index,
+        node_index));
+    TF_LITE_ENSURE_STATUS(CheckTensorsQuantizationMatch(
+        logging_context, input_tensor, output_tensor,
+        BuiltinOperator_BROADCAST_TO, node_index));
+
+    const std::vector<int64_t> shape = GetStaticDimensionParams(shape_tensor);
+    const int num_dims = NumDimensions(&output_tensor);
+    const int num_input_dims = NumDimensions(&input_tensor);
+    if (static_cast<int>(shape.size()) != num_dims ||
+        num_input_dims > num_dims) {
+      TF_LITE_MAYBE_KERNEL_LOG(
+          logging_context,
+          "unsupported broadcast of %d-dimensional tensor #%d to %d "
+          "dimensions in BROADCAST_TO node #%d",
+          num_input_dims, input_tensor_index, static_cast<int>(shape.size()),
+          node_index);
+      return kTfLiteError;
+    }
+
+    // Broadcasting is tiling of the (rank-extended) input by the ratio of the
+    // output and input dimensions.
+    std::vector<size_t> input_dims(num_dims, 1);
+    std::vector<int64_t> multiples(num_dims, 1);
+    for (int i = 0; i < num_dims; i++) {
+      int64_t input_dim = 1;
+      if (i >= num_dims - num_input_dims) {
+        input_dim =
+            SizeOfDimension(&input_tensor, i - (num_dims - num_input_dims));
+      }
+      input_dims[i] = input_dim;
+      if (shape[i] != SizeOfDimension(&output_tensor, i) ||
+          (input_dim != 1 && input_dim != shape[i])) {
+        TF_LITE_MAYBE_KERNEL_LOG(
+            logging_context,
+            "incompatible dimension #%d of input tensor #%d and output "
+            "tensor #%d in BROADCAST_TO node #%d",
+            i, input_tensor_index, output_tensor_index, node_index);
+        return kTfLiteError;
+      }
+      multiples[i] = shape[i] / input_dim;
+    }
+    std::vector<std::pair<size_t, size_t>> steps;
+    if (!GetTileSteps(multiples, &steps)) {
+      TF_LITE_MAYBE_KERNEL_LOG(
+          logging_context,
+          "unsupported broadcast factor in BROADCAST_TO node #%d: only "
+          "factors with no prime divisors above 5 are supported",
+          node_index);
+      return kTfLiteError;
+    }
+
+    if (subgraph != nullptr) {
+      uint32_t input_id = input_output_tensors.at(input_tensor_index);
+      if (num_input_dims != num_dims) {
+        uint32_t reshaped_id = XNN_INVALID_VALUE_ID;
+        TF_LITE_ENSURE_STATUS(DefineInternalValue(
+            subgraph, logging_context, input_tensor, input_dims,
+            &reshaped_id));
+        if (xnn_define_static_reshape(subgraph, input_dims.size(),
+                                      input_dims.data(), input_id, reshaped_id,
+                                      /*flags=*/0) != xnn_status_success) {
+          TF_LITE_KERNEL_LOG(
+              logging_context, "failed to delegate %s node #%d",
+              EnumNameBuiltinOperator(BuiltinOperator_BROADCAST_TO),
+              node_index);
+          return kTfLiteError;
+        }
+        input_id = reshaped_id;
+      }
+      TF_LITE_ENSURE_STATUS(DefineTile(
+          subgraph, logging_context, output_tensor, input_dims, multiples,
+          input_id, input_output_tensors.at(output_tensor_index),
+          BuiltinOperator_BROADCAST_TO, node_index));
+    }
+
+    return kTfLiteOk;
+  }
+
   static TfLiteStatus VisitCeilNode(
       xnn_subgraph_t subgraph, const Delegate& delegate,
       TfLiteContext* logging_context, int node_index, TfLiteNode* node,
@@ -4305,13 +5034,13 @@ class Subgraph {
     return kTfLiteOk;
   }
 
-  static TfLiteStatus VisitHardSwishNode(
+  static TfLiteStatus VisitGeluNode(
       xnn_subgraph_t subgraph, const Delegate& delegate,
       TfLiteContext* logging_context, int node_index, TfLiteNode* node,
-      const TfLiteTensor* tensors,
+      const TfLiteTensor* tensors, const TfLiteGeluParams* gelu_params,
       const std::unordered_map<int, uint32_t>& input_output_tensors) {
     TF_LITE_ENSURE_STATUS(CheckNumInputsAndOutputs(
-        logging_context, node, 1, 1, BuiltinOperator_HARD_SWISH, node_index));
+        logging_context, node, 1, 1, BuiltinOperator_GELU, node_index));
 
     const TfLiteTensor& input_tensor = tensors[node->inputs->data[0]];
     TF_LITE_ENSURE_STATUS(CheckTensorFloat32Type(
@@ -4327,22 +5056,119 @@ class Subgraph {
         delegate, logging_context, output_tensor, node->outputs->data[0],
         node_index));
 
-    if (subgraph != nullptr) {
-      const xnn_status status = xnn_define_hardswish(
-          subgraph,
-          /*input_id=*/input_output_tensors.at(node->inputs->data[0]),
-          /*output_id=*/input_output_tensors.at(node->outputs->data[0]),
-          /*flags=*/0);
-      if (status != xnn_status_success) {
-        TF_LITE_KERNEL_LOG(logging_context, "failed to delegate %s node #%d",
-                           EnumNameBuiltinOperator(BuiltinOperator_HARD_SWISH),
-                           node_index);
-        return kTfLiteError;
-      }
+    // XNNPACK has no error function, so only the tanh approximation of GELU
+    // can be expressed with its operators.
+    if (!gelu_params->approximate) {
+      TF_LITE_MAYBE_KERNEL_LOG(
+          logging_context,
+          "unsupported exact (non-approximate) GELU in node #%d", node_index);
+      return kTfLiteError;
     }
 
-    return kTfLiteOk;
-  }
+    if (subgraph != nullptr) {
+      // 0.5 * x * (1 + tanh(sqrt(2 / pi) * (x + 0.044715 * x^3))) is
+      // rewritten as x * sigmoid(x * (a + b * x^2)) with a = 2 * sqrt(2 / pi)
+      // and b = 0.044715 * a, using 0.5 * (1 + tanh(z)) = sigmoid(2 * z).
+      static const float kLinearCoefficient =
+          static_cast<float>(2.0 * M_2_SQRTPI * M_SQRT1_2);
+      static const float kCubicCoefficient =
+          static_cast<float>(0.044715 * 2.0 * M_2_SQRTPI * M_SQRT1_2);
+
+      const uint32_t input_id = input_output_tensors.at(node->inputs->data[0]);
+      const uint32_t output_id =
+          input_output_tensors.at(node->outputs->data[0]);
+      const std::vector<size_t> dims(
+          &output_tensor.dims->data[0],
+          &output_tensor.dims->data[NumDimensions(&output_tensor)]);
+      const float output_min = -std::numeric_limits<float>::infinity();
+      const float output_max = std::numeric_limits<float>::infinity();
+
+      uint32_t linear_id = XNN_INVALID_VALUE_ID;
+      TF_LITE_ENSURE_EQ(
+          logging_context, xnn_status_success,
+          xnn_define_tensor_value(subgraph, xnn_datatype_fp32, /*num_dims=*/0,
+                                  /*dims=*/nullptr, &kLinearCoefficient,
+                                  XNN_INVALID_VALUE_ID, 0, &linear_id));
+      uint32_t cubic_id = XNN_INVALID_VALUE_ID;
+      TF_LITE_ENSURE_EQ(
+          logging_context, xnn_status_success,
+          xnn_define_tensor_value(subgraph, xnn_datatype_fp32, /*num_dims=*/0,
+                                  /*dims=*/nullptr, &kCubicCoefficient,
+                                  XNN_INVALID_VALUE_ID, 0, &cubic_id));
+      std::array<uint32_t, 5> temp_ids;
+      for (uint32_t& temp_id : temp_ids) {
+        TF_LITE_ENSURE_STATUS(DefineInternalValue(
+            subgraph, logging_context, output_tensor, dims, &temp_id));
+      }
+      // x^2
+      TF_LITE_ENSURE_EQ(logging_context, xnn_status_success,
+                        xnn_define_square(subgraph, input_id, temp_ids[0],
+                                          /*flags=*/0));
+      // b * x^2
+      TF_LITE_ENSURE_EQ(
+          logging_context, xnn_status_success,
+          xnn_define_multiply2(subgraph, output_min, output_max, temp_ids[0],
+                               cubic_id, temp_ids[1], /*flags=*/0));
+      // a + b * x^2
+      TF_LITE_ENSURE_EQ(
+          logging_context, xnn_status_success,
+          xnn_define_add2(subgraph, output_min, output_max, temp_ids[1],
+                          linear_id, temp_ids[2], /*flags=*/0));
+      // x * (a + b * x^2)
+      TF_LITE_ENSURE_EQ(
+          logging_context, xnn_status_success,
+          xnn_define_multiply2(subgraph, output_min, output_max, temp_ids[2],
+                               input_id, temp_ids[3], /*flags=*/0));
+      TF_LITE_ENSURE_EQ(logging_context, xnn_status_success,
+                        xnn_define_sigmoid(subgraph, temp_ids[3], temp_ids[4],
+                                           /*flags=*/0));
+      TF_LITE_ENSURE_EQ(
+          logging_context, xnn_status_success,
+          xnn_define_multiply2(subgraph, output_min, output_max, input_id,
+                               temp_ids[4], output_id, /*flags=*/0));
+    }
+
+    return kTfLiteOk;
+  }
+
+  static TfLiteStatus VisitHardSwishNode(
+      xnn_subgraph_t subgraph, const Delegate& delegate,
+      TfLiteContext* logging_context, int node_index, TfLiteNode* node,
+      const TfLiteTensor* tensors,
+      const std::unordered_map<int, uint32_t>& input_output_tensors) {
+    TF_LITE_ENSURE_STATUS(CheckNumInputsAndOutputs(
+        logging_context, node, 1, 1, BuiltinOperator_HARD_SWISH, node_index));
+
+    const TfLiteTensor& input_tensor = tensors[node->inputs->data[0]];
+    TF_LITE_ENSURE_STATUS(CheckTensorFloat32Type(
+        logging_context, input_tensor, node->inputs->data[0], node_index));
+    TF_LITE_ENSURE_STATUS(
+        CheckTensorNonDynamicAllocation(delegate, logging_context, input_tensor,
+                                        node->inputs->data[0], node_index));
+
+    const TfLiteTensor& output_tensor = tensors[node->outputs->data[0]];
+    TF_LITE_ENSURE_STATUS(CheckTensorFloat32Type(
+        logging_context, output_tensor, node->outputs->data[0], node_index));
+    TF_LITE_ENSURE_STATUS(CheckTensorNonDynamicAllocation(
+        delegate, logging_context, output_tensor, node->outputs->data[0],
+        node_index));
+
+    if (subgraph != nullptr) {
+      const xnn_status status = xnn_define_hardswish(
+          subgraph,
+          /*input_id=*/input_output_tensors.at(node->inputs->data[0]),
+          /*output_id=*/input_output_tensors.at(node->outputs->data[0]),
+          /*flags=*/0);
+      if (status != xnn_status_success) {
+        TF_LITE_KERNEL_LOG(logging_context, "failed to delegate %s node #%d",
+                           EnumNameBuiltinOperator(BuiltinOperator_HARD_SWISH),
+                           node_index);
+        return kTfLiteError;
+      }
+    }
+
+    return kTfLiteOk;
+  }
 
   static TfLiteStatus VisitLeakyReluNode(
       xnn_subgraph_t subgraph, const Delegate& delegate,
@@ -5218,6 +6044,95 @@ class Subgraph {
     return kTfLiteOk;
   }
 
+  static TfLiteStatus VisitPackNode(
+      xnn_subgraph_t subgraph, const Delegate& delegate,
+      TfLiteContext* logging_context, int node_index, TfLiteNode* node,
+      const TfLiteTensor* tensors, const TfLitePackParams* pack_params,
+      const std::unordered_map<int, uint32_t>& input_output_tensors) {
+    TF_LITE_ENSURE_STATUS(CheckNumInputsAndOutputs(
+        logging_context, node, 1, 5, 1, BuiltinOperator_PACK, node_index));
+    const int num_inputs = NumInputs(node);
+
+    const int output_tensor_index = node->outputs->data[0];
+    const TfLiteTensor& output_tensor = tensors[output_tensor_index];
+    TF_LITE_ENSURE_STATUS(CheckTensorFloat32OrQUInt8Type(
+        delegate, logging_context, output_tensor, output_tensor_index,
+        node_index));
+    TF_LITE_ENSURE_STATUS(CheckTensorShape(
+        logging_context, output_tensor, 2, XNN_MAX_TENSOR_DIMS,
+        output_tensor_index, BuiltinOperator_PACK, node_index));
+    TF_LITE_ENSURE_STATUS(CheckTensorNonDynamicAllocation(
+        delegate, logging_context, output_tensor, output_tensor_index,
+        node_index));
+
+    const int num_dims = NumDimensions(&output_tensor);
+    int axis = pack_params->axis;
+    if (axis < 0) {
+      axis += num_dims;
+    }
+    if (axis < 0 || axis >= num_dims) {
+      TF_LITE_MAYBE_KERNEL_LOG(logging_context,
+                               "invalid axis %d in PACK node #%d",
+                               pack_params->axis, node_index);
+      return kTfLiteError;
+    }
+
+    for (int i = 0; i < num_inputs; i++) {
+      const int input_tensor_index = node->inputs->data[i];
+      const TfLiteTensor& input_tensor = tensors[input_tensor_index];
+      TF_LITE_ENSURE_STATUS(CheckTensorFloat32OrQUInt8Type(
+          delegate, logging_context, input_tensor, input_tensor_index,
+          node_index));
+      TF_LITE_ENSURE_STATUS(CheckTensorShape(
+          logging_context, input_tensor, num_dims - 1, input_tensor_index,
+          BuiltinOperator_PACK, node_index));
+      TF_LITE_ENSURE_STATUS(CheckTensorNonDynamicAllocation(
+          delegate, logging_context, input_tensor, input_tensor_index,
+          node_index));
+      TF_LITE_ENSURE_STATUS(CheckTensorsQuantizationMatch(
+          logging_context, input_tensor, output_tensor, BuiltinOperator_PACK,
+          node_index));
+    }
+
+    if (subgraph != nullptr) {
+      // Every input is reshaped to the output rank with a unit dimension at
+      // the packing axis, and the results are concatenated along that axis.
+      std::vector<size_t> dims(
+          &output_tensor.dims->data[0],
+          &output_tensor.dims->data[NumDimensions(&output_tensor)]);
+      dims[axis] = 1;
+      const uint32_t output_id = input_output_tensors.at(output_tensor_index);
+      std::vector<uint32_t> reshaped_ids(num_inputs, output_id);
+      for (int i = 0; i < num_inputs; i++) {
+        if (num_inputs != 1) {
+          TF_LITE_ENSURE_STATUS(DefineInternalValue(
+              subgraph, logging_context, output_tensor, dims,
+              &reshaped_ids[i]));
+        }
+        if (xnn_define_static_reshape(
+                subgraph, dims.size(), dims.data(),
+                /*input_id=*/input_output_tensors.at(node->inputs->data[i]),
+                /*output_id=*/reshaped_ids[i],
+                /*flags=*/0) != xnn_status_success) {
+          TF_LITE_KERNEL_LOG(logging_context, "failed to delegate %s node #%d",
+                             EnumNameBuiltinOperator(BuiltinOperator_PACK),
+                             node_index);
+          return kTfLiteError;
+        }
+      }
+      if (num_inputs != 1 &&
+          DefineConcatenate(subgraph, axis, reshaped_ids, output_id) !=
+              xnn_status_success) {
+        TF_LITE_KERNEL_LOG(logging_context, "failed to delegate %s node #%d",
+                           EnumNameBuiltinOperator(BuiltinOperator_PACK),
+                           node_index);
+        return kTfLiteError;
+      }
+    }
+
+    return kTfLiteOk;
+  }
+
   static TfLiteStatus VisitPadNode(
       xnn_subgraph_t subgraph, const Delegate& delegate,
       TfLiteContext* logging_context, int node_index, TfLiteNode* node,
@@ -5727,6 +6642,145 @@ class Subgraph {
     return kTfLiteOk;
   }
 
+  static TfLiteStatus VisitResizeNearestNeighborNode(
+      xnn_subgraph_t subgraph, const Delegate& delegate,
+      TfLiteContext* logging_context, int node_index, TfLiteNode* node,
+      const TfLiteTensor* tensors,
+      const TfLiteResizeNearestNeighborParams* resize_params,
+      const std::unordered_map<int, uint32_t>& input_output_tensors) {
+    TF_LITE_ENSURE_STATUS(CheckNumInputsAndOutputs(
+        logging_context, node, 2, 1, BuiltinOperator_RESIZE_NEAREST_NEIGHBOR,
+        node_index));
+
+    const TfLiteTensor& input_tensor = tensors[node->inputs->data[0]];
+    TF_LITE_ENSURE_STATUS(
+        CheckTensorFloat32OrQUInt8Type(delegate, logging_context, input_tensor,
+                                       node->inputs->data[0], node_index));
+    TF_LITE_ENSURE_STATUS(CheckTensorShape(
+        logging_context, input_tensor, 4, node->inputs->data[0],
+        BuiltinOperator_RESIZE_NEAREST_NEIGHBOR, node_index));
+    TF_LITE_ENSURE_STATUS(
+        CheckTensorNonDynamicAllocation(delegate, logging_context, input_tensor,
+                                        node->inputs->data[0], node_index));
+
+    const TfLiteTensor& shape_tensor = tensors[node->inputs->data[1]];
+    TF_LITE_ENSURE_STATUS(CheckTensorType(logging_context, shape_tensor,
+                                          kTfLiteInt32, node->inputs->data[1],
+                                          node_index));
+    TF_LITE_ENSURE_STATUS(CheckShapeTensorShape(
+        logging_context, shape_tensor, /*squeeze_dims=*/false,
+        node->inputs->data[1], BuiltinOperator_RESIZE_NEAREST_NEIGHBOR,
+        node_index));
+    if (SizeOfDimension(&shape_tensor, 0) != 2) {
+      TF_LITE_MAYBE_KERNEL_LOG(
+          logging_context,
+          "unexpected number of dimensions %d in the output shape in node %d",
+          SizeOfDimension(&shape_tensor, 0), node_index);
+      return kTfLiteError;
+    }
+    TF_LITE_ENSURE_STATUS(CheckTensorStaticAllocation(
+        logging_context, shape_tensor, node->inputs->data[1],
+        BuiltinOperator_RESIZE_NEAREST_NEIGHBOR, node_index));
+
+    const TfLiteTensor& output_tensor = tensors[node->outputs->data[0]];
+    TF_LITE_ENSURE_STATUS(
+        CheckTensorFloat32OrQUInt8Type(delegate, logging_context, output_tensor,
+                                       node->outputs->data[0], node_index));
+    TF_LITE_ENSURE_STATUS(CheckTensorShape(
+        logging_context, output_tensor, 4, node->outputs->data[0],
+        BuiltinOperator_RESIZE_NEAREST_NEIGHBOR, node_index));
+    TF_LITE_ENSURE_STATUS(CheckTensorNonDynamicAllocation(
+        delegate, logging_context, output_tensor, node->outputs->data[0],
+        node_index));
+    TF_LITE_ENSURE_STATUS(CheckTensorsQuantizationMatch(
+        logging_context, input_tensor, output_tensor,
+        BuiltinOperator_RESIZE_NEAREST_NEIGHBOR, node_index));
+
+    // XNNPACK has no nearest-neighbor resize, but upsampling by integer
+    // factors (the common case in detection and segmentation heads) is
+    // repetition of every input pixel, which is expressed as a Tile of the
+    // input viewed as [N, H, 1, W, 1, C].
+    const int32_t* shape_data = GetTensorData<int32_t>(&shape_tensor);
+    const int32_t input_height = SizeOfDimension(&input_tensor, 1);
+    const int32_t input_width = SizeOfDimension(&input_tensor, 2);
+    if (!IsNearestNeighborUpsampling(input_height, shape_data[0],
+                                     resize_params->align_corners,
+                                     resize_params->half_pixel_centers) ||
+        !IsNearestNeighborUpsampling(input_width, shape_data[1],
+                                     resize_params->align_corners,
+                                     resize_params->half_pixel_centers)) {
+      TF_LITE_MAYBE_KERNEL_LOG(
+          logging_context,
+          "unsupported resize from %dx%d to %dx%d in "
+          "RESIZE_NEAREST_NEIGHBOR node #%d: only upsampling by integer "
+          "factors is supported",
+          input_height, input_width, shape_data[0], shape_data[1],
+          node_index);
+      return kTfLiteError;
+    }
+    const std::vector<int64_t> multiples = {
+        1, 1, shape_data[0] / input_height, 1, shape_data[1] / input_width, 1};
+    std::vector<std::pair<size_t, size_t>> steps;
+    if (!GetTileSteps(multiples, &steps)) {
+      TF_LITE_MAYBE_KERNEL_LOG(
+          logging_context,
+          "unsupported upsampling factor in RESIZE_NEAREST_NEIGHBOR node #%d: "
+          "only factors with no prime divisors above 5 are supported",
+          node_index);
+      return kTfLiteError;
+    }
+
+    if (subgraph != nullptr) {
+      const uint32_t input_id = input_output_tensors.at(node->inputs->data[0]);
+      const uint32_t output_id =
+          input_output_tensors.at(node->outputs->data[0]);
+      if (steps.empty()) {
+        TF_LITE_ENSURE_EQ(
+            logging_context, xnn_status_success,
+            xnn_define_copy(subgraph, input_id, output_id, /*flags=*/0));
+        return kTfLiteOk;
+      }
+
+      const std::vector<size_t> expanded_dims = {
+          static_cast<size_t>(SizeOfDimension(&input_tensor, 0)),
+          static_cast<size_t>(input_height),
+          1,
+          static_cast<size_t>(input_width),
+          1,
+          static_cast<size_t>(SizeOfDimension(&input_tensor, 3))};
+      std::vector<size_t> tiled_dims = expanded_dims;
+      tiled_dims[2] = multiples[2];
+      tiled_dims[4] = multiples[4];
+      const std::vector<size_t> output_dims(
+          &output_tensor.dims->data[0],
+          &output_tensor.dims->data[NumDimensions(&output_tensor)]);
+
+      uint32_t expanded_id = XNN_INVALID_VALUE_ID;
+      TF_LITE_ENSURE_STATUS(DefineInternalValue(subgraph, logging_context,
+                                                output_tensor, expanded_dims,
+                                                &expanded_id));
+      uint32_t tiled_id = XNN_INVALID_VALUE_ID;
+      TF_LITE_ENSURE_STATUS(DefineInternalValue(
+          subgraph, logging_context, output_tensor, tiled_dims, &tiled_id));
+      TF_LITE_ENSURE_EQ(
+          logging_context, xnn_status_success,
+          xnn_define_static_reshape(subgraph, expanded_dims.size(),
+                                    expanded_dims.data(), input_id,
+                                    expanded_id, /*flags=*/0));
+      TF_LITE_ENSURE_STATUS(DefineTile(
+          subgraph, logging_context, output_tensor, expanded_dims, multiples,
+          expanded_id, tiled_id, BuiltinOperator_RESIZE_NEAREST_NEIGHBOR,
+          node_index));
+      TF_LITE_ENSURE_EQ(
+          logging_context, xnn_status_success,
+          xnn_define_static_reshape(subgraph, output_dims.size(),
+                                    output_dims.data(), tiled_id, output_id,
+                                    /*flags=*/0));
+    }
+
+    return kTfLiteOk;
+  }
+
   static TfLiteStatus VisitRoundNode(
       xnn_subgraph_t subgraph, const Delegate& delegate,
       TfLiteContext* logging_context, int node_index, TfLiteNode* node,
@@ -6143,6 +7197,85 @@ class Subgraph {
     return kTfLiteOk;
   }
 
+  static TfLiteStatus VisitTileNode(
+      xnn_subgraph_t subgraph, const Delegate& delegate,
+      TfLiteContext* logging_context, int node_index, TfLiteNode* node,
+      const TfLiteTensor* tensors,
+      const std::unordered_map<int, uint32_t>& input_output_tensors) {
+    TF_LITE_ENSURE_STATUS(CheckNumInputsAndOutputs(
+        logging_context, node, 2, 1, BuiltinOperator_TILE, node_index));
+
+    const int input_tensor_index = node->inputs->data[0];
+    const TfLiteTensor& input_tensor = tensors[input_tensor_index];
+    TF_LITE_ENSURE_STATUS(CheckTensorFloat32OrQUInt8Type(
+        delegate, logging_context, input_tensor, input_tensor_index,
+        node_index));
+    TF_LITE_ENSURE_STATUS(CheckTensorShape(
+        logging_context, input_tensor, 1, XNN_MAX_TENSOR_DIMS,
+        input_tensor_index, BuiltinOperator_TILE, node_index));
+    TF_LITE_ENSURE_STATUS(CheckTensorNonDynamicAllocation(
+        delegate, logging_context, input_tensor, input_tensor_index,
+        node_index));
+
+    const int multiples_tensor_index = node->inputs->data[1];
+    const TfLiteTensor& multiples_tensor = tensors[multiples_tensor_index];
+    TF_LITE_ENSURE_STATUS(CheckTensorInt32OrInt64Type(
+        logging_context, multiples_tensor, multiples_tensor_index,
+        node_index));
+    TF_LITE_ENSURE_STATUS(CheckShapeTensorShape(
+        logging_context, multiples_tensor, /*squeeze_dims=*/false,
+        multiples_tensor_index, BuiltinOperator_TILE, node_index));
+    TF_LITE_ENSURE_STATUS(CheckTensorStaticAllocation(
+        logging_context, multiples_tensor, multiples_tensor_index,
+        BuiltinOperator_TILE, node_index));
+
+    const int output_tensor_index = node->outputs->data[0];
+    const TfLiteTensor& output_tensor = tensors[output_tensor_index];
+    TF_LITE_ENSURE_STATUS(CheckTensorFloat32OrQUInt8Type(
+        delegate, logging_context, output_tensor, output_tensor_index,
+        node_index));
+    TF_LITE_ENSURE_STATUS(CheckTensorNonDynamicAllocation(
+        delegate, logging_context, output_tensor, output_tensor_index,
+        node_index));
+    TF_LITE_ENSURE_STATUS(CheckTensorsQuantizationMatch(
+        logging_context, input_tensor, output_tensor, BuiltinOperator_TILE,
+        node_index));
+
+    const std::vector<int64_t> multiples =
+        GetStaticDimensionParams(multiples_tensor);
+    if (static_cast<int>(multiples.size()) != NumDimensions(&input_tensor)) {
+      TF_LITE_MAYBE_KERNEL_LOG(
+          logging_context,
+          "mismatch between the number of multiples (%d) and the number of "
+          "dimensions (%d) of input tensor #%d in TILE node #%d",
+          static_cast<int>(multiples.size()), NumDimensions(&input_tensor),
+          input_tensor_index, node_index);
+      return kTfLiteError;
+    }
+    std::vector<std::pair<size_t, size_t>> steps;
+    if (!GetTileSteps(multiples, &steps)) {
+      TF_LITE_MAYBE_KERNEL_LOG(
+          logging_context,
+          "unsupported multiples in TILE node #%d: only positive multiples "
+          "with no prime divisors above 5 are supported",
+          node_index);
+      return kTfLiteError;
+    }
+
+    if (subgraph != nullptr) {
+      const std::vector<size_t> dims(
+          &input_tensor.dims->data[0],
+          &input_tensor.dims->data[NumDimensions(&input_tensor)]);
+      TF_LITE_ENSURE_STATUS(DefineTile(
+          subgraph, logging_context, output_tensor, dims, multiples,
+          input_output_tensors.at(input_tensor_index),
+          input_output_tensors.at(output_tensor_index), BuiltinOperator_TILE,
+          node_index));
+    }
+
+    return kTfLiteOk;
+  }
+
   static TfLiteStatus VisitTransposeNode(
       xnn_subgraph_t subgraph, const Delegate& delegate,
       TfLiteContext* logging_context, int node_index, TfLiteNode* node,
@@ -7212,6 +8345,110 @@ class Subgraph {
     return kTfLiteOk;
   }
 
+  static TfLiteStatus VisitUnpackNode(
+      xnn_subgraph_t subgraph, const Delegate& delegate,
+      TfLiteContext* logging_context, int node_index, TfLiteNode* node,
+      const TfLiteTensor* tensors, const TfLiteUnpackParams* unpack_params,
+      const std::unordered_map<int, uint32_t>& input_output_tensors) {
+    TF_LITE_ENSURE_STATUS(CheckNumInputs(logging_context, node, 1,
+                                         BuiltinOperator_UNPACK, node_index));
+    TF_LITE_ENSURE_STATUS(CheckNumOutputs(logging_context, node, 1, 4,
+                                          BuiltinOperator_UNPACK, node_index));
+    const int num_outputs = NumOutputs(node);
+
+    const int input_tensor_index = node->inputs->data[0];
+    const TfLiteTensor& input_tensor = tensors[input_tensor_index];
+    TF_LITE_ENSURE_STATUS(CheckTensorFloat32OrQUInt8Type(
+        delegate, logging_context, input_tensor, input_tensor_index,
+        node_index));
+    TF_LITE_ENSURE_STATUS(CheckTensorShape(
+        logging_context, input_tensor, 2, XNN_MAX_TENSOR_DIMS,
+        input_tensor_index, BuiltinOperator_UNPACK, node_index));
+    TF_LITE_ENSURE_STATUS(CheckTensorNonDynamicAllocation(
+        delegate, logging_context, input_tensor, input_tensor_index,
+        node_index));
+
+    const int num_dims = NumDimensions(&input_tensor);
+    int axis = unpack_params->axis;
+    if (axis < 0) {
+      axis += num_dims;
+    }
+    if (axis < 0 || axis >= num_dims ||
+        SizeOfDimension(&input_tensor, axis) != num_outputs) {
+      TF_LITE_MAYBE_KERNEL_LOG(logging_context,
+                               "invalid axis %d in UNPACK node #%d",
+                               unpack_params->axis, node_index);
+      return kTfLiteError;
+    }
+
+    for (int i = 0; i < num_outputs; i++) {
+      const int output_tensor_index = node->outputs->data[i];
+      const TfLiteTensor& output_tensor = tensors[output_tensor_index];
+      TF_LITE_ENSURE_STATUS(CheckTensorFloat32OrQUInt8Type(
+          delegate, logging_context, output_tensor, output_tensor_index,
+          node_index));
+      TF_LITE_ENSURE_STATUS(CheckTensorNonDynamicAllocation(
+          delegate, logging_context, output_tensor, output_tensor_index,
+          node_index));
+      TF_LITE_ENSURE_STATUS(CheckTensorsQuantizationMatch(
+          logging_context, input_tensor, output_tensor,
+          BuiltinOperator_UNPACK, node_index));
+    }
+
+    if (subgraph != nullptr) {
+      // The input is split evenly along the axis, and the unit dimension is
+      // then dropped from every part.
+      std::vector<size_t> split_dims(
+          &input_tensor.dims->data[0],
+          &input_tensor.dims->data[NumDimensions(&input_tensor)]);
+      split_dims[axis] = 1;
+      const uint32_t input_id = input_output_tensors.at(input_tensor_index);
+      std::vector<uint32_t> split_ids(num_outputs, input_id);
+      if (num_outputs != 1) {
+        for (int i = 0; i < num_outputs; i++) {
+          TF_LITE_ENSURE_STATUS(
+              DefineInternalValue(subgraph, logging_context, input_tensor,
+                                  split_dims, &split_ids[i]));
+        }
+        xnn_status status = xnn_status_invalid_parameter;
+        if (num_outputs == 2) {
+          status = xnn_define_even_split2(subgraph, axis, input_id,
+                                          split_ids[0], split_ids[1],
+                                          /*flags=*/0);
+        } else if (num_outputs == 3) {
+          status = xnn_define_even_split3(subgraph, axis, input_id,
+                                          split_ids[0], split_ids[1],
+                                          split_ids[2], /*flags=*/0);
+        } else if (num_outputs == 4) {
+          status = xnn_define_even_split4(
+              subgraph, axis, input_id, split_ids[0], split_ids[1],
+              split_ids[2], split_ids[3], /*flags=*/0);
+        }
+        if (status != xnn_status_success) {
+          TF_LITE_KERNEL_LOG(logging_context, "failed to delegate %s node #%d",
+                             EnumNameBuiltinOperator(BuiltinOperator_UNPACK),
+                             node_index);
+          return kTfLiteError;
+        }
+      }
+      for (int i = 0; i < num_outputs; i++) {
+        const TfLiteTensor& output_tensor = tensors[node->outputs->data[i]];
+        const std::vector<size_t> output_dims(
+            &output_tensor.dims->data[0],
+            &output_tensor.dims->data[NumDimensions(&output_tensor)]);
+        TF_LITE_ENSURE_EQ(
+            logging_context, xnn_status_success,
+            xnn_define_static_reshape(
+                subgraph, output_dims.size(), output_dims.data(),
+                /*input_id=*/split_ids[i],
+                /*output_id=*/input_output_tensors.at(node->outputs->data[i]),
+                /*flags=*/0));
+      }
+    }
+
+    return kTfLiteOk;
+  }
+
   static TfLiteStatus VisitVarHandleNode(xnn_subgraph_t subgraph,
                                          Delegate& delegate,
                                          TfLiteContext* logging_context,
@@ -7247,11 +8484,35 @@ class Subgraph {
   inline Delegate* GetDelegate() const { return delegate_; }
 
  private:
-  Subgraph(Delegate& delegate, xnn_runtime_t runtime,
-           const std::unordered_set<int>& externals, std::vector<int>& inputs,
-           std::vector<int>& outputs,
+  // Runtime reshaped for one set of input shapes, kept for when the inputs
+  // change back to these shapes.
+  struct CachedRuntime {
+    std::unique_ptr<xnn_runtime, decltype(&xnn_delete_runtime)> runtime{
+        nullptr, &xnn_delete_runtime};
+    std::unordered_map<int, void*> externals;
+    std::vector<size_t> input_dims;
+    std::vector<std::vector<size_t>> output_dims;
+  };
+
+  // Moves the current runtime and its state out of the subgraph.
+  CachedRuntime StashRuntime() {
+    CachedRuntime cached;
+    cached.runtime = std::move(runtime_);
+    cached.externals = externals_;
+    cached.input_dims = std::move(input_dims_);
+    cached.output_dims = std::move(output_dims_);
+    input_dims_.clear();
+    output_dims_.clear();
+    return cached;
+  }
+
+  Subgraph(Delegate& delegate,
+           std::unique_ptr<xnn_subgraph, decltype(&xnn_delete_subgraph)>
+               subgraph,
+           uint32_t runtime_flags, const std::unordered_set<int>& externals,
+           std::vector<int>& inputs, std::vector<int>& outputs,
            std::unordered_map<int, uint32_t>& tflite_tensor_to_xnnpack)
-      : runtime_(runtime, &xnn_delete_runtime) {
+      : subgraph_(std::move(subgraph)), runtime_flags_(runtime_flags) {
     for (int t : externals) {
       externals_[t] = nullptr;
     }
@@ -7260,16 +8521,36 @@ class Subgraph {
     outputs_ = outputs;
     has_variables_ = !delegate.GetAllVariableTensors().empty();
     enable_subgraph_reshaping_ = delegate.enable_subgraph_reshaping();
+    // Persistent tensors are set up once, in a single runtime.
+    if (enable_subgraph_reshaping_ && !has_variables_) {
+      max_cached_input_shapes_ = delegate.max_cached_input_shapes();
+    }
     delegate_ = &delegate;
   }
 
+  // XNNPACK subgraph the runtime is created from. Released once the runtime
+  // exists.
+  std::unique_ptr<xnn_subgraph, decltype(&xnn_delete_subgraph)> subgraph_{
+      nullptr, &xnn_delete_subgraph};
+  // Flags passed to xnn_create_runtime_v4.
+  uint32_t runtime_flags_ = 0;
   // XNNPACK Runtime (subgraph + workspace) with smart-pointer for lifetime
-  // management.
+  // management. Created lazily with
+  // TFLITE_XNNPACK_DELEGATE_FLAG_LAZY_WEIGHT_PACKING.
   std::unique_ptr<xnn_runtime, decltype(&xnn_delete_runtime)> runtime_{
       nullptr, &xnn_delete_runtime};
   // Mapping from TFLite Tensor IDs for input/output tensors in the delegated
   // subgraph to their data locations.
   std::unordered_map<int, void*> externals_;
+  // With subgraph reshaping, the input shapes runtime_ is reshaped for, as
+  // returned by GetInputDims, and the resulting output shapes. input_dims_ is
+  // empty while runtime_ is not reshaped.
+  std::vector<size_t> input_dims_;
+  std::vector<std::vector<size_t>> output_dims_;
+  // Runtimes reshaped for other input shapes, most recently used first.
+  std::list<CachedRuntime> cached_runtimes_;
+  // Maximum number of runtimes, including runtime_.
+  size_t max_cached_input_shapes_ = 1;
   // The input tensors to the XNNPack partition. Not all node input tensors
   // are consumed by XNNPack.
   std::vector<int> inputs_;
@@ -7291,12 +8572,157 @@ class Subgraph {
   Delegate* delegate_;
 };
 
+void Delegate::ScheduleWeightPacking(Subgraph* subgraph) {
+  {
+    std::lock_guard<std::mutex> lock(weight_packing_mutex_);
+    weight_packing_queue_.push_back(subgraph);
+    if (!weight_packing_thread_.joinable()) {
+      weight_packing_thread_ = std::thread([this] { WeightPackingLoop(); });
+    }
+  }
+  weight_packing_cv_.notify_all();
+}
+
+void Delegate::CancelWeightPacking(Subgraph* subgraph) {
+  std::unique_lock<std::mutex> lock(weight_packing_mutex_);
+  weight_packing_queue_.erase(std::remove(weight_packing_queue_.begin(),
+                                          weight_packing_queue_.end(),
+                                          subgraph),
+                              weight_packing_queue_.end());
+  weight_packing_cv_.wait(
+      lock, [this, subgraph] { return subgraph_being_packed_ != subgraph; });
+}
+
+void Delegate::WaitForWeightPacking() {
+  std::unique_lock<std::mutex> lock(weight_packing_mutex_);
+  weight_packing_cv_.wait(lock, [this] {
+    return weight_packing_queue_.empty() && subgraph_being_packed_ == nullptr;
+  });
+}
+
+void Delegate::WeightPackingLoop() {
+  std::unique_lock<std::mutex> lock(weight_packing_mutex_);
+  while (true) {
+    weight_packing_cv_.wait(lock, [this] {
+      return stop_weight_packing_ || !weight_packing_queue_.empty();
+    });
+    if (stop_weight_packing_) {
+      return;
+    }
+    subgraph_being_packed_ = weight_packing_queue_.front();
+    weight_packing_queue_.pop_front();
+    lock.unlock();
+    {
+      // Failures are reported again by the first invoke, which retries.
+      std::lock_guard<std::mutex> workspace_lock(workspace_->mutex);
+      subgraph_being_packed_->CreateRuntime(/*logging_context=*/nullptr,
+                                            workspace());
+    }
+    lock.lock();
+    subgraph_being_packed_ = nullptr;
+    weight_packing_cv_.notify_all();
+  }
+}
+
+TfLiteStatus Delegate::FinalizeWeightCache(TfLiteContext* logging_context) {
+  if (weight_cache_provider_.IsBuilding() &&
+      !weight_cache_provider_.Finalize()) {
+    TF_LITE_MAYBE_KERNEL_LOG(logging_context,
+                             "failed to write XNNPACK weights into %s",
+                             weight_cache_provider_.GetFilePath().c_str());
+    return kTfLiteError;
+  }
+  return kTfLiteOk;
+}
+
+void Delegate::MapWeightCacheIdentifiers(TfLiteContext* context) {
+  // The static buffers all lie in the model, so they are identified by their
+  // offsets in it, which unlike their addresses and tensor indices are the
+  // same in every process and TFLite subgraph.
+  if (weight_cache_model_start_ == nullptr) {
+    for (int t = 0; t < context->tensors_size; t++) {
+      const TfLiteTensor& tensor = context->tensors[t];
+      if (tensor.allocation_type == kTfLiteMmapRo &&
+          tensor.data.raw_const != nullptr &&
+          (weight_cache_model_start_ == nullptr ||
+           tensor.data.raw_const < weight_cache_model_start_)) {
+        weight_cache_model_start_ = tensor.data.raw_const;
+      }
+    }
+  }
+  // The unpacked buffers are identified by the static buffer they are
+  // unpacked from, their type and the number of unpacking steps, e.g.
+  // densifying then dequantizing.
+  auto get_identifier = [&](int t) {
+    const TfLiteType type = context->tensors[t].type;
+    uint64_t num_steps = 0;
+    for (auto it = static_unpacked_input_map_.find(t);
+         it != static_unpacked_input_map_.end();
+         it = static_unpacked_input_map_.find(t)) {
+      t = it->second;
+      num_steps++;
+    }
+    const uint64_t offset = static_cast<uint64_t>(
+        context->tensors[t].data.raw_const - weight_cache_model_start_);
+    if (num_steps == 0) {
+      return offset;
+    }
+    const uint64_t key[] = {offset, num_steps, static_cast<uint64_t>(type)};
+    return ::util::Fingerprint64(reinterpret_cast<const char*>(key),
+                                 sizeof(key));
+  };
+
+  // A file packed from another model, e.g. with a reused model token or from
+  // a retrained model with the same layout, would hold other or stale packed
+  // weights, so it is rejected and packed again. The model is told apart by
+  // the offsets, sizes and full contents of its static buffers. They are
+  // hashed once per delegate, before the file is loaded.
+  std::vector<uint64_t> layout;
+  std::unordered_set<const char*> hashed_buffers;
+  for (int t = 0; t < context->tensors_size; t++) {
+    const TfLiteTensor& tensor = context->tensors[t];
+    const char* data = nullptr;
+    if (tensor.allocation_type == kTfLiteMmapRo) {
+      data = tensor.data.raw_const;
+    } else if (const auto it = static_unpacked_data_map_.find(t);
+               it != static_unpacked_data_map_.end()) {
+      data = static_unpacked_data_.data() + it->second;
+    }
+    if (data == nullptr) {
+      continue;
+    }
+    const uint64_t identifier = get_identifier(t);
+    weight_cache_provider_.MapBufferIdentifier(data, identifier);
+    if (!weight_cache_loaded_ && tensor.allocation_type == kTfLiteMmapRo &&
+        hashed_buffers.insert(data).second) {
+      layout.insert(layout.end(),
+                    {identifier, static_cast<uint64_t>(tensor.bytes),
+                     ::util::Fingerprint64(data, tensor.bytes)});
+    }
+  }
+  if (weight_cache_loaded_) {
+    return;
+  }
+  weight_cache_loaded_ = true;
+
+  weight_cache_provider_.SetModelFingerprint(
+      ::util::Fingerprint64(reinterpret_cast<const char*>(layout.data()),
+                            layout.size() * sizeof(uint64_t)));
+  if (!weight_cache_provider_.Load()) {
+    TFLITE_LOG_PROD(tflite::TFLITE_LOG_INFO,
+                    "Packing XNNPACK weights into %s.",
+                    weight_cache_provider_.GetFilePath().c_str());
+  }
+}
+
 TfLiteIntArray* Delegate::PrepareOpsToDelegate(TfLiteContext* context) {
   // Clear previous data, in case the delegate is reused without re-creation.
   static_unpacked_data_map_.clear();
+  static_unpacked_input_map_.clear();
   static_unpacked_data_.clear();
   static_unpack_nodes_.clear();
   static_sparse_weights_.clear();
+  fp32_nodes_.clear();
   variable_holder_.ClearTensorIdToGlobalId();
 
   TfLiteIntArray* execution_plan = nullptr;
@@ -7652,6 +9078,7 @@ TfLiteIntArray* Delegate::PrepareOpsToDelegate(TfLiteContext* context) {
     }
 
     static_unpacked_data_map_[t] = tensor_offset;
+    static_unpacked_input_map_[t] = node->inputs->data[0];
   }
 
   // Add nodes that unpack static data consumed by delegated nodes.
@@ -7678,9 +9105,81 @@ TfLiteIntArray* Delegate::PrepareOpsToDelegate(TfLiteContext* context) {
             &nodes_to_delegate->data[0]);
 #endif
 
+  if (mixed_precision_fp16()) {
+    SelectFP32Nodes(context, nodes_to_delegate);
+  }
+
+  if (weight_cache_provider_.IsActive()) {
+    MapWeightCacheIdentifiers(context);
+  }
+
   return nodes_to_delegate;
 }
 
+void Delegate::SelectFP32Nodes(TfLiteContext* context,
+                               const TfLiteIntArray* nodes_to_delegate) {
+  // Tensors read by the delegated nodes, mapped to their first reader.
+  std::unordered_map<int, int> first_consumer;
+  for (int i = 0; i < nodes_to_delegate->size; ++i) {
+    const int node_index = nodes_to_delegate->data[i];
+    TfLiteNode* node = nullptr;
+    TfLiteRegistration* registration = nullptr;
+    if (context->GetNodeAndRegistration(context, node_index, &node,
+                                        &registration) != kTfLiteOk) {
+      continue;
+    }
+    for (int j = 0; j < node->inputs->size; ++j) {
+      first_consumer.emplace(node->inputs->data[j], node_index);
+    }
+  }
+
+  for (int i = 0; i < nodes_to_delegate->size; ++i) {
+    const int node_index = nodes_to_delegate->data[i];
+    TfLiteNode* node = nullptr;
+    TfLiteRegistration* registration = nullptr;
+    if (static_unpack_nodes_.count(node_index) != 0 ||
+        context->GetNodeAndRegistration(context, node_index, &node,
+                                        &registration) != kTfLiteOk) {
+      continue;
+    }
+    switch (registration->builtin_code) {
+      case kTfLiteBuiltinLogSoftmax:
+      case kTfLiteBuiltinMean:
+      case kTfLiteBuiltinRsqrt:
+      case kTfLiteBuiltinSoftmax:
+      case kTfLiteBuiltinSqrt:
+      case kTfLiteBuiltinSquaredDifference:
+      case kTfLiteBuiltinSum:
+        fp32_nodes_.insert(node_index);
+        break;
+      case kTfLiteBuiltinFullyConnected:
+        // Fully connected layers whose output leaves the delegate, typically
+        // the final logits.
+        if (first_consumer.count(node->outputs->data[0]) == 0) {
+          fp32_nodes_.insert(node_index);
+        }
+        break;
+      default:
+        break;
+    }
+  }
+
+  // Nodes unpacking static weights go with their consumer, so that they never
+  // form a partition on their own.
+  for (int node_index : static_unpack_nodes_) {
+    TfLiteNode* node = nullptr;
+    TfLiteRegistration* registration = nullptr;
+    if (context->GetNodeAndRegistration(context, node_index, &node,
+                                        &registration) != kTfLiteOk) {
+      continue;
+    }
+    const auto it = first_consumer.find(node->outputs->data[0]);
+    if (it != first_consumer.end() && fp32_nodes_.count(it->second) != 0) {
+      fp32_nodes_.insert(node_index);
+    }
+  }
+}
+
 void* SubgraphInit(TfLiteContext* context, const char* buffer, size_t length) {
   const TfLiteDelegateParams* params =
       reinterpret_cast<const TfLiteDelegateParams*>(buffer);
@@ -7714,7 +9213,9 @@ TfLiteStatus SubgraphInvoke(TfLiteContext* context, TfLiteNode* node) {
 
 void SubgraphFree(TfLiteContext* context, void* buffer) {
   if (buffer != nullptr) {
-    delete static_cast<Subgraph*>(buffer);
+    Subgraph* subgraph = static_cast<Subgraph*>(buffer);
+    subgraph->GetDelegate()->CancelWeightPacking(subgraph);
+    delete subgraph;
   }
 }
 
@@ -7730,15 +9231,60 @@ const TfLiteRegistration kSubgraphRegistration = {
 };
 
 TfLiteStatus DelegatePrepare(TfLiteContext* context, TfLiteDelegate* delegate) {
+  ::tflite::xnnpack::Delegate* xnnpack_delegate =
+      static_cast<::tflite::xnnpack::Delegate*>(delegate->data_);
   TfLiteIntArray* ops_to_replace =
-      static_cast<::tflite::xnnpack::Delegate*>(delegate->data_)
-          ->PrepareOpsToDelegate(context);
+      xnnpack_delegate->PrepareOpsToDelegate(context);
   if (ops_to_replace == nullptr) {
     return kTfLiteError;
   }
 
-  const TfLiteStatus status = context->ReplaceNodeSubsetsWithDelegateKernels(
+  if (xnnpack_delegate->partition_cost_model() != nullptr) {
+    delegates::GraphPartitionHelper helper(
+        context, std::vector<int>(&ops_to_replace->data[0],
+                                  &ops_to_replace->data[ops_to_replace->size]));
+    if (helper.Partition(nullptr) != kTfLiteOk) {
+      TfLiteIntArrayFree(ops_to_replace);
+      return kTfLiteError;
+    }
+    std::vector<int> profitable_ops = helper.GetNodesOfProfitablePartitions(
+        *xnnpack_delegate->partition_cost_model());
+    std::sort(profitable_ops.begin(), profitable_ops.end());
+    std::copy(profitable_ops.begin(), profitable_ops.end(),
+              &ops_to_replace->data[0]);
+    ops_to_replace->size = profitable_ops.size();
+  }
+
+  const std::unordered_set<int>& fp32_nodes = xnnpack_delegate->fp32_nodes();
+  if (fp32_nodes.empty()) {
+    const TfLiteStatus status = context->ReplaceNodeSubsetsWithDelegateKernels(
+        context, kSubgraphRegistration, ops_to_replace, delegate);
+    TfLiteIntArrayFree(ops_to_replace);
+    return status;
+  }
+
+  // Replace the FP16 and FP32 nodes separately, so that every partition runs
+  // in a single precision.
+  TfLiteIntArray* fp32_ops_to_replace =
+      TfLiteIntArrayCreate(ops_to_replace->size);
+  fp32_ops_to_replace->size = 0;
+  int fp16_size = 0;
+  for (int i = 0; i < ops_to_replace->size; ++i) {
+    const int node_index = ops_to_replace->data[i];
+    if (fp32_nodes.count(node_index) != 0) {
+      fp32_ops_to_replace->data[fp32_ops_to_replace->size++] = node_index;
+    } else {
+      ops_to_replace->data[fp16_size++] = node_index;
+    }
+  }
+  ops_to_replace->size = fp16_size;
+  TfLiteStatus status = context->ReplaceNodeSubsetsWithDelegateKernels(
       context, kSubgraphRegistration, ops_to_replace, delegate);
+  if (status == kTfLiteOk) {
+    status = context->ReplaceNodeSubsetsWithDelegateKernels(
+        context, kSubgraphRegistration, fp32_ops_to_replace, delegate);
+  }
+  TfLiteIntArrayFree(fp32_ops_to_replace);
   TfLiteIntArrayFree(ops_to_replace);
   return status;
 }
@@ -7838,6 +9384,21 @@ TfLiteXNNPackDelegateOptions GetOptions(const void* delegate_data) {
       ->options();
 }
 
+int GetNumPackedPartitions(const void* delegate_data) {
+  return static_cast<const tflite::xnnpack::Delegate*>(delegate_data)
+      ->num_packed_partitions();
+}
+
+bool IsWeightCacheMapped(const void* delegate_data) {
+  return static_cast<const tflite::xnnpack::Delegate*>(delegate_data)
+      ->weight_cache_mapped();
+}
+
+void WaitForWeightPacking(void* delegate_data) {
+  static_cast<tflite::xnnpack::Delegate*>(delegate_data)
+      ->WaitForWeightPacking();
+}
+
 TfLiteDelegate* TfLiteXNNPackDelegateCreate(
     const TfLiteXNNPackDelegateOptions* options) {
   return TfLiteXNNPackDelegateCreateWithThreadpool(options, nullptr);
@@ -7851,8 +9412,10 @@ TfLiteDelegate* TfLiteXNNPackDelegateCreateWithThreadpool(
   }
 
   xnn_workspace_t workspace = nullptr;
-  if (xnn_create_workspace(&workspace) != xnn_status_success) {
-    return nullptr;
+  if (options == nullptr || options->workspace == nullptr) {
+    if (xnn_create_workspace(&workspace) != xnn_status_success) {
+      return nullptr;
+    }
   }
 
   auto* xnnpack_delegate =
@@ -7860,6 +9423,31 @@ TfLiteDelegate* TfLiteXNNPackDelegateCreateWithThreadpool(
   return xnnpack_delegate ? xnnpack_delegate->tflite_delegate() : nullptr;
 }
 
+TfLiteXNNPackDelegateWorkspace* TfLiteXNNPackDelegateWorkspaceCreate() {
+  xnn_status status = xnn_initialize(/*allocator=*/nullptr);
+  if (status != xnn_status_success) {
+    return nullptr;
+  }
+
+  xnn_workspace_t xnn_workspace = nullptr;
+  if (xnn_create_workspace(&xnn_workspace) != xnn_status_success) {
+    xnn_deinitialize();
+    return nullptr;
+  }
+  auto* workspace = new TfLiteXNNPackDelegateWorkspace;
+  workspace->workspace.reset(xnn_workspace);
+  return workspace;
+}
+
+void TfLiteXNNPackDelegateWorkspaceDelete(
+    TfLiteXNNPackDelegateWorkspace* workspace) {
+  if (workspace == nullptr) {
+    return;
+  }
+  delete workspace;
+  xnn_deinitialize();
+}
+
 void* TfLiteXNNPackDelegateGetThreadPool(TfLiteDelegate* delegate) {
   if (delegate == nullptr) {
     return nullptr;
@@ -45,8 +45,32 @@ extern "C" {
 // Enable XNNPack subgraph reshaping. This means that models with dynamic
 // tensors are supported and that inputs may be efficiently resized.
 #define TFLITE_XNNPACK_DELEGATE_FLAG_ENABLE_SUBGRAPH_RESHAPING 0x00000080
+// Defer packing the weights of each delegated partition until the partition is
+// first used: on its first invoke, or on its first prepare when subgraph
+// reshaping is enabled. Partitions which are never run, e.g. the unused
+// signatures of a multi-signature model, never allocate their packed weights.
+// Ignored when a weights cache is used, as it must be finalized after all the
+// weights are packed.
+#define TFLITE_XNNPACK_DELEGATE_FLAG_LAZY_WEIGHT_PACKING 0x00000100
+// Together with TFLITE_XNNPACK_DELEGATE_FLAG_LAZY_WEIGHT_PACKING, pack the
+// weights of the delegated partitions on a background thread, so that they
+// are usually ready by the time the partition is first used.
+#define TFLITE_XNNPACK_DELEGATE_FLAG_BACKGROUND_WEIGHT_PACKING 0x00000200
+// Select the precision per delegated partition: nodes which are sensitive to
+// FP16 rounding (softmax, reductions and normalization statistics, and fully
+// connected layers producing graph outputs such as logits) are grouped in FP32
+// partitions, and the other partitions run in FP16 where the CPU supports it.
+// Conversions only happen on the tensors between partitions of different
+// precisions. Ignored with TFLITE_XNNPACK_DELEGATE_FLAG_FORCE_FP16.
+#define TFLITE_XNNPACK_DELEGATE_FLAG_MIXED_PRECISION_FP16 0x00000400
+// Delegate only the partitions which tflite::delegates::PartitionCostModel
+// estimates to run faster in XNNPACK than on the TFLite kernels, leaving e.g.
+// single operators between unsupported ones to the TFLite kernels. See
+// TfLiteXNNPackDelegateOptions.partition_cost_table.
+#define TFLITE_XNNPACK_DELEGATE_FLAG_COST_MODEL_PARTITIONING 0x00000800
 
 struct TfLiteXNNPackDelegateWeightsCache;
+struct TfLiteXNNPackDelegateWorkspace;
 
 typedef struct {
   // Number of threads to use in the thread pool.
@@ -61,6 +85,10 @@ typedef struct {
   // - TFLITE_XNNPACK_DELEGATE_FLAG_TRANSIENT_INDIRECTION_BUFFER
   // - TFLITE_XNNPACK_DELEGATE_FLAG_ENABLE_LATEST_OPERATORS
   // - TFLITE_XNNPACK_DELEGATE_FLAG_ENABLE_SUBGRAPH_RESHAPING
+  // - TFLITE_XNNPACK_DELEGATE_FLAG_LAZY_WEIGHT_PACKING
+  // - TFLITE_XNNPACK_DELEGATE_FLAG_BACKGROUND_WEIGHT_PACKING
+  // - TFLITE_XNNPACK_DELEGATE_FLAG_MIXED_PRECISION_FP16
+  // - TFLITE_XNNPACK_DELEGATE_FLAG_COST_MODEL_PARTITIONING
   uint32_t flags;
   // Cache for packed weights, can be shared between multiple instances of
   // delegates.
@@ -70,6 +98,38 @@ typedef struct {
   bool handle_variable_ops;
   // Enable adaptive optimization for AVX CPUs.
   bool experimental_adaptive_avx_optimization;
+  // Externally owned pthreadpool_t to use instead of creating a thread pool
+  // with num_threads threads. The delegate does not take ownership; the thread
+  // pool must outlive every delegate using it. A single thread pool can be
+  // shared by all delegate instances in a process, and with the builtin
+  // kernels via CpuBackendContext::SetXNNPackThreadpool, to avoid
+  // oversubscribing the cores when several models run concurrently.
+  void* threadpool;
+  // Workspace for XNNPACK runtime memory, can be shared between multiple
+  // instances of delegates. Delegates sharing a workspace serialize their
+  // inferences. When NULL, each delegate creates a private workspace.
+  struct TfLiteXNNPackDelegateWorkspace* workspace;
+  // With TFLITE_XNNPACK_DELEGATE_FLAG_ENABLE_SUBGRAPH_RESHAPING, maximum number
+  // of input shapes for which every delegated partition keeps a reshaped
+  // XNNPACK runtime. Going back to a recently used input shape then only
+  // rebinds the input and output tensors instead of reshaping every operator.
+  // Each runtime holds its own packed weights unless a weights cache is used.
+  // 0 or 1 keeps a single runtime, reshaped on every input shape change.
+  int32_t max_cached_input_shapes;
+  // With TFLITE_XNNPACK_DELEGATE_FLAG_COST_MODEL_PARTITIONING, path to a
+  // calibration table for the partition cost model, read when the delegate is
+  // created. See tflite::delegates::PartitionCostModel for the format. When
+  // NULL, the default costs are used.
+  const char* partition_cost_table;
+  // Directory in which the packed weights of the model identified by
+  // model_token are stored, so that later delegate instances, including in
+  // other processes, map them instead of packing the weights again. Both must
+  // be set, and weights_cache must be NULL. The weights are then always packed
+  // when the graph is delegated, and the file is written on the first invoke.
+  // The delegate instance must only be applied to this model. Not used with
+  // FP16 inference. See tflite::delegates::Serialization.
+  const char* serialization_dir;
+  const char* model_token;
 } TfLiteXNNPackDelegateOptions;
 
 // Returns a structure with the default XNNPack delegate options.
@@ -86,7 +146,8 @@ TFL_CAPI_EXPORT TfLiteDelegate* TfLiteXNNPackDelegateCreate(
 
 // Performs the same task as TfLiteXNNPackDelegateCreate, with one exception.
 // If the context passed contains a non-null xnnpack_threadpool field,
-// we will use it as the threadpool for the delegate created.
+// we will use it as the threadpool for the delegate created. The threadpool
+// field of `options` takes precedence over the one in the context.
 TfLiteDelegate* TfLiteXNNPackDelegateCreateWithThreadpool(
     const TfLiteXNNPackDelegateOptions* options, TfLiteContext* context);
 
@@ -137,6 +198,15 @@ TFL_CAPI_EXPORT bool TfLiteXNNPackDelegateWeightsCacheFinalizeHard(
 TFL_CAPI_EXPORT void TfLiteXNNPackDelegateWeightsCacheDelete(
     struct TfLiteXNNPackDelegateWeightsCache* cache);
 
+// Creates a new workspace that can be shared with multiple delegate instances.
+// The workspace must outlive every delegate using it.
+TFL_CAPI_EXPORT struct TfLiteXNNPackDelegateWorkspace*
+TfLiteXNNPackDelegateWorkspaceCreate();
+// Destroys a workspace created with `TfLiteXNNPackDelegateWorkspaceCreate`
+// call.
+TFL_CAPI_EXPORT void TfLiteXNNPackDelegateWorkspaceDelete(
+    struct TfLiteXNNPackDelegateWorkspace* workspace);
+
 #ifdef __cplusplus
 }
 #endif  // __cplusplus
@@ -23,4 +23,14 @@ limitations under the License.
 // to an XNNPACK delegate, or from the 'data' field of a TfLiteDelegate* that
 // refers to an XNNPACK delegate.
 TfLiteXNNPackDelegateOptions GetOptions(const void* delegate_data);
+
+// These test only functions have the same precondition as GetOptions.
+// Returns the number of delegated partitions which have packed their weights.
+int GetNumPackedPartitions(const void* delegate_data);
+// Returns whether the delegate maps its packed weights from the serialized
+// weights file, whether loaded or written by the first invoke.
+bool IsWeightCacheMapped(const void* delegate_data);
+// Waits until TFLITE_XNNPACK_DELEGATE_FLAG_BACKGROUND_WEIGHT_PACKING has
+// packed the weights of all the partitions queued so far.
+void WaitForWeightPacking(void* delegate_data);
 #endif  // TENSORFLOW_LITE_DELEGATES_XNNPACK_XNNPACK_DELEGATE_TEST_H_
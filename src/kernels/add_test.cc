@@ -928,6 +928,37 @@ TEST(QuantizedAddOpModel, Uint8QuantizedMultiDimBroadcastSubshard9) {
   TestQuantizedMultiDimBroadcast<uint8_t>(9, kMultiDimBroadcastSubshardCount);
 }
 
+TEST(QuantizedAddOpModel, Int16QuantizedMultiDimBroadcastSubshard0) {
+  TestQuantizedMultiDimBroadcast<int16_t>(0, kMultiDimBroadcastSubshardCount);
+}
+TEST(QuantizedAddOpModel, Int16QuantizedMultiDimBroadcastSubshard1) {
+  TestQuantizedMultiDimBroadcast<int16_t>(1, kMultiDimBroadcastSubshardCount);
+}
+TEST(QuantizedAddOpModel, Int16QuantizedMultiDimBroadcastSubshard2) {
+  TestQuantizedMultiDimBroadcast<int16_t>(2, kMultiDimBroadcastSubshardCount);
+}
+TEST(QuantizedAddOpModel, Int16QuantizedMultiDimBroadcastSubshard3) {
+  TestQuantizedMultiDimBroadcast<int16_t>(3, kMultiDimBroadcastSubshardCount);
+}
+TEST(QuantizedAddOpModel, Int16QuantizedMultiDimBroadcastSubshard4) {
+  TestQuantizedMultiDimBroadcast<int16_t>(4, kMultiDimBroadcastSubshardCount);
+}
+TEST(QuantizedAddOpModel, Int16QuantizedMultiDimBroadcastSubshard5) {
+  TestQuantizedMultiDimBroadcast<int16_t>(5, kMultiDimBroadcastSubshardCount);
+}
+TEST(QuantizedAddOpModel, Int16QuantizedMultiDimBroadcastSubshard6) {
+  TestQuantizedMultiDimBroadcast<int16_t>(6, kMultiDimBroadcastSubshardCount);
+}
+TEST(QuantizedAddOpModel, Int16QuantizedMultiDimBroadcastSubshard7) {
+  TestQuantizedMultiDimBroadcast<int16_t>(7, kMultiDimBroadcastSubshardCount);
+}
+TEST(QuantizedAddOpModel, Int16QuantizedMultiDimBroadcastSubshard8) {
+  TestQuantizedMultiDimBroadcast<int16_t>(8, kMultiDimBroadcastSubshardCount);
+}
+TEST(QuantizedAddOpModel, Int16QuantizedMultiDimBroadcastSubshard9) {
+  TestQuantizedMultiDimBroadcast<int16_t>(9, kMultiDimBroadcastSubshardCount);
+}
+
 template <TensorType tensor_type, typename integer_dtype>
 void QuantizedTestsNoActivation() {
   float kQuantizedTolerance = GetTolerance<integer_dtype>(-1.0, 1.0);
@@ -14,6 +14,7 @@ limitations under the License.
 ==============================================================================*/
 #include <cstddef>
 #include <cstdint>
+#include <vector>
 
 #include "core/c/builtin_op_data.h"
 #include "core/c/common.h"
@@ -31,6 +32,12 @@ namespace {
 struct OpData {
   int scratch_tensor_index;
   bool compute_row_sums = false;
+  // Float input and recurrent weights packed as [W R] by
+  // kernel_utils::PackRnnWeights. Only populated when both weights are
+  // constant, in which case Eval runs the fused per-timestep kernel.
+  std::vector<float> packed_weights;
+  // Scratch for the concatenated [input hidden_state] fed to the fused kernel.
+  std::vector<float> concat_scratch;
 };
 
 }  // namespace
@@ -106,10 +113,23 @@ TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node) {
 
   const bool is_hybrid = IsHybridOp(input, input_weights);
 
+  auto* op_data = reinterpret_cast<OpData*>(node->user_data);
+  op_data->packed_weights.clear();
+  op_data->concat_scratch.clear();
+  if (!is_hybrid && IsConstantTensor(input_weights) &&
+      IsConstantTensor(recurrent_weights)) {
+    const int input_size = input->dims->data[1];
+    op_data->packed_weights.resize(num_units * (input_size + num_units));
+    kernel_utils::PackRnnWeights(GetTensorData<float>(input_weights),
+                                 GetTensorData<float>(recurrent_weights),
+                                 input_size, num_units,
+                                 op_data->packed_weights.data());
+    op_data->concat_scratch.resize(batch_size * (input_size + num_units));
+  }
+
   // Allocate temporary tensors to store quantized values of input and
   // hidden_state tensors.
   if (is_hybrid) {
-    auto* op_data = reinterpret_cast<OpData*>(node->user_data);
     op_data->compute_row_sums = true;
     TfLiteIntArrayFree(node->temporaries);
     node->temporaries = TfLiteIntArrayCreate(6);
@@ -202,7 +222,8 @@ TfLiteStatus EvalFloat(const TfLiteTensor* input,
                        const TfLiteTensor* input_weights,
                        const TfLiteTensor* recurrent_weights,
                        const TfLiteTensor* bias, const TfLiteRNNParams* params,
-                       TfLiteTensor* hidden_state, TfLiteTensor* output) {
+                       OpData* op_data, TfLiteTensor* hidden_state,
+                       TfLiteTensor* output) {
   const int batch_size = input->dims->data[0];
   const int num_units = input_weights->dims->data[0];
   const int input_size = input->dims->data[1];
@@ -219,6 +240,15 @@ TfLiteStatus EvalFloat(const TfLiteTensor* input,
   const float* recurrent_weights_ptr = GetTensorData<float>(recurrent_weights);
   const float* bias_ptr = GetTensorData<float>(bias);
 
+  if (!op_data->packed_weights.empty()) {
+    kernel_utils::FusedRnnBatchStep(
+        input_ptr_batch, op_data->packed_weights.data(), bias_ptr, input_size,
+        num_units, batch_size, output_batch_leading_dim, params->activation,
+        op_data->concat_scratch.data(), hidden_state_ptr_batch,
+        output_ptr_batch);
+    return kTfLiteOk;
+  }
+
   kernel_utils::RnnBatchStep(
       input_ptr_batch, input_weights_ptr, recurrent_weights_ptr, bias_ptr,
       input_size, num_units, batch_size, output_batch_leading_dim,
@@ -303,7 +333,7 @@ TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
   switch (input_weights->type) {
     case kTfLiteFloat32:
       return EvalFloat(input, input_weights, recurrent_weights, bias, params,
-                       hidden_state, output);
+                       op_data, hidden_state, output);
     case kTfLiteUInt8:
     case kTfLiteInt8: {
       // TODO(mirkov): implement eval with quantized inputs as well.
@@ -229,6 +229,52 @@ class RNNOpModel : public SingleOpModel {
   int input_size_;
 };
 
+// Same as RNNOpModel, but with constant weights and recurrent_weights, which
+// are packed once in Prepare and run through the fused kernel.
+class ConstWeightsRNNOpModel : public SingleOpModel {
+ public:
+  ConstWeightsRNNOpModel(int batches, int units, int size,
+                         std::initializer_list<float> weights,
+                         std::initializer_list<float> recurrent_weights)
+      : batches_(batches), units_(units), input_size_(size) {
+    input_ = AddInput({TensorType_FLOAT32, {batches_, input_size_}});
+    AddConstInput(TensorType_FLOAT32, weights, {units_, input_size_});
+    AddConstInput(TensorType_FLOAT32, recurrent_weights, {units_, units_});
+    bias_ = AddInput({TensorType_FLOAT32, {units_}});
+    AddVariableInput({TensorType_FLOAT32, {batches_, units_}});
+    output_ = AddOutput(TensorType_FLOAT32);
+    SetBuiltinOp(
+        BuiltinOperator_RNN, BuiltinOptions_RNNOptions,
+        CreateRNNOptions(builder_, ActivationFunctionType_RELU).Union());
+    BuildInterpreter({GetShape(input_),      // input tensor
+                      {},                    // weights tensor
+                      {},                    // recurrent weights tensor
+                      GetShape(bias_),       // bias tensor
+                      {batches_, units_}});  // hidden state tensor
+  }
+
+  void SetBias(std::initializer_list<float> f) { PopulateTensor(bias_, f); }
+
+  void SetInput(int offset, float* begin, float* end) {
+    PopulateTensor(input_, offset, begin, end);
+  }
+
+  std::vector<float> GetOutput() { return ExtractVector<float>(output_); }
+
+  int input_size() { return input_size_; }
+  int num_units() { return units_; }
+  int num_batches() { return batches_; }
+
+ private:
+  int input_;
+  int bias_;
+  int output_;
+
+  int batches_;
+  int units_;
+  int input_size_;
+};
+
 // The hybrid model has quantized weights and recurrent_weights.
 class HybridRNNOpModel : public RNNOpModel {
  public:
@@ -283,6 +329,31 @@ TEST(RnnOpTest, BlackBoxTest) {
   }
 }
 
+TEST(RnnOpTest, ConstantWeightsBlackBoxTest) {
+  ConstWeightsRNNOpModel rnn(2, 16, 8, rnn_weights, rnn_recurrent_weights);
+  rnn.SetBias(rnn_bias);
+
+  const int input_sequence_size = sizeof(rnn_input) / sizeof(float) /
+                                  (rnn.input_size() * rnn.num_batches());
+
+  for (int i = 0; i < input_sequence_size; i++) {
+    float* batch_start = rnn_input + i * rnn.input_size();
+    float* batch_end = batch_start + rnn.input_size();
+    rnn.SetInput(0, batch_start, batch_end);
+    rnn.SetInput(rnn.input_size(), batch_start, batch_end);
+
+    ASSERT_EQ(rnn.Invoke(), kTfLiteOk);
+
+    float* golden_start = rnn_golden_output + i * rnn.num_units();
+    float* golden_end = golden_start + rnn.num_units();
+    std::vector<float> expected;
+    expected.insert(expected.end(), golden_start, golden_end);
+    expected.insert(expected.end(), golden_start, golden_end);
+
+    EXPECT_THAT(rnn.GetOutput(), ElementsAreArray(ArrayFloatNear(expected)));
+  }
+}
+
 class HybridRnnOpTest : public ::testing::TestWithParam<bool> {};
 
 TEST_P(HybridRnnOpTest, BlackBoxTestUint8) {
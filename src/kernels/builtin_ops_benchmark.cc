@@ -0,0 +1,578 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// Microbenchmarks of the builtin kernels across representative shapes, data
+// types, thread counts and kernel variants, i.e. the reference kernels, the
+// generic optimized kernels and the XNNPACK delegate. Each benchmark is named
+// <op>/<shape>/<data type>/<variant>/threads:<n>, e.g.
+//
+//   builtin_ops_benchmark --benchmark_filter='CONV_2D/.*/int8/' \
+//     --benchmark_out=conv.json --benchmark_out_format=json
+//
+// runs the int8 convolutions and writes the results as JSON for regression
+// tracking. Besides the time per invocation, each benchmark reports the FLOP
+// rate and the bytes processed as estimated by profiling/node_cost.h.
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "benchmark/benchmark.h"  // from @com_google_benchmark
+#include "core/c/common.h"
+#ifndef TFLITE_WITHOUT_XNNPACK
+#include "delegates/xnnpack/xnnpack_delegate.h"
+#endif  // TFLITE_WITHOUT_XNNPACK
+#include "kernels/test_util.h"
+#include "profiling/node_cost.h"
+#include "schema/schema_generated.h"
+
+namespace tflite {
+namespace ops {
+namespace builtin {
+
+TfLiteRegistration* Register_ADD_REF();
+TfLiteRegistration* Register_ADD_GENERIC_OPT();
+TfLiteRegistration* Register_AVERAGE_POOL_REF();
+TfLiteRegistration* Register_AVERAGE_POOL_GENERIC_OPT();
+TfLiteRegistration* Register_CONVOLUTION_REF();
+TfLiteRegistration* Register_CONVOLUTION_GENERIC_OPT();
+TfLiteRegistration* Register_DEPTHWISE_CONVOLUTION_REF();
+TfLiteRegistration* Register_DEPTHWISE_CONVOLUTION_GENERIC_OPT();
+TfLiteRegistration* Register_FULLY_CONNECTED_REF();
+TfLiteRegistration* Register_FULLY_CONNECTED_GENERIC_OPT();
+TfLiteRegistration* Register_MAX_POOL_REF();
+TfLiteRegistration* Register_MAX_POOL_GENERIC_OPT();
+TfLiteRegistration* Register_MEAN_REF();
+TfLiteRegistration* Register_MEAN_OPT();
+TfLiteRegistration* Register_MUL_REF();
+TfLiteRegistration* Register_MUL_GENERIC_OPT();
+TfLiteRegistration* Register_SOFTMAX_REF();
+TfLiteRegistration* Register_SOFTMAX();
+TfLiteRegistration* Register_TRANSPOSE_REF();
+TfLiteRegistration* Register_TRANSPOSE_GENERIC_OPTIMIZED();
+
+}  // namespace builtin
+}  // namespace ops
+
+namespace {
+
+using ops::builtin::Register_ADD_GENERIC_OPT;
+using ops::builtin::Register_ADD_REF;
+using ops::builtin::Register_AVERAGE_POOL_GENERIC_OPT;
+using ops::builtin::Register_AVERAGE_POOL_REF;
+using ops::builtin::Register_CONVOLUTION_GENERIC_OPT;
+using ops::builtin::Register_CONVOLUTION_REF;
+using ops::builtin::Register_DEPTHWISE_CONVOLUTION_GENERIC_OPT;
+using ops::builtin::Register_DEPTHWISE_CONVOLUTION_REF;
+using ops::builtin::Register_FULLY_CONNECTED_GENERIC_OPT;
+using ops::builtin::Register_FULLY_CONNECTED_REF;
+using ops::builtin::Register_MAX_POOL_GENERIC_OPT;
+using ops::builtin::Register_MAX_POOL_REF;
+using ops::builtin::Register_MEAN_OPT;
+using ops::builtin::Register_MEAN_REF;
+using ops::builtin::Register_MUL_GENERIC_OPT;
+using ops::builtin::Register_MUL_REF;
+using ops::builtin::Register_SOFTMAX;
+using ops::builtin::Register_SOFTMAX_REF;
+using ops::builtin::Register_TRANSPOSE_GENERIC_OPTIMIZED;
+using ops::builtin::Register_TRANSPOSE_REF;
+
+enum class KernelVariant { kReference, kGenericOptimized, kXnnpack };
+
+// The data type of the activations. The weights of the quantized types are
+// int8, i.e. int16 benchmarks the 16x8 kernels. float16 graphs are float32
+// graphs run by XNNPACK in half precision, as the builtin kernels have no
+// float16 arithmetic.
+enum class DataType { kFloat32, kFloat16, kInt8, kInt16 };
+
+const char* ToString(KernelVariant variant) {
+  switch (variant) {
+    case KernelVariant::kReference:
+      return "reference";
+    case KernelVariant::kGenericOptimized:
+      return "generic_optimized";
+    case KernelVariant::kXnnpack:
+      return "xnnpack";
+  }
+  return "unknown";
+}
+
+const char* ToString(DataType type) {
+  switch (type) {
+    case DataType::kFloat32:
+      return "float32";
+    case DataType::kFloat16:
+      return "float16";
+    case DataType::kInt8:
+      return "int8";
+    case DataType::kInt16:
+      return "int16";
+  }
+  return "unknown";
+}
+
+std::string ToString(const std::vector<int>& shape) {
+  std::string result;
+  for (const int dim : shape) {
+    if (!result.empty()) result += "x";
+    result += std::to_string(dim);
+  }
+  return result;
+}
+
+// The quantization of a tensor, ignored for float tensors. The benchmarks only
+// need the scales to keep the requantization multipliers of the kernels in
+// their supported range, not to be accurate.
+struct Quantization {
+  float scale;
+  int32_t zero_point;
+};
+
+// A model of a single builtin op whose activations are filled with random
+// values.
+class KernelBenchmarkModel : public SingleOpModel {
+ public:
+  explicit KernelBenchmarkModel(DataType type) : type_(type) {}
+
+  DataType type() const { return type_; }
+  flatbuffers::FlatBufferBuilder& builder() { return builder_; }
+
+  // The quantization of activations, in [-2, 2].
+  Quantization ActivationQuantization() const {
+    switch (type_) {
+      case DataType::kInt8:
+        return {1.0f / 64, 0};
+      case DataType::kInt16:
+        return {1.0f / 16384, 0};
+      default:
+        return {0.0f, 0};
+    }
+  }
+
+  // The quantization of outputs summing products of activations and weights,
+  // e.g. of convolutions.
+  Quantization AccumulatorQuantization() const {
+    switch (type_) {
+      case DataType::kInt8:
+        return {1.0f / 4, 0};
+      case DataType::kInt16:
+        return {1.0f / 1024, 0};
+      default:
+        return {0.0f, 0};
+    }
+  }
+
+  // The quantization of probabilities, as required by SOFTMAX.
+  Quantization ProbabilityQuantization() const {
+    switch (type_) {
+      case DataType::kInt8:
+        return {1.0f / 256, -128};
+      case DataType::kInt16:
+        return {1.0f / 32768, 0};
+      default:
+        return {0.0f, 0};
+    }
+  }
+
+  int AddActivation(const std::vector<int>& shape) {
+    const Quantization quantization = ActivationQuantization();
+    const int id = AddInput(TensorData(TensorTypeOf(), shape, 0.0f, 0.0f,
+                                       quantization.scale,
+                                       quantization.zero_point));
+    activations_.push_back(id);
+    return id;
+  }
+
+  // Adds constant weights with random values, int8 for the quantized types.
+  int AddWeights(const std::vector<int>& shape) {
+    int size = 1;
+    for (const int dim : shape) size *= dim;
+    if (type_ == DataType::kFloat32 || type_ == DataType::kFloat16) {
+      std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+      std::vector<float> data(size);
+      for (auto& value : data) value = distribution(engine_);
+      return AddConstInput(TensorData(TensorType_FLOAT32, shape), data);
+    }
+    std::uniform_int_distribution<int> distribution(-127, 127);
+    std::vector<int8_t> data(size);
+    for (auto& value : data) value = distribution(engine_);
+    return AddConstInput(
+        TensorData(TensorType_INT8, shape, 0.0f, 0.0f, 1.0f / 128, 0), data);
+  }
+
+  int AddResult(const Quantization& quantization) {
+    return AddOutput(TensorData(TensorTypeOf(), {}, 0.0f, 0.0f,
+                                quantization.scale, quantization.zero_point));
+  }
+
+  // Fills the activations with random values.
+  void RandomizeActivations() {
+    for (const int id : activations_) {
+      TfLiteTensor* tensor = interpreter_->tensor(id);
+      const int size = GetTensorSize(id);
+      switch (tensor->type) {
+        case kTfLiteFloat32: {
+          std::uniform_real_distribution<float> distribution(-2.0f, 2.0f);
+          for (int i = 0; i < size; ++i) {
+            tensor->data.f[i] = distribution(engine_);
+          }
+          break;
+        }
+        case kTfLiteInt8: {
+          std::uniform_int_distribution<int> distribution(-128, 127);
+          for (int i = 0; i < size; ++i) {
+            tensor->data.int8[i] = distribution(engine_);
+          }
+          break;
+        }
+        case kTfLiteInt16: {
+          std::uniform_int_distribution<int> distribution(-32768, 32767);
+          for (int i = 0; i < size; ++i) {
+            tensor->data.i16[i] = distribution(engine_);
+          }
+          break;
+        }
+        default:
+          break;
+      }
+    }
+  }
+
+  profiling::NodeCost Cost() const {
+    return profiling::EstimateNodeCost(interpreter_->primary_subgraph(),
+                                       /*node_index=*/0);
+  }
+
+ private:
+  TensorType TensorTypeOf() const {
+    switch (type_) {
+      case DataType::kInt8:
+        return TensorType_INT8;
+      case DataType::kInt16:
+        return TensorType_INT16;
+      default:
+        return TensorType_FLOAT32;
+    }
+  }
+
+  const DataType type_;
+  std::vector<int> activations_;
+  // A fixed seed so that data dependent kernels do the same work every run.
+  std::mt19937 engine_{42};
+};
+
+// One op with one configuration of its shapes and options.
+struct OpCase {
+  // E.g. "CONV_2D/1x56x56x64_k3s1_c64".
+  std::string name;
+  BuiltinOperator op;
+  TfLiteRegistration* (*reference)();
+  TfLiteRegistration* (*optimized)();
+  // Adds the tensors and the op to the model.
+  std::function<void(KernelBenchmarkModel*)> build;
+};
+
+std::vector<OpCase> CreateOpCases() {
+  std::vector<OpCase> cases;
+
+  struct ConvConfig {
+    std::vector<int> input;
+    int kernel_size;
+    int stride;
+    int output_channels;
+  };
+  for (const ConvConfig& config : std::vector<ConvConfig>{
+           {{1, 224, 224, 3}, 3, 2, 32},
+           {{1, 56, 56, 64}, 3, 1, 64},
+           {{1, 14, 14, 256}, 1, 1, 256}}) {
+    cases.push_back(
+        {"CONV_2D/" + ToString(config.input) + "_k" +
+             std::to_string(config.kernel_size) + "s" +
+             std::to_string(config.stride) + "_c" +
+             std::to_string(config.output_channels),
+         BuiltinOperator_CONV_2D, Register_CONVOLUTION_REF,
+         Register_CONVOLUTION_GENERIC_OPT, [config](KernelBenchmarkModel* m) {
+           m->AddActivation(config.input);
+           m->AddWeights({config.output_channels, config.kernel_size,
+                          config.kernel_size, config.input[3]});
+           m->AddResult(m->AccumulatorQuantization());
+           m->SetBuiltinOp(BuiltinOperator_CONV_2D,
+                           BuiltinOptions_Conv2DOptions,
+                           CreateConv2DOptions(m->builder(), Padding_SAME,
+                                               config.stride, config.stride)
+                               .Union());
+         }});
+  }
+
+  struct DepthwiseConvConfig {
+    std::vector<int> input;
+    int stride;
+  };
+  for (const DepthwiseConvConfig& config : std::vector<DepthwiseConvConfig>{
+           {{1, 112, 112, 32}, 1},
+           {{1, 56, 56, 128}, 2},
+           {{1, 14, 14, 512}, 1}}) {
+    cases.push_back(
+        {"DEPTHWISE_CONV_2D/" + ToString(config.input) + "_k3s" +
+             std::to_string(config.stride),
+         BuiltinOperator_DEPTHWISE_CONV_2D, Register_DEPTHWISE_CONVOLUTION_REF,
+         Register_DEPTHWISE_CONVOLUTION_GENERIC_OPT,
+         [config](KernelBenchmarkModel* m) {
+           m->AddActivation(config.input);
+           m->AddWeights({1, 3, 3, config.input[3]});
+           m->AddResult(m->AccumulatorQuantization());
+           m->SetBuiltinOp(
+               BuiltinOperator_DEPTHWISE_CONV_2D,
+               BuiltinOptions_DepthwiseConv2DOptions,
+               CreateDepthwiseConv2DOptions(m->builder(), Padding_SAME,
+                                            config.stride, config.stride,
+                                            /*depth_multiplier=*/1)
+                   .Union());
+         }});
+  }
+
+  struct FullyConnectedConfig {
+    int batch;
+    int input_size;
+    int output_size;
+  };
+  for (const FullyConnectedConfig& config : std::vector<FullyConnectedConfig>{
+           {1, 1024, 1000}, {8, 512, 512}, {128, 768, 768}}) {
+    cases.push_back(
+        {"FULLY_CONNECTED/" + ToString({config.batch, config.input_size}) +
+             "_c" + std::to_string(config.output_size),
+         BuiltinOperator_FULLY_CONNECTED, Register_FULLY_CONNECTED_REF,
+         Register_FULLY_CONNECTED_GENERIC_OPT,
+         [config](KernelBenchmarkModel* m) {
+           m->AddActivation({config.batch, config.input_size});
+           m->AddWeights({config.output_size, config.input_size});
+           m->AddResult(m->AccumulatorQuantization());
+           m->SetBuiltinOp(BuiltinOperator_FULLY_CONNECTED,
+                           BuiltinOptions_FullyConnectedOptions,
+                           CreateFullyConnectedOptions(m->builder()).Union());
+         }});
+  }
+
+  // Elementwise ops, with and without broadcasting.
+  for (const auto& shapes : std::vector<std::pair<std::vector<int>,
+                                                  std::vector<int>>>{
+           {{1, 56, 56, 64}, {1, 56, 56, 64}},
+           {{1, 56, 56, 64}, {1, 1, 1, 64}}}) {
+    const std::string name = ToString(shapes.first) + "_" +
+                             ToString(shapes.second);
+    cases.push_back({"ADD/" + name, BuiltinOperator_ADD, Register_ADD_REF,
+                     Register_ADD_GENERIC_OPT,
+                     [shapes](KernelBenchmarkModel* m) {
+                       m->AddActivation(shapes.first);
+                       m->AddActivation(shapes.second);
+                       m->AddResult(m->ActivationQuantization());
+                       m->SetBuiltinOp(BuiltinOperator_ADD,
+                                       BuiltinOptions_AddOptions,
+                                       CreateAddOptions(m->builder()).Union());
+                     }});
+    cases.push_back({"MUL/" + name, BuiltinOperator_MUL, Register_MUL_REF,
+                     Register_MUL_GENERIC_OPT,
+                     [shapes](KernelBenchmarkModel* m) {
+                       m->AddActivation(shapes.first);
+                       m->AddActivation(shapes.second);
+                       m->AddResult(m->ActivationQuantization());
+                       m->SetBuiltinOp(BuiltinOperator_MUL,
+                                       BuiltinOptions_MulOptions,
+                                       CreateMulOptions(m->builder()).Union());
+                     }});
+  }
+
+  struct PoolConfig {
+    std::vector<int> input;
+    int filter_size;
+    int stride;
+  };
+  for (const PoolConfig& config : std::vector<PoolConfig>{
+           {{1, 112, 112, 64}, 3, 2}, {{1, 7, 7, 1024}, 7, 1}}) {
+    const std::string name = ToString(config.input) + "_k" +
+                             std::to_string(config.filter_size) + "s" +
+                             std::to_string(config.stride);
+    auto build = [config](BuiltinOperator op) {
+      return [config, op](KernelBenchmarkModel* m) {
+        m->AddActivation(config.input);
+        // Pooling requires the same quantization for the input and output.
+        m->AddResult(m->ActivationQuantization());
+        m->SetBuiltinOp(
+            op, BuiltinOptions_Pool2DOptions,
+            CreatePool2DOptions(m->builder(), Padding_VALID, config.stride,
+                                config.stride, config.filter_size,
+                                config.filter_size)
+                .Union());
+      };
+    };
+    cases.push_back({"AVERAGE_POOL_2D/" + name, BuiltinOperator_AVERAGE_POOL_2D,
+                     Register_AVERAGE_POOL_REF,
+                     Register_AVERAGE_POOL_GENERIC_OPT,
+                     build(BuiltinOperator_AVERAGE_POOL_2D)});
+    cases.push_back({"MAX_POOL_2D/" + name, BuiltinOperator_MAX_POOL_2D,
+                     Register_MAX_POOL_REF, Register_MAX_POOL_GENERIC_OPT,
+                     build(BuiltinOperator_MAX_POOL_2D)});
+  }
+
+  for (const std::vector<int>& input :
+       std::vector<std::vector<int>>{{1, 1000}, {1, 8, 128, 128}}) {
+    cases.push_back(
+        {"SOFTMAX/" + ToString(input), BuiltinOperator_SOFTMAX,
+         Register_SOFTMAX_REF, Register_SOFTMAX,
+         [input](KernelBenchmarkModel* m) {
+           m->AddActivation(input);
+           m->AddResult(m->ProbabilityQuantization());
+           m->SetBuiltinOp(BuiltinOperator_SOFTMAX,
+                           BuiltinOptions_SoftmaxOptions,
+                           CreateSoftmaxOptions(m->builder(), 1.0f).Union());
+         }});
+  }
+
+  // Spatial means, e.g. the global pooling at the end of CNNs.
+  for (const std::vector<int>& input :
+       std::vector<std::vector<int>>{{1, 7, 7, 1024}, {1, 56, 56, 64}}) {
+    cases.push_back(
+        {"MEAN/" + ToString(input) + "_axis1,2", BuiltinOperator_MEAN,
+         Register_MEAN_REF, Register_MEAN_OPT,
+         [input](KernelBenchmarkModel* m) {
+           m->AddActivation(input);
+           m->AddConstInput(TensorType_INT32, {1, 2}, {2});
+           m->AddResult(m->ActivationQuantization());
+           m->SetBuiltinOp(
+               BuiltinOperator_MEAN, BuiltinOptions_ReducerOptions,
+               CreateReducerOptions(m->builder(), /*keep_dims=*/true).Union());
+         }});
+  }
+
+  for (const auto& config :
+       std::vector<std::pair<std::vector<int>, std::vector<int>>>{
+           {{1, 56, 56, 64}, {0, 3, 1, 2}}, {{1, 128, 12, 64}, {0, 2, 1, 3}}}) {
+    cases.push_back(
+        {"TRANSPOSE/" + ToString(config.first) + "_perm" +
+             ToString(config.second),
+         BuiltinOperator_TRANSPOSE, Register_TRANSPOSE_REF,
+         Register_TRANSPOSE_GENERIC_OPTIMIZED,
+         [config](KernelBenchmarkModel* m) {
+           m->AddActivation(config.first);
+           m->AddConstInput(TensorType_INT32, config.second,
+                            {static_cast<int>(config.second.size())});
+           m->AddResult(m->ActivationQuantization());
+           m->SetBuiltinOp(BuiltinOperator_TRANSPOSE,
+                           BuiltinOptions_TransposeOptions,
+                           CreateTransposeOptions(m->builder()).Union());
+         }});
+  }
+
+  return cases;
+}
+
+void BM_Kernel(benchmark::State& state, const OpCase& op_case, DataType type,
+               KernelVariant variant) {
+  const int num_threads = state.range(0);
+
+  // The delegate must outlive the interpreter of the model.
+  std::unique_ptr<TfLiteDelegate, void (*)(TfLiteDelegate*)> delegate(
+      nullptr, [](TfLiteDelegate*) {});
+#ifndef TFLITE_WITHOUT_XNNPACK
+  if (variant == KernelVariant::kXnnpack) {
+    auto options = TfLiteXNNPackDelegateOptionsDefault();
+    options.num_threads = num_threads;
+    if (type == DataType::kFloat16) {
+      options.flags |= TFLITE_XNNPACK_DELEGATE_FLAG_FORCE_FP16;
+    }
+    delegate = std::unique_ptr<TfLiteDelegate, void (*)(TfLiteDelegate*)>(
+        TfLiteXNNPackDelegateCreate(&options), TfLiteXNNPackDelegateDelete);
+  }
+#endif  // TFLITE_WITHOUT_XNNPACK
+
+  KernelBenchmarkModel model(type);
+  op_case.build(&model);
+  model.SetResolver(std::make_unique<SingleOpResolver>(
+      op_case.op, variant == KernelVariant::kReference ? op_case.reference()
+                                                       : op_case.optimized()));
+  if (delegate != nullptr) model.SetDelegate(delegate.get());
+  model.BuildInterpreter(/*input_shapes=*/{}, num_threads,
+                         /*allow_fp32_relax_to_fp16=*/false,
+                         /*apply_delegate=*/true);
+  if (variant == KernelVariant::kXnnpack &&
+      model.CountOpsExecutedByCpuKernel() != 0) {
+    state.SkipWithError("The op isn't supported by XNNPACK.");
+    return;
+  }
+  model.RandomizeActivations();
+
+  bool invoke_ok = true;
+  for (auto _ : state) {
+    if (model.Invoke() != kTfLiteOk) {
+      state.SkipWithError("Invoke failed.");
+      invoke_ok = false;
+      break;
+    }
+  }
+  if (!invoke_ok) return;
+
+  const profiling::NodeCost cost = model.Cost();
+  state.counters["flops"] = benchmark::Counter(
+      cost.flops, benchmark::Counter::kIsIterationInvariantRate);
+  state.SetBytesProcessed(state.iterations() * cost.bytes);
+}
+
+void RegisterKernelBenchmarks() {
+  std::vector<std::pair<DataType, KernelVariant>> configs = {
+      {DataType::kFloat32, KernelVariant::kReference},
+      {DataType::kFloat32, KernelVariant::kGenericOptimized},
+      {DataType::kInt8, KernelVariant::kReference},
+      {DataType::kInt8, KernelVariant::kGenericOptimized},
+      {DataType::kInt16, KernelVariant::kReference},
+      {DataType::kInt16, KernelVariant::kGenericOptimized},
+  };
+#ifndef TFLITE_WITHOUT_XNNPACK
+  // XNNPACK has no int16 kernels, and float16 is XNNPACK only.
+  configs.push_back({DataType::kFloat32, KernelVariant::kXnnpack});
+  configs.push_back({DataType::kFloat16, KernelVariant::kXnnpack});
+  configs.push_back({DataType::kInt8, KernelVariant::kXnnpack});
+#endif  // TFLITE_WITHOUT_XNNPACK
+
+  for (const OpCase& op_case : CreateOpCases()) {
+    for (const auto& config : configs) {
+      const std::string name = op_case.name + "/" + ToString(config.first) +
+                               "/" + ToString(config.second);
+      benchmark::RegisterBenchmark(name.c_str(), BM_Kernel, op_case,
+                                   config.first, config.second)
+          ->ArgName("threads")
+          ->Arg(1)
+          ->Arg(2)
+          ->Arg(4)
+          // The kernels run on a thread pool, so the CPU time of the calling
+          // thread says little.
+          ->UseRealTime();
+    }
+  }
+}
+
+}  // namespace
+}  // namespace tflite
+
+int main(int argc, char** argv) {
+  tflite::RegisterKernelBenchmarks();
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+  benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
@@ -38,6 +38,7 @@ limitations under the License.
 #include "kernels/internal/optimized/multithreaded_conv.h"
 #endif
 #include "kernels/internal/optimized/optimized_ops.h"
+#include "kernels/internal/optimized/sparse_ops/block_sparse_gemm.h"
 #include "kernels/internal/quantization_util.h"
 #include "kernels/internal/reference/conv.h"
 #include "kernels/internal/reference/integer_ops/conv.h"
@@ -123,6 +124,10 @@ struct OpData {
   int32_t groups = 1;
 
   TfLiteType quantized_bias_type = kTfLiteNoType;
+  // The int64 bias of a 16x8 op narrowed to int32 for the optimized kernels,
+  // set in Prepare if the int32 accumulators can't overflow.
+  std::vector<int32_t> bias_int32;
+  bool use_bias_int32 = false;
 };
 
 inline PaddingType RuntimePaddingType(TfLitePadding padding) {
@@ -179,6 +184,8 @@ bool IsIm2ColRequired(const TfLiteTensor* input, TfLiteConvParams* params,
                       KernelType kernel_type) {
   // If HWCN weights are required, Im2Col not required
   if (data->need_hwcn_weights) return false;
+  // Sparse filters are 1x1 with unit stride and run as a fully connected layer.
+  if (filter->sparsity != nullptr) return false;
 
   // segregate based on dilated conv & non-dialated conv
   const bool need_dilated_im2col =
@@ -407,6 +414,15 @@ TfLiteStatus Prepare(KernelType kernel_type, TfLiteContext* context,
                                   bias->type == params->quantized_bias_type);
       data->quantized_bias_type = params->quantized_bias_type;
     }
+    // The optimized kernels accumulate in int32, so they take a constant
+    // int64 bias only if it can be narrowed w/o overflowing the accumulators.
+    data->use_bias_int32 = false;
+    if (kernel_type != kReference && bias && bias->type == kTfLiteInt64 &&
+        IsConstantTensor(bias) && IsConstantTensor(filter)) {
+      data->bias_int32.resize(NumElements(bias));
+      data->use_bias_int32 =
+          NarrowInt64BiasToInt32(bias, filter, data->bias_int32.data());
+    }
   }
 
   const bool is_hybrid =
@@ -432,6 +448,22 @@ TfLiteStatus Prepare(KernelType kernel_type, TfLiteContext* context,
     }
   }
 
+  // Sparse filters run through the block sparse GEMM, which treats a 1x1,
+  // unit stride convolution as a fully connected layer over the pixels.
+  if (filter->sparsity != nullptr) {
+    TF_LITE_ENSURE_MSG(
+        context,
+        (input_type == kTfLiteFloat32 && filter->type == kTfLiteFloat32) ||
+            (input_type == kTfLiteInt8 && filter->type == kTfLiteInt8),
+        "Sparse convolution supports float32 and int8 only.");
+    TF_LITE_ENSURE_MSG(
+        context,
+        filter->dims->data[1] == 1 && filter->dims->data[2] == 1 &&
+            params->stride_height == 1 && params->stride_width == 1 &&
+            data->groups == 1,
+        "Sparse convolution supports 1x1 filters with unit stride only.");
+  }
+
   // The multi-threaded kernel supports neither dilation nor hybrid kernels, and
   // is incompatible with mutable input filters that might change between evals.
   data->supports_multithreaded_kernel =
@@ -439,7 +471,8 @@ TfLiteStatus Prepare(KernelType kernel_type, TfLiteContext* context,
       (context->recommended_num_threads != 1) && !is_hybrid &&
       (params->dilation_width_factor == 1) &&
       (params->dilation_height_factor == 1) &&
-      (filter->allocation_type != kTfLiteArenaRw) && !IsDynamicTensor(filter);
+      (filter->allocation_type != kTfLiteArenaRw) && !IsDynamicTensor(filter) &&
+      filter->sparsity == nullptr;
 
   int channels_in = filter->dims->data[3];
   int channels_out = filter->dims->data[0];
@@ -867,31 +900,34 @@ void EvalQuantizedPerChannel16x8(TfLiteContext* context, TfLiteNode* node,
   bool has_non_zero_point = input->params.zero_point ||
                             filter->params.zero_point ||
                             output->params.zero_point;
+  if (has_non_zero_point) {
+    effective_kernel_type = kReference;
+  }
 
-  if (data->quantized_bias_type == kTfLiteInt32) {
-    if (effective_kernel_type == kReference || has_non_zero_point) {
-      reference_integer_ops::ConvPerChannel(
-          op_params, data->per_channel_output_multiplier.data(),
-          data->per_channel_output_shift.data(), GetTensorShape(input),
-          GetTensorData<int16>(input), GetTensorShape(filter),
-          GetTensorData<int8>(filter), GetTensorShape(bias),
-          GetTensorData<int32_t>(bias), GetTensorShape(output),
-          GetTensorData<int16>(output));
+  // The optimized kernel accumulates in int32, so it takes the int64 bias
+  // narrowed to int32 in Prepare. Models whose accumulators actually need the
+  // wider range keep using the reference kernel.
+  const int32_t* bias_int32 = nullptr;
+  if (bias != nullptr && bias->type == kTfLiteInt64) {
+    if (data->use_bias_int32) {
+      bias_int32 = data->bias_int32.data();
     } else {
-      optimized_integer_ops::ConvPerChannel(
-          op_params, data->per_channel_output_multiplier.data(),
-          data->per_channel_output_shift.data(), GetTensorShape(input),
-          GetTensorData<int16_t>(input), GetTensorShape(filter),
-          GetTensorData<int8_t>(filter), GetTensorShape(bias),
-          GetTensorData<int32_t>(bias), GetTensorShape(output),
-          GetTensorData<int16_t>(output), GetTensorShape(im2col),
-          GetTensorData<int16_t>(im2col),
-          CpuBackendContext::GetFromContext(context));
+      effective_kernel_type = kReference;
     }
   } else {
-    TFLITE_DCHECK(!has_non_zero_point);
-    // Fallback to reference kernel when bias_type is int64 as
-    // there is no optimized kernel for int64 bias yet.
+    bias_int32 = GetTensorData<int32_t>(bias);
+  }
+
+  if (effective_kernel_type != kReference) {
+    optimized_integer_ops::ConvPerChannel(
+        op_params, data->per_channel_output_multiplier.data(),
+        data->per_channel_output_shift.data(), GetTensorShape(input),
+        GetTensorData<int16_t>(input), GetTensorShape(filter),
+        GetTensorData<int8_t>(filter), GetTensorShape(bias), bias_int32,
+        GetTensorShape(output), GetTensorData<int16_t>(output),
+        GetTensorShape(im2col), GetTensorData<int16_t>(im2col),
+        CpuBackendContext::GetFromContext(context));
+  } else if (bias != nullptr && bias->type == kTfLiteInt64) {
     reference_integer_ops::ConvPerChannel(
         op_params, data->per_channel_output_multiplier.data(),
         data->per_channel_output_shift.data(), GetTensorShape(input),
@@ -899,6 +935,14 @@ void EvalQuantizedPerChannel16x8(TfLiteContext* context, TfLiteNode* node,
         GetTensorData<int8>(filter), GetTensorShape(bias),
         GetTensorData<int64_t>(bias), GetTensorShape(output),
         GetTensorData<int16>(output));
+  } else {
+    reference_integer_ops::ConvPerChannel(
+        op_params, data->per_channel_output_multiplier.data(),
+        data->per_channel_output_shift.data(), GetTensorShape(input),
+        GetTensorData<int16>(input), GetTensorShape(filter),
+        GetTensorData<int8>(filter), GetTensorShape(bias),
+        GetTensorData<int32_t>(bias), GetTensorShape(output),
+        GetTensorData<int16>(output));
   }
 }
 
@@ -1190,6 +1234,47 @@ TfLiteStatus EvalHybrid(TfLiteContext* context, TfLiteNode* node,
   return kTfLiteOk;
 }
 
+// Runs a 1x1, unit stride convolution with a sparse filter as a fully
+// connected layer over the output pixels. Prepare has checked the shape and
+// types.
+TfLiteStatus EvalSparse(TfLiteContext* context, TfLiteConvParams* params,
+                        OpData* data, const TfLiteTensor* input,
+                        const TfLiteTensor* filter, const TfLiteTensor* bias,
+                        TfLiteTensor* output) {
+  optimized_ops::BlockSparseLayout layout;
+  if (!optimized_ops::GetBlockSparseLayout(
+          *filter->sparsity, GetTensorShape(filter), &layout)) {
+    TF_LITE_KERNEL_LOG(context, "Unsupported sparse convolution format.");
+    return kTfLiteError;
+  }
+  const RuntimeShape output_shape = GetTensorShape(output);
+  const int pixels = FlatSizeSkipDim(output_shape, 3);
+  FullyConnectedParams op_params;
+  if (input->type == kTfLiteFloat32) {
+    CalculateActivationRange(params->activation,
+                             &op_params.float_activation_min,
+                             &op_params.float_activation_max);
+    optimized_ops::FullyConnectedBlockSparseWeight(
+        layout, op_params, pixels, GetTensorData<float>(input),
+        GetTensorData<float>(filter), GetTensorData<float>(bias),
+        GetTensorData<float>(output),
+        CpuBackendContext::GetFromContext(context));
+  } else {
+    op_params.input_offset = -input->params.zero_point;
+    op_params.output_offset = output->params.zero_point;
+    op_params.quantized_activation_min = data->output_activation_min;
+    op_params.quantized_activation_max = data->output_activation_max;
+    optimized_ops::FullyConnectedBlockSparseWeight(
+        layout, op_params, pixels, GetTensorData<int8_t>(input),
+        GetTensorData<int8_t>(filter),
+        data->per_channel_output_multiplier.data(),
+        data->per_channel_output_shift.data(), GetTensorData<int32_t>(bias),
+        GetTensorData<int8_t>(output),
+        CpuBackendContext::GetFromContext(context));
+  }
+  return kTfLiteOk;
+}
+
 template <KernelType kernel_type, TfLiteType input_type>
 TfLiteStatus EvalImpl(TfLiteContext* context, TfLiteNode* node) {
   auto* params = reinterpret_cast<TfLiteConvParams*>(node->builtin_data);
@@ -1218,6 +1303,9 @@ TfLiteStatus EvalImpl(TfLiteContext* context, TfLiteNode* node) {
   }
 
   TFLITE_DCHECK_EQ(input_type, input->type);
+  if (filter->sparsity != nullptr) {
+    return EvalSparse(context, params, data, input, filter, bias, output);
+  }
   switch (input_type) {  // Already know in/outtypes are same.
     case kTfLiteFloat32:
       if (filter->type == kTfLiteUInt8 || filter->type == kTfLiteInt8) {
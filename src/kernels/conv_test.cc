@@ -1907,6 +1907,60 @@ TEST_P(ConvolutionOpTest, SimplePerChannel16x8Bias64) {
               ElementsAreArray({15872, 32767, -29184, -23552}));
 }
 
+// A 16x8 convolution w/ a constant filter and int64 bias.
+class ConstFilter16x8ConvolutionOpModel : public SingleOpModel {
+ public:
+  ConstFilter16x8ConvolutionOpModel(TfLiteRegistration* registration,
+                                    const TensorData& input,
+                                    const TensorData& filter,
+                                    const std::vector<int8_t>& filter_data,
+                                    const TensorData& bias,
+                                    const std::vector<int64_t>& bias_data,
+                                    const TensorData& output) {
+    input_ = AddInput(input);
+    AddConstInput(filter, filter_data);
+    AddConstInput(bias, bias_data);
+    output_ = AddOutput(output);
+    SetBuiltinOp(BuiltinOperator_CONV_2D, BuiltinOptions_Conv2DOptions,
+                 CreateConv2DOptions(builder_, Padding_VALID, /*stride_w=*/1,
+                                     /*stride_h=*/1,
+                                     ActivationFunctionType_NONE,
+                                     /*dilation_w_factor=*/1,
+                                     /*dilation_h_factor=*/1, TensorType_INT64)
+                     .Union());
+    resolver_ = std::make_unique<SingleOpResolver>(BuiltinOperator_CONV_2D,
+                                                   registration);
+    BuildInterpreter({GetShape(input_)});
+  }
+
+  void SetInput(const std::vector<int16_t>& data) {
+    PopulateTensor(input_, data);
+  }
+
+  std::vector<int16_t> GetOutput() { return ExtractVector<int16_t>(output_); }
+
+ private:
+  int input_;
+  int output_;
+};
+
+TEST_P(ConvolutionOpTest, PerChannel16x8Bias64AccumulatorExceedsInt32) {
+  // The bias fits into int32, but not the sum of the products, so the int32
+  // accumulating kernels must not be used.
+  constexpr int kDepth = 1024;
+  ConstFilter16x8ConvolutionOpModel m(
+      GetRegistration(), {TensorType_INT16, {1, 1, 1, kDepth}, 0, 0, 1, 0},
+      {TensorType_INT8, {1, 1, 1, kDepth}, 0, 0, 1, 0},
+      std::vector<int8_t>(kDepth, 127), {TensorType_INT64, {1}, 0, 0, 1, 0},
+      /*bias_data=*/{1000000},
+      {TensorType_INT16, {}, 0, 0, /*scale=*/262144, 0});
+  m.SetInput(std::vector<int16_t>(kDepth, 32767));
+
+  ASSERT_EQ(m.Invoke(), kTfLiteOk);
+  // 127 * 32767 * 1024 + 1000000 = 4262023744 = 16258.3 * 262144.
+  EXPECT_THAT(m.GetOutput(), ElementsAreArray({16258}));
+}
+
 TEST_P(ConvolutionOpTest, Simple4bitPerChannelTest) {
   PerChannelQuantizedConvolutionOpModel m(
       GetRegistration(), {TensorType_INT8, {1, 2, 3, 2}, -63.5, 64, 0.5, -1},
@@ -2214,6 +2268,71 @@ TEST_P(QuantizedConvolutionOpTest, SimpleTestExplicitQuantizedOp) {
                              }));
 }
 
+class SparseConvolutionOpModel : public SingleOpModel {
+ public:
+  SparseConvolutionOpModel(TfLiteRegistration* registration,
+                           const TensorData& input, const TensorData& filter,
+                           const std::vector<float>& filter_data) {
+    input_ = AddInput(input);
+    filter_ = AddConstSparseInput(filter, filter_data);
+    bias_ = AddInput({TensorType_FLOAT32, {filter.shape[0]}});
+    output_ = AddOutput({TensorType_FLOAT32, {}});
+    SetBuiltinOp(BuiltinOperator_CONV_2D, BuiltinOptions_Conv2DOptions,
+                 CreateConv2DOptions(builder_, Padding_SAME, /*stride_w=*/1,
+                                     /*stride_h=*/1,
+                                     ActivationFunctionType_NONE)
+                     .Union());
+    resolver_ = std::make_unique<SingleOpResolver>(BuiltinOperator_CONV_2D,
+                                                   registration);
+    BuildInterpreter({GetShape(input_), GetShape(filter_), GetShape(bias_)},
+                     /*num_threads=*/-1, /*allow_fp32_relax_to_fp16=*/false,
+                     /*apply_delegate=*/false);
+  }
+
+  void SetBias(std::initializer_list<float> f) { PopulateTensor(bias_, f); }
+  void SetInput(std::initializer_list<float> data) {
+    PopulateTensor(input_, data);
+  }
+  std::vector<float> GetOutput() { return ExtractVector<float>(output_); }
+
+ private:
+  int input_;
+  int filter_;
+  int bias_;
+  int output_;
+};
+
+TEST_P(ConvolutionOpTest, Sparse1x1TestFloat32) {
+  TensorData filter = {TensorType_FLOAT32, {4, 1, 1, 4}};
+  filter.traversal_order = {0, 1, 2, 3};
+  filter.format = {kTfLiteDimDense, kTfLiteDimDense, kTfLiteDimDense,
+                   kTfLiteDimSparseCSR};
+  SparseConvolutionOpModel m(GetRegistration(),
+                             {TensorType_FLOAT32, {1, 2, 2, 4}}, filter,
+                             {
+                                 1, 0, 0, 2,  // out channel 0
+                                 0, 0, 0, 0,  // out channel 1
+                                 0, 3, 0, 0,  // out channel 2
+                                 1, 1, 1, 1,  // out channel 3
+                             });
+  m.SetInput({
+      1,  2, 3, 4,  // pixel 0
+      0,  1, 0, 1,  // pixel 1
+      2,  2, 2, 2,  // pixel 2
+      -1, 0, 1, 0,  // pixel 3
+  });
+  m.SetBias({0, 1, 2, 3});
+
+  ASSERT_EQ(m.Invoke(), kTfLiteOk);
+
+  EXPECT_THAT(m.GetOutput(), ElementsAreArray({
+                                 9, 1, 8, 13,  // pixel 0
+                                 2, 1, 5, 5,   // pixel 1
+                                 6, 1, 8, 11,  // pixel 2
+                                 -1, 1, 2, 3,  // pixel 3
+                             }));
+}
+
 INSTANTIATE_TEST_SUITE_P(
     ConvolutionOpTest, ConvolutionOpTest,
     ::testing::ValuesIn(SingleOpTest::GetKernelTags(*kKernelMap)));
@@ -150,6 +150,9 @@ void CpuBackendContext::SetMaxNumThreads(int max_num_threads) {
 void CpuBackendContext::SetUseCaching(bool flag) { use_caching_ = flag; }
 
 pthreadpool_t CpuBackendContext::get_xnnpack_threadpool() {
+  if (external_xnnpack_threadpool_ != nullptr) {
+    return external_xnnpack_threadpool_;
+  }
   if (!xnnpack_threadpool_ && max_num_threads_ > 1) {
     xnnpack_threadpool_.reset(
         pthreadpool_create(static_cast<size_t>(max_num_threads_)));
@@ -157,6 +160,14 @@ pthreadpool_t CpuBackendContext::get_xnnpack_threadpool() {
   return xnnpack_threadpool_.get();
 }
 
+void CpuBackendContext::SetXNNPackThreadpool(pthreadpool_t threadpool) {
+  external_xnnpack_threadpool_ = threadpool;
+}
+
+void CpuBackendContext::SetThreadpoolProfiler(Profiler* profiler) {
+  threadpool_profiler_ = profiler;
+}
+
 bool CpuBackendContext::PreferGemmlowpOnX86() {
   bool use_gemmlowp_on_x86 = false;
 #if defined(TFLITE_X86_PLATFORM) && TFLITE_HAS_ATTRIBUTE_WEAK && \
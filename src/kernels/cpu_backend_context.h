@@ -26,6 +26,7 @@ limitations under the License.
 #include "public/gemmlowp.h"
 #include "pthreadpool.h"  // from @pthreadpool
 #include "ruy/context.h"  // from @ruy
+#include "core/api/profiler.h"
 #include "core/c/common.h"
 #include "external_cpu_backend_context.h"
 
@@ -56,6 +57,22 @@ class CpuBackendContext final : public TfLiteInternalBackendContext {
 
   pthreadpool_t get_xnnpack_threadpool();
 
+  // Makes get_xnnpack_threadpool() return an externally owned threadpool
+  // instead of creating one, so that the builtin kernels and XNNPACK delegates
+  // of several interpreters can share a single threadpool. The threadpool is
+  // not owned and must outlive this context. Passing nullptr restores the
+  // default behavior.
+  void SetXNNPackThreadpool(pthreadpool_t threadpool);
+
+  // Makes cpu_backend_threadpool::Execute report each task it runs to
+  // 'profiler', as a GENERAL_RUNTIME_INSTRUMENTATION_EVENT recorded from the
+  // thread running the task, so the profiler must be thread safe. The profiler
+  // is not owned and must outlive this context. Passing nullptr disables task
+  // profiling.
+  void SetThreadpoolProfiler(Profiler* profiler);
+
+  Profiler* threadpool_profiler() const { return threadpool_profiler_; }
+
   void ClearCaches() override { ruy_context_->ClearPrepackedCache(); }
 
   // Gemmlowp on x86 is a deprecated path but some clients may still use
@@ -122,6 +139,12 @@ class CpuBackendContext final : public TfLiteInternalBackendContext {
   // interpreter, and then consumed by xnnpack, possibly via a TFLite kernel.
   std::unique_ptr<pthreadpool, decltype(&pthreadpool_destroy)>
       xnnpack_threadpool_{nullptr, &pthreadpool_destroy};
+  // Externally owned xnnpack threadpool, takes precedence over
+  // xnnpack_threadpool_ when set.
+  pthreadpool_t external_xnnpack_threadpool_ = nullptr;
+
+  // Not owned.
+  Profiler* threadpool_profiler_ = nullptr;
 
   CpuBackendContext(const CpuBackendContext&) = delete;
 };
@@ -16,6 +16,10 @@ limitations under the License.
 #ifndef TENSORFLOW_LITE_KERNELS_CPU_BACKEND_THREADPOOL_H_
 #define TENSORFLOW_LITE_KERNELS_CPU_BACKEND_THREADPOOL_H_
 
+#include <cstdint>
+#include <vector>
+
+#include "core/api/profiler.h"
 #include "kernels/cpu_backend_context.h"
 #include "kernels/internal/compatibility.h"
 
@@ -33,27 +37,85 @@ namespace cpu_backend_threadpool {
 
 using Task = ruy::Task;
 
+namespace internal {
+
 template <typename TaskType>
-void Execute(int tasks_count, TaskType* tasks,
-             CpuBackendContext* cpu_backend_context) {
-  TFLITE_DCHECK_LE(tasks_count, cpu_backend_context->max_num_threads());
+void ExecuteTasks(int tasks_count, TaskType* tasks,
+                  CpuBackendContext* cpu_backend_context) {
   cpu_backend_context->ruy_context()->mutable_thread_pool()->Execute(
       tasks_count, tasks);
 }
 
+}  // namespace internal
+
 #else  // not TFLITE_WITH_RUY
 
 using Task = gemmlowp::Task;
 
+namespace internal {
+
 template <typename TaskType>
-void Execute(int tasks_count, TaskType* tasks,
-             CpuBackendContext* cpu_backend_context) {
-  TFLITE_DCHECK_LE(tasks_count, cpu_backend_context->max_num_threads());
+void ExecuteTasks(int tasks_count, TaskType* tasks,
+                  CpuBackendContext* cpu_backend_context) {
   cpu_backend_context->gemmlowp_context()->workers_pool()->Execute(tasks_count,
                                                                    tasks);
 }
 
+}  // namespace internal
+
+#endif
+
+namespace internal {
+
+// Runs a task within an event of the threadpool profiler, so that it shows
+// up on the track of the thread that ran it.
+class ProfiledTask final : public Task {
+ public:
+  ProfiledTask(Task* task, int task_index, int tasks_count, Profiler* profiler)
+      : task_(task),
+        task_index_(task_index),
+        tasks_count_(tasks_count),
+        profiler_(profiler) {}
+
+  void Run() override {
+#ifndef TFLITE_WITH_RUY
+    // The workers pool hands its per-thread allocator to the task it runs.
+    task_->local_allocator = local_allocator;
 #endif
+    const uint32_t handle = profiler_->BeginEvent(
+        "ThreadpoolTask",
+        Profiler::EventType::GENERAL_RUNTIME_INSTRUMENTATION_EVENT,
+        task_index_, tasks_count_);
+    task_->Run();
+    profiler_->EndEvent(handle);
+  }
+
+ private:
+  Task* const task_;
+  const int task_index_;
+  const int tasks_count_;
+  Profiler* const profiler_;
+};
+
+}  // namespace internal
+
+template <typename TaskType>
+void Execute(int tasks_count, TaskType* tasks,
+             CpuBackendContext* cpu_backend_context) {
+  TFLITE_DCHECK_LE(tasks_count, cpu_backend_context->max_num_threads());
+  Profiler* profiler = cpu_backend_context->threadpool_profiler();
+  if (profiler == nullptr) {
+    internal::ExecuteTasks(tasks_count, tasks, cpu_backend_context);
+    return;
+  }
+  std::vector<internal::ProfiledTask> profiled_tasks;
+  profiled_tasks.reserve(tasks_count);
+  for (int i = 0; i < tasks_count; ++i) {
+    profiled_tasks.emplace_back(&tasks[i], i, tasks_count, profiler);
+  }
+  internal::ExecuteTasks(tasks_count, profiled_tasks.data(),
+                         cpu_backend_context);
+}
 
 }  // namespace cpu_backend_threadpool
 }  // namespace tflite
@@ -15,9 +15,12 @@ limitations under the License.
 
 #include "kernels/cpu_backend_threadpool.h"
 
+#include <atomic>
+#include <cstdint>
 #include <vector>
 
 #include <gtest/gtest.h>
+#include "core/api/profiler.h"
 #include "kernels/cpu_backend_context.h"
 
 namespace tflite {
@@ -42,7 +45,33 @@ class TestGenerateArrayOfIncrementingIntsTask
   int end_;
 };
 
-void TestGenerateArrayOfIncrementingInts(int num_threads, int size) {
+// Counts the task events, from any thread.
+class TaskCountingProfiler : public Profiler {
+ public:
+  uint32_t BeginEvent(const char* tag, EventType event_type,
+                      int64_t event_metadata1,
+                      int64_t event_metadata2) override {
+    if (event_type == EventType::GENERAL_RUNTIME_INSTRUMENTATION_EVENT) {
+      begin_count_++;
+      task_index_sum_ += event_metadata1;
+    }
+    return 0;
+  }
+
+  void EndEvent(uint32_t event_handle) override { end_count_++; }
+
+  int begin_count() const { return begin_count_; }
+  int end_count() const { return end_count_; }
+  int64_t task_index_sum() const { return task_index_sum_; }
+
+ private:
+  std::atomic<int> begin_count_{0};
+  std::atomic<int> end_count_{0};
+  std::atomic<int64_t> task_index_sum_{0};
+};
+
+void TestGenerateArrayOfIncrementingInts(int num_threads, int size,
+                                         Profiler* profiler = nullptr) {
   // The buffer that our threads will write to.
   std::vector<int> buffer(size);
 
@@ -67,6 +96,7 @@ void TestGenerateArrayOfIncrementingInts(int num_threads, int size) {
   // What actually determines the number of threads used is the parameter
   // passed to Execute, since Execute does 1:1 mapping of tasks to threads.
   context.SetMaxNumThreads(num_threads);
+  context.SetThreadpoolProfiler(profiler);
 
   // Execute tasks on the threadpool.
   cpu_backend_threadpool::Execute(tasks.size(), tasks.data(), &context);
@@ -89,6 +119,14 @@ TEST(CpuBackendThreadpoolTest, TenThreadsSize1234567) {
   TestGenerateArrayOfIncrementingInts(10, 1234567);
 }
 
+TEST(CpuBackendThreadpoolTest, ProfilesEachTask) {
+  TaskCountingProfiler profiler;
+  TestGenerateArrayOfIncrementingInts(4, 1000, &profiler);
+  EXPECT_EQ(profiler.begin_count(), 4);
+  EXPECT_EQ(profiler.end_count(), 4);
+  EXPECT_EQ(profiler.task_index_sum(), 0 + 1 + 2 + 3);
+}
+
 }  // namespace
 
 }  // namespace tflite
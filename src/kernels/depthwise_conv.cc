@@ -466,9 +466,10 @@ TfLiteStatus EvalQuantizedPerChannel(TfLiteContext* context, TfLiteNode* node,
   return kTfLiteOk;
 }
 
+template <KernelType kernel_type>
 TfLiteStatus EvalQuantizedPerChannel16x8(
-    const TfLiteDepthwiseConvParams* params, const OpData* data,
-    const TfLiteTensor* input, const TfLiteTensor* filter,
+    TfLiteContext* context, const TfLiteDepthwiseConvParams* params,
+    const OpData* data, const TfLiteTensor* input, const TfLiteTensor* filter,
     const TfLiteTensor* bias, TfLiteTensor* output) {
   DepthwiseParams op_params;
   op_params.padding_type = PaddingType::kSame;
@@ -483,13 +484,24 @@ TfLiteStatus EvalQuantizedPerChannel16x8(
   op_params.quantized_activation_min = data->output_activation_min;
   op_params.quantized_activation_max = data->output_activation_max;
 
-  reference_integer_ops::DepthwiseConvPerChannel(
-      op_params, data->per_channel_output_multiplier.data(),
-      data->per_channel_output_shift.data(), GetTensorShape(input),
-      GetTensorData<int16>(input), GetTensorShape(filter),
-      GetTensorData<int8>(filter), GetTensorShape(bias),
-      GetTensorData<std::int64_t>(bias), GetTensorShape(output),
-      GetTensorData<int16>(output));
+  if (kernel_type == kReference) {
+    reference_integer_ops::DepthwiseConvPerChannel(
+        op_params, data->per_channel_output_multiplier.data(),
+        data->per_channel_output_shift.data(), GetTensorShape(input),
+        GetTensorData<int16>(input), GetTensorShape(filter),
+        GetTensorData<int8>(filter), GetTensorShape(bias),
+        GetTensorData<std::int64_t>(bias), GetTensorShape(output),
+        GetTensorData<int16>(output));
+  } else {
+    optimized_integer_ops::DepthwiseConvPerChannel(
+        op_params, data->per_channel_output_multiplier.data(),
+        data->per_channel_output_shift.data(), GetTensorShape(input),
+        GetTensorData<int16>(input), GetTensorShape(filter),
+        GetTensorData<int8>(filter), GetTensorShape(bias),
+        GetTensorData<std::int64_t>(bias), GetTensorShape(output),
+        GetTensorData<int16>(output),
+        CpuBackendContext::GetFromContext(context));
+  }
 
   return kTfLiteOk;
 }
@@ -610,8 +622,8 @@ TfLiteStatus EvalImpl(TfLiteContext* context, TfLiteNode* node) {
                                                   input, filter, bias, output);
       break;
     case kTfLiteInt16:
-      return EvalQuantizedPerChannel16x8(params, data, input, filter, bias,
-                                         output);
+      return EvalQuantizedPerChannel16x8<kernel_type>(
+          context, params, data, input, filter, bias, output);
       break;
     default:
       TF_LITE_KERNEL_LOG(context, "Type %d not currently supported.",
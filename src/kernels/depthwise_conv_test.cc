@@ -1621,6 +1621,26 @@ class PerChannelQuantizedDepthwiseConvolutionOpModel
   }
 };
 
+class PerChannelQuantized16x8DepthwiseConvolutionOpModel
+    : public BaseDepthwiseConvolutionOpModel {
+ public:
+  using BaseDepthwiseConvolutionOpModel::BaseDepthwiseConvolutionOpModel;
+
+  void SetInput(std::initializer_list<float> data) {
+    QuantizeAndPopulate<int16_t>(input_, data);
+  }
+
+  void SetFilter(std::initializer_list<float> data) {
+    PerChannelSymmetricQuantizeAndPopulate(filter_, data);
+  }
+
+  void SetBias(std::initializer_list<float> data) {
+    PerChannelQuantizeBias(bias_, data);
+  }
+
+  std::vector<int16_t> GetOutput() { return ExtractVector<int16_t>(output_); }
+};
+
 class PerChannelQuantizedDepthwiseConvolutionOpTest : public SingleOpTest {
  protected:
   const std::map<string, TfLiteRegistration*>& GetKernelMap() override {
@@ -1997,6 +2017,85 @@ TEST_P(PerChannelQuantizedDepthwiseConvolutionOpTest,
               })));
 }
 
+TEST_P(PerChannelQuantizedDepthwiseConvolutionOpTest, Simple16x8Test) {
+  PerChannelQuantized16x8DepthwiseConvolutionOpModel m(
+      GetRegistration(), {TensorType_INT16, {1, 2, 3, 2}, 0, 0, 0.5, 0},
+      {TensorType_INT8,
+       // [1 * 2 * 2 * 4] as [input_channel, y, x, output_channel]
+       {1, 2, 2, 4},
+       0,
+       0,
+       0,
+       0,
+       /*per_channel_quantization=*/true,
+       /*per_channel_quantization_scales=*/{1, 1, 1, 1},
+       /*per_channel_quantization_offsets=*/{0, 0, 0, 0},
+       /*channel_index=*/3},
+      {TensorType_INT16, {}, 0, 0, 0.5, 0}, Padding_VALID);
+  m.SetInput({
+      // [1 * 2 * 3 * 2] as [batch, y, x, input_channel]
+      3, 2,    // batch = 0, y = 0, x = 0
+      1, -1,   // batch = 0, y = 0, x = 1
+      -2, -3,  // batch = 0, y = 0, x = 2
+      4, 3,    // batch = 0, y = 1, x = 0
+      2, -2,   // batch = 0, y = 1, x = 1
+      -3, -4,  // batch = 0, y = 1, x = 2
+  });
+  m.SetFilter(
+      /*filter data*/
+      {
+          // [1 * 2 * 2 * 4] as [input_channel, y, x, output_channel]
+          // depth multiplier = 2
+          1, 2, 3, 4,  // y = 0, x = 0
+          3, 4, 5, 6,  // y = 0, x = 1
+          7, 8, 5, 6,  // y = 1, x = 0
+          3, 4, 1, 2,  // y = 1, x = 1
+      });
+  m.SetBias({3, -2, 4, 6});
+
+  // Invoke and verify output.
+  // output has dimension [1 * 1 * 2 * 4] as [batch, y, x, output_channel]
+  ASSERT_EQ(m.Invoke(), kTfLiteOk);
+  EXPECT_THAT(m.GetOutput(),
+              ElementsAreArray({86, 96, 36, 44, 6, -8, -56, -72}));
+}
+
+// Depth multiplier 1 with enough channels to go through the vectorized
+// accumulation loop of the optimized 16x8 kernel.
+TEST_P(PerChannelQuantizedDepthwiseConvolutionOpTest,
+       Simple16x8DepthMultiplier1Test) {
+  PerChannelQuantized16x8DepthwiseConvolutionOpModel m(
+      GetRegistration(), {TensorType_INT16, {1, 2, 2, 10}, 0, 0, 0.5, 0},
+      {TensorType_INT8,
+       // [1 * 2 * 2 * 10] as [input_channel, y, x, output_channel]
+       {1, 2, 2, 10},
+       0,
+       0,
+       0,
+       0,
+       /*per_channel_quantization=*/true,
+       /*per_channel_quantization_scales=*/
+       {1, 1, 1, 1, 1, 1, 1, 1, 1, 1},
+       /*per_channel_quantization_offsets=*/{0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+       /*channel_index=*/3},
+      {TensorType_INT16, {}, 0, 0, 0.5, 0}, Padding_VALID);
+  // Every pixel holds the same values, -4 to 5 along the channels.
+  m.SetInput({-4, -3, -2, -1, 0, 1, 2, 3, 4, 5,  //
+              -4, -3, -2, -1, 0, 1, 2, 3, 4, 5,  //
+              -4, -3, -2, -1, 0, 1, 2, 3, 4, 5,  //
+              -4, -3, -2, -1, 0, 1, 2, 3, 4, 5});
+  // The four filter taps are 1, 2, 3 and 4 for every channel.
+  m.SetFilter({1, 1, 1, 1, 1, 1, 1, 1, 1, 1,  //
+               2, 2, 2, 2, 2, 2, 2, 2, 2, 2,  //
+               3, 3, 3, 3, 3, 3, 3, 3, 3, 3,  //
+               4, 4, 4, 4, 4, 4, 4, 4, 4, 4});
+  m.SetBias({1, 1, 1, 1, 1, 1, 1, 1, 1, 1});
+
+  ASSERT_EQ(m.Invoke(), kTfLiteOk);
+  EXPECT_THAT(m.GetOutput(), ElementsAreArray({-78, -58, -38, -18, 2, 22, 42,
+                                               62, 82, 102}));
+}
+
 INSTANTIATE_TEST_SUITE_P(
     DepthwiseConvolutionOpTest, DepthwiseConvolutionOpTest,
     ::testing::ValuesIn(SingleOpTest::GetKernelTags(*kKernelMap)));
@@ -27,6 +27,7 @@ limitations under the License.
 #include "kernels/cpu_backend_context.h"
 #include "kernels/internal/optimized/fully_connected_4bit.h"
 #include "kernels/internal/optimized/optimized_ops.h"
+#include "kernels/internal/optimized/sparse_ops/block_sparse_gemm.h"
 #include "kernels/internal/optimized/sparse_ops/fully_connected.h"
 #include "kernels/internal/quantization_util.h"
 #include "kernels/internal/reference/fully_connected.h"
@@ -62,9 +63,17 @@ bool SupportedSparsityFormat(const TfLiteSparsity& sparsity) {
   return false;
 }
 
-static const int kDimMetadataSizeRandomSparse = 2;
 static const int kDimMetadataSizeBlockSparse = 3;
 
+// Returns true if the weights are stored in 1 x block_cols blocks, which have
+// dedicated tensor_utils kernels.
+bool Is1xNBlockSparse(const TfLiteSparsity& sparsity, int block_cols) {
+  return sparsity.dim_metadata_size == kDimMetadataSizeBlockSparse &&
+         sparsity.block_map != nullptr && sparsity.block_map->size == 1 &&
+         sparsity.block_map->data[0] == 1 &&
+         sparsity.dim_metadata[2].dense_size == block_cols;
+}
+
 TfLiteStatus CreateLedgerTensor(const TfLiteSparsity* sparsity,
                                 TfLiteContext* context, TfLiteTensor* ledger) {
   TF_LITE_ENSURE(context, sparsity != nullptr);
@@ -160,6 +169,10 @@ struct OpData {
   // Used for 4bit hybrid
   std::unique_ptr<optimized_4bit::OpData4Bit> op_data_4bit = nullptr;
   TfLiteType quantized_bias_type = kTfLiteNoType;
+  // The int64 bias of a 16x8 op narrowed to int32 for the optimized kernels,
+  // set in Prepare if the int32 accumulators can't overflow.
+  std::vector<int32_t> bias_int32;
+  bool use_bias_int32 = false;
 };
 
 constexpr int kInputTensor = 0;
@@ -498,6 +511,15 @@ TfLiteStatus PrepareImpl(TfLiteContext* context, TfLiteNode* node,
                                   bias->type == params->quantized_bias_type);
       data->quantized_bias_type = params->quantized_bias_type;
     }
+    // The optimized kernels accumulate in int32, so they take a constant
+    // int64 bias only if it can be narrowed w/o overflowing the accumulators.
+    data->use_bias_int32 = false;
+    if (kernel_type != kReference && bias && bias->type == kTfLiteInt64 &&
+        IsConstantTensor(bias) && IsConstantTensor(filter)) {
+      data->bias_int32.resize(NumElements(bias));
+      data->use_bias_int32 =
+          NarrowInt64BiasToInt32(bias, filter, data->bias_int32.data());
+    }
   }
 
   // If we have to perform on-the-fly quantization (with quantized weights and
@@ -1368,8 +1390,8 @@ TfLiteStatus EvalQuantized(TfLiteContext* context, TfLiteNode* node,
           }
           // Int4 support for sparse filter tensor is currently not supported
           TF_LITE_ENSURE(context, filter->type != kTfLiteInt4);
-          if (sparsity.dim_metadata_size == kDimMetadataSizeBlockSparse &&
-              sparsity.dim_metadata[2].dense_size == 16) {
+          optimized_ops::BlockSparseLayout layout;
+          if (Is1xNBlockSparse(sparsity, 16)) {
             // Block sparse with block size of 1x16.
             optimized_ops::FullyConnectedSparseWeight1x16(
                 sparsity, op_params, input_shape, GetTensorData<int8_t>(input),
@@ -1379,6 +1401,20 @@ TfLiteStatus EvalQuantized(TfLiteContext* context, TfLiteNode* node,
                 GetTensorData<int32_t>(bias), output_shape,
                 GetTensorData<int8_t>(output),
                 CpuBackendContext::GetFromContext(context));
+          } else if (optimized_ops::GetBlockSparseLayout(sparsity, filter_shape,
+                                                         &layout)) {
+            // Any other block shape, including unblocked sparsity.
+            optimized_ops::FullyConnectedBlockSparseWeight(
+                layout, op_params,
+                FlatSizeSkipDim(output_shape,
+                                output_shape.DimensionsCount() - 1),
+                GetTensorData<int8_t>(input), GetTensorData<int8_t>(filter),
+                is_per_channel ? data->per_channel_output_multiplier.data()
+                               : nullptr,
+                is_per_channel ? data->per_channel_output_shift.data()
+                               : nullptr,
+                GetTensorData<int32_t>(bias), GetTensorData<int8_t>(output),
+                CpuBackendContext::GetFromContext(context));
           } else {
             TF_LITE_KERNEL_LOG(
                 context, "Unsupported sparse fully-connected weight format.");
@@ -1400,8 +1436,16 @@ TfLiteStatus EvalQuantized(TfLiteContext* context, TfLiteNode* node,
           bool has_non_zero_point = input->params.zero_point ||
                                     filter->params.zero_point ||
                                     output->params.zero_point;
-          if (kernel_type == kReference || has_non_zero_point ||
-              (bias && bias->type == kTfLiteInt64)) {
+          bool use_optimized = kernel_type != kReference && !has_non_zero_point;
+          // RUY accumulates in int32, so it takes the int64 bias narrowed
+          // to int32 in Prepare; if the accumulators might overflow, the
+          // reference kernel is used.
+          const int32_t* bias_int32 = GetTensorData<int32_t>(bias);
+          if (use_optimized && bias && bias->type == kTfLiteInt64) {
+            use_optimized = data->use_bias_int32;
+            bias_int32 = data->bias_int32.data();
+          }
+          if (!use_optimized) {
             is_per_channel ? FullyConnectedPerChannelInt16<kernel_type>(
                                  data, input, filter, bias, output)
                            : FullyConnectedInt16<kernel_type>(
@@ -1413,14 +1457,14 @@ TfLiteStatus EvalQuantized(TfLiteContext* context, TfLiteNode* node,
                       data->per_channel_output_shift.data(),
                       GetTensorShape(input), GetTensorData<int16_t>(input),
                       GetTensorShape(filter), GetTensorData<int8_t>(filter),
-                      GetTensorShape(bias), GetTensorData<int32_t>(bias),
-                      GetTensorShape(output), GetTensorData<int16_t>(output),
+                      GetTensorShape(bias), bias_int32, GetTensorShape(output),
+                      GetTensorData<int16_t>(output),
                       CpuBackendContext::GetFromContext(context))
                 : optimized_integer_ops::FullyConnected(
                       op_params, GetTensorShape(input),
                       GetTensorData<int16_t>(input), GetTensorShape(filter),
                       GetTensorData<int8_t>(filter), GetTensorShape(bias),
-                      GetTensorData<int32_t>(bias), GetTensorShape(output),
+                      bias_int32, GetTensorShape(output),
                       GetTensorData<int16_t>(output),
                       CpuBackendContext::GetFromContext(context));
           }
@@ -1552,16 +1596,8 @@ TfLiteStatus EvalFloat(TfLiteContext* context, TfLiteNode* node,
         return kTfLiteError;
       }
 
-      if (sparsity.dim_metadata_size == kDimMetadataSizeRandomSparse) {
-        // Random sparse.
-        optimized_ops::FullyConnectedSparseWeight(
-            sparsity, op_params,                         // Disable formatting
-            input_shape, GetTensorData<float>(input),    // Disable formatting
-            filter_shape, GetTensorData<float>(filter),  // Disable formatting
-            bias_shape, GetTensorData<float>(bias),      // Disable formatting
-            output_shape, GetTensorData<float>(output));
-      } else if (sparsity.dim_metadata_size == kDimMetadataSizeBlockSparse &&
-                 sparsity.dim_metadata[2].dense_size == 4) {
+      optimized_ops::BlockSparseLayout layout;
+      if (Is1xNBlockSparse(sparsity, 4)) {
         // Block sparse with block size of 1x4.
         optimized_ops::FullyConnectedSparseWeight1x4(
             sparsity, op_params,                         // Disable formatting
@@ -1570,6 +1606,15 @@ TfLiteStatus EvalFloat(TfLiteContext* context, TfLiteNode* node,
             bias_shape, GetTensorData<float>(bias),      // Disable formatting
             output_shape, GetTensorData<float>(output),
             CpuBackendContext::GetFromContext(context));
+      } else if (optimized_ops::GetBlockSparseLayout(sparsity, filter_shape,
+                                                     &layout)) {
+        // Random sparse and every other block shape.
+        optimized_ops::FullyConnectedBlockSparseWeight(
+            layout, op_params,
+            FlatSizeSkipDim(output_shape, output_shape.DimensionsCount() - 1),
+            GetTensorData<float>(input), GetTensorData<float>(filter),
+            GetTensorData<float>(bias), GetTensorData<float>(output),
+            CpuBackendContext::GetFromContext(context));
       } else {
         TF_LITE_KERNEL_LOG(context,
                            "Unsupported sparse fully-connected weight format.");
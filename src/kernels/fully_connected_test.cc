@@ -922,6 +922,59 @@ TEST_P(QuantizedFullyConnectedOpTest, SimpleTestQuantizedInt16Bias64) {
               ElementsAre(12288, 12800, 13312, 29696, 30208, 30720));
 }
 
+// A 16x8 fully connected op w/ constant weights and int64 bias.
+class ConstWeights16x8FullyConnectedOpModel : public SingleOpModel {
+ public:
+  ConstWeights16x8FullyConnectedOpModel(
+      TfLiteRegistration* registration, const TensorData& input,
+      const TensorData& weights, const std::vector<int8_t>& weights_data,
+      const TensorData& bias, const std::vector<int64_t>& bias_data,
+      const TensorData& output) {
+    input_ = AddInput(input);
+    AddConstInput(weights, weights_data);
+    AddConstInput(bias, bias_data);
+    output_ = AddOutput(output);
+    SetBuiltinOp(BuiltinOperator_FULLY_CONNECTED,
+                 BuiltinOptions_FullyConnectedOptions,
+                 CreateFullyConnectedOptions(
+                     builder_, ActivationFunctionType_NONE,
+                     FullyConnectedOptionsWeightsFormat_DEFAULT,
+                     /*keep_num_dims=*/false,
+                     /*asymmetric_quantize_inputs=*/false, TensorType_INT64)
+                     .Union());
+    resolver_ = std::make_unique<SingleOpResolver>(
+        BuiltinOperator_FULLY_CONNECTED, registration);
+    BuildInterpreter({GetShape(input_)});
+  }
+
+  void SetInput(const std::vector<int16_t>& data) {
+    PopulateTensor(input_, data);
+  }
+
+  std::vector<int16_t> GetOutput() { return ExtractVector<int16_t>(output_); }
+
+ private:
+  int input_;
+  int output_;
+};
+
+TEST_P(QuantizedFullyConnectedOpTest, Int16Bias64AccumulatorExceedsInt32) {
+  // The bias fits into int32, but not the sum of the products, so the int32
+  // accumulating kernels must not be used.
+  constexpr int kInputSize = 1024;
+  ConstWeights16x8FullyConnectedOpModel m(
+      GetRegistration(), {TensorType_INT16, {1, kInputSize}, 0, 0, 1, 0},
+      {TensorType_INT8, {1, kInputSize}, 0, 0, 1, 0},
+      std::vector<int8_t>(kInputSize, 127),
+      {TensorType_INT64, {1}, 0, 0, 1, 0}, /*bias_data=*/{1000000},
+      {TensorType_INT16, {}, 0, 0, /*scale=*/262144, 0});
+  m.SetInput(std::vector<int16_t>(kInputSize, 32767));
+
+  ASSERT_EQ(m.Invoke(), kTfLiteOk);
+  // 127 * 32767 * 1024 + 1000000 = 4262023744 = 16258.3 * 262144.
+  EXPECT_THAT(m.GetOutput(), ElementsAre(16258));
+}
+
 TEST_P(QuantizedFullyConnectedOpTest, SimpleTestQuantizedInt8NoBias) {
   QuantizedFullyConnectedOpModel m(
       GetRegistration(), /*units=*/3, /*batches*/ 2,
@@ -2016,6 +2069,48 @@ TEST_P(SparseFullyConnectedOpTest, Simple1x4TestMultiThreadedMoreBatches) {
   }
 }
 
+TEST_P(SparseFullyConnectedOpTest, Simple4x4Test) {
+  std::initializer_list<float> weight_data = {
+      1,  2, 3, 4, 0, 0,  0, 0,   // u = 0
+      2,  2, 2, 2, 0, 0,  0, 0,   // u = 1
+      -1, 0, 1, 0, 0, 0,  0, 0,   // u = 2
+      0,  0, 0, 3, 0, 0,  0, 0,   // u = 3
+      0,  0, 0, 0, 1, 1,  1, 1,   // u = 4
+      0,  0, 0, 0, 1, -1, 1, -1,  // u = 5
+      0,  0, 0, 0, 4, 3,  2, 1,   // u = 6
+      0,  0, 0, 0, 0, 1,  0, 0,   // u = 7
+  };
+  TensorData weight = {};
+  weight.type = TensorType_FLOAT32;
+  weight.shape = {8, 8};
+  weight.traversal_order = {0, 1, 2, 3};
+  weight.format = {kTfLiteDimDense, kTfLiteDimSparseCSR};
+  weight.block_map = {0, 1};
+  weight.block_size = {4, 4};
+  for (int num_threads = 1; num_threads <= 4; num_threads++) {
+    SparseFullyConnectedOpModel<float> m(
+        GetRegistration(),
+        /*units=*/8, /*batches=*/2,
+        /*input=*/{TensorType_FLOAT32, {2, 8}}, weight, weight_data,
+        /*output=*/{TensorType_FLOAT32},
+        /*bias_tensor_optional=*/false, /*num_threads=*/num_threads);
+    m.SetBias({1, 2, 3, 4, 5, 6, 7, 8});
+
+    m.SetInput({
+        1,  2, 3,  4, 5, 6, 7, 8,  // b = 0
+        -1, 1, -1, 1, 2, 2, 2, 2,  // b = 1
+    });
+
+    ASSERT_EQ(m.Invoke(), kTfLiteOk);
+
+    EXPECT_THAT(m.GetOutputShape(), ElementsAre(2, 8));
+    EXPECT_THAT(m.GetOutput(),
+                ElementsAre(31, 22, 5, 16, 31, 4, 67, 14,  // b = 0
+                            3, 2, 3, 7, 13, 6, 27, 10      // b = 1
+                            ));
+  }
+}
+
 TEST_P(SparseHybridFullyConnectedOpTest, SparseHybrid1x16Test) {
   std::initializer_list<float> weight_data = {
       /* 1st row */
@@ -2293,6 +2388,43 @@ TEST_P(SparseQuantizedFullyConnectedOpTest, Simple1x16TestNoBias) {
   EXPECT_THAT(m.GetOutput(), ElementsAre(10, 0, 22, 0, 0, 18));
 }
 
+TEST_P(SparseQuantizedFullyConnectedOpTest, Simple8x1Test) {
+  std::vector<float> weight_data = {
+      1, 0, 0,  0,  // u = 0
+      2, 0, -1, 0,  // u = 1
+      3, 0, -2, 0,  // u = 2
+      4, 0, -3, 0,  // u = 3
+      5, 0, -4, 0,  // u = 4
+      6, 0, -5, 0,  // u = 5
+      7, 0, -6, 0,  // u = 6
+      8, 0, -7, 0,  // u = 7
+  };
+  TensorData weight = {TensorType_INT8, {8, 4}, 0, 0, 1};
+  weight.traversal_order = {0, 1, 2};
+  weight.format = {kTfLiteDimDense, kTfLiteDimSparseCSR};
+  weight.block_map = {0};
+  weight.block_size = {8};
+  SparseQuantizedFullyConnectedOpModel m(
+      GetRegistration(),
+      /*units=*/8, /*batches=*/2,
+      /*input=*/{TensorType_INT8, {2, 4}, 0, 0, 1}, weight, weight_data,
+      /*output=*/{TensorType_INT8, {}, 0, 0, 1});
+
+  m.SetBias({10, 10, 10, 10, 10, 10, 10, 10});
+  m.SetInput({
+      1, 2, 3, 4,  // b = 0
+      2, 5, 1, 7,  // b = 1
+  });
+
+  ASSERT_EQ(m.Invoke(), kTfLiteOk);
+
+  EXPECT_THAT(m.GetOutputShape(), ElementsAre(2, 8));
+  EXPECT_THAT(m.GetOutput(),
+              ElementsAre(11, 9, 7, 5, 3, 1, 0, 0,         // b = 0
+                          12, 13, 14, 15, 16, 17, 18, 19  // b = 1
+                          ));
+}
+
 TEST_P(SparseQuantizedFullyConnectedOpTest, Simple1x16TestScaledInputOutput) {
   std::initializer_list<float> weight_data = {
       0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
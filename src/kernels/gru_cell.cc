@@ -15,9 +15,11 @@ limitations under the License.
 
 #include "kernels/gru_cell.h"
 
+#include <algorithm>
 #include <vector>
 
 #include "kernels/internal/optimized/optimized_ops.h"
+#include "kernels/internal/tensor_utils.h"
 
 namespace tflite {
 namespace ops {
@@ -29,6 +31,66 @@ using optimized_ops::FullyConnected;
 using optimized_ops::MapAsArrayWithLastDimAsRows;
 using reference_ops::Concatenation;
 
+namespace {
+
+// Up to this batch size the gates are computed by the fused matrix-vector
+// kernels below; past it the GEMM based FullyConnected path amortizes the
+// weight loads over the batch and wins.
+constexpr int kFusedGateMaxBatch = 4;
+
+// Same as GruCell, but computes each gate in a single pass over its weights
+// (matmul, bias and activation fused), and the state update in a single pass
+// over the state. Used for the small batches of streaming models, where the
+// separate FullyConnected and element-wise sweeps dominate.
+void FusedGruCell(int n_batch, int n_input, int n_output, const float* input,
+                  const float* input_state, const float* gate_weight,
+                  const float* gate_bias, const float* candidate_weight,
+                  const float* candidate_bias, float* output,
+                  float* output_state, float* activation, float* concat) {
+  const int n_concat = n_input + n_output;
+
+  // [x h] = concat(input, state)
+  for (int b = 0; b < n_batch; ++b) {
+    std::copy_n(input + b * n_input, n_input, concat + b * n_concat);
+    std::copy_n(input_state + b * n_output, n_output,
+                concat + b * n_concat + n_input);
+  }
+
+  // [r u] = sigmoid([x h] * gate_weight + gate_bias)
+  tensor_utils::MatrixBatchVectorMultiplyBiasActivation(
+      gate_weight, 2 * n_output, n_concat, concat, gate_bias, n_batch,
+      kTfLiteActSigmoid, activation, 2 * n_output);
+
+  // hr = h .* r
+  for (int b = 0; b < n_batch; ++b) {
+    const float* h = input_state + b * n_output;
+    const float* r = activation + b * 2 * n_output;
+    float* hr = concat + b * n_concat + n_input;
+    for (int i = 0; i < n_output; ++i) {
+      hr[i] = h[i] * r[i];
+    }
+  }
+
+  // c = tanh([x hr] * candidate_weight + candidate_bias)
+  tensor_utils::MatrixBatchVectorMultiplyBiasActivation(
+      candidate_weight, n_output, n_concat, concat, candidate_bias, n_batch,
+      kTfLiteActTanh, output, n_output);
+
+  // output = (1 - u) .* c + u .* h
+  for (int b = 0; b < n_batch; ++b) {
+    const float* h = input_state + b * n_output;
+    const float* u = activation + b * 2 * n_output + n_output;
+    float* c = output + b * n_output;
+    for (int i = 0; i < n_output; ++i) {
+      c[i] += u[i] * (h[i] - c[i]);
+    }
+  }
+
+  memcpy(output_state, output, n_batch * n_output * sizeof(float));
+}
+
+}  // namespace
+
 void GruCell(const RuntimeShape& input_shape, const float* input,
              const RuntimeShape& state_shape, const float* input_state,
              const RuntimeShape& gate_weight_shape, const float* gate_weight,
@@ -46,6 +108,13 @@ void GruCell(const RuntimeShape& input_shape, const float* input,
   const int n_input = input_shape.Dims(1);
   const int n_output = state_shape.Dims(1);
 
+  if (n_batch <= kFusedGateMaxBatch) {
+    FusedGruCell(n_batch, n_input, n_output, input, input_state, gate_weight,
+                 gate_bias, candidate_weight, candidate_bias, output,
+                 output_state, activation, concat);
+    return;
+  }
+
   // [x h] = concat(input, state)
   std::vector<float const*> concat_arrays_data;
   std::vector<RuntimeShape const*> concat_arrays_shapes;
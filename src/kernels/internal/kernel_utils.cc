@@ -116,6 +116,45 @@ void RnnBatchStep(const float* input_ptr_batch, const float* input_weights_ptr,
   }
 }
 
+void PackRnnWeights(const float* input_weights_ptr,
+                    const float* recurrent_weights_ptr, int input_size,
+                    int num_units, float* packed_weights_ptr) {
+  for (int u = 0; u < num_units; u++) {
+    packed_weights_ptr =
+        std::copy_n(input_weights_ptr + u * input_size, input_size,
+                    packed_weights_ptr);
+    packed_weights_ptr = std::copy_n(recurrent_weights_ptr + u * num_units,
+                                     num_units, packed_weights_ptr);
+  }
+}
+
+void FusedRnnBatchStep(const float* input_ptr_batch,
+                       const float* packed_weights_ptr, const float* bias_ptr,
+                       int input_size, int num_units, int batch_size,
+                       int output_batch_leading_dim,
+                       TfLiteFusedActivation activation, float* concat_scratch,
+                       float* hidden_state_ptr_batch, float* output_ptr_batch) {
+  const int concat_size = input_size + num_units;
+  // [x h] = concat(input, hidden_state)
+  for (int k = 0; k < batch_size; k++) {
+    float* concat_in_batch = concat_scratch + k * concat_size;
+    std::copy_n(input_ptr_batch + k * input_size, input_size, concat_in_batch);
+    std::copy_n(hidden_state_ptr_batch + k * num_units, num_units,
+                concat_in_batch + input_size);
+  }
+
+  // Output = activation([x h] * [W R] + bias)
+  tensor_utils::MatrixBatchVectorMultiplyBiasActivation(
+      packed_weights_ptr, num_units, concat_size, concat_scratch, bias_ptr,
+      batch_size, activation, output_ptr_batch, output_batch_leading_dim);
+
+  // Update hidden_state.
+  for (int k = 0; k < batch_size; k++) {
+    std::copy_n(output_ptr_batch + k * output_batch_leading_dim, num_units,
+                hidden_state_ptr_batch + k * num_units);
+  }
+}
+
 void RnnBatchStep(
     const float* input_ptr_batch, const int8_t* input_weights_ptr,
     float input_weights_scale, const int8_t* recurrent_weights_ptr,
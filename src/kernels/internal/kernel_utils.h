@@ -53,6 +53,26 @@ void RnnBatchStep(const float* input_ptr_batch, const float* input_weights_ptr,
                   TfLiteFusedActivation activation,
                   float* hidden_state_ptr_batch, float* output_ptr_batch);
 
+// Packs the input and recurrent weights of an RNN cell row by row into a
+// single [num_units, input_size + num_units] matrix, as consumed by
+// FusedRnnBatchStep. 'packed_weights_ptr' must hold
+// num_units * (input_size + num_units) floats.
+void PackRnnWeights(const float* input_weights_ptr,
+                    const float* recurrent_weights_ptr, int input_size,
+                    int num_units, float* packed_weights_ptr);
+
+// Same as the first RnnBatchStep above, but using weights packed by
+// PackRnnWeights. Each step is then a single pass over the weights which
+// computes the matmul, adds the bias and applies the activation, instead of
+// separate bias, matmul and activation sweeps over the output.
+// 'concat_scratch' must hold batch_size * (input_size + num_units) floats.
+void FusedRnnBatchStep(const float* input_ptr_batch,
+                       const float* packed_weights_ptr, const float* bias_ptr,
+                       int input_size, int num_units, int batch_size,
+                       int output_batch_leading_dim,
+                       TfLiteFusedActivation activation, float* concat_scratch,
+                       float* hidden_state_ptr_batch, float* output_ptr_batch);
+
 // Performs a quantized RNN batch inference step. Same as above, but for
 // quantization purposes, we also pass in quantized_hidden_state_ptr_batch and
 // quantized_input_ptr_batch pointers for temporary storage of the quantized
@@ -0,0 +1,304 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#if defined(FC_4BIT_SSE) && defined(__SSSE3__)
+
+#include "kernels/internal/optimized/4bit/avx2_fully_connected_impl.h"
+
+#if defined(FC_4BIT_AVX2)
+
+#include <immintrin.h>
+#include <stdint.h>
+
+#include <algorithm>
+
+#include "kernels/internal/optimized/cpu_check.h"
+
+namespace tflite {
+namespace optimized_4bit {
+namespace {
+
+// Horizontally add the partial sums of four rows, where 'rows01' holds rows 0
+// and 1 and 'rows23' holds rows 2 and 3, one row per 128-bit lane. The result
+// is [row0, row1, row2, row3].
+TFLITE_AVX2_TARGET inline __m128i ReduceRowPairs(__m256i rows01,
+                                                 __m256i rows23) {
+  // [r0, r0, r2, r2 | r1, r1, r3, r3]
+  __m256i sum = _mm256_hadd_epi32(rows01, rows23);
+  // [r0, r2, r0, r2 | r1, r3, r1, r3]
+  sum = _mm256_hadd_epi32(sum, sum);
+  return _mm_unpacklo_epi32(_mm256_castsi256_si128(sum),
+                            _mm256_extracti128_si256(sum, 1));
+}
+
+#if defined(FC_4BIT_AVX512VNNI)
+// Horizontally add each of 4 XMM registers with 4 int32 values, pack result
+// into a single XMM register.
+TFLITE_AVX512VNNI_TARGET inline __m128i ReduceInt32x4x4(__m128i a, __m128i b,
+                                                        __m128i c, __m128i d) {
+  const __m128i a_b_lo_half = _mm_unpacklo_epi32(a, b);  // [a0, b0, a1, b1]
+  const __m128i a_b_hi_half = _mm_unpackhi_epi32(a, b);  // [a2, b2, a3, b3]
+  const __m128i a_plus_b = _mm_add_epi32(a_b_lo_half, a_b_hi_half);
+  const __m128i c_d_lo_half = _mm_unpacklo_epi32(c, d);  // [c0, d0, c1, d1]
+  const __m128i c_d_hi_half = _mm_unpackhi_epi32(c, d);  // [c2, d2, c3, d3]
+  const __m128i c_plus_d = _mm_add_epi32(c_d_lo_half, c_d_hi_half);
+  const __m128i all_evns = _mm_unpacklo_epi64(a_plus_b, c_plus_d);
+  const __m128i all_odds = _mm_unpackhi_epi64(a_plus_b, c_plus_d);
+  return _mm_add_epi32(all_evns, all_odds);  // [a0123, b0123, c0123, d0123]
+}
+#endif  // defined(FC_4BIT_AVX512VNNI)
+
+}  // namespace
+
+bool CanUseAvx2FullyConnected4Bit() {
+#if defined(__AVX2__)
+  return true;
+#else
+  return DetectX86Avx2Fma();
+#endif
+}
+
+template <int Depth, int Width>
+TFLITE_AVX2_TARGET void Avx2Unpack(float* output_ptr, const int32_t* dst,
+                                   int batch_size, int num_units,
+                                   const float* scaling_factors,
+                                   const float* filter_scales,
+                                   int dst_layout_rows, int dst_layout_cols) {
+  static_assert(Depth == 4, "Each accumulator row holds four output units.");
+  const int outer_rows = dst_layout_rows / Width;
+  const int outer_cols = dst_layout_cols / Depth;
+  for (int outer_col = 0; outer_col < outer_cols; ++outer_col) {
+    const int unit = outer_col * Depth;
+    const int remaining_units = std::min(num_units - unit, Depth);
+    const float* filter_scales_ptr = filter_scales + unit;
+    const bool full_units = remaining_units == Depth;
+    const __m128 filter_scales_f32x4 =
+        full_units ? _mm_loadu_ps(filter_scales_ptr) : _mm_setzero_ps();
+    for (int outer_row = 0; outer_row < outer_rows; ++outer_row) {
+      const int batch = outer_row * Width;
+      const int remaining_width = std::min(batch_size - batch, Width);
+      const int cluster_index = outer_col * outer_rows + outer_row;
+      const int32_t* dst_ptr = dst + cluster_index * Depth * Width;
+      float* tmp_output_ptr = output_ptr + batch * num_units + unit;
+      for (int w = 0; w < remaining_width; ++w) {
+        const float scale = scaling_factors[batch + w];
+        if (full_units) {
+          const __m128 dst_f32x4 = _mm_cvtepi32_ps(
+              _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst_ptr)));
+          const __m128 scaled_f32x4 = _mm_mul_ps(
+              _mm_mul_ps(dst_f32x4, _mm_set1_ps(scale)), filter_scales_f32x4);
+          _mm_storeu_ps(tmp_output_ptr,
+                        _mm_add_ps(_mm_loadu_ps(tmp_output_ptr), scaled_f32x4));
+        } else {
+          for (int d = 0; d < remaining_units; ++d) {
+            tmp_output_ptr[d] += dst_ptr[d] * scale * filter_scales_ptr[d];
+          }
+        }
+        dst_ptr += Depth;
+        tmp_output_ptr += num_units;
+      }
+    }
+  }
+}
+
+// Same blocking as SseRunKernel, but the four lhs rows of a block are held in
+// two YMM registers and each 16-byte half of the rhs is broadcast to both
+// lanes. The 4-bit lhs values are unsigned, so they are fed directly to
+// _mm256_maddubs_epi16 without the sign transfer the int8 kernels need, and
+// the 16-bit pair sums (at most 2 * 2 * 15 * 128) cannot saturate.
+template <int RowsLeft, int RowsRight, int Cols>
+TFLITE_AVX2_TARGET void Avx2RunKernel(const uint8_t* lhs, const int8_t* rhs,
+                                      int32_t* dst, int lhs_layout_rows,
+                                      int lhs_layout_cols, int rhs_layout_rows,
+                                      int rhs_layout_cols, int dst_layout_rows,
+                                      int dst_layout_cols) {
+  static_assert(RowsLeft == 4 && Cols == 32,
+                "Avx2RunKernel expects 4x32 filter blocks.");
+  const int clamped_end_row = std::min(lhs_layout_rows, dst_layout_cols);
+  const int clamped_end_col = std::min(rhs_layout_rows, dst_layout_rows);
+  const int outer_rows = (clamped_end_row + RowsLeft - 1) / RowsLeft;
+  const int outer_cols = (clamped_end_col + RowsRight - 1) / RowsRight;
+  const int depth = std::min(lhs_layout_cols / Cols, rhs_layout_cols / Cols);
+  const __m256i bitmask = _mm256_set1_epi8(15);
+  const __m256i ones = _mm256_set1_epi16(1);
+  int32_t* element_ptr = dst;
+  for (int i = 0; i < outer_rows; ++i) {
+    const uint8_t* lhs_val_data = lhs + i * RowsLeft * lhs_layout_cols / 2;
+    for (int j = 0; j < outer_cols; ++j) {
+      const uint8_t* lhs_val = lhs_val_data;
+      const int8_t* rhs_val = rhs + j * RowsRight * rhs_layout_cols;
+      // accum[r][0] holds lhs rows 0 and 1, accum[r][1] rows 2 and 3.
+      __m256i accum[RowsRight][2];
+      for (int r = 0; r < RowsRight; ++r) {
+        accum[r][0] = _mm256_setzero_si256();
+        accum[r][1] = _mm256_setzero_si256();
+      }
+      for (int k = 0; k < depth; ++k) {
+        // The high nibbles multiply the first 16 rhs values, the low nibbles
+        // the last 16.
+        __m256i lhs_hi[2];
+        __m256i lhs_lo[2];
+        for (int p = 0; p < 2; ++p) {
+          const __m256i packed = _mm256_loadu_si256(
+              reinterpret_cast<const __m256i*>(lhs_val + 32 * p));
+          lhs_hi[p] = _mm256_and_si256(_mm256_srli_epi16(packed, 4), bitmask);
+          lhs_lo[p] = _mm256_and_si256(packed, bitmask);
+        }
+        lhs_val += 64;
+        for (int r = 0; r < RowsRight; ++r) {
+          const __m256i rhs_hi = _mm256_broadcastsi128_si256(
+              _mm_loadu_si128(reinterpret_cast<const __m128i*>(rhs_val)));
+          const __m256i rhs_lo = _mm256_broadcastsi128_si256(
+              _mm_loadu_si128(reinterpret_cast<const __m128i*>(rhs_val + 16)));
+          rhs_val += 32;
+          for (int p = 0; p < 2; ++p) {
+            const __m256i sum_16x16 =
+                _mm256_add_epi16(_mm256_maddubs_epi16(lhs_hi[p], rhs_hi),
+                                 _mm256_maddubs_epi16(lhs_lo[p], rhs_lo));
+            accum[r][p] = _mm256_add_epi32(accum[r][p],
+                                           _mm256_madd_epi16(sum_16x16, ones));
+          }
+        }
+      }
+      for (int r = 0; r < RowsRight; ++r) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(element_ptr),
+                         ReduceRowPairs(accum[r][0], accum[r][1]));
+        element_ptr += 4;
+      }
+    }
+  }
+}
+
+#if defined(FC_4BIT_AVX512VNNI)
+bool CanUseAvx512VnniFullyConnected4Bit() {
+#if defined(__AVX512VNNI__) && defined(__AVX512BW__) && defined(__AVX512VL__)
+  return true;
+#else
+  return DetectX86Avx512Vnni();
+#endif
+}
+
+// As Avx2RunKernel, with the whole 4x32 lhs block in one ZMM register (one
+// row per 128-bit lane) and VPDPBUSD doing the unsigned x signed products and
+// the accumulation in a single instruction.
+template <int RowsLeft, int RowsRight, int Cols>
+TFLITE_AVX512VNNI_TARGET void Avx512VnniRunKernel(
+    const uint8_t* lhs, const int8_t* rhs, int32_t* dst, int lhs_layout_rows,
+    int lhs_layout_cols, int rhs_layout_rows, int rhs_layout_cols,
+    int dst_layout_rows, int dst_layout_cols) {
+  static_assert(RowsLeft == 4 && Cols == 32,
+                "Avx512VnniRunKernel expects 4x32 filter blocks.");
+  const int clamped_end_row = std::min(lhs_layout_rows, dst_layout_cols);
+  const int clamped_end_col = std::min(rhs_layout_rows, dst_layout_rows);
+  const int outer_rows = (clamped_end_row + RowsLeft - 1) / RowsLeft;
+  const int outer_cols = (clamped_end_col + RowsRight - 1) / RowsRight;
+  const int depth = std::min(lhs_layout_cols / Cols, rhs_layout_cols / Cols);
+  const __m512i bitmask = _mm512_set1_epi8(15);
+  int32_t* element_ptr = dst;
+  for (int i = 0; i < outer_rows; ++i) {
+    const uint8_t* lhs_val_data = lhs + i * RowsLeft * lhs_layout_cols / 2;
+    for (int j = 0; j < outer_cols; ++j) {
+      const uint8_t* lhs_val = lhs_val_data;
+      const int8_t* rhs_val = rhs + j * RowsRight * rhs_layout_cols;
+      __m512i accum[RowsRight];
+      for (int r = 0; r < RowsRight; ++r) {
+        accum[r] = _mm512_setzero_si512();
+      }
+      for (int k = 0; k < depth; ++k) {
+        const __m512i packed = _mm512_loadu_si512(lhs_val);
+        const __m512i lhs_hi =
+            _mm512_and_si512(_mm512_srli_epi16(packed, 4), bitmask);
+        const __m512i lhs_lo = _mm512_and_si512(packed, bitmask);
+        lhs_val += 64;
+        for (int r = 0; r < RowsRight; ++r) {
+          const __m512i rhs_hi = _mm512_broadcast_i32x4(
+              _mm_loadu_si128(reinterpret_cast<const __m128i*>(rhs_val)));
+          const __m512i rhs_lo = _mm512_broadcast_i32x4(
+              _mm_loadu_si128(reinterpret_cast<const __m128i*>(rhs_val + 16)));
+          rhs_val += 32;
+          accum[r] = _mm512_dpbusd_epi32(accum[r], lhs_hi, rhs_hi);
+          accum[r] = _mm512_dpbusd_epi32(accum[r], lhs_lo, rhs_lo);
+        }
+      }
+      for (int r = 0; r < RowsRight; ++r) {
+        const __m128i sum =
+            ReduceInt32x4x4(_mm512_extracti32x4_epi32(accum[r], 0),
+                            _mm512_extracti32x4_epi32(accum[r], 1),
+                            _mm512_extracti32x4_epi32(accum[r], 2),
+                            _mm512_extracti32x4_epi32(accum[r], 3));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(element_ptr), sum);
+        element_ptr += 4;
+      }
+    }
+  }
+}
+
+template void Avx512VnniRunKernel<4, 1, 32>(
+    const uint8_t* lhs, const int8_t* rhs, int32_t* dst, int lhs_layout_rows,
+    int lhs_layout_cols, int rhs_layout_rows, int rhs_layout_cols,
+    int dst_layout_rows, int dst_layout_cols);
+
+template void Avx512VnniRunKernel<4, 2, 32>(
+    const uint8_t* lhs, const int8_t* rhs, int32_t* dst, int lhs_layout_rows,
+    int lhs_layout_cols, int rhs_layout_rows, int rhs_layout_cols,
+    int dst_layout_rows, int dst_layout_cols);
+
+template void Avx512VnniRunKernel<4, 4, 32>(
+    const uint8_t* lhs, const int8_t* rhs, int32_t* dst, int lhs_layout_rows,
+    int lhs_layout_cols, int rhs_layout_rows, int rhs_layout_cols,
+    int dst_layout_rows, int dst_layout_cols);
+#endif  // defined(FC_4BIT_AVX512VNNI)
+
+template void Avx2Unpack<4, 1>(float* output_ptr, const int32_t* dst,
+                               int batch_size, int num_units,
+                               const float* scaling_factors,
+                               const float* filter_scales, int dst_layout_rows,
+                               int dst_layout_cols);
+
+template void Avx2Unpack<4, 2>(float* output_ptr, const int32_t* dst,
+                               int batch_size, int num_units,
+                               const float* scaling_factors,
+                               const float* filter_scales, int dst_layout_rows,
+                               int dst_layout_cols);
+
+template void Avx2Unpack<4, 4>(float* output_ptr, const int32_t* dst,
+                               int batch_size, int num_units,
+                               const float* scaling_factors,
+                               const float* filter_scales, int dst_layout_rows,
+                               int dst_layout_cols);
+
+template void Avx2RunKernel<4, 1, 32>(const uint8_t* lhs, const int8_t* rhs,
+                                      int32_t* dst, int lhs_layout_rows,
+                                      int lhs_layout_cols, int rhs_layout_rows,
+                                      int rhs_layout_cols, int dst_layout_rows,
+                                      int dst_layout_cols);
+
+template void Avx2RunKernel<4, 2, 32>(const uint8_t* lhs, const int8_t* rhs,
+                                      int32_t* dst, int lhs_layout_rows,
+                                      int lhs_layout_cols, int rhs_layout_rows,
+                                      int rhs_layout_cols, int dst_layout_rows,
+                                      int dst_layout_cols);
+
+template void Avx2RunKernel<4, 4, 32>(const uint8_t* lhs, const int8_t* rhs,
+                                      int32_t* dst, int lhs_layout_rows,
+                                      int lhs_layout_cols, int rhs_layout_rows,
+                                      int rhs_layout_cols, int dst_layout_rows,
+                                      int dst_layout_cols);
+
+}  // namespace optimized_4bit
+}  // namespace tflite
+
+#endif  // defined(FC_4BIT_AVX2)
+#endif  // defined(FC_4BIT_SSE) && defined(__SSSE3__)
@@ -0,0 +1,68 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_LITE_KERNELS_INTERNAL_OPTIMIZED_4BIT_AVX2_FULLY_CONNECTED_IMPL_H_
+#define TENSORFLOW_LITE_KERNELS_INTERNAL_OPTIMIZED_4BIT_AVX2_FULLY_CONNECTED_IMPL_H_
+#if defined(FC_4BIT_SSE) && defined(__SSSE3__)
+
+#include <stdint.h>
+
+#include "kernels/internal/optimized/cpu_check.h"
+
+// The kernels below have the same contract as their Sse* counterparts in
+// sse_fully_connected_impl.h. RunKernel and Unpack in sse_fully_connected.h
+// pick them when the CPU supports them.
+#if defined(TFLITE_AVX2_TARGET)
+#define FC_4BIT_AVX2
+#endif
+#if defined(TFLITE_AVX512VNNI_TARGET)
+#define FC_4BIT_AVX512VNNI
+#endif
+
+namespace tflite {
+namespace optimized_4bit {
+
+#if defined(FC_4BIT_AVX2)
+// Returns true if the Avx2* kernels may be called on this CPU.
+bool CanUseAvx2FullyConnected4Bit();
+
+template <int Depth, int Width>
+extern TFLITE_AVX2_TARGET void Avx2Unpack(
+    float* output_ptr, const int32_t* dst, int batch_size, int num_units,
+    const float* scaling_factors, const float* filter_scales,
+    int dst_layout_rows, int dst_layout_cols);
+
+template <int RowsLeft, int RowsRight, int Cols>
+extern TFLITE_AVX2_TARGET void Avx2RunKernel(
+    const uint8_t* lhs, const int8_t* rhs, int32_t* dst, int lhs_layout_rows,
+    int lhs_layout_cols, int rhs_layout_rows, int rhs_layout_cols,
+    int dst_layout_rows, int dst_layout_cols);
+#endif  // defined(FC_4BIT_AVX2)
+
+#if defined(FC_4BIT_AVX512VNNI)
+// Returns true if the Avx512Vnni* kernels may be called on this CPU.
+bool CanUseAvx512VnniFullyConnected4Bit();
+
+template <int RowsLeft, int RowsRight, int Cols>
+extern TFLITE_AVX512VNNI_TARGET void Avx512VnniRunKernel(
+    const uint8_t* lhs, const int8_t* rhs, int32_t* dst, int lhs_layout_rows,
+    int lhs_layout_cols, int rhs_layout_rows, int rhs_layout_cols,
+    int dst_layout_rows, int dst_layout_cols);
+#endif  // defined(FC_4BIT_AVX512VNNI)
+
+}  // namespace optimized_4bit
+}  // namespace tflite
+
+#endif  // defined(FC_4BIT_SSE) && defined(__SSSE3__)
+#endif  // TENSORFLOW_LITE_KERNELS_INTERNAL_OPTIMIZED_4BIT_AVX2_FULLY_CONNECTED_IMPL_H_
@@ -19,6 +19,7 @@ limitations under the License.
 
 #include <stdint.h>
 
+#include "kernels/internal/optimized/4bit/avx2_fully_connected_impl.h"
 #include "kernels/internal/optimized/4bit/sse_fully_connected_impl.h"
 
 namespace tflite {
@@ -72,81 +73,46 @@ void Unpack(float* output_ptr, const int32_t* dst, int batch_size,
             int num_units, const float* scaling_factors,
             const float* filter_scales, int dst_layout_rows,
             int dst_layout_cols) {
+#if defined(FC_4BIT_AVX2)
+  if (CanUseAvx2FullyConnected4Bit()) {
+    Avx2Unpack<Depth, Width>(output_ptr, dst, batch_size, num_units,
+                             scaling_factors, filter_scales, dst_layout_rows,
+                             dst_layout_cols);
+    return;
+  }
+#endif
   SseUnpack<Depth, Width>(output_ptr, dst, batch_size, num_units,
                           scaling_factors, filter_scales, dst_layout_rows,
                           dst_layout_cols);
 }
 
-// Compute sum of lhs * rhs columnwise.
+// Compute sum of lhs * rhs columnwise, using the widest kernel the CPU
+// supports.
 template <int RowsLeft, int RowsRight, int Cols>
 void RunKernel(const uint8_t* lhs, const int8_t* rhs, int32_t* dst,
                int lhs_layout_rows, int lhs_layout_cols, int rhs_layout_rows,
                int rhs_layout_cols, int dst_layout_rows, int dst_layout_cols) {
+#if defined(FC_4BIT_AVX512VNNI)
+  if (CanUseAvx512VnniFullyConnected4Bit()) {
+    Avx512VnniRunKernel<RowsLeft, RowsRight, Cols>(
+        lhs, rhs, dst, lhs_layout_rows, lhs_layout_cols, rhs_layout_rows,
+        rhs_layout_cols, dst_layout_rows, dst_layout_cols);
+    return;
+  }
+#endif
+#if defined(FC_4BIT_AVX2)
+  if (CanUseAvx2FullyConnected4Bit()) {
+    Avx2RunKernel<RowsLeft, RowsRight, Cols>(
+        lhs, rhs, dst, lhs_layout_rows, lhs_layout_cols, rhs_layout_rows,
+        rhs_layout_cols, dst_layout_rows, dst_layout_cols);
+    return;
+  }
+#endif
   SseRunKernel<RowsLeft, RowsRight, Cols>(
       lhs, rhs, dst, lhs_layout_rows, lhs_layout_cols, rhs_layout_rows,
       rhs_layout_cols, dst_layout_rows, dst_layout_cols);
 }
 
-template <>
-inline void Unpack<4, 1>(float* output_ptr, const int32_t* dst, int batch_size,
-                         int num_units, const float* scaling_factors,
-                         const float* filter_scales, int dst_layout_rows,
-                         int dst_layout_cols) {
-  SseUnpack<4, 1>(output_ptr, dst, batch_size, num_units, scaling_factors,
-                  filter_scales, dst_layout_rows, dst_layout_cols);
-}
-
-template <>
-inline void RunKernel<4, 1, 32>(const uint8_t* lhs, const int8_t* rhs,
-                                int32_t* dst, int lhs_layout_rows,
-                                int lhs_layout_cols, int rhs_layout_rows,
-                                int rhs_layout_cols, int dst_layout_rows,
-                                int dst_layout_cols) {
-  SseRunKernel<4, 1, 32>(lhs, rhs, dst, lhs_layout_rows, lhs_layout_cols,
-                         rhs_layout_rows, rhs_layout_cols, dst_layout_rows,
-                         dst_layout_cols);
-}
-
-template <>
-inline void Unpack<4, 2>(float* output_ptr, const int32_t* dst, int batch_size,
-                         int num_units, const float* scaling_factors,
-                         const float* filter_scales, int dst_layout_rows,
-                         int dst_layout_cols) {
-  SseUnpack<4, 2>(output_ptr, dst, batch_size, num_units, scaling_factors,
-                  filter_scales, dst_layout_rows, dst_layout_cols);
-}
-
-template <>
-inline void RunKernel<4, 2, 32>(const uint8_t* lhs, const int8_t* rhs,
-                                int32_t* dst, int lhs_layout_rows,
-                                int lhs_layout_cols, int rhs_layout_rows,
-                                int rhs_layout_cols, int dst_layout_rows,
-                                int dst_layout_cols) {
-  SseRunKernel<4, 2, 32>(lhs, rhs, dst, lhs_layout_rows, lhs_layout_cols,
-                         rhs_layout_rows, rhs_layout_cols, dst_layout_rows,
-                         dst_layout_cols);
-}
-
-template <>
-inline void Unpack<4, 4>(float* output_ptr, const int32_t* dst, int batch_size,
-                         int num_units, const float* scaling_factors,
-                         const float* filter_scales, int dst_layout_rows,
-                         int dst_layout_cols) {
-  SseUnpack<4, 4>(output_ptr, dst, batch_size, num_units, scaling_factors,
-                  filter_scales, dst_layout_rows, dst_layout_cols);
-}
-
-template <>
-inline void RunKernel<4, 4, 32>(const uint8_t* lhs, const int8_t* rhs,
-                                int32_t* dst, int lhs_layout_rows,
-                                int lhs_layout_cols, int rhs_layout_rows,
-                                int rhs_layout_cols, int dst_layout_rows,
-                                int dst_layout_cols) {
-  SseRunKernel<4, 4, 32>(lhs, rhs, dst, lhs_layout_rows, lhs_layout_cols,
-                         rhs_layout_rows, rhs_layout_cols, dst_layout_rows,
-                         dst_layout_cols);
-}
-
 // Compute sum of lhs * rhs columnwise and write output to output_ptr.
 inline void RunAndUnpack(int rhs_width, const uint8_t* lhs, const int8_t* rhs,
                          int32_t* dst, int output_depth, int batch_size,
@@ -156,26 +122,26 @@ inline void RunAndUnpack(int rhs_width, const uint8_t* lhs, const int8_t* rhs,
                          float* output_ptr, const float* scaling_factors,
                          const float* filter_scales) {
   if (rhs_width >= 4) {
-    SseRunKernel<4, 4, 32>(lhs, rhs, dst, lhs_layout_rows, lhs_layout_cols,
-                           rhs_layout_rows, rhs_layout_cols, dst_layout_rows,
-                           dst_layout_cols);
-    SseUnpack<4, 4>(output_ptr, dst, batch_size, output_depth, scaling_factors,
-                    filter_scales, dst_layout_rows, dst_layout_cols);
+    RunKernel<4, 4, 32>(lhs, rhs, dst, lhs_layout_rows, lhs_layout_cols,
+                        rhs_layout_rows, rhs_layout_cols, dst_layout_rows,
+                        dst_layout_cols);
+    Unpack<4, 4>(output_ptr, dst, batch_size, output_depth, scaling_factors,
+                 filter_scales, dst_layout_rows, dst_layout_cols);
     return;
   }
   if (rhs_width >= 2) {
-    SseRunKernel<4, 2, 32>(lhs, rhs, dst, lhs_layout_rows, lhs_layout_cols,
-                           rhs_layout_rows, rhs_layout_cols, dst_layout_rows,
-                           dst_layout_cols);
-    SseUnpack<4, 2>(output_ptr, dst, batch_size, output_depth, scaling_factors,
-                    filter_scales, dst_layout_rows, dst_layout_cols);
+    RunKernel<4, 2, 32>(lhs, rhs, dst, lhs_layout_rows, lhs_layout_cols,
+                        rhs_layout_rows, rhs_layout_cols, dst_layout_rows,
+                        dst_layout_cols);
+    Unpack<4, 2>(output_ptr, dst, batch_size, output_depth, scaling_factors,
+                 filter_scales, dst_layout_rows, dst_layout_cols);
     return;
   }
-  SseRunKernel<4, 1, 32>(lhs, rhs, dst, lhs_layout_rows, lhs_layout_cols,
-                         rhs_layout_rows, rhs_layout_cols, dst_layout_rows,
-                         dst_layout_cols);
-  SseUnpack<4, 1>(output_ptr, dst, batch_size, output_depth, scaling_factors,
-                  filter_scales, dst_layout_rows, dst_layout_cols);
+  RunKernel<4, 1, 32>(lhs, rhs, dst, lhs_layout_rows, lhs_layout_cols,
+                      rhs_layout_rows, rhs_layout_cols, dst_layout_rows,
+                      dst_layout_cols);
+  Unpack<4, 1>(output_ptr, dst, batch_size, output_depth, scaling_factors,
+               filter_scales, dst_layout_rows, dst_layout_cols);
 }
 
 }  // namespace optimized_4bit
@@ -19,6 +19,16 @@ limitations under the License.
 #include <sys/auxv.h>
 #endif
 
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || \
+    defined(_M_IX86)
+#define TFLITE_CPU_CHECK_X86
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
 namespace tflite {
 
 namespace {
@@ -37,6 +47,72 @@ bool DetectDotprodByLinuxAuxvMethod() {
 }
 #endif
 
+#ifdef TFLITE_CPU_CHECK_X86
+struct X86Features {
+  bool avx2_fma = false;
+  bool avx512_vnni = false;
+};
+
+void RunCpuid(unsigned int leaf, unsigned int subleaf, unsigned int regs[4]) {
+#if defined(_MSC_VER)
+  int out[4];
+  __cpuidex(out, static_cast<int>(leaf), static_cast<int>(subleaf));
+  for (int i = 0; i < 4; ++i) regs[i] = static_cast<unsigned int>(out[i]);
+#else
+  __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+// Returns the low half of XCR0, i.e. the register states the OS saves and
+// restores on context switches. Only valid when CPUID reports OSXSAVE.
+unsigned int ReadXcr0() {
+#if defined(_MSC_VER)
+  return static_cast<unsigned int>(_xgetbv(0));
+#else
+  unsigned int eax, edx;
+  __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+  return eax;
+#endif
+}
+
+X86Features DetectX86Features() {
+  X86Features features;
+  unsigned int regs[4];  // eax, ebx, ecx, edx
+  RunCpuid(0, 0, regs);
+  const unsigned int max_leaf = regs[0];
+  if (max_leaf < 7) return features;
+
+  RunCpuid(1, 0, regs);
+  const bool has_fma = regs[2] & (1u << 12);
+  const bool has_osxsave = regs[2] & (1u << 27);
+  const bool has_avx = regs[2] & (1u << 28);
+  if (!has_osxsave || !has_avx) return features;
+  const unsigned int xcr0 = ReadXcr0();
+  // XMM and YMM state.
+  const bool os_saves_ymm = (xcr0 & 0x6) == 0x6;
+  // Opmask, upper ZMM0-15 and ZMM16-31 state on top of the above.
+  const bool os_saves_zmm = (xcr0 & 0xe6) == 0xe6;
+
+  RunCpuid(7, 0, regs);
+  const bool has_avx2 = regs[1] & (1u << 5);
+  const bool has_avx512f = regs[1] & (1u << 16);
+  const bool has_avx512bw = regs[1] & (1u << 30);
+  const bool has_avx512vl = regs[1] & (1u << 31);
+  const bool has_avx512vnni = regs[2] & (1u << 11);
+
+  features.avx2_fma = os_saves_ymm && has_avx2 && has_fma;
+  features.avx512_vnni = features.avx2_fma && os_saves_zmm && has_avx512f &&
+                         has_avx512bw && has_avx512vl && has_avx512vnni;
+  return features;
+}
+
+// CPUID is a serializing instruction, so query it only once per process.
+const X86Features& GetX86Features() {
+  static const X86Features features = DetectX86Features();
+  return features;
+}
+#endif  // TFLITE_CPU_CHECK_X86
+
 }  // namespace
 
 bool DetectArmNeonDotprod() {
@@ -47,4 +123,20 @@ bool DetectArmNeonDotprod() {
   return false;
 }
 
+bool DetectX86Avx2Fma() {
+#ifdef TFLITE_CPU_CHECK_X86
+  return GetX86Features().avx2_fma;
+#else
+  return false;
+#endif
+}
+
+bool DetectX86Avx512Vnni() {
+#ifdef TFLITE_CPU_CHECK_X86
+  return GetX86Features().avx512_vnni;
+#else
+  return false;
+#endif
+}
+
 }  // namespace tflite
@@ -21,18 +21,56 @@ limitations under the License.
 // any such issues. This requires running more than just TFLite presubmits.
 #include "kernels/internal/optimized/neon_check.h"
 
+// x86 kernels that need more than the baseline ISA of the build are either
+// compiled for the whole translation unit when the compiler flags allow it
+// (e.g. -mavx2), or, on GCC and Clang, compiled with per-function target
+// attributes and selected at runtime with the Detect* functions below.
+// TFLITE_AVX2_TARGET and TFLITE_AVX512VNNI_TARGET are only defined when such
+// kernels can be built. Define TFLITE_DISABLE_X86_RUNTIME_DISPATCH to only use
+// what the compiler flags allow.
+#if defined(__SSSE3__) && (defined(__GNUC__) || defined(__clang__)) && \
+    !defined(TFLITE_DISABLE_X86_RUNTIME_DISPATCH)
+#define TFLITE_X86_RUNTIME_DISPATCH
+#endif
+
+#if defined(__AVX2__)
+#define TFLITE_AVX2_TARGET
+#elif defined(TFLITE_X86_RUNTIME_DISPATCH)
+#define TFLITE_AVX2_TARGET __attribute__((target("avx2,fma")))
+#endif
+
+#if defined(__AVX512VNNI__) && defined(__AVX512BW__) && defined(__AVX512VL__)
+#define TFLITE_AVX512VNNI_TARGET
+#elif defined(TFLITE_X86_RUNTIME_DISPATCH) && \
+    (defined(__clang__) || __GNUC__ >= 8)
+#define TFLITE_AVX512VNNI_TARGET \
+  __attribute__((target("avx2,fma,avx512f,avx512bw,avx512vl,avx512vnni")))
+#endif
+
 namespace tflite {
 
 // On A64, returns true if the dotprod extension is present.
 // On other architectures, returns false unconditionally.
 bool DetectArmNeonDotprod();
 
+// On x86, returns true if both the CPU and the OS support AVX2 and FMA.
+// On other architectures, returns false unconditionally.
+bool DetectX86Avx2Fma();
+
+// On x86, returns true if both the CPU and the OS support AVX-512 F, BW, VL
+// and VNNI. On other architectures, returns false unconditionally.
+bool DetectX86Avx512Vnni();
+
 struct CpuFlags {
   bool neon_dotprod = false;
+  bool x86_avx2_fma = false;
+  bool x86_avx512_vnni = false;
 };
 
 inline void GetCpuFlags(CpuFlags* cpu_flags) {
   cpu_flags->neon_dotprod = DetectArmNeonDotprod();
+  cpu_flags->x86_avx2_fma = DetectX86Avx2Fma();
+  cpu_flags->x86_avx512_vnni = DetectX86Avx512Vnni();
 }
 
 }  // namespace tflite
@@ -455,6 +455,41 @@ inline void AddScalarBroadcast(int size, const ArithmeticParams& params,
   }
 }
 
+// 16bit version of the scalar-broadcast add above. The broadcast input is
+// rescaled once, the loop over the other input is the scalar tail of
+// AddElementwiseInt16.
+inline void AddScalarBroadcastInt16(int size, const ArithmeticParams& params,
+                                    int16 input1_data, const int16* input2_data,
+                                    int16* output_data) {
+  ruy::profiler::ScopeLabel label("AddScalarBroadcastInt16/16bit");
+  TFLITE_DCHECK_GT(params.input1_offset, -32768);
+  TFLITE_DCHECK_GT(params.input2_offset, -32768);
+  TFLITE_DCHECK_LT(params.input1_offset, 32768);
+  TFLITE_DCHECK_LT(params.input2_offset, 32768);
+
+  const int32 input1_val = params.input1_offset + input1_data;
+  const int32 shifted_input1_val = input1_val * (1 << params.left_shift);
+  const int32 scaled_input1_val =
+      MultiplyByQuantizedMultiplierSmallerThanOneExp(
+          shifted_input1_val, params.input1_multiplier, params.input1_shift);
+  for (int i = 0; i < size; ++i) {
+    const int32 input2_val = params.input2_offset + input2_data[i];
+    const int32 shifted_input2_val = input2_val * (1 << params.left_shift);
+    const int32 scaled_input2_val =
+        MultiplyByQuantizedMultiplierSmallerThanOneExp(
+            shifted_input2_val, params.input2_multiplier, params.input2_shift);
+    const int32 raw_sum = scaled_input1_val + scaled_input2_val;
+    const int32 raw_output =
+        MultiplyByQuantizedMultiplierSmallerThanOneExp(
+            raw_sum, params.output_multiplier, params.output_shift) +
+        params.output_offset;
+    const int32 clamped_output =
+        std::min(params.quantized_activation_max,
+                 std::max(params.quantized_activation_min, raw_output));
+    output_data[i] = static_cast<int16>(clamped_output);
+  }
+}
+
 inline void Add(const ArithmeticParams& params,
                 const RuntimeShape& input1_shape, const int8* input1_data,
                 const RuntimeShape& input2_shape, const int8* input2_data,
@@ -507,6 +542,24 @@ inline void BroadcastAddDispatch(const ArithmeticParams& params,
       output_shape, output_data, AddElementwiseInt8, AddScalarBroadcast);
 }
 
+inline void BroadcastAddDispatch(const ArithmeticParams& params,
+                                 const RuntimeShape& input1_shape,
+                                 const int16* input1_data,
+                                 const RuntimeShape& input2_shape,
+                                 const int16* input2_data,
+                                 const RuntimeShape& output_shape,
+                                 int16* output_data) {
+  if (params.broadcast_category == BroadcastableOpCategory::kGenericBroadcast) {
+    return reference_ops::BroadcastAdd6DSlow(params, input1_shape, input1_data,
+                                             input2_shape, input2_data,
+                                             output_shape, output_data);
+  }
+
+  optimized_ops::BinaryBroadcastFiveFold(
+      params, input1_shape, input1_data, input2_shape, input2_data,
+      output_shape, output_data, AddElementwiseInt16, AddScalarBroadcastInt16);
+}
+
 }  // namespace optimized_integer_ops
 }  // namespace tflite
 
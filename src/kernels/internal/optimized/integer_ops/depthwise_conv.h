@@ -31,6 +31,7 @@ limitations under the License.
 #include "kernels/internal/optimized/neon_check.h"
 #include "kernels/internal/optimized/optimized_ops.h"
 #include "kernels/internal/reference/depthwiseconv_uint8.h"
+#include "kernels/internal/reference/integer_ops/depthwise_conv.h"
 #include "kernels/internal/types.h"
 
 namespace tflite {
@@ -1798,6 +1799,189 @@ inline void DepthwiseConvGeneral(
   }
 }
 
+// 16x8 variant of QuantizedDepthwiseConvAccumRowGeneric: int16 activations,
+// which are symmetric and so need no input offset, times int8 filter values.
+inline void QuantizedDepthwiseConvAccumRow16x8(
+    int stride, int dilation_factor, int input_depth, int input_width,
+    const int16* input_data, int pad_width, int depth_multiplier,
+    int filter_width, const int8* filter_data, int out_x_buffer_start,
+    int out_x_buffer_end, int output_depth, int32* acc_buffer) {
+  ruy::profiler::ScopeLabel label("DepthwiseConvAccumRow16x8");
+  const int8* filter_base_ptr = filter_data;
+  for (int filter_x = 0; filter_x < filter_width; ++filter_x) {
+    const int out_x_loop_start = std::max(
+        out_x_buffer_start,
+        (pad_width - dilation_factor * filter_x + stride - 1) / stride);
+    const int out_x_loop_end = std::min(
+        out_x_buffer_end,
+        (pad_width + input_width - dilation_factor * filter_x + stride - 1) /
+            stride);
+
+    int32* acc_buffer_ptr =
+        acc_buffer + (out_x_loop_start - out_x_buffer_start) * output_depth;
+    const int in_x_origin =
+        (out_x_loop_start * stride) - pad_width + dilation_factor * filter_x;
+    const int16* input_ptr = input_data + in_x_origin * input_depth;
+    const int input_ptr_increment = stride * input_depth;
+    for (int out_x = out_x_loop_start; out_x < out_x_loop_end; out_x++) {
+      if (depth_multiplier == 1) {
+        // The common case: one output channel per input channel, so input,
+        // filter and accumulators are all contiguous along the depth.
+        int ic = 0;
+#ifdef USE_NEON
+        for (; ic <= input_depth - 8; ic += 8) {
+          const int16x8_t input = vld1q_s16(input_ptr + ic);
+          const int16x8_t filter = vmovl_s8(vld1_s8(filter_base_ptr + ic));
+          int32x4_t acc_lo = vld1q_s32(acc_buffer_ptr + ic);
+          int32x4_t acc_hi = vld1q_s32(acc_buffer_ptr + ic + 4);
+          acc_lo =
+              vmlal_s16(acc_lo, vget_low_s16(input), vget_low_s16(filter));
+          acc_hi =
+              vmlal_s16(acc_hi, vget_high_s16(input), vget_high_s16(filter));
+          vst1q_s32(acc_buffer_ptr + ic, acc_lo);
+          vst1q_s32(acc_buffer_ptr + ic + 4, acc_hi);
+        }
+#endif
+        for (; ic < input_depth; ++ic) {
+          acc_buffer_ptr[ic] += static_cast<int32>(filter_base_ptr[ic]) *
+                                static_cast<int32>(input_ptr[ic]);
+        }
+        acc_buffer_ptr += output_depth;
+      } else {
+        const int8* filter_ptr = filter_base_ptr;
+        for (int ic = 0; ic < input_depth; ++ic) {
+          const int32 input_val = input_ptr[ic];
+          for (int m = 0; m < depth_multiplier; m++) {
+            *acc_buffer_ptr++ += static_cast<int32>(*filter_ptr++) * input_val;
+          }
+        }
+      }
+      input_ptr += input_ptr_increment;
+    }
+    filter_base_ptr += output_depth;
+  }
+}
+
+// 16x8 counterpart of DepthwiseConvGeneral. The int8 * int16 products are
+// accumulated in int32 (see DepthwiseConvPerChannel for why that is exact);
+// the int64 bias is only added when downquantizing, which therefore matches
+// reference_integer_ops::DepthwiseConvPerChannel bit for bit.
+inline void DepthwiseConv16x8General(
+    const DepthwiseParams& params, const int32* output_multiplier,
+    const int32* output_shift, const RuntimeShape& input_shape,
+    const int16* input_data, const RuntimeShape& filter_shape,
+    const int8* filter_data, const RuntimeShape& bias_shape,
+    const std::int64_t* bias_data, const RuntimeShape& output_shape,
+    int16* output_data, int thread_start, int thread_end, int thread_dim) {
+  ruy::profiler::ScopeLabel label("DepthwiseConvInt16/General");
+  const int stride_width = params.stride_width;
+  const int stride_height = params.stride_height;
+  const int pad_width = params.padding_values.width;
+  const int pad_height = params.padding_values.height;
+  const int depth_multiplier = params.depth_multiplier;
+  const int32 output_activation_min = params.quantized_activation_min;
+  const int32 output_activation_max = params.quantized_activation_max;
+  const int dilation_width_factor = params.dilation_width_factor;
+  const int dilation_height_factor = params.dilation_height_factor;
+  const int batches = MatchingDim(input_shape, 0, output_shape, 0);
+  const int output_depth = MatchingDim(filter_shape, 3, output_shape, 3);
+  const int input_height = input_shape.Dims(1);
+  const int input_width = input_shape.Dims(2);
+  const int input_depth = input_shape.Dims(3);
+  const int filter_height = filter_shape.Dims(1);
+  const int filter_width = filter_shape.Dims(2);
+  const int output_rows = output_shape.Dims(1);
+  const int output_width = output_shape.Dims(2);
+  TFLITE_DCHECK_EQ(output_depth, input_depth * depth_multiplier);
+
+  static const int kAccBufferMaxSize = 2048;
+  int acc_buffer_size = kAccBufferMaxSize;
+  int32 stack_acc_buffer[kAccBufferMaxSize];
+  int32* acc_buffer = stack_acc_buffer;
+#ifndef TF_LITE_STATIC_MEMORY
+  std::unique_ptr<int32[]> heap_acc_buffer;
+  if (kAccBufferMaxSize < output_depth) {
+    heap_acc_buffer.reset(new int32[output_depth]);
+    acc_buffer = heap_acc_buffer.get();
+    acc_buffer_size = output_depth;
+  }
+#endif
+  TFLITE_DCHECK_GE(acc_buffer_size, output_depth);
+  const int kOutputPixelsInAccBuffer = acc_buffer_size / output_depth;
+  TFLITE_DCHECK_GE(kOutputPixelsInAccBuffer, 1);
+  TFLITE_DCHECK(thread_dim == 0 || thread_dim == 1);
+
+  const int input_height_stride = input_shape.Dims(3) * input_shape.Dims(2);
+  const int input_batch_stride = input_height_stride * input_shape.Dims(1);
+  const int filter_height_stride = filter_shape.Dims(3) * filter_shape.Dims(2);
+
+  int batch_start = 0;
+  int batch_end = batches;
+  int row_start = 0;
+  int row_end = output_rows;
+  if (thread_dim == 0) {
+    TFLITE_DCHECK_GE(thread_start, 0);
+    TFLITE_DCHECK_LE(thread_end, batches);
+    batch_start = thread_start;
+    batch_end = thread_end;
+  } else {
+    TFLITE_DCHECK_GE(thread_start, 0);
+    TFLITE_DCHECK_LE(thread_end, output_rows);
+    row_start = thread_start;
+    row_end = thread_end;
+  }
+
+  for (int b = batch_start; b < batch_end; ++b) {
+    for (int out_y = row_start; out_y < row_end; ++out_y) {
+      const int in_y_origin = (out_y * stride_height) - pad_height;
+      const int filter_y_start =
+          std::max(0, (-in_y_origin + dilation_height_factor - 1) /
+                          dilation_height_factor);
+      const int filter_y_end =
+          std::min(filter_height,
+                   (input_height - in_y_origin + dilation_height_factor - 1) /
+                       dilation_height_factor);
+      int16* output_ptr =
+          output_data + Offset(output_shape, b, out_y, 0, 0);
+      for (int out_x_buffer_start = 0; out_x_buffer_start < output_width;
+           out_x_buffer_start += kOutputPixelsInAccBuffer) {
+        const int out_x_buffer_end = std::min(
+            output_width, out_x_buffer_start + kOutputPixelsInAccBuffer);
+        const int num_output_pixels = out_x_buffer_end - out_x_buffer_start;
+        memset(acc_buffer, 0,
+               sizeof(acc_buffer[0]) * num_output_pixels * output_depth);
+        for (int filter_y = filter_y_start; filter_y < filter_y_end;
+             ++filter_y) {
+          const int in_y = in_y_origin + dilation_height_factor * filter_y;
+          QuantizedDepthwiseConvAccumRow16x8(
+              stride_width, dilation_width_factor, input_depth, input_width,
+              input_data + in_y * input_height_stride + b * input_batch_stride,
+              pad_width, depth_multiplier, filter_width,
+              filter_data + filter_y * filter_height_stride, out_x_buffer_start,
+              out_x_buffer_end, output_depth, acc_buffer);
+        }
+        ruy::profiler::ScopeLabel label("downquantize+store");
+        const int32* acc_ptr = acc_buffer;
+        for (int i = 0; i < num_output_pixels; ++i) {
+          for (int c = 0; c < output_depth; ++c) {
+            std::int64_t acc = acc_ptr[c];
+            if (bias_data) {
+              acc += bias_data[c];
+            }
+            int32 scaled_acc = MultiplyByQuantizedMultiplier(
+                acc, output_multiplier[c], output_shift[c]);
+            scaled_acc = std::max(scaled_acc, output_activation_min);
+            scaled_acc = std::min(scaled_acc, output_activation_max);
+            output_ptr[c] = static_cast<int16>(scaled_acc);
+          }
+          acc_ptr += output_depth;
+          output_ptr += output_depth;
+        }
+      }
+    }
+  }
+}
+
 }  // namespace depthwise_conv
 
 template <DepthwiseConvOutputRounding kOutputRounding>
@@ -1899,6 +2083,53 @@ inline void DepthwiseConvImpl(
       output_data, thread_start, thread_end, thread_dim, cpu_backend_context);
 }
 
+struct DepthwiseConv16x8WorkerTask : cpu_backend_threadpool::Task {
+  DepthwiseConv16x8WorkerTask(
+      const DepthwiseParams& params, const int32* output_multiplier,
+      const int32* output_shift, const RuntimeShape& input_shape,
+      const int16* input_data, const RuntimeShape& filter_shape,
+      const int8* filter_data, const RuntimeShape& bias_shape,
+      const std::int64_t* bias_data, const RuntimeShape& output_shape,
+      int16* output_data, int thread_start, int thread_end, int thread_dim)
+      : params_(params),
+        output_multiplier_(output_multiplier),
+        output_shift_(output_shift),
+        input_shape_(input_shape),
+        input_data_(input_data),
+        filter_shape_(filter_shape),
+        filter_data_(filter_data),
+        bias_shape_(bias_shape),
+        bias_data_(bias_data),
+        output_shape_(output_shape),
+        output_data_(output_data),
+        thread_start_(thread_start),
+        thread_end_(thread_end),
+        thread_dim_(thread_dim) {}
+
+  void Run() override {
+    depthwise_conv::DepthwiseConv16x8General(
+        params_, output_multiplier_, output_shift_, input_shape_, input_data_,
+        filter_shape_, filter_data_, bias_shape_, bias_data_, output_shape_,
+        output_data_, thread_start_, thread_end_, thread_dim_);
+  }
+
+ private:
+  const DepthwiseParams& params_;
+  const int32* output_multiplier_;
+  const int32* output_shift_;
+  const RuntimeShape& input_shape_;
+  const int16* input_data_;
+  const RuntimeShape& filter_shape_;
+  const int8* filter_data_;
+  const RuntimeShape& bias_shape_;
+  const std::int64_t* bias_data_;
+  const RuntimeShape& output_shape_;
+  int16* output_data_;
+  int thread_start_;
+  int thread_end_;
+  int thread_dim_;
+};
+
 template <typename T, typename TS>
 struct DepthwiseConvWorkerTask : cpu_backend_threadpool::Task {
   DepthwiseConvWorkerTask(const DepthwiseParams& params,
@@ -2022,6 +2253,75 @@ inline void DepthwiseConvPerChannel(
   }
 }
 
+// 16x8 per-channel depthwise conv: int16 activations, int8 weights and an
+// optional int64 bias. Each int8 * int16 product is at most 2^22 in
+// magnitude, so the int32 accumulators cannot overflow as long as the filter
+// has fewer than 512 taps; larger filters go to the reference kernel, which
+// accumulates in int64.
+inline void DepthwiseConvPerChannel(
+    const DepthwiseParams& params, const int32* output_multiplier,
+    const int32* output_shift, const RuntimeShape& input_shape,
+    const int16* input_data, const RuntimeShape& filter_shape,
+    const int8* filter_data, const RuntimeShape& bias_shape,
+    const std::int64_t* bias_data, const RuntimeShape& output_shape,
+    int16* output_data, CpuBackendContext* cpu_backend_context) {
+  ruy::profiler::ScopeLabel label("DepthwiseConvInt16");
+  TFLITE_DCHECK_EQ(input_shape.DimensionsCount(), 4);
+  TFLITE_DCHECK_EQ(filter_shape.DimensionsCount(), 4);
+  TFLITE_DCHECK_EQ(output_shape.DimensionsCount(), 4);
+
+  constexpr int kMaxFilterTapsForInt32Accumulators = 511;
+  if (filter_shape.Dims(1) * filter_shape.Dims(2) >
+      kMaxFilterTapsForInt32Accumulators) {
+    reference_integer_ops::DepthwiseConvPerChannel(
+        params, output_multiplier, output_shift, input_shape, input_data,
+        filter_shape, filter_data, bias_shape, bias_data, output_shape,
+        output_data);
+    return;
+  }
+
+  const int output_batches = output_shape.Dims(0);
+  const int output_rows = output_shape.Dims(1);
+  int thread_count_batch = HowManyConvThreads(output_shape, filter_shape, 0);
+  int thread_count_row = HowManyConvThreads(output_shape, filter_shape, 1);
+  int thread_dim, thread_count, thread_dim_size;
+  if (thread_count_batch > thread_count_row) {
+    thread_dim = 0;
+    thread_dim_size = output_batches;
+    thread_count = thread_count_batch;
+  } else {
+    thread_dim = 1;
+    thread_dim_size = output_rows;
+    thread_count = thread_count_row;
+  }
+
+  const int max_threads = cpu_backend_context->max_num_threads();
+  thread_count = std::max(1, std::min(thread_count, max_threads));
+
+  if (thread_count == 1) {
+    depthwise_conv::DepthwiseConv16x8General(
+        params, output_multiplier, output_shift, input_shape, input_data,
+        filter_shape, filter_data, bias_shape, bias_data, output_shape,
+        output_data, /*thread_start=*/0, /*thread_end=*/output_rows,
+        /*thread_dim=*/1);
+  } else {
+    std::vector<DepthwiseConv16x8WorkerTask> tasks;
+    tasks.reserve(thread_count);
+    int thread_start = 0;
+    for (int i = 0; i < thread_count; ++i) {
+      int thread_end =
+          thread_start + (thread_dim_size - thread_start) / (thread_count - i);
+      tasks.emplace_back(params, output_multiplier, output_shift, input_shape,
+                         input_data, filter_shape, filter_data, bias_shape,
+                         bias_data, output_shape, output_data, thread_start,
+                         thread_end, thread_dim);
+      thread_start = thread_end;
+    }
+    cpu_backend_threadpool::Execute(tasks.size(), tasks.data(),
+                                    cpu_backend_context);
+  }
+}
+
 }  // namespace optimized_integer_ops
 }  // namespace tflite
 
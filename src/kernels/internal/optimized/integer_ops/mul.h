@@ -229,6 +229,47 @@ inline void MulSimpleBroadcast(int size, const ArithmeticParams& params,
   }
 }
 
+// 16bit element-wise mul. The 16x8 quantization scheme is symmetric, so the
+// offsets are zero and the product of two int16 values always fits in int32.
+inline void MulElementwiseInt16(int size, const ArithmeticParams& params,
+                                const int16* input1_data,
+                                const int16* input2_data, int16* output_data) {
+  ruy::profiler::ScopeLabel label("MulElementwiseInt16/16bit");
+  TFLITE_DCHECK_EQ(params.input1_offset, 0);
+  TFLITE_DCHECK_EQ(params.input2_offset, 0);
+  TFLITE_DCHECK_EQ(params.output_offset, 0);
+  for (int i = 0; i < size; ++i) {
+    const int32 unclamped_result = MultiplyByQuantizedMultiplier(
+        static_cast<int32>(input1_data[i]) * input2_data[i],
+        params.output_multiplier, params.output_shift);
+    const int32 clamped_output =
+        std::min(params.quantized_activation_max,
+                 std::max(params.quantized_activation_min, unclamped_result));
+    output_data[i] = static_cast<int16>(clamped_output);
+  }
+}
+
+// 16bit version of MulSimpleBroadcast, see MulElementwiseInt16 above.
+inline void MulSimpleBroadcastInt16(int size, const ArithmeticParams& params,
+                                    const int16 broadcast_value,
+                                    const int16* input2_data,
+                                    int16* output_data) {
+  ruy::profiler::ScopeLabel label("MulSimpleBroadcastInt16/16bit");
+  TFLITE_DCHECK_EQ(params.input1_offset, 0);
+  TFLITE_DCHECK_EQ(params.input2_offset, 0);
+  TFLITE_DCHECK_EQ(params.output_offset, 0);
+  const int32 input1_val = broadcast_value;
+  for (int i = 0; i < size; ++i) {
+    const int32 unclamped_result = MultiplyByQuantizedMultiplier(
+        input1_val * input2_data[i], params.output_multiplier,
+        params.output_shift);
+    const int32 clamped_output =
+        std::min(params.quantized_activation_max,
+                 std::max(params.quantized_activation_min, unclamped_result));
+    output_data[i] = static_cast<int16>(clamped_output);
+  }
+}
+
 inline void Mul(const ArithmeticParams& params,
                 const RuntimeShape& input1_shape, const int8* input1_data,
                 const RuntimeShape& input2_shape, const int8* input2_data,
@@ -242,6 +283,20 @@ inline void Mul(const ArithmeticParams& params,
   MulElementwise(flat_size, params, input1_data, input2_data, output_data);
 }
 
+inline void Mul(const ArithmeticParams& params,
+                const RuntimeShape& input1_shape, const int16* input1_data,
+                const RuntimeShape& input2_shape, const int16* input2_data,
+                const RuntimeShape& output_shape, int16* output_data) {
+  TFLITE_DCHECK_LE(params.quantized_activation_min,
+                   params.quantized_activation_max);
+  ruy::profiler::ScopeLabel label("MulInt16/16bit");
+  const int flat_size =
+      MatchingElementsSize(input1_shape, input2_shape, output_shape);
+
+  MulElementwiseInt16(flat_size, params, input1_data, input2_data,
+                      output_data);
+}
+
 inline void BroadcastMulDispatch(const ArithmeticParams& params,
                                  const RuntimeShape& input1_shape,
                                  const int8* input1_data,
@@ -260,6 +315,24 @@ inline void BroadcastMulDispatch(const ArithmeticParams& params,
       output_shape, output_data, MulElementwise, MulSimpleBroadcast);
 }
 
+inline void BroadcastMulDispatch(const ArithmeticParams& params,
+                                 const RuntimeShape& input1_shape,
+                                 const int16* input1_data,
+                                 const RuntimeShape& input2_shape,
+                                 const int16* input2_data,
+                                 const RuntimeShape& output_shape,
+                                 int16* output_data) {
+  if (params.broadcast_category == BroadcastableOpCategory::kGenericBroadcast) {
+    return reference_integer_ops::BroadcastMul6DSlow(
+        params, input1_shape, input1_data, input2_shape, input2_data,
+        output_shape, output_data);
+  }
+
+  optimized_ops::BinaryBroadcastFiveFold(
+      params, input1_shape, input1_data, input2_shape, input2_data,
+      output_shape, output_data, MulElementwiseInt16, MulSimpleBroadcastInt16);
+}
+
 }  // namespace optimized_integer_ops
 }  // namespace tflite
 
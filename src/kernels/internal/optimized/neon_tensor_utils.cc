@@ -259,6 +259,78 @@ void NeonMatrixBatchVectorMultiplyAccumulate(const float* matrix, int m_rows,
   }
 }
 
+void NeonMatrixBatchVectorMultiplyBias(const float* matrix, int m_rows,
+                                       int m_cols, const float* vector,
+                                       const float* bias, int n_batch,
+                                       float* result, int result_stride) {
+  const int postamble_start =
+      RoundDownVectors<kFloatValuesPerNeonVector>(m_cols);
+  // Four rows share each load of the vector, which is what makes the
+  // per-timestep matrix-vector products of the recurrent kernels bound by the
+  // weight bandwidth rather than by the vector loads.
+  const int m_rows_rounddown_4 = m_rows & ~3;
+
+  for (int b = 0; b < n_batch; b++) {
+    float* result_in_batch = result + b * result_stride;
+    const float* vector_in_batch = vector + b * m_cols;
+
+    int r = 0;
+    for (; r < m_rows_rounddown_4; r += 4) {
+      const float* row0 = matrix + (r + 0) * m_cols;
+      const float* row1 = matrix + (r + 1) * m_cols;
+      const float* row2 = matrix + (r + 2) * m_cols;
+      const float* row3 = matrix + (r + 3) * m_cols;
+      float32x4_t acc0_32x4 = vmovq_n_f32(0.0);
+      float32x4_t acc1_32x4 = vmovq_n_f32(0.0);
+      float32x4_t acc2_32x4 = vmovq_n_f32(0.0);
+      float32x4_t acc3_32x4 = vmovq_n_f32(0.0);
+      int c = 0;
+      for (; c < postamble_start; c += kFloatValuesPerNeonVector) {
+        const float32x4_t vector_f32x4 = vld1q_f32(vector_in_batch + c);
+        acc0_32x4 = vmlaq_f32(acc0_32x4, vld1q_f32(row0 + c), vector_f32x4);
+        acc1_32x4 = vmlaq_f32(acc1_32x4, vld1q_f32(row1 + c), vector_f32x4);
+        acc2_32x4 = vmlaq_f32(acc2_32x4, vld1q_f32(row2 + c), vector_f32x4);
+        acc3_32x4 = vmlaq_f32(acc3_32x4, vld1q_f32(row3 + c), vector_f32x4);
+      }
+      float sum0 = AccumulateNeonLane(acc0_32x4);
+      float sum1 = AccumulateNeonLane(acc1_32x4);
+      float sum2 = AccumulateNeonLane(acc2_32x4);
+      float sum3 = AccumulateNeonLane(acc3_32x4);
+      for (; TFLITE_UNLIKELY(c < m_cols); c++) {
+        const float v = vector_in_batch[c];
+        sum0 += row0[c] * v;
+        sum1 += row1[c] * v;
+        sum2 += row2[c] * v;
+        sum3 += row3[c] * v;
+      }
+      if (bias) {
+        sum0 += bias[r + 0];
+        sum1 += bias[r + 1];
+        sum2 += bias[r + 2];
+        sum3 += bias[r + 3];
+      }
+      result_in_batch[r + 0] = sum0;
+      result_in_batch[r + 1] = sum1;
+      result_in_batch[r + 2] = sum2;
+      result_in_batch[r + 3] = sum3;
+    }
+    for (; r < m_rows; r++) {
+      const float* matrix_row = matrix + r * m_cols;
+      float32x4_t acc_32x4 = vmovq_n_f32(0.0);
+      int c = 0;
+      for (; c < postamble_start; c += kFloatValuesPerNeonVector) {
+        acc_32x4 = vmlaq_f32(acc_32x4, vld1q_f32(matrix_row + c),
+                             vld1q_f32(vector_in_batch + c));
+      }
+      float sum = AccumulateNeonLane(acc_32x4);
+      for (; TFLITE_UNLIKELY(c < m_cols); c++) {
+        sum += matrix_row[c] * vector_in_batch[c];
+      }
+      result_in_batch[r] = bias ? sum + bias[r] : sum;
+    }
+  }
+}
+
 #ifdef __aarch64__
 
 // We interleave vector data to make the dot product logic more efficient.
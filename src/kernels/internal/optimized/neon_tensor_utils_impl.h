@@ -33,6 +33,13 @@ void NeonMatrixBatchVectorMultiplyAccumulate(const float* matrix, int m_rows,
                                              int m_cols, const float* vector,
                                              int n_batch, float* result);
 
+// Multiply a matrix by a batch vector, add a per-row bias and store (rather
+// than accumulate) the results.
+void NeonMatrixBatchVectorMultiplyBias(const float* matrix, int m_rows,
+                                       int m_cols, const float* vector,
+                                       const float* bias, int n_batch,
+                                       float* result, int result_stride);
+
 // Matrix multiplication for quantized values using symmetric quantization.
 void NeonMatrixBatchVectorMultiplyAccumulate(const int8_t* __restrict__ matrix,
                                              const int m_rows, const int m_cols,
@@ -0,0 +1,113 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+// Compares the 4-bit fully connected kernels compiled for x86, i.e. the SSE
+// kernels and the AVX2 and AVX-512 VNNI kernels picked at runtime, e.g.
+//
+//   optimized_4bit_benchmark --benchmark_filter='avx2'
+//
+// The kernels are only compiled with FC_4BIT_SSE on SSSE3 targets; other
+// builds run no benchmarks.
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "benchmark/benchmark.h"  // from @com_google_benchmark
+#include "kernels/internal/optimized/fully_connected_4bit.h"
+
+#if defined(FC_4BIT_SSE) && defined(__SSSE3__)
+#include "kernels/internal/optimized/4bit/avx2_fully_connected_impl.h"
+
+namespace tflite {
+namespace {
+
+std::mt19937 random_engine(2023);
+std::uniform_int_distribution<int32_t> int_dist(-7, 7);
+
+using RunKernelFn = void (*)(const uint8_t* lhs, const int8_t* rhs,
+                             int32_t* dst, int lhs_layout_rows,
+                             int lhs_layout_cols, int rhs_layout_rows,
+                             int rhs_layout_cols, int dst_layout_rows,
+                             int dst_layout_cols);
+
+// Each benchmark takes {batch_size, num_units, input_depth}; kernels the CPU
+// does not support are skipped.
+void BM_FullyConnected4Bit(benchmark::State& state, RunKernelFn kernel,
+                           int rows_right, bool supported) {
+  if (!supported) {
+    state.SkipWithError("Kernel not supported on this CPU");
+    return;
+  }
+  const int batch_size = state.range(0);
+  const int num_units = state.range(1);
+  const int depth = state.range(2);
+  const int lhs_layout_rows =
+      (num_units + optimized_4bit::FilterWidth - 1) &
+      ~(optimized_4bit::FilterWidth - 1);
+  const int layout_cols = (depth + optimized_4bit::FilterDepth - 1) &
+                          ~(optimized_4bit::FilterDepth - 1);
+  const int rhs_layout_rows = (batch_size + rows_right - 1) & ~(rows_right - 1);
+  std::vector<uint8_t> lhs(lhs_layout_rows * layout_cols / 2);
+  std::vector<int8_t> rhs(rhs_layout_rows * layout_cols);
+  std::vector<int32_t> dst(lhs_layout_rows * rhs_layout_rows);
+  for (auto& v : lhs) {
+    v = static_cast<uint8_t>(((int_dist(random_engine) + 7) << 4) |
+                             (int_dist(random_engine) + 7));
+  }
+  for (auto& v : rhs) {
+    v = static_cast<int8_t>(int_dist(random_engine));
+  }
+  for (auto _ : state) {
+    kernel(lhs.data(), rhs.data(), dst.data(), lhs_layout_rows, layout_cols,
+           rhs_layout_rows, layout_cols, rhs_layout_rows, lhs_layout_rows);
+    benchmark::DoNotOptimize(dst.data());
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) *
+                          batch_size * num_units * depth);
+}
+
+void FullyConnected4BitArgs(benchmark::internal::Benchmark* b) {
+  for (int batch_size : {1, 2, 4, 8, 16, 64}) {
+    b->Args({batch_size, 1024, 1024});
+  }
+}
+
+#define FC_4BIT_BENCHMARK(name, rows_right, kernel, supported)      \
+  BENCHMARK_CAPTURE(BM_FullyConnected4Bit, name, kernel, rows_right, \
+                    supported)                                       \
+      ->Apply(FullyConnected4BitArgs)
+
+FC_4BIT_BENCHMARK(sse_1, 1, (optimized_4bit::SseRunKernel<4, 1, 32>), true);
+FC_4BIT_BENCHMARK(sse_4, 4, (optimized_4bit::SseRunKernel<4, 4, 32>), true);
+#if defined(FC_4BIT_AVX2)
+FC_4BIT_BENCHMARK(avx2_1, 1, (optimized_4bit::Avx2RunKernel<4, 1, 32>),
+                  optimized_4bit::CanUseAvx2FullyConnected4Bit());
+FC_4BIT_BENCHMARK(avx2_4, 4, (optimized_4bit::Avx2RunKernel<4, 4, 32>),
+                  optimized_4bit::CanUseAvx2FullyConnected4Bit());
+#endif
+#if defined(FC_4BIT_AVX512VNNI)
+FC_4BIT_BENCHMARK(avx512vnni_1, 1,
+                  (optimized_4bit::Avx512VnniRunKernel<4, 1, 32>),
+                  optimized_4bit::CanUseAvx512VnniFullyConnected4Bit());
+FC_4BIT_BENCHMARK(avx512vnni_4, 4,
+                  (optimized_4bit::Avx512VnniRunKernel<4, 4, 32>),
+                  optimized_4bit::CanUseAvx512VnniFullyConnected4Bit());
+#endif
+
+}  // namespace
+}  // namespace tflite
+#endif  // defined(FC_4BIT_SSE) && defined(__SSSE3__)
+
+BENCHMARK_MAIN();
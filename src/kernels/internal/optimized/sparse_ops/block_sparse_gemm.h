@@ -0,0 +1,376 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_LITE_KERNELS_INTERNAL_OPTIMIZED_SPARSE_OPS_BLOCK_SPARSE_GEMM_H_
+#define TENSORFLOW_LITE_KERNELS_INTERNAL_OPTIMIZED_SPARSE_OPS_BLOCK_SPARSE_GEMM_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "ruy/profiler/instrumentation.h"  // from @ruy
+#include "core/c/common.h"
+#include "kernels/cpu_backend_context.h"
+#include "kernels/cpu_backend_threadpool.h"
+#include "kernels/internal/common.h"
+#include "kernels/internal/types.h"
+
+namespace tflite {
+namespace optimized_ops {
+
+// A weights matrix of shape [rows, cols] stored in the block CSR layout that
+// the TFLite converter emits in SparsityParameters: the first dimension is
+// dense over row blocks, the second is CSR over column blocks, and every
+// non-zero block is stored densely as block_rows x block_cols values in row
+// major order. Unblocked ("random") sparsity is the 1x1 case.
+struct BlockSparseLayout {
+  int rows = 0;
+  int cols = 0;
+  int block_rows = 1;
+  int block_cols = 1;
+  // Number of row blocks, i.e. rows / block_rows.
+  int row_blocks = 0;
+  // row_blocks + 1 offsets into 'indices', one run per row block.
+  const int* segments = nullptr;
+  // Column block index of every non-zero block.
+  const int* indices = nullptr;
+};
+
+// Fills 'layout' from 'sparsity' for a weights tensor of 'weights_shape',
+// which is viewed as [dims(0), product of the remaining dims]. Returns false
+// if the encoding is not a block CSR layout over those two dimensions or if
+// its indices are out of range. Inner dimensions of size 1 (the spatial dims
+// of a 1x1 convolution filter) are allowed anywhere before the last one.
+inline bool GetBlockSparseLayout(const TfLiteSparsity& sparsity,
+                                 const RuntimeShape& weights_shape,
+                                 BlockSparseLayout* layout) {
+  const int dims_count = weights_shape.DimensionsCount();
+  if (dims_count < 2) return false;
+  const int block_dims_count =
+      sparsity.block_map ? sparsity.block_map->size : 0;
+  if (sparsity.dim_metadata_size != dims_count + block_dims_count) {
+    return false;
+  }
+  if (sparsity.traversal_order != nullptr) {
+    if (sparsity.traversal_order->size != sparsity.dim_metadata_size) {
+      return false;
+    }
+    for (int i = 0; i < sparsity.traversal_order->size; ++i) {
+      if (sparsity.traversal_order->data[i] != i) return false;
+    }
+  }
+
+  BlockSparseLayout result;
+  result.rows = weights_shape.Dims(0);
+  result.cols = weights_shape.FlatSize() / std::max(1, result.rows);
+  for (int i = 0; i < block_dims_count; ++i) {
+    const int block_dim = sparsity.block_map->data[i];
+    const TfLiteDimensionMetadata& metadata =
+        sparsity.dim_metadata[dims_count + i];
+    if (metadata.format != kTfLiteDimDense || metadata.dense_size <= 0) {
+      return false;
+    }
+    if (block_dim == 0) {
+      result.block_rows = metadata.dense_size;
+    } else if (block_dim == dims_count - 1) {
+      result.block_cols = metadata.dense_size;
+    } else {
+      return false;
+    }
+  }
+  if (result.rows % result.block_rows != 0 ||
+      result.cols % result.block_cols != 0) {
+    return false;
+  }
+  result.row_blocks = result.rows / result.block_rows;
+
+  if (sparsity.dim_metadata[0].format != kTfLiteDimDense ||
+      sparsity.dim_metadata[0].dense_size != result.row_blocks) {
+    return false;
+  }
+  for (int i = 1; i < dims_count - 1; ++i) {
+    if (sparsity.dim_metadata[i].format != kTfLiteDimDense ||
+        sparsity.dim_metadata[i].dense_size != 1) {
+      return false;
+    }
+  }
+  const TfLiteDimensionMetadata& csr = sparsity.dim_metadata[dims_count - 1];
+  if (csr.format != kTfLiteDimSparseCSR || csr.array_segments == nullptr ||
+      csr.array_indices == nullptr ||
+      csr.array_segments->size != result.row_blocks + 1) {
+    return false;
+  }
+  result.segments = csr.array_segments->data;
+  result.indices = csr.array_indices->data;
+
+  const int col_blocks = result.cols / result.block_cols;
+  if (result.segments[0] != 0 ||
+      result.segments[result.row_blocks] != csr.array_indices->size) {
+    return false;
+  }
+  for (int i = 0; i < result.row_blocks; ++i) {
+    if (result.segments[i] > result.segments[i + 1]) return false;
+  }
+  for (int i = 0; i < csr.array_indices->size; ++i) {
+    if (result.indices[i] < 0 || result.indices[i] >= col_blocks) {
+      return false;
+    }
+  }
+  *layout = result;
+  return true;
+}
+
+namespace block_sparse {
+
+inline float WithInputOffset(float value, float /*input_offset*/) {
+  return value;
+}
+
+inline int32_t WithInputOffset(int8_t value, int32_t input_offset) {
+  return static_cast<int32_t>(value) + input_offset;
+}
+
+struct FloatOutputStage {
+  const float* bias;
+  float activation_min;
+  float activation_max;
+
+  float operator()(float acc, int row) const {
+    return ActivationFunctionWithMinMax(acc + (bias ? bias[row] : 0.f),
+                                        activation_min, activation_max);
+  }
+};
+
+struct Int8OutputStage {
+  const int32_t* bias;
+  // Per output row requantization, or null to use the per-tensor values.
+  const int32_t* per_channel_multiplier;
+  const int32_t* per_channel_shift;
+  int32_t output_multiplier;
+  int32_t output_shift;
+  int32_t output_offset;
+  int32_t activation_min;
+  int32_t activation_max;
+
+  int8_t operator()(int32_t acc, int row) const {
+    acc = MultiplyByQuantizedMultiplier(
+        acc + (bias ? bias[row] : 0),
+        per_channel_multiplier ? per_channel_multiplier[row]
+                               : output_multiplier,
+        per_channel_shift ? per_channel_shift[row] : output_shift);
+    acc += output_offset;
+    return static_cast<int8_t>(
+        ActivationFunctionWithMinMax(acc, activation_min, activation_max));
+  }
+};
+
+// Computes the output rows of row blocks [row_block_start, row_block_end) for
+// every batch. The non-zero blocks of one row block are walked once per batch
+// while they are still hot in cache. kBlockRows/kBlockCols are compile-time
+// block sizes for the common shapes, or 0 to read them from 'layout'.
+template <int kBlockRows, int kBlockCols, typename WeightT, typename InputT,
+          typename AccumT, typename OutputT, typename OutputStage>
+void BlockSparseGemmRowBlocks(const BlockSparseLayout& layout,
+                              const WeightT* weights, const InputT* input,
+                              AccumT input_offset, int batches,
+                              const OutputStage& output_stage, OutputT* output,
+                              int row_block_start, int row_block_end) {
+  const int block_rows = kBlockRows > 0 ? kBlockRows : layout.block_rows;
+  const int block_cols = kBlockCols > 0 ? kBlockCols : layout.block_cols;
+  const int block_size = block_rows * block_cols;
+  std::vector<AccumT> acc(block_rows);
+  for (int rb = row_block_start; rb < row_block_end; ++rb) {
+    const int segment_start = layout.segments[rb];
+    const int segment_end = layout.segments[rb + 1];
+    const int row_start = rb * block_rows;
+    for (int b = 0; b < batches; ++b) {
+      const InputT* input_row = input + b * layout.cols;
+      std::fill(acc.begin(), acc.end(), AccumT(0));
+      const WeightT* block = weights + segment_start * block_size;
+      for (int k = segment_start; k < segment_end; ++k) {
+        const InputT* input_block = input_row + layout.indices[k] * block_cols;
+        for (int r = 0; r < block_rows; ++r) {
+          AccumT sum = 0;
+          for (int c = 0; c < block_cols; ++c) {
+            sum += block[r * block_cols + c] *
+                   WithInputOffset(input_block[c], input_offset);
+          }
+          acc[r] += sum;
+        }
+        block += block_size;
+      }
+      OutputT* output_row = output + b * layout.rows + row_start;
+      for (int r = 0; r < block_rows; ++r) {
+        output_row[r] = output_stage(acc[r], row_start + r);
+      }
+    }
+  }
+}
+
+template <typename WeightT, typename InputT, typename AccumT, typename OutputT,
+          typename OutputStage>
+void BlockSparseGemmImpl(const BlockSparseLayout& layout,
+                         const WeightT* weights, const InputT* input,
+                         AccumT input_offset, int batches,
+                         const OutputStage& output_stage, OutputT* output,
+                         int row_block_start, int row_block_end) {
+#define TFLITE_BLOCK_SPARSE_GEMM_CASE(rows, cols)                          \
+  if (layout.block_rows == rows && layout.block_cols == cols) {            \
+    return BlockSparseGemmRowBlocks<rows, cols>(                           \
+        layout, weights, input, input_offset, batches, output_stage,       \
+        output, row_block_start, row_block_end);                           \
+  }
+  TFLITE_BLOCK_SPARSE_GEMM_CASE(1, 1)
+  TFLITE_BLOCK_SPARSE_GEMM_CASE(1, 4)
+  TFLITE_BLOCK_SPARSE_GEMM_CASE(1, 8)
+  TFLITE_BLOCK_SPARSE_GEMM_CASE(1, 16)
+  TFLITE_BLOCK_SPARSE_GEMM_CASE(4, 1)
+  TFLITE_BLOCK_SPARSE_GEMM_CASE(8, 1)
+  TFLITE_BLOCK_SPARSE_GEMM_CASE(4, 4)
+#undef TFLITE_BLOCK_SPARSE_GEMM_CASE
+  BlockSparseGemmRowBlocks<0, 0>(layout, weights, input, input_offset, batches,
+                                 output_stage, output, row_block_start,
+                                 row_block_end);
+}
+
+template <typename WeightT, typename InputT, typename AccumT, typename OutputT,
+          typename OutputStage>
+struct BlockSparseGemmTask : cpu_backend_threadpool::Task {
+  BlockSparseGemmTask(const BlockSparseLayout& layout, const WeightT* weights,
+                      const InputT* input, AccumT input_offset, int batches,
+                      const OutputStage& output_stage, OutputT* output,
+                      int row_block_start, int row_block_end)
+      : layout(layout),
+        weights(weights),
+        input(input),
+        input_offset(input_offset),
+        batches(batches),
+        output_stage(output_stage),
+        output(output),
+        row_block_start(row_block_start),
+        row_block_end(row_block_end) {}
+
+  void Run() override {
+    BlockSparseGemmImpl(layout, weights, input, input_offset, batches,
+                        output_stage, output, row_block_start, row_block_end);
+  }
+
+ private:
+  const BlockSparseLayout& layout;
+  const WeightT* weights;
+  const InputT* input;
+  AccumT input_offset;
+  int batches;
+  const OutputStage& output_stage;
+  OutputT* output;
+  int row_block_start;
+  int row_block_end;
+};
+
+// Splits the row blocks into contiguous ranges holding roughly the same number
+// of non-zero blocks, so heavily pruned rows do not leave threads idle.
+template <typename WeightT, typename InputT, typename AccumT, typename OutputT,
+          typename OutputStage>
+void BlockSparseGemm(const BlockSparseLayout& layout, const WeightT* weights,
+                     const InputT* input, AccumT input_offset, int batches,
+                     const OutputStage& output_stage, OutputT* output,
+                     CpuBackendContext* cpu_backend_context) {
+  // Below this many multiply-accumulates per thread the threadpool overhead
+  // outweighs the work.
+  constexpr int kMinMacsPerThread = 16 * 1024;
+  const int nonzero_blocks = layout.segments[layout.row_blocks];
+  const int64_t macs = static_cast<int64_t>(nonzero_blocks) *
+                       layout.block_rows * layout.block_cols * batches;
+  int thread_count = std::min<int64_t>(
+      {static_cast<int64_t>(cpu_backend_context->max_num_threads()),
+       static_cast<int64_t>(layout.row_blocks), macs / kMinMacsPerThread});
+  if (thread_count <= 1) {
+    BlockSparseGemmImpl(layout, weights, input, input_offset, batches,
+                        output_stage, output, 0, layout.row_blocks);
+    return;
+  }
+
+  std::vector<BlockSparseGemmTask<WeightT, InputT, AccumT, OutputT,
+                                  OutputStage>>
+      tasks;
+  tasks.reserve(thread_count);
+  int row_block_start = 0;
+  for (int i = 0; i < thread_count && row_block_start < layout.row_blocks;
+       ++i) {
+    int row_block_end = layout.row_blocks;
+    if (i < thread_count - 1) {
+      // Row blocks also cost their output stage, so count each as one block.
+      const int64_t target =
+          static_cast<int64_t>(nonzero_blocks + layout.row_blocks) * (i + 1) /
+          thread_count;
+      row_block_end = row_block_start + 1;
+      while (row_block_end < layout.row_blocks &&
+             layout.segments[row_block_end] + row_block_end < target) {
+        ++row_block_end;
+      }
+    }
+    tasks.emplace_back(layout, weights, input, input_offset, batches,
+                       output_stage, output, row_block_start, row_block_end);
+    row_block_start = row_block_end;
+  }
+  cpu_backend_threadpool::Execute(tasks.size(), tasks.data(),
+                                  cpu_backend_context);
+}
+
+}  // namespace block_sparse
+
+// output[b, :] = activation(weights * input[b, :] + bias) for 'batches' rows
+// of input of depth layout.cols, writing rows of depth layout.rows.
+inline void FullyConnectedBlockSparseWeight(
+    const BlockSparseLayout& layout, const FullyConnectedParams& params,
+    int batches, const float* input_data, const float* weights_data,
+    const float* bias_data, float* output_data,
+    CpuBackendContext* cpu_backend_context) {
+  ruy::profiler::ScopeLabel label("FullyConnected");
+  ruy::profiler::ScopeLabel inner_label("Block Sparse");
+  const block_sparse::FloatOutputStage output_stage = {
+      bias_data, params.float_activation_min, params.float_activation_max};
+  block_sparse::BlockSparseGemm(layout, weights_data, input_data, 0.f, batches,
+                                output_stage, output_data,
+                                cpu_backend_context);
+}
+
+// Quantized variant for symmetric int8 weights. 'per_channel_multiplier' and
+// 'per_channel_shift' may be null to use params.output_multiplier/shift.
+inline void FullyConnectedBlockSparseWeight(
+    const BlockSparseLayout& layout, const FullyConnectedParams& params,
+    int batches, const int8_t* input_data, const int8_t* weights_data,
+    const int32_t* per_channel_multiplier, const int32_t* per_channel_shift,
+    const int32_t* bias_data, int8_t* output_data,
+    CpuBackendContext* cpu_backend_context) {
+  ruy::profiler::ScopeLabel label("FullyConnected");
+  ruy::profiler::ScopeLabel inner_label("Block Sparse");
+  const block_sparse::Int8OutputStage output_stage = {
+      bias_data,
+      per_channel_multiplier,
+      per_channel_shift,
+      params.output_multiplier,
+      params.output_shift,
+      params.output_offset,
+      params.quantized_activation_min,
+      params.quantized_activation_max};
+  block_sparse::BlockSparseGemm(layout, weights_data, input_data,
+                                params.input_offset, batches, output_stage,
+                                output_data, cpu_backend_context);
+}
+
+}  // namespace optimized_ops
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_KERNELS_INTERNAL_OPTIMIZED_SPARSE_OPS_BLOCK_SPARSE_GEMM_H_
@@ -21,7 +21,7 @@ limitations under the License.
 #ifdef __SSE4_1__
 #include <smmintrin.h>  // SSE4.1
 #endif
-#ifdef __AVX2__
+#ifdef TFLITE_HAS_AVX2_TENSOR_UTILS
 #include <immintrin.h>
 
 #include "absl/base/prefetch.h"
@@ -34,6 +34,7 @@ limitations under the License.
 #include "kernels/cpu_backend_gemm.h"
 #include "kernels/cpu_backend_gemm_params.h"
 #include "kernels/internal/compatibility.h"
+#include "kernels/internal/optimized/cpu_check.h"
 
 namespace tflite {
 namespace tensor_utils {
@@ -88,9 +89,9 @@ static inline int32_t ReduceInt32x4(__m128i acc) {
   return _mm_cvtsi128_si32(acc);
 }
 
-#ifdef __AVX2__
+#ifdef TFLITE_HAS_AVX2_TENSOR_UTILS
 // Horizontally add 4 float values stored in a single XMM register to float.
-static inline float ReduceFloat32x4(__m128 acc) {
+TFLITE_AVX2_TARGET static inline float ReduceFloat32x4(__m128 acc) {
   __m128 shuffle = _mm_movehdup_ps(acc);
   acc = _mm_add_ps(acc, shuffle);
   shuffle = _mm_movehl_ps(shuffle, acc);
@@ -99,7 +100,7 @@ static inline float ReduceFloat32x4(__m128 acc) {
 }
 
 // Horizontally add 8 float values stored in a single XMM register to float.
-static inline float ReduceFloat32x8(__m256 acc) {
+TFLITE_AVX2_TARGET static inline float ReduceFloat32x8(__m256 acc) {
   __m128 low = _mm256_extractf128_ps(acc, 0);
   __m128 high = _mm256_extractf128_ps(acc, 1);
   return ReduceFloat32x4(_mm_add_ps(low, high));
@@ -108,7 +109,8 @@ static inline float ReduceFloat32x8(__m256 acc) {
 // Dot product of four int8 vectors of 4 elements packed into a YMM register.
 // Result is eight int32 scalars packed into a YMM register.
 // int8x4x8 · int8x4x8 => int32x8
-static inline __m256i DotProdInt8x4x8(__m256i a_16x16, __m256i b_16x16) {
+TFLITE_AVX2_TARGET static inline __m256i DotProdInt8x4x8(__m256i a_16x16,
+                                                           __m256i b_16x16) {
   // Transfer sign from 'a' to 'b', as _mm256_maddubs_epi16 treats 'a' unsigned.
   b_16x16 = _mm256_sign_epi8(b_16x16, a_16x16);
   a_16x16 = _mm256_abs_epi8(a_16x16);
@@ -117,7 +119,7 @@ static inline __m256i DotProdInt8x4x8(__m256i a_16x16, __m256i b_16x16) {
   // sumprod[i] = sumprod[2*i]*1 + sumprod[2*i+1]*1 (i = 0..7)
   return _mm256_madd_epi16(sumprod_16x16, _mm256_set1_epi16(1));
 }
-#endif  // __AVX2__
+#endif  // TFLITE_HAS_AVX2_TENSOR_UTILS
 
 // Horizontally add each of 4 XMM registers with 4 int32 values, pack result
 // into a single XMM register. Similar to ReduceInt32x4, but with 4x inputs.
@@ -151,14 +153,22 @@ float GetFloatVectorElement(__m128 v) {
 
 }  // namespace
 
+#ifdef TFLITE_HAS_AVX2_TENSOR_UTILS
+bool CanUseAvx2TensorUtils() {
 #ifdef __AVX2__
+  return true;
+#else
+  return DetectX86Avx2Fma();
+#endif
+}
+
 constexpr int kFloatValuesPerAvx2Vector = 8;
 template <int PerVectorSize>
 inline int RoundDownVectors(int size) {
   return size & ~(PerVectorSize - 1);
 }
 
-void Avx2MatrixBatchVectorMultiplyAccumulateImpl(
+TFLITE_AVX2_TARGET void Avx2MatrixBatchVectorMultiplyAccumulateImpl(
     const float* __restrict__ matrix, int m_rows, int m_cols,
     const float* __restrict__ vector, int n_batch, float* __restrict__ result) {
   // If v_size is not divisible by the vector size, then we need to process the
@@ -198,7 +208,83 @@ void Avx2MatrixBatchVectorMultiplyAccumulateImpl(
   }
 }
 
-void Avx2MatrixBatchVectorMultiplyAccumulateImpl(
+TFLITE_AVX2_TARGET void Avx2MatrixBatchVectorMultiplyBiasImpl(
+    const float* __restrict__ matrix, int m_rows, int m_cols,
+    const float* __restrict__ vector, const float* __restrict__ bias,
+    int n_batch, float* __restrict__ result, int result_stride) {
+  const int postamble_start =
+      RoundDownVectors<kFloatValuesPerAvx2Vector>(m_cols);
+  // Four rows share each load of the vector, see
+  // NeonMatrixBatchVectorMultiplyBias.
+  const int m_rows_rounddown_4 = m_rows & ~3;
+
+  for (int b = 0; b < n_batch; ++b) {
+    float* result_in_batch = result + b * result_stride;
+    const float* vector_in_batch = vector + b * m_cols;
+
+    int r = 0;
+    for (; r < m_rows_rounddown_4; r += 4) {
+      const float* row0 = matrix + (r + 0) * m_cols;
+      const float* row1 = matrix + (r + 1) * m_cols;
+      const float* row2 = matrix + (r + 2) * m_cols;
+      const float* row3 = matrix + (r + 3) * m_cols;
+      __m256 acc0_32x8 = _mm256_setzero_ps();
+      __m256 acc1_32x8 = _mm256_setzero_ps();
+      __m256 acc2_32x8 = _mm256_setzero_ps();
+      __m256 acc3_32x8 = _mm256_setzero_ps();
+      int c = 0;
+      for (; c < postamble_start; c += kFloatValuesPerAvx2Vector) {
+        const __m256 vector_f32x8 = _mm256_loadu_ps(vector_in_batch + c);
+        acc0_32x8 = _mm256_add_ps(
+            acc0_32x8, _mm256_mul_ps(_mm256_loadu_ps(row0 + c), vector_f32x8));
+        acc1_32x8 = _mm256_add_ps(
+            acc1_32x8, _mm256_mul_ps(_mm256_loadu_ps(row1 + c), vector_f32x8));
+        acc2_32x8 = _mm256_add_ps(
+            acc2_32x8, _mm256_mul_ps(_mm256_loadu_ps(row2 + c), vector_f32x8));
+        acc3_32x8 = _mm256_add_ps(
+            acc3_32x8, _mm256_mul_ps(_mm256_loadu_ps(row3 + c), vector_f32x8));
+      }
+      float sum0 = ReduceFloat32x8(acc0_32x8);
+      float sum1 = ReduceFloat32x8(acc1_32x8);
+      float sum2 = ReduceFloat32x8(acc2_32x8);
+      float sum3 = ReduceFloat32x8(acc3_32x8);
+      for (; c < m_cols; ++c) {
+        const float v = vector_in_batch[c];
+        sum0 += row0[c] * v;
+        sum1 += row1[c] * v;
+        sum2 += row2[c] * v;
+        sum3 += row3[c] * v;
+      }
+      if (bias) {
+        sum0 += bias[r + 0];
+        sum1 += bias[r + 1];
+        sum2 += bias[r + 2];
+        sum3 += bias[r + 3];
+      }
+      result_in_batch[r + 0] = sum0;
+      result_in_batch[r + 1] = sum1;
+      result_in_batch[r + 2] = sum2;
+      result_in_batch[r + 3] = sum3;
+    }
+    for (; r < m_rows; ++r) {
+      const float* matrix_row = matrix + r * m_cols;
+      __m256 acc_32x8 = _mm256_setzero_ps();
+      int c = 0;
+      for (; c < postamble_start; c += kFloatValuesPerAvx2Vector) {
+        acc_32x8 = _mm256_add_ps(
+            acc_32x8, _mm256_mul_ps(_mm256_loadu_ps(matrix_row + c),
+                                    _mm256_loadu_ps(vector_in_batch + c)));
+      }
+      float sum = ReduceFloat32x8(acc_32x8);
+      for (; c < m_cols; ++c) {
+        sum += matrix_row[c] * vector_in_batch[c];
+      }
+      result_in_batch[r] = bias ? sum + bias[r] : sum;
+    }
+  }
+}
+
+TFLITE_AVX2_TARGET void Avx2MatrixBatchVectorMultiplyAccumulateImpl(
     const int8_t* __restrict__ matrix, const int m_rows, const int m_cols,
     const int8_t* __restrict__ vectors,
     const float* __restrict__ scaling_factors, int n_batch,
@@ -291,7 +377,101 @@ void Avx2MatrixBatchVectorMultiplyAccumulateImpl(
   }  // for batch
 }
 
-#endif  // __AVX2__
+#endif  // TFLITE_HAS_AVX2_TENSOR_UTILS
+
+#ifdef TFLITE_HAS_AVX512VNNI_TENSOR_UTILS
+namespace {
+
+bool CanUseAvx512VnniTensorUtils() {
+#if defined(__AVX512VNNI__) && defined(__AVX512BW__) && defined(__AVX512VL__)
+  return true;
+#else
+  return DetectX86Avx512Vnni();
+#endif
+}
+
+constexpr int kInt8ValuesPerAvx512Vector = 64;
+
+// Multiplies kRows consecutive rows of 'matrix' with a single int8 vector and
+// accumulates the scaled dot products into 'result'. The rows share each load
+// of the vector, and the last partial block of columns is read with masked
+// loads instead of a scalar postamble.
+template <int kRows>
+TFLITE_AVX512VNNI_TARGET inline void
+Avx512VnniMatrixRowsVectorMultiplyAccumulate(
+    const int8_t* __restrict__ matrix, const int m_cols,
+    const int8_t* __restrict__ vector, const float batch_scaling_factor,
+    const int32_t batch_offset, const float* per_channel_scale,
+    const int32_t* row_sums, float* __restrict__ result) {
+  const int postamble_start =
+      RoundDownVectors<kInt8ValuesPerAvx512Vector>(m_cols);
+  const __mmask64 postamble_mask =
+      (static_cast<__mmask64>(1) << (m_cols - postamble_start)) - 1;
+  const __m512i zero = _mm512_setzero_si512();
+  __m512i dotprod_32x16[kRows];
+  for (int i = 0; i < kRows; ++i) {
+    dotprod_32x16[i] = zero;
+  }
+  for (int col = 0; col < m_cols; col += kInt8ValuesPerAvx512Vector) {
+    const __mmask64 mask =
+        col < postamble_start ? ~static_cast<__mmask64>(0) : postamble_mask;
+    const __m512i vec_8x64 = _mm512_maskz_loadu_epi8(mask, vector + col);
+    // VPDPBUSD multiplies unsigned by signed bytes, so feed it |vec| and
+    // transfer the sign of 'vec' to the rows, as DotProdInt8x4x4 does.
+    const __m512i vec_abs_8x64 = _mm512_abs_epi8(vec_8x64);
+    const __mmask64 vec_negative = _mm512_movepi8_mask(vec_8x64);
+    for (int i = 0; i < kRows; ++i) {
+      const __m512i row_8x64 =
+          _mm512_maskz_loadu_epi8(mask, matrix + i * m_cols + col);
+      const __m512i signed_row_8x64 =
+          _mm512_mask_sub_epi8(row_8x64, vec_negative, zero, row_8x64);
+      dotprod_32x16[i] =
+          _mm512_dpbusd_epi32(dotprod_32x16[i], vec_abs_8x64, signed_row_8x64);
+    }
+  }
+  for (int i = 0; i < kRows; ++i) {
+    int32_t sum = _mm512_reduce_add_epi32(dotprod_32x16[i]);
+    if (row_sums && batch_offset) {
+      sum -= batch_offset * row_sums[i];
+    }
+    const float row_scale = per_channel_scale
+                                ? per_channel_scale[i] * batch_scaling_factor
+                                : batch_scaling_factor;
+    result[i] += sum * row_scale;
+  }
+}
+
+TFLITE_AVX512VNNI_TARGET void Avx512VnniMatrixBatchVectorMultiplyAccumulateImpl(
+    const int8_t* __restrict__ matrix, const int m_rows, const int m_cols,
+    const int8_t* __restrict__ vectors,
+    const float* __restrict__ scaling_factors, int n_batch,
+    float* __restrict__ result, const float* per_channel_scale,
+    const int32_t* input_offset, const int32_t* row_sums) {
+  constexpr int kRowBlock = 4;
+  const int m_rows_rounddown = m_rows & ~(kRowBlock - 1);
+  for (int batch = 0; batch < n_batch; ++batch) {
+    const int8_t* vector = vectors + batch * m_cols;
+    float* result_in_batch = result + batch * m_rows;
+    const float batch_scaling_factor = scaling_factors[batch];
+    const int32_t batch_offset = input_offset ? input_offset[batch] : 0;
+    int row = 0;
+    for (; row < m_rows_rounddown; row += kRowBlock) {
+      Avx512VnniMatrixRowsVectorMultiplyAccumulate<kRowBlock>(
+          matrix + row * m_cols, m_cols, vector, batch_scaling_factor,
+          batch_offset, per_channel_scale ? per_channel_scale + row : nullptr,
+          row_sums ? row_sums + row : nullptr, result_in_batch + row);
+    }
+    for (; row < m_rows; ++row) {
+      Avx512VnniMatrixRowsVectorMultiplyAccumulate<1>(
+          matrix + row * m_cols, m_cols, vector, batch_scaling_factor,
+          batch_offset, per_channel_scale ? per_channel_scale + row : nullptr,
+          row_sums ? row_sums + row : nullptr, result_in_batch + row);
+    }
+  }
+}
+
+}  // namespace
+#endif  // TFLITE_HAS_AVX512VNNI_TENSOR_UTILS
 
 void SseMatrixBatchVectorMultiplyAccumulateImpl(
     const int8_t* __restrict__ matrix, const int m_rows, const int m_cols,
@@ -299,12 +479,22 @@ void SseMatrixBatchVectorMultiplyAccumulateImpl(
     const float* __restrict__ scaling_factors, int n_batch,
     float* __restrict__ result, const float* per_channel_scale,
     const int32_t* input_offset, const int32_t* row_sums) {
-#ifdef __AVX2__
-  Avx2MatrixBatchVectorMultiplyAccumulateImpl(
-      matrix, m_rows, m_cols, vectors, scaling_factors, n_batch, result,
-      per_channel_scale, input_offset, row_sums);
-  return;
-#else
+#ifdef TFLITE_HAS_AVX512VNNI_TENSOR_UTILS
+  if (CanUseAvx512VnniTensorUtils()) {
+    Avx512VnniMatrixBatchVectorMultiplyAccumulateImpl(
+        matrix, m_rows, m_cols, vectors, scaling_factors, n_batch, result,
+        per_channel_scale, input_offset, row_sums);
+    return;
+  }
+#endif
+#ifdef TFLITE_HAS_AVX2_TENSOR_UTILS
+  if (CanUseAvx2TensorUtils()) {
+    Avx2MatrixBatchVectorMultiplyAccumulateImpl(
+        matrix, m_rows, m_cols, vectors, scaling_factors, n_batch, result,
+        per_channel_scale, input_offset, row_sums);
+    return;
+  }
+#endif
   for (std::intptr_t batch = 0; batch < n_batch; ++batch) {
     const float batch_scaling_factor = scaling_factors[batch];
     const int32_t batch_offset = input_offset ? input_offset[batch] : 0;
@@ -377,7 +567,6 @@ void SseMatrixBatchVectorMultiplyAccumulateImpl(
 
     vectors += m_cols;
   }  // for batch
-#endif  // ifdef __AVX2__
 }
 
 void SseCpuBackendGemm(const int8_t* input, const int32_t* bias,
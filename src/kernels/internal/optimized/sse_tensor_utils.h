@@ -18,7 +18,8 @@ limitations under the License.
 // Note: This file is a copy-paste version of neon_tensor_utils.h, only
 // difference is in MatrixBatchVectorMultiplyAccumulate and
 // SparseMatrixBatchVectorMultiplyAccumulate (other functions do not have SSE
-// implementation yet).
+// implementation yet). The float and hybrid MatrixBatchVectorMultiplyAccumulate
+// pick AVX2 or AVX-512 VNNI kernels at runtime when the CPU supports them.
 
 // Note: Most of the functions below use NEON_OR_PORTABLE, through the Intel
 // NEON_2_SSE translator library. If a native SSE version of a function is
@@ -37,13 +38,30 @@ namespace tensor_utils {
 void MatrixBatchVectorMultiplyAccumulate(const float* matrix, int m_rows,
                                          int m_cols, const float* vector,
                                          int n_batch, float* result) {
-#if defined(__AVX2__)
-  Avx2MatrixBatchVectorMultiplyAccumulateImpl(matrix, m_rows, m_cols, vector,
-                                              n_batch, result);
-#else
+#if defined(TFLITE_HAS_AVX2_TENSOR_UTILS)
+  if (CanUseAvx2TensorUtils()) {
+    Avx2MatrixBatchVectorMultiplyAccumulateImpl(matrix, m_rows, m_cols, vector,
+                                                n_batch, result);
+    return;
+  }
+#endif
   NEON_OR_PORTABLE(MatrixBatchVectorMultiplyAccumulate, matrix, m_rows, m_cols,
                    vector, n_batch, result);
+}
+
+void MatrixBatchVectorMultiplyBias(const float* matrix, int m_rows, int m_cols,
+                                   const float* vector, const float* bias,
+                                   int n_batch, float* result,
+                                   int result_stride) {
+#if defined(TFLITE_HAS_AVX2_TENSOR_UTILS)
+  if (CanUseAvx2TensorUtils()) {
+    Avx2MatrixBatchVectorMultiplyBiasImpl(matrix, m_rows, m_cols, vector, bias,
+                                          n_batch, result, result_stride);
+    return;
+  }
 #endif
+  NEON_OR_PORTABLE(MatrixBatchVectorMultiplyBias, matrix, m_rows, m_cols,
+                   vector, bias, n_batch, result, result_stride);
 }
 
 void MatrixBatchVectorMultiplyAccumulate(
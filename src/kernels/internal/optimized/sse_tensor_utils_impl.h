@@ -18,20 +18,38 @@ limitations under the License.
 #include <cstdint>
 
 #include "kernels/cpu_backend_context.h"
+#include "kernels/internal/optimized/cpu_check.h"
 
 #if defined(_MSC_VER)
 #define __restrict__ __restrict
 #endif
 
+#if defined(TFLITE_AVX2_TARGET)
+#define TFLITE_HAS_AVX2_TENSOR_UTILS
+#endif
+#if defined(TFLITE_AVX512VNNI_TARGET)
+#define TFLITE_HAS_AVX512VNNI_TENSOR_UTILS
+#endif
+
 namespace tflite {
 namespace tensor_utils {
 
-#if defined(__AVX2__)
+#if defined(TFLITE_HAS_AVX2_TENSOR_UTILS)
+// Returns true if the Avx2* kernels below may be called on this CPU.
+bool CanUseAvx2TensorUtils();
+
 // Matrix multiplication for float values.
 void Avx2MatrixBatchVectorMultiplyAccumulateImpl(
     const float* __restrict__ matrix, int m_rows, int m_cols,
     const float* __restrict__ vector, int n_batch, float* __restrict__ result);
 
+// Matrix multiplication for float values with a per-row bias, storing rather
+// than accumulating the results.
+void Avx2MatrixBatchVectorMultiplyBiasImpl(
+    const float* __restrict__ matrix, int m_rows, int m_cols,
+    const float* __restrict__ vector, const float* __restrict__ bias,
+    int n_batch, float* __restrict__ result, int result_stride);
+
 // Matrix multiplication for quantized values using asymmetric quantization.
 void Avx2MatrixBatchVectorMultiplyAccumulateImpl(
     const int8_t* __restrict__ matrix, const int m_rows, const int m_cols,
@@ -40,7 +58,7 @@ void Avx2MatrixBatchVectorMultiplyAccumulateImpl(
     float* __restrict__ result, const float* per_channel_scale,
     const int32_t* input_offset, int32_t* scratch, int32_t* row_sums,
     bool* compute_row_sums, CpuBackendContext* context);
-#endif  // defined(__AVX2__)
+#endif  // defined(TFLITE_HAS_AVX2_TENSOR_UTILS)
 
 #ifdef __SSSE3__
 
@@ -184,6 +184,16 @@ void MatrixBatchVectorMultiplyAccumulate(const float* matrix, int m_rows,
                                          int m_cols, const float* vector,
                                          int n_batch, float* result);
 
+// Same as the function above, but instead of accumulating into 'result' the
+// product is written to it after adding the per-row 'bias' (which may be
+// null). Consecutive batches are 'result_stride' elements apart in 'result',
+// which allows writing directly into outputs whose leading dimension is larger
+// than m_rows.
+void MatrixBatchVectorMultiplyBias(const float* matrix, int m_rows, int m_cols,
+                                   const float* vector, const float* bias,
+                                   int n_batch, float* result,
+                                   int result_stride);
+
 // Same as the function above, but the matrix is a sparse tensor with block
 // pattern 1x4.
 // This function assumes that m_cols is a multiple of the block size (4 in this
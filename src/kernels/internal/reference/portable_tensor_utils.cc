@@ -135,6 +135,24 @@ void PortableMatrixBatchVectorMultiplyAccumulate(const float* matrix,
   }
 }
 
+void PortableMatrixBatchVectorMultiplyBias(const float* matrix, int m_rows,
+                                           int m_cols, const float* vector,
+                                           const float* bias, int n_batch,
+                                           float* result, int result_stride) {
+  for (int b = 0; b < n_batch; b++) {
+    const float* matrix_ptr = matrix;
+    float* result_in_batch = result + b * result_stride;
+    for (int r = 0; r < m_rows; r++) {
+      float dot_prod = bias ? bias[r] : 0.0f;
+      const float* vector_in_batch = vector + b * m_cols;
+      for (int c = 0; c < m_cols; c++) {
+        dot_prod += *matrix_ptr++ * *vector_in_batch++;
+      }
+      result_in_batch[r] = dot_prod;
+    }
+  }
+}
+
 void PortableMatrixBatchVectorMultiplyAccumulate(
     const int8_t* __restrict__ matrix, const int m_rows, const int m_cols,
     const int8_t* __restrict__ vectors, const float* scaling_factors,
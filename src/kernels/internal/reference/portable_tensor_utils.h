@@ -62,6 +62,14 @@ void MatrixBatchVectorMultiplyAccumulate(const float* matrix, int m_rows,
                                               n_batch, result);
 }
 
+void MatrixBatchVectorMultiplyBias(const float* matrix, int m_rows, int m_cols,
+                                   const float* vector, const float* bias,
+                                   int n_batch, float* result,
+                                   int result_stride) {
+  PortableMatrixBatchVectorMultiplyBias(matrix, m_rows, m_cols, vector, bias,
+                                        n_batch, result, result_stride);
+}
+
 void MatrixBatchVectorMultiplyAccumulate(const int8_t* __restrict__ matrix,
                                          const int m_rows, const int m_cols,
                                          const int8_t* __restrict__ vector,
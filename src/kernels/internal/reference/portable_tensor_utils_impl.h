@@ -59,6 +59,11 @@ void PortableMatrixBatchVectorMultiplyAccumulate(const float* matrix,
                                                  const float* vector,
                                                  int n_batch, float* result);
 
+void PortableMatrixBatchVectorMultiplyBias(const float* matrix, int m_rows,
+                                           int m_cols, const float* vector,
+                                           const float* bias, int n_batch,
+                                           float* result, int result_stride);
+
 void PortableMatrixBatchVectorMultiplyAccumulate(
     const int8_t* __restrict__ matrix, const int m_rows, const int m_cols,
     const int8_t* __restrict__ vectors, const float* scaling_factors,
@@ -34,33 +34,34 @@ limitations under the License.
 namespace tflite {
 namespace reference_ops {
 
+// Computes matmul(state, weights_time), the reduction over rank, the bias and
+// the activation in a single pass: every unit accumulates the dot products of
+// its rank filters directly, so no intermediate per-filter results are
+// written out and swept again.
 static inline void ApplyTimeWeightsBiasAndActivation(
     int batch_size, int memory_size, int num_filters, int num_units, int rank,
     const float* const __restrict__ weights_time_data,
     const float* const __restrict__ bias_ptr, TfLiteFusedActivation activation,
-    float* const __restrict__ state_ptr, float* const __restrict__ scratch_ptr,
+    const float* const __restrict__ state_ptr,
     float* const __restrict__ output_ptr) {
-  // Compute matmul(state, weights_time).
   for (int b = 0; b < batch_size; ++b) {
-    float* state_ptr_batch = state_ptr + b * memory_size * num_filters;
-    float* scratch_ptr_batch = scratch_ptr + b * num_filters;
-    tensor_utils::BatchVectorBatchVectorDotProduct(
-        weights_time_data, state_ptr_batch, memory_size, num_filters,
-        scratch_ptr_batch);
-  }
-
-  // Reduction sum.
-  tensor_utils::ReductionSumVector(scratch_ptr, output_ptr,
-                                   batch_size * num_units, rank);
-  // Add bias if provided.
-  if (bias_ptr) {
-    tensor_utils::VectorBatchVectorAdd(bias_ptr, num_units, batch_size,
-                                       output_ptr);
+    const float* state_ptr_filter = state_ptr + b * memory_size * num_filters;
+    const float* weights_time_ptr = weights_time_data;
+    float* output_ptr_batch = output_ptr + b * num_units;
+    for (int u = 0; u < num_units; ++u) {
+      float sum = bias_ptr ? bias_ptr[u] : 0.0f;
+      for (int r = 0; r < rank; ++r) {
+        sum += tensor_utils::VectorVectorDotProduct(
+            weights_time_ptr, state_ptr_filter, memory_size);
+        weights_time_ptr += memory_size;
+        state_ptr_filter += memory_size;
+      }
+      output_ptr_batch[u] = sum;
+    }
+    // Apply activation while this batch's output is still in cache.
+    tensor_utils::ApplyActivationToVector(output_ptr_batch, num_units,
+                                          activation, output_ptr_batch);
   }
-
-  // Apply activation.
-  tensor_utils::ApplyActivationToVector(output_ptr, batch_size * num_units,
-                                        activation, output_ptr);
 }
 
 inline void EvalIntegerSVDF(
@@ -169,13 +170,11 @@ inline void EvalFloatSVDF(
   std::copy(state_data + 1, state_data + batch_size * memory_size * num_filters,
             state_data);
 
-  // Clear scratch (the matmul is accumulative).
-  std::fill_n(scratch_data, batch_size * num_filters, 0.0f);
-
-  // Compute conv1d(inputs, weights_feature).
-  tensor_utils::MatrixBatchVectorMultiplyAccumulate(
-      weights_feature_data, num_filters, input_size, input_data, batch_size,
-      scratch_data);
+  // Compute conv1d(inputs, weights_feature). The product is stored rather
+  // than accumulated, so scratch does not need to be cleared first.
+  tensor_utils::MatrixBatchVectorMultiplyBias(
+      weights_feature_data, num_filters, input_size, input_data,
+      /*bias=*/nullptr, batch_size, scratch_data, num_filters);
 
   // Copy the latest activation from scratch into activation_state:
   // The last, i.e. (memory_size-1)th entry for each batch, and filter.
@@ -185,7 +184,7 @@ inline void EvalFloatSVDF(
 
   ApplyTimeWeightsBiasAndActivation(
       batch_size, memory_size, num_filters, num_units, rank, weights_time_data,
-      bias_data, params->activation, state_data, scratch_data, output_data);
+      bias_data, params->activation, state_data, output_data);
 }
 
 inline void EvalHybridSVDF(
@@ -240,7 +239,7 @@ inline void EvalHybridSVDF(
   // a time.
   ApplyTimeWeightsBiasAndActivation(
       batch_size, memory_size, num_filters, num_units, rank, weights_time_data,
-      bias_data, params->activation, state, scratch, output_data);
+      bias_data, params->activation, state, output_data);
 }
 
 }  // namespace reference_ops
@@ -76,6 +76,26 @@ inline void ApplyActivationToVector(const float* vector, int v_size,
   }
 }
 
+// Fused gate computation for the recurrent kernels:
+//   result = activation(matrix * vector + bias)
+// The product is computed one batch at a time so that the activation runs
+// over the freshly written gate values while they are still in L1, instead
+// of sweeping the whole batched output again. 'bias' may be null, and the
+// results of consecutive batches are 'result_stride' elements apart.
+inline void MatrixBatchVectorMultiplyBiasActivation(
+    const float* matrix, int m_rows, int m_cols, const float* vector,
+    const float* bias, int n_batch, TfLiteFusedActivation activation,
+    float* result, int result_stride) {
+  for (int b = 0; b < n_batch; ++b) {
+    float* result_in_batch = result + b * result_stride;
+    MatrixBatchVectorMultiplyBias(matrix, m_rows, m_cols, vector + b * m_cols,
+                                  bias, /*n_batch=*/1, result_in_batch,
+                                  result_stride);
+    ApplyActivationToVector(result_in_batch, m_rows, activation,
+                            result_in_batch);
+  }
+}
+
 }  // namespace tensor_utils
 }  // namespace tflite
 
@@ -23,6 +23,7 @@ limitations under the License.
 #include "kernels/cpu_backend_context.h"
 #include "kernels/internal/common.h"
 #include "kernels/internal/quantization_util.h"
+#include "kernels/internal/reference/portable_tensor_utils_impl.h"
 #include "kernels/test_util.h"
 
 #ifdef DOTPROD_BENCHMARKS
@@ -360,6 +361,68 @@ TEST(uKernels, MatrixBatchVectorMultiplyAccumulateTest) {
                                                        -1., 7., 23.})));
 }
 
+TEST(uKernels, MatrixBatchVectorMultiplyBiasTest) {
+  constexpr int kRow = 5;
+  constexpr int kCol = 9;
+  constexpr int kBatch = 2;
+  constexpr int kStride = 6;
+  std::vector<float> matrix(kRow * kCol);
+  std::vector<float> vector(kCol * kBatch);
+  for (size_t i = 0; i < matrix.size(); ++i) {
+    matrix[i] = (i % 7) - 3.0f;
+  }
+  for (size_t i = 0; i < vector.size(); ++i) {
+    vector[i] = (i % 5) * 0.5f - 1.0f;
+  }
+  const float bias[kRow] = {0.5, -0.5, 1.0, -1.0, 2.0};
+
+  // Results are stored with a stride, the padding is left untouched.
+  std::vector<float> output(kStride * kBatch, 42.0f);
+  std::vector<float> expected(kStride * kBatch, 42.0f);
+  for (int b = 0; b < kBatch; ++b) {
+    for (int r = 0; r < kRow; ++r) {
+      float sum = bias[r];
+      for (int c = 0; c < kCol; ++c) {
+        sum += matrix[r * kCol + c] * vector[b * kCol + c];
+      }
+      expected[b * kStride + r] = sum;
+    }
+  }
+  MatrixBatchVectorMultiplyBias(matrix.data(), kRow, kCol, vector.data(), bias,
+                                kBatch, output.data(), kStride);
+  EXPECT_THAT(output, ElementsAreArray(ArrayFloatNear(expected)));
+
+  // Without a bias.
+  std::fill(output.begin(), output.end(), 42.0f);
+  for (int b = 0; b < kBatch; ++b) {
+    for (int r = 0; r < kRow; ++r) {
+      expected[b * kStride + r] -= bias[r];
+    }
+  }
+  MatrixBatchVectorMultiplyBias(matrix.data(), kRow, kCol, vector.data(),
+                                /*bias=*/nullptr, kBatch, output.data(),
+                                kStride);
+  EXPECT_THAT(output, ElementsAreArray(ArrayFloatNear(expected)));
+}
+
+TEST(uKernels, MatrixBatchVectorMultiplyBiasActivationTest) {
+  constexpr int kRow = 3;
+  constexpr int kCol = 4;
+  constexpr int kBatch = 2;
+  static float matrix[kRow * kCol] = {1.0,  2.0,  3.0,  4.0,   //
+                                      -1.0, -2.0, -3.0, -4.0,  //
+                                      1.0,  -2.0, 3.0,  -4.0};
+  static float vector[kCol * kBatch] = {1.0, -1.0, 1.0, -1.0,  //
+                                        2.0, -2.0, 2.0, -2.0};
+  static float bias[kRow] = {3.0, 3.0, 3.0};
+  std::vector<float> output(kRow * kBatch);
+  MatrixBatchVectorMultiplyBiasActivation(matrix, kRow, kCol, vector, bias,
+                                          kBatch, kTfLiteActRelu,
+                                          output.data(), kRow);
+  EXPECT_THAT(output, ElementsAreArray(ArrayFloatNear({1., 5., 13.,  //
+                                                       0., 7., 23.})));
+}
+
 // Quantized matmul with 2 * 30 input and 9 * 30 matrix.
 TEST(uKernels, QuantMatrixBatchVectorMultiplyAccumulate8x8_16Test) {
   CpuBackendContext context;
@@ -1229,6 +1292,39 @@ TEST(uKernels, PerChannelDotprodMatrixBatchVectorMultiplyAccumulateTest) {
   EXPECT_NEAR(1050930, results[150], 0.0001);
 }
 
+// Shapes that exercise the row blocking and the column postambles of the
+// optimized kernels, compared against the portable implementation.
+TEST(uKernels, HybridMatrixBatchVectorMultiplyAccumulateOddShapesTest) {
+  const bool kNegative = true;
+  const bool kPerChannel = true;
+  for (int rows : {1, 3, 4, 7, 9}) {
+    for (int cols : {1, 7, 15, 33, 63, 65, 100, 130}) {
+      for (int batch : {1, 3}) {
+        MatrixVectorData data =
+            SetupMatrixVectorData(rows, cols, batch, kNegative, kPerChannel);
+        std::vector<float> expected = data.results;
+        std::vector<int32_t> scratch(rows * batch);
+        std::vector<int32_t> row_sums(rows);
+        bool compute_row_sums = true;
+        CpuBackendContext context;
+        PortableMatrixBatchVectorMultiplyAccumulate(
+            data.matrix.data(), rows, cols, data.vectors.data(),
+            data.scale_factors.data(), batch, expected.data(),
+            data.per_channel_scales.data(), data.input_offsets.data(),
+            scratch.data(), row_sums.data(), &compute_row_sums, &context);
+        compute_row_sums = true;
+        MatrixBatchVectorMultiplyAccumulate(
+            data.matrix.data(), rows, cols, data.vectors.data(),
+            data.scale_factors.data(), batch, data.results.data(),
+            data.per_channel_scales.data(), data.input_offsets.data(),
+            scratch.data(), row_sums.data(), &compute_row_sums, &context);
+        EXPECT_THAT(data.results, testing::ElementsAreArray(expected))
+            << "rows=" << rows << " cols=" << cols << " batch=" << batch;
+      }
+    }
+  }
+}
+
 TEST(uKernels, DotprodMatrixBatchFourVectorMultiplyAccumulateDotprodTest) {
   ASSERT_THAT(TestDotprodMatrixBatchVectorMultiply(2, 16, 4),
               testing::ElementsAreArray(
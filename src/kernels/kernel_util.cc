@@ -19,6 +19,7 @@ limitations under the License.
 
 #include <algorithm>
 #include <complex>
+#include <cstdlib>
 #include <limits>
 #include <memory>
 
@@ -569,6 +570,36 @@ int TfLiteTypeGetSize(TfLiteType type) {
   }
 }
 
+bool NarrowInt64BiasToInt32(const TfLiteTensor* bias,
+                            const TfLiteTensor* filter, int32_t* bias_int32) {
+  const int64_t num_channels = NumElements(bias);
+  const int64_t filter_size = NumElements(filter);
+  if (filter->type != kTfLiteInt8 || num_channels == 0 ||
+      filter_size % num_channels != 0) {
+    return false;
+  }
+  const int64_t* bias_data = bias->data.i64;
+  const int8_t* filter_data = filter->data.int8;
+  const int64_t channel_size = filter_size / num_channels;
+  // The largest magnitude of an int16 input.
+  constexpr int64_t kMaxInput = -static_cast<int64_t>(
+      std::numeric_limits<int16_t>::min());
+  constexpr int64_t kMaxAccumulator = std::numeric_limits<int32_t>::max();
+  for (int64_t c = 0; c < num_channels; ++c) {
+    if (bias_data[c] < -kMaxAccumulator || bias_data[c] > kMaxAccumulator) {
+      return false;
+    }
+    int64_t accumulator_bound = std::abs(bias_data[c]);
+    const int8_t* channel_filter = filter_data + c * channel_size;
+    for (int64_t i = 0; i < channel_size; ++i) {
+      accumulator_bound += std::abs(channel_filter[i]) * kMaxInput;
+    }
+    if (accumulator_bound > kMaxAccumulator) return false;
+    bias_int32[c] = static_cast<int32_t>(bias_data[c]);
+  }
+  return true;
+}
+
 bool IsMobilePlatform() {
 #if defined(ANDROID) || defined(__ANDROID__)
   return true;
@@ -271,6 +271,16 @@ TfLiteStatus GetQuantizedConvolutionMultipler(TfLiteContext* context,
                                               TfLiteTensor* output,
                                               double* multiplier);
 
+// Copies the int64 bias of a 16x8 quantized op into 'bias_int32', which must
+// hold NumElements(bias) values. 'filter' is the int8 filter, whose first
+// dimension is the output channel of each bias value. Returns false, leaving
+// 'bias_int32' partly written, if the accumulator of an output channel might
+// not fit into int32, i.e. its bias plus the largest sum of the products of
+// its filter values and any int16 inputs; the op then has to stay on the
+// int64 reference path instead of the int32 accumulating optimized kernels.
+bool NarrowInt64BiasToInt32(const TfLiteTensor* bias,
+                            const TfLiteTensor* filter, int32_t* bias_int32);
+
 // Calculates the useful quantized range of an activation layer given its
 // activation tensor.
 TfLiteStatus CalculateActivationRangeQuantized(TfLiteContext* context,
@@ -331,10 +331,18 @@ TfLiteStatus EvalQuantized(TfLiteContext* context, TfLiteNode* node,
       TF_LITE_ENSURE_EQ(context, op_params.input2_offset, 0.0);
       TF_LITE_ENSURE_EQ(context, op_params.output_offset, 0.0);
 
-      if (need_broadcast) {
-        TF_LITE_MUL(reference_integer_ops, BroadcastMul6DSlow, int16_t);
+      if (kernel_type == kReference) {
+        if (need_broadcast) {
+          TF_LITE_MUL(reference_integer_ops, BroadcastMul6DSlow, int16_t);
+        } else {
+          TF_LITE_MUL(reference_integer_ops, Mul, int16_t);
+        }
       } else {
-        TF_LITE_MUL(reference_integer_ops, Mul, int16_t);
+        if (need_broadcast) {
+          TF_LITE_MUL(optimized_integer_ops, BroadcastMulDispatch, int16_t);
+        } else {
+          TF_LITE_MUL(optimized_integer_ops, Mul, int16_t);
+        }
       }
     } else {
       // type == kTfLiteUInt8
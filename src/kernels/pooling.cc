@@ -234,7 +234,11 @@ TfLiteStatus AverageEvalQuantizedInt16(TfLiteContext* context, TfLiteNode* node,
                                             GetTensorData<int16_t>(input),    \
                                             GetTensorShape(output),           \
                                             GetTensorData<int16_t>(output)))
-  TF_LITE_AVERAGE_POOL(reference_integer_ops);
+  if (kernel_type == kReference) {
+    TF_LITE_AVERAGE_POOL(reference_integer_ops);
+  } else {
+    TF_LITE_AVERAGE_POOL(optimized_integer_ops);
+  }
 #undef TF_LITE_AVERAGE_POOL
   return kTfLiteOk;
 }
@@ -345,7 +349,11 @@ void MaxEvalQuantizedInt16(TfLiteContext* context, TfLiteNode* node,
   type::MaxPool(op_params, GetTensorShape(input),                      \
                 GetTensorData<int16_t>(input), GetTensorShape(output), \
                 GetTensorData<int16_t>(output))
-  TF_LITE_MAX_POOL(reference_integer_ops);
+  if (kernel_type == kReference) {
+    TF_LITE_MAX_POOL(reference_integer_ops);
+  } else {
+    TF_LITE_MAX_POOL(optimized_integer_ops);
+  }
 #undef TF_LITE_MAX_POOL
 }
 
@@ -0,0 +1,215 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "profiling/chrome_trace_profiler.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>  // NOLINT(build/c++11)
+#include <ostream>
+#include <string>
+#include <thread>  // NOLINT(build/c++11)
+
+#include "minimal_logging.h"
+#include "profiling/profile_buffer.h"
+#include "profiling/time.h"
+
+namespace tflite {
+namespace profiling {
+namespace {
+
+const char* GetCategory(Profiler::EventType event_type) {
+  switch (event_type) {
+    case Profiler::EventType::OPERATOR_INVOKE_EVENT:
+    case Profiler::EventType::DELEGATE_PROFILED_OPERATOR_INVOKE_EVENT:
+      return "operator";
+    case Profiler::EventType::DELEGATE_OPERATOR_INVOKE_EVENT:
+      return "delegate_operator";
+    case Profiler::EventType::GENERAL_RUNTIME_INSTRUMENTATION_EVENT:
+      return "runtime";
+    default:
+      return "default";
+  }
+}
+
+void WriteJsonString(const std::string& value, std::ostream* stream) {
+  (*stream) << '"';
+  for (const char c : value) {
+    if (c == '"' || c == '\\') {
+      (*stream) << '\\' << c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      char escaped[8];
+      snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+      (*stream) << escaped;
+    } else {
+      (*stream) << c;
+    }
+  }
+  (*stream) << '"';
+}
+
+}  // namespace
+
+ChromeTraceProfiler::ChromeTraceProfiler(uint32_t max_num_entries)
+    : max_num_entries_(max_num_entries) {}
+
+void ChromeTraceProfiler::StartProfiling() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  enabled_ = true;
+}
+
+void ChromeTraceProfiler::StopProfiling() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  enabled_ = false;
+}
+
+void ChromeTraceProfiler::Reset() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  events_.clear();
+  // Threads keep their track.
+  for (auto& thread : threads_) {
+    thread.second.open_events.clear();
+  }
+}
+
+size_t ChromeTraceProfiler::NumEvents() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return events_.size();
+}
+
+ChromeTraceProfiler::ThreadState& ChromeTraceProfiler::GetThreadState() {
+  auto it = threads_.find(std::this_thread::get_id());
+  if (it == threads_.end()) {
+    ThreadState state;
+    state.thread_index = static_cast<int>(threads_.size());
+    it = threads_.emplace(std::this_thread::get_id(), state).first;
+  }
+  return it->second;
+}
+
+bool ChromeTraceProfiler::ShouldRecord(EventType event_type) const {
+  if (!enabled_ ||
+      static_cast<int>(event_type) >=
+          static_cast<int>(EventType::TELEMETRY_EVENT)) {
+    return false;
+  }
+  if (events_.size() >= max_num_entries_) {
+    TFLITE_LOG_PROD_ONCE(TFLITE_LOG_INFO,
+                         "Warning: Dropping ChromeTraceProfiler event.");
+    return false;
+  }
+  return true;
+}
+
+uint32_t ChromeTraceProfiler::BeginEvent(const char* tag, EventType event_type,
+                                         int64_t event_metadata1,
+                                         int64_t event_metadata2) {
+  const uint64_t now_us = time::NowMicros();
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!ShouldRecord(event_type)) {
+    return kInvalidEventHandle;
+  }
+  ThreadState& thread = GetThreadState();
+  const uint32_t handle = static_cast<uint32_t>(events_.size());
+  events_.push_back({tag, event_type, event_metadata1, event_metadata2,
+                     thread.thread_index, now_us, /*duration_us=*/-1});
+  thread.open_events.push_back(handle);
+  thread.next_added_timestamp_us = now_us;
+  return handle;
+}
+
+void ChromeTraceProfiler::EndEvent(uint32_t event_handle) {
+  const uint64_t now_us = time::NowMicros();
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (event_handle >= events_.size()) {
+    return;
+  }
+  TraceEvent& event = events_[event_handle];
+  event.duration_us = static_cast<int64_t>(now_us - event.begin_timestamp_us);
+  ThreadState& thread = GetThreadState();
+  auto it = std::find(thread.open_events.begin(), thread.open_events.end(),
+                      event_handle);
+  if (it != thread.open_events.end()) {
+    thread.open_events.erase(it);
+  }
+  thread.next_added_timestamp_us = now_us;
+}
+
+void ChromeTraceProfiler::AddEvent(const char* tag, EventType event_type,
+                                   uint64_t elapsed_time,
+                                   int64_t event_metadata1,
+                                   int64_t event_metadata2) {
+  const uint64_t now_us = time::NowMicros();
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!ShouldRecord(event_type)) {
+    return;
+  }
+  ThreadState& thread = GetThreadState();
+  uint64_t begin_us = now_us - std::min(now_us, elapsed_time);
+  if (!thread.open_events.empty()) {
+    begin_us = thread.next_added_timestamp_us;
+    thread.next_added_timestamp_us += elapsed_time;
+  }
+  events_.push_back({tag, event_type, event_metadata1, event_metadata2,
+                     thread.thread_index, begin_us,
+                     static_cast<int64_t>(elapsed_time)});
+}
+
+void ChromeTraceProfiler::WriteTrace(std::ostream* stream) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  (*stream) << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  bool first = true;
+  // Name the tracks in the order threads first reported.
+  std::vector<int> thread_indices;
+  for (const auto& thread : threads_) {
+    thread_indices.push_back(thread.second.thread_index);
+  }
+  std::sort(thread_indices.begin(), thread_indices.end());
+  for (const int thread_index : thread_indices) {
+    (*stream) << (first ? "" : ",") << "\n{\"name\":\"thread_name\","
+              << "\"ph\":\"M\",\"pid\":0,\"tid\":" << thread_index
+              << ",\"args\":{\"name\":\"Thread " << thread_index << "\"}}";
+    first = false;
+  }
+  for (const TraceEvent& event : events_) {
+    if (event.duration_us < 0) continue;
+    (*stream) << (first ? "" : ",") << "\n{\"name\":";
+    WriteJsonString(event.tag, stream);
+    (*stream) << ",\"cat\":\"" << GetCategory(event.event_type)
+              << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << event.thread_index
+              << ",\"ts\":" << event.begin_timestamp_us
+              << ",\"dur\":" << event.duration_us << ",\"args\":{";
+    switch (event.event_type) {
+      case EventType::OPERATOR_INVOKE_EVENT:
+        (*stream) << "\"node_index\":" << event.event_metadata1
+                  << ",\"subgraph_index\":" << event.event_metadata2;
+        break;
+      case EventType::DELEGATE_OPERATOR_INVOKE_EVENT:
+      case EventType::DELEGATE_PROFILED_OPERATOR_INVOKE_EVENT:
+        (*stream) << "\"node_index\":" << event.event_metadata1;
+        break;
+      default:
+        (*stream) << "\"metadata1\":" << event.event_metadata1
+                  << ",\"metadata2\":" << event.event_metadata2;
+        break;
+    }
+    (*stream) << "}}";
+    first = false;
+  }
+  (*stream) << "\n]}\n";
+}
+
+}  // namespace profiling
+}  // namespace tflite
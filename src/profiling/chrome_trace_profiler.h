@@ -0,0 +1,112 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_LITE_PROFILING_CHROME_TRACE_PROFILER_H_
+#define TENSORFLOW_LITE_PROFILING_CHROME_TRACE_PROFILER_H_
+
+#include <cstdint>
+#include <map>
+#include <mutex>  // NOLINT(build/c++11)
+#include <ostream>
+#include <string>
+#include <thread>  // NOLINT(build/c++11)
+#include <vector>
+
+#include "core/api/profiler.h"
+
+namespace tflite {
+namespace profiling {
+
+// Records the events of all threads reporting to it as a timeline, which is
+// written in the Chrome trace event JSON format understood by Perfetto
+// (https://ui.perfetto.dev) and chrome://tracing, with one track per thread.
+//
+// Besides being added to an interpreter, which reports the operator and
+// delegate operator events of the invoking thread, it's meant to be set as the
+// threadpool profiler of a CpuBackendContext, so that the tasks run by the
+// cpu_backend_threadpool workers show up on their own tracks.
+//
+// Events added with AddEvent only carry their duration; when they are added
+// while another event of the same thread is open, as delegates do for their
+// internal operators at the end of their kernel, they are laid out back to
+// back from the start of that event. Telemetry events aren't recorded.
+//
+// This class is thread safe.
+class ChromeTraceProfiler : public tflite::Profiler {
+ public:
+  explicit ChromeTraceProfiler(uint32_t max_num_entries);
+
+  ChromeTraceProfiler(const ChromeTraceProfiler&) = delete;
+  ChromeTraceProfiler& operator=(const ChromeTraceProfiler&) = delete;
+
+  uint32_t BeginEvent(const char* tag, EventType event_type,
+                      int64_t event_metadata1,
+                      int64_t event_metadata2) override;
+
+  void EndEvent(uint32_t event_handle) override;
+
+  void AddEvent(const char* tag, EventType event_type, uint64_t elapsed_time,
+                int64_t event_metadata1, int64_t event_metadata2) override;
+
+  void StartProfiling();
+  void StopProfiling();
+  void Reset();
+
+  // Returns the number of recorded events.
+  size_t NumEvents() const;
+
+  // Writes the recorded events as a Chrome trace JSON object. Events that are
+  // still open are left out.
+  void WriteTrace(std::ostream* stream) const;
+
+ private:
+  struct TraceEvent {
+    std::string tag;
+    EventType event_type;
+    int64_t event_metadata1;
+    int64_t event_metadata2;
+    // The index of the thread track, in the order threads first reported.
+    int thread_index;
+    uint64_t begin_timestamp_us;
+    // -1 while the event is open.
+    int64_t duration_us;
+  };
+
+  struct ThreadState {
+    int thread_index;
+    // The events of the thread that are open, innermost last.
+    std::vector<uint32_t> open_events;
+    // Where the next event added with AddEvent within an open event begins,
+    // i.e. the start or end of the last event of the thread.
+    uint64_t next_added_timestamp_us = 0;
+  };
+
+  // Returns the state of the calling thread. Must be called with mutex_ held.
+  ThreadState& GetThreadState();
+
+  // Returns whether an event can be recorded. Must be called with mutex_
+  // held.
+  bool ShouldRecord(EventType event_type) const;
+
+  const uint32_t max_num_entries_;
+  mutable std::mutex mutex_;
+  bool enabled_ = false;
+  std::vector<TraceEvent> events_;
+  std::map<std::thread::id, ThreadState> threads_;
+};
+
+}  // namespace profiling
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_PROFILING_CHROME_TRACE_PROFILER_H_
@@ -0,0 +1,138 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "profiling/chrome_trace_profiler.h"
+
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <thread>  // NOLINT(build/c++11)
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "core/api/profiler.h"
+#include "profiling/profile_buffer.h"
+
+namespace tflite {
+namespace profiling {
+
+namespace {
+
+using EventType = Profiler::EventType;
+using ::testing::HasSubstr;
+using ::testing::Not;
+
+std::string GetTrace(const ChromeTraceProfiler& profiler) {
+  std::stringstream stream;
+  profiler.WriteTrace(&stream);
+  return stream.str();
+}
+
+TEST(ChromeTraceProfilerTest, RecordsEventsWhileProfiling) {
+  ChromeTraceProfiler profiler(/*max_num_entries=*/16);
+  EXPECT_EQ(profiler.BeginEvent("op", EventType::OPERATOR_INVOKE_EVENT, 0, 0),
+            kInvalidEventHandle);
+
+  profiler.StartProfiling();
+  const uint32_t invoke =
+      profiler.BeginEvent("Invoke", EventType::DEFAULT, 0, 0);
+  const uint32_t op = profiler.BeginEvent(
+      "CONV_2D", EventType::OPERATOR_INVOKE_EVENT, /*event_metadata1=*/3,
+      /*event_metadata2=*/1);
+  profiler.EndEvent(op);
+  profiler.AddEvent("Telemetry", EventType::TELEMETRY_EVENT, 0, 0, 0);
+  profiler.EndEvent(invoke);
+  profiler.StopProfiling();
+
+  EXPECT_EQ(profiler.NumEvents(), 2);
+  const std::string trace = GetTrace(profiler);
+  EXPECT_THAT(trace, HasSubstr("\"traceEvents\":["));
+  EXPECT_THAT(trace, HasSubstr("\"name\":\"Thread 0\""));
+  EXPECT_THAT(trace, HasSubstr("\"name\":\"Invoke\",\"cat\":\"default\""));
+  EXPECT_THAT(trace, HasSubstr("\"name\":\"CONV_2D\",\"cat\":\"operator\""));
+  EXPECT_THAT(trace, HasSubstr("\"node_index\":3,\"subgraph_index\":1"));
+  EXPECT_THAT(trace, Not(HasSubstr("Telemetry")));
+
+  profiler.Reset();
+  EXPECT_EQ(profiler.NumEvents(), 0);
+}
+
+TEST(ChromeTraceProfilerTest, LaysOutAddedEventsFromEnclosingEvent) {
+  ChromeTraceProfiler profiler(/*max_num_entries=*/16);
+  profiler.StartProfiling();
+  const uint32_t delegate = profiler.BeginEvent(
+      "TfLiteXNNPackDelegate", EventType::OPERATOR_INVOKE_EVENT, 0, 0);
+  profiler.AddEvent("Convolution \"1x1\"",
+                    EventType::DELEGATE_PROFILED_OPERATOR_INVOKE_EVENT,
+                    /*elapsed_time=*/100, 0, 0);
+  profiler.AddEvent("Add", EventType::DELEGATE_PROFILED_OPERATOR_INVOKE_EVENT,
+                    /*elapsed_time=*/50, 1, 0);
+  profiler.EndEvent(delegate);
+  profiler.StopProfiling();
+
+  const std::string trace = GetTrace(profiler);
+  const size_t delegate_ts = trace.find("\"ts\":");
+  ASSERT_NE(delegate_ts, std::string::npos);
+  const uint64_t begin_us =
+      std::stoull(trace.substr(delegate_ts + std::string("\"ts\":").size()));
+  EXPECT_THAT(trace, HasSubstr("\"name\":\"Convolution \\\"1x1\\\"\""));
+  EXPECT_THAT(trace, HasSubstr("\"ts\":" + std::to_string(begin_us) +
+                               ",\"dur\":100"));
+  EXPECT_THAT(trace, HasSubstr("\"ts\":" + std::to_string(begin_us + 100) +
+                               ",\"dur\":50"));
+}
+
+TEST(ChromeTraceProfilerTest, RecordsOneTrackPerThread) {
+  ChromeTraceProfiler profiler(/*max_num_entries=*/16);
+  profiler.StartProfiling();
+  const uint32_t invoke =
+      profiler.BeginEvent("Invoke", EventType::DEFAULT, 0, 0);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 3; ++i) {
+    threads.emplace_back([&profiler, i]() {
+      profiler.EndEvent(profiler.BeginEvent(
+          "ThreadpoolTask", EventType::GENERAL_RUNTIME_INSTRUMENTATION_EVENT,
+          i, 3));
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  profiler.EndEvent(invoke);
+  profiler.StopProfiling();
+
+  EXPECT_EQ(profiler.NumEvents(), 4);
+  const std::string trace = GetTrace(profiler);
+  EXPECT_THAT(trace, HasSubstr("\"name\":\"Thread 3\""));
+  EXPECT_THAT(trace, Not(HasSubstr("\"name\":\"Thread 4\"")));
+  EXPECT_THAT(trace,
+              HasSubstr("\"name\":\"ThreadpoolTask\",\"cat\":\"runtime\""));
+}
+
+TEST(ChromeTraceProfilerTest, DropsEventsWhenFull) {
+  ChromeTraceProfiler profiler(/*max_num_entries=*/1);
+  profiler.StartProfiling();
+  profiler.EndEvent(
+      profiler.BeginEvent("op", EventType::OPERATOR_INVOKE_EVENT, 0, 0));
+  EXPECT_EQ(profiler.BeginEvent("op", EventType::OPERATOR_INVOKE_EVENT, 1, 0),
+            kInvalidEventHandle);
+  profiler.StopProfiling();
+
+  EXPECT_EQ(profiler.NumEvents(), 1);
+}
+
+}  // namespace
+}  // namespace profiling
+}  // namespace tflite
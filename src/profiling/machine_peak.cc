@@ -0,0 +1,127 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "profiling/machine_peak.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <thread>  // NOLINT(build/c++11)
+#include <vector>
+
+#include "profiling/time.h"
+
+namespace tflite {
+namespace profiling {
+namespace {
+
+constexpr int kNumLanes = 64;
+constexpr int64_t kMultiplyAddIterations = 1 << 20;
+// Larger than the last level cache of most CPUs.
+constexpr size_t kBandwidthBufferBytes = size_t{128} << 20;
+constexpr int kNumTrials = 3;
+
+// Runs independent multiply-adds on kNumLanes accumulators, which the compiler
+// can keep in vector registers, and returns their sum so that they aren't
+// optimized away.
+float RunMultiplyAdds(int64_t iterations) {
+  float accumulators[kNumLanes];
+  for (int i = 0; i < kNumLanes; ++i) {
+    accumulators[i] = static_cast<float>(i);
+  }
+  for (int64_t iteration = 0; iteration < iterations; ++iteration) {
+    for (int i = 0; i < kNumLanes; ++i) {
+      accumulators[i] = accumulators[i] * 0.999f + 0.001f;
+    }
+  }
+  float sum = 0;
+  for (int i = 0; i < kNumLanes; ++i) {
+    sum += accumulators[i];
+  }
+  return sum;
+}
+
+// Reads [begin, end) and returns its sum so that the reads aren't optimized
+// away.
+uint64_t ReadBuffer(const uint64_t* begin, const uint64_t* end) {
+  uint64_t sum = 0;
+  for (const uint64_t* value = begin; value < end; ++value) {
+    sum += *value;
+  }
+  return sum;
+}
+
+// Runs 'work(thread_index)' on 'num_threads' threads started at once, and
+// returns the elapsed time in seconds of the best of kNumTrials runs.
+double TimeOnThreads(int num_threads, const std::function<void(int)>& work) {
+  double best_seconds = 0;
+  for (int trial = 0; trial < kNumTrials; ++trial) {
+    std::atomic<int> num_ready{0};
+    std::atomic<bool> start{false};
+    std::vector<std::thread> threads;
+    for (int i = 0; i < num_threads; ++i) {
+      threads.emplace_back([&, i]() {
+        num_ready.fetch_add(1);
+        while (!start.load()) {
+        }
+        work(i);
+      });
+    }
+    while (num_ready.load() < num_threads) {
+    }
+    const uint64_t start_us = time::NowMicros();
+    start.store(true);
+    for (std::thread& thread : threads) {
+      thread.join();
+    }
+    const double seconds =
+        std::max<uint64_t>(time::NowMicros() - start_us, 1) * 1e-6;
+    best_seconds = trial == 0 ? seconds : std::min(best_seconds, seconds);
+  }
+  return best_seconds;
+}
+
+}  // namespace
+
+MachinePeak MeasureMachinePeak(int num_threads) {
+  num_threads = std::max(num_threads, 1);
+  MachinePeak peak;
+
+  std::vector<float> sums(num_threads);
+  const double multiply_add_seconds = TimeOnThreads(num_threads, [&](int i) {
+    sums[i] = RunMultiplyAdds(kMultiplyAddIterations);
+  });
+  // 2 flops per multiply-add.
+  peak.gflops = 2.0 * kNumLanes * kMultiplyAddIterations * num_threads /
+                multiply_add_seconds * 1e-9;
+
+  const size_t num_values = kBandwidthBufferBytes / sizeof(uint64_t);
+  std::vector<uint64_t> buffer(num_values, 1);
+  std::vector<uint64_t> read_sums(num_threads);
+  const double read_seconds = TimeOnThreads(num_threads, [&](int i) {
+    const size_t begin = num_values * i / num_threads;
+    const size_t end = num_values * (i + 1) / num_threads;
+    read_sums[i] = ReadBuffer(buffer.data() + begin, buffer.data() + end);
+  });
+  peak.gbytes_per_second = kBandwidthBufferBytes / read_seconds * 1e-9;
+
+  // Keeps the results alive.
+  volatile float unused_sum = sums[0] + static_cast<float>(read_sums[0]);
+  (void)unused_sum;
+  return peak;
+}
+
+}  // namespace profiling
+}  // namespace tflite
@@ -0,0 +1,44 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_LITE_PROFILING_MACHINE_PEAK_H_
+#define TENSORFLOW_LITE_PROFILING_MACHINE_PEAK_H_
+
+namespace tflite {
+namespace profiling {
+
+// The peak arithmetic throughput and memory bandwidth of the machine, the two
+// roofs of the roofline model.
+struct MachinePeak {
+  double gflops = 0;
+  double gbytes_per_second = 0;
+
+  // The arithmetic intensity (flops per byte) above which an operator is
+  // compute bound rather than bandwidth bound.
+  double RidgePoint() const {
+    return gbytes_per_second > 0 ? gflops / gbytes_per_second : 0;
+  }
+};
+
+// Measures the peak of the machine on 'num_threads' threads: the arithmetic
+// throughput of independent float multiply-adds, vectorized as the compiler
+// flags of the build allow, and the bandwidth of reading a buffer much larger
+// than the caches. It takes a few hundred milliseconds and should run on an
+// otherwise idle machine.
+MachinePeak MeasureMachinePeak(int num_threads);
+
+}  // namespace profiling
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_PROFILING_MACHINE_PEAK_H_
@@ -0,0 +1,198 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "profiling/memory_timeline_profiler.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <utility>
+
+#include "core/c/common.h"
+#include "profiling/memory_info.h"
+#include "profiling/time.h"
+
+namespace tflite {
+namespace profiling {
+namespace {
+
+// Returns the in-use heap in bytes, or -1 if it's unknown.
+int64_t GetHeapInUseBytes() {
+  if (!memory::MemoryUsage::IsSupported()) return -1;
+  const size_t bytes = memory::GetMemoryUsage().in_use_allocated_bytes;
+  if (bytes == static_cast<size_t>(-1)) return -1;
+  return static_cast<int64_t>(bytes);
+}
+
+// Returns the phase of the operator events, i.e. "OpInit", "OpPrepare" and
+// the OPERATOR_INVOKE_EVENTs, or kNone for the others.
+MemoryTimelineEvent::Phase GetPhase(const char* tag,
+                                    Profiler::EventType event_type) {
+  if (event_type == Profiler::EventType::OPERATOR_INVOKE_EVENT) {
+    return MemoryTimelineEvent::Phase::kInvoke;
+  }
+  if (event_type == Profiler::EventType::DEFAULT && tag != nullptr) {
+    if (std::strcmp(tag, "OpInit") == 0) {
+      return MemoryTimelineEvent::Phase::kInit;
+    }
+    if (std::strcmp(tag, "OpPrepare") == 0) {
+      return MemoryTimelineEvent::Phase::kPrepare;
+    }
+  }
+  return MemoryTimelineEvent::Phase::kNone;
+}
+
+}  // namespace
+
+const char* GetMemoryKindName(MemoryTimelineEvent::Kind kind) {
+  switch (kind) {
+    case MemoryTimelineEvent::Kind::kArena:
+      return "arena";
+    case MemoryTimelineEvent::Kind::kPersistentArena:
+      return "persistent_arena";
+    case MemoryTimelineEvent::Kind::kDynamicTensor:
+      return "dynamic";
+    case MemoryTimelineEvent::Kind::kPersistentTensor:
+      return "persistent";
+    case MemoryTimelineEvent::Kind::kUntrackedHeap:
+      return "untracked_heap";
+  }
+  return "unknown";
+}
+
+const char* GetMemoryPhaseName(MemoryTimelineEvent::Phase phase) {
+  switch (phase) {
+    case MemoryTimelineEvent::Phase::kNone:
+      return "";
+    case MemoryTimelineEvent::Phase::kInit:
+      return "init";
+    case MemoryTimelineEvent::Phase::kPrepare:
+      return "prepare";
+    case MemoryTimelineEvent::Phase::kInvoke:
+      return "invoke";
+  }
+  return "unknown";
+}
+
+MemoryTimelineProfiler::MemoryTimelineProfiler(uint32_t max_num_events)
+    : max_num_events_(max_num_events) {}
+
+void MemoryTimelineProfiler::Reset() {
+  events_.clear();
+  peak_bytes_ = total_bytes_;
+  peak_event_index_ = -1;
+  num_dropped_events_ = 0;
+}
+
+uint32_t MemoryTimelineProfiler::BeginEvent(const char* tag,
+                                            EventType event_type,
+                                            int64_t event_metadata1,
+                                            int64_t event_metadata2) {
+  if (!enabled_) return 0;
+  const MemoryTimelineEvent::Phase phase = GetPhase(tag, event_type);
+  if (phase == MemoryTimelineEvent::Phase::kNone) return 0;
+  OpenOp op;
+  op.subgraph_index = event_metadata2;
+  op.node_index = event_metadata1;
+  op.phase = phase;
+  op.heap_bytes = GetHeapInUseBytes();
+  op.total_bytes = total_bytes_;
+  open_ops_.push_back(op);
+  return static_cast<uint32_t>(open_ops_.size());
+}
+
+void MemoryTimelineProfiler::EndEvent(uint32_t event_handle) {
+  if (event_handle == 0 || event_handle > open_ops_.size()) return;
+  // Operator events that weren't ended, if any, end w/ their parent.
+  open_ops_.resize(event_handle);
+  const OpenOp op = open_ops_.back();
+  open_ops_.pop_back();
+
+  int64_t untracked_bytes = 0;
+  const int64_t heap_bytes = op.heap_bytes < 0 ? -1 : GetHeapInUseBytes();
+  if (heap_bytes >= 0) {
+    untracked_bytes = (heap_bytes - op.heap_bytes) -
+                      (total_bytes_ - op.total_bytes) -
+                      op.nested_untracked_bytes;
+  }
+  if (untracked_bytes > 0) {
+    MemoryTimelineEvent event;
+    event.kind = MemoryTimelineEvent::Kind::kUntrackedHeap;
+    event.phase = op.phase;
+    event.bytes = untracked_bytes;
+    event.subgraph_index = op.subgraph_index;
+    event.node_index = op.node_index;
+    Record(std::move(event));
+  }
+  if (!open_ops_.empty()) {
+    open_ops_.back().nested_untracked_bytes +=
+        op.nested_untracked_bytes + std::max<int64_t>(untracked_bytes, 0);
+  }
+}
+
+void MemoryTimelineProfiler::AddEventWithData(const char* tag,
+                                              EventType event_type,
+                                              const void* data) {
+  if (!enabled_ || event_type != EventType::MEMORY_ALLOCATION_EVENT ||
+      data == nullptr) {
+    return;
+  }
+  const auto* allocation = static_cast<const ProfiledMemoryAllocation*>(data);
+  MemoryTimelineEvent event;
+  switch (allocation->allocation_type) {
+    case kTfLiteArenaRw:
+      event.kind = MemoryTimelineEvent::Kind::kArena;
+      break;
+    case kTfLiteArenaRwPersistent:
+      event.kind = MemoryTimelineEvent::Kind::kPersistentArena;
+      break;
+    case kTfLitePersistentRo:
+      event.kind = MemoryTimelineEvent::Kind::kPersistentTensor;
+      break;
+    default:
+      event.kind = MemoryTimelineEvent::Kind::kDynamicTensor;
+      break;
+  }
+  event.bytes = allocation->bytes;
+  event.subgraph_index = allocation->subgraph_index;
+  event.tensor_index = allocation->tensor_index;
+  if (allocation->node_index >= 0) {
+    event.node_index = allocation->node_index;
+  } else if (!open_ops_.empty() &&
+             open_ops_.back().subgraph_index == allocation->subgraph_index) {
+    event.node_index = open_ops_.back().node_index;
+    event.phase = open_ops_.back().phase;
+  }
+  if (tag != nullptr) event.tag = tag;
+  Record(std::move(event));
+}
+
+void MemoryTimelineProfiler::Record(MemoryTimelineEvent event) {
+  total_bytes_ += event.bytes;
+  event.total_bytes = total_bytes_;
+  const bool is_peak = total_bytes_ > peak_bytes_;
+  if (is_peak) peak_bytes_ = total_bytes_;
+  if (events_.size() >= max_num_events_) {
+    ++num_dropped_events_;
+    if (is_peak) peak_event_index_ = -1;
+    return;
+  }
+  event.timestamp_us = time::NowMicros();
+  if (is_peak) peak_event_index_ = static_cast<int64_t>(events_.size());
+  events_.push_back(std::move(event));
+}
+
+}  // namespace profiling
+}  // namespace tflite
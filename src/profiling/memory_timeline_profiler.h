@@ -0,0 +1,147 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_LITE_PROFILING_MEMORY_TIMELINE_PROFILER_H_
+#define TENSORFLOW_LITE_PROFILING_MEMORY_TIMELINE_PROFILER_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "core/api/profiler.h"
+
+namespace tflite {
+namespace profiling {
+
+// One change in the memory held by the runtime.
+struct MemoryTimelineEvent {
+  enum class Kind {
+    // The growth of the kTfLiteArenaRw arena.
+    kArena,
+    // The growth of the kTfLiteArenaRwPersistent arena.
+    kPersistentArena,
+    // The heap allocation of a kTfLiteDynamic tensor.
+    kDynamicTensor,
+    // The heap allocation of a kTfLitePersistentRo tensor.
+    kPersistentTensor,
+    // The growth of the heap over an operator that isn't any of the above,
+    // e.g. the buffers owned by a delegate or a kernel.
+    kUntrackedHeap,
+  };
+  static constexpr int kNumKinds = 5;
+
+  // What the operator the event is attributed to was doing.
+  enum class Phase { kNone, kInit, kPrepare, kInvoke };
+
+  uint64_t timestamp_us = 0;
+  Kind kind = Kind::kArena;
+  Phase phase = Phase::kNone;
+  // The number of bytes allocated, negative when released.
+  int64_t bytes = 0;
+  // The memory held after the event, i.e. the sum of the bytes of all the
+  // events so far, dropped ones included.
+  int64_t total_bytes = 0;
+  int64_t subgraph_index = -1;
+  // The node the event is attributed to, or -1 if none.
+  int64_t node_index = -1;
+  // The tensor allocated, or -1.
+  int64_t tensor_index = -1;
+  // The name of the tensor or of the arena.
+  std::string tag;
+};
+
+// Returns a short name of 'kind', e.g. "arena", and of 'phase', e.g. "invoke".
+const char* GetMemoryKindName(MemoryTimelineEvent::Kind kind);
+const char* GetMemoryPhaseName(MemoryTimelineEvent::Phase phase);
+
+// Records the MEMORY_ALLOCATION_EVENTs of the runtime into a timeline, and
+// attributes those that aren't tied to a node, e.g. the allocation of a dynamic
+// tensor, to the operator of the same subgraph being initialized, prepared or
+// invoked when they happened, i.e. the innermost "OpInit", "OpPrepare" or
+// OPERATOR_INVOKE_EVENT event.
+//
+// The in-use heap is also sampled at the beginning and end of each of these
+// operator events, and the growth that the recorded allocations don't account
+// for is recorded as a kUntrackedHeap event of the operator, so that e.g. the
+// buffers a delegate allocates while its kernel is initialized are attributed
+// to it. Only the allocations the heap statistics of the platform report are
+// seen, e.g. not the ones glibc mmaps, and releases aren't recorded.
+//
+// Not thread safe: the events must be reported by the thread that invokes
+// the interpreter.
+class MemoryTimelineProfiler : public tflite::Profiler {
+ public:
+  // Records up to 'max_num_events' events, the following ones are counted
+  // and only update the total.
+  explicit MemoryTimelineProfiler(uint32_t max_num_events = 1 << 16);
+
+  void StartProfiling() { enabled_ = true; }
+  void StopProfiling() { enabled_ = false; }
+
+  // Clears the recorded events. The memory held is kept, as it's not released.
+  void Reset();
+
+  uint32_t BeginEvent(const char* tag, EventType event_type,
+                      int64_t event_metadata1,
+                      int64_t event_metadata2) override;
+
+  void EndEvent(uint32_t event_handle) override;
+
+  void AddEventWithData(const char* tag, EventType event_type,
+                        const void* data) override;
+
+  // The events in the order they happened.
+  const std::vector<MemoryTimelineEvent>& events() const { return events_; }
+
+  int64_t total_bytes() const { return total_bytes_; }
+  int64_t peak_bytes() const { return peak_bytes_; }
+
+  // Returns the index in events() of the event that reached the peak, or -1
+  // if it was dropped or there's none.
+  int64_t peak_event_index() const { return peak_event_index_; }
+
+  uint64_t num_dropped_events() const { return num_dropped_events_; }
+
+ private:
+  // An operator event whose heap growth is being measured.
+  struct OpenOp {
+    int64_t subgraph_index;
+    int64_t node_index;
+    MemoryTimelineEvent::Phase phase;
+    // The in-use heap at the beginning, or -1 if it's unknown.
+    int64_t heap_bytes;
+    // The total at the beginning, to subtract the recorded allocations.
+    int64_t total_bytes;
+    // The untracked heap growth already attributed to the nested operators.
+    int64_t nested_untracked_bytes = 0;
+  };
+
+  void Record(MemoryTimelineEvent event);
+
+  const uint32_t max_num_events_;
+  bool enabled_ = false;
+  // The operator events being recorded, innermost last. The handle of an
+  // operator event is its depth, from 1; other events get 0.
+  std::vector<OpenOp> open_ops_;
+  std::vector<MemoryTimelineEvent> events_;
+  int64_t total_bytes_ = 0;
+  int64_t peak_bytes_ = 0;
+  int64_t peak_event_index_ = -1;
+  uint64_t num_dropped_events_ = 0;
+};
+
+}  // namespace profiling
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_PROFILING_MEMORY_TIMELINE_PROFILER_H_
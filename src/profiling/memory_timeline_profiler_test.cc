@@ -0,0 +1,127 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "profiling/memory_timeline_profiler.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "core/c/common.h"
+#include "profiling/memory_info.h"
+
+namespace tflite {
+namespace profiling {
+namespace {
+
+using Kind = MemoryTimelineEvent::Kind;
+using Phase = MemoryTimelineEvent::Phase;
+
+void AddAllocation(Profiler* profiler, const char* tag,
+                   TfLiteAllocationType allocation_type, int64_t bytes,
+                   int64_t tensor_index = -1, int64_t node_index = -1,
+                   int64_t subgraph_index = 0) {
+  ProfiledMemoryAllocation allocation;
+  allocation.allocation_type = allocation_type;
+  allocation.bytes = bytes;
+  allocation.subgraph_index = subgraph_index;
+  allocation.tensor_index = tensor_index;
+  allocation.node_index = node_index;
+  profiler->AddEventWithData(
+      tag, Profiler::EventType::MEMORY_ALLOCATION_EVENT, &allocation);
+}
+
+TEST(MemoryTimelineProfilerTest, RecordsNothingUntilStarted) {
+  MemoryTimelineProfiler profiler;
+  AddAllocation(&profiler, "ArenaRw", kTfLiteArenaRw, 1024);
+  EXPECT_TRUE(profiler.events().empty());
+  EXPECT_EQ(profiler.total_bytes(), 0);
+}
+
+TEST(MemoryTimelineProfilerTest, AttributesAllocationsToOperators) {
+  MemoryTimelineProfiler profiler;
+  profiler.StartProfiling();
+  // The arena growth names its node.
+  AddAllocation(&profiler, "ArenaRw", kTfLiteArenaRw, 4096, -1,
+                /*node_index=*/2);
+  // The dynamic tensors belong to the operator being invoked.
+  const uint32_t handle = profiler.BeginEvent(
+      "RESHAPE", Profiler::EventType::OPERATOR_INVOKE_EVENT, /*node=*/3,
+      /*subgraph=*/0);
+  AddAllocation(&profiler, "output", kTfLiteDynamic, 512, /*tensor_index=*/7);
+  profiler.EndEvent(handle);
+  AddAllocation(&profiler, "output", kTfLiteDynamic, -512, 7);
+
+  // Leaves out the heap the test itself may have allocated during the invoke.
+  std::vector<MemoryTimelineEvent> events;
+  for (const MemoryTimelineEvent& event : profiler.events()) {
+    if (event.kind != Kind::kUntrackedHeap) events.push_back(event);
+  }
+  ASSERT_EQ(events.size(), 3);
+  EXPECT_EQ(events[0].kind, Kind::kArena);
+  EXPECT_EQ(events[0].node_index, 2);
+  EXPECT_EQ(events[0].phase, Phase::kNone);
+  EXPECT_EQ(events[0].total_bytes, 4096);
+  EXPECT_EQ(events[1].kind, Kind::kDynamicTensor);
+  EXPECT_EQ(events[1].node_index, 3);
+  EXPECT_EQ(events[1].tensor_index, 7);
+  EXPECT_EQ(events[1].phase, Phase::kInvoke);
+  EXPECT_EQ(events[1].tag, "output");
+  EXPECT_EQ(events[1].total_bytes, 4096 + 512);
+  EXPECT_EQ(events[2].bytes, -512);
+  EXPECT_EQ(events[2].node_index, -1);
+  EXPECT_GE(profiler.peak_bytes(), 4096 + 512);
+}
+
+TEST(MemoryTimelineProfilerTest, RecordsUntrackedHeapGrowth) {
+  if (!memory::MemoryUsage::IsSupported()) GTEST_SKIP();
+  MemoryTimelineProfiler profiler;
+  profiler.StartProfiling();
+  const uint32_t handle = profiler.BeginEvent(
+      "OpInit", Profiler::EventType::DEFAULT, /*node=*/1, /*subgraph=*/0);
+  // Stands for the buffers of a delegate kernel, small enough not to be
+  // mmapped.
+  std::vector<void*> buffers;
+  for (int i = 0; i < 16; ++i) buffers.push_back(std::malloc(4096));
+  profiler.EndEvent(handle);
+  for (void* buffer : buffers) std::free(buffer);
+
+  ASSERT_EQ(profiler.events().size(), 1);
+  const MemoryTimelineEvent& event = profiler.events()[0];
+  EXPECT_EQ(event.kind, Kind::kUntrackedHeap);
+  EXPECT_EQ(event.phase, Phase::kInit);
+  EXPECT_EQ(event.node_index, 1);
+  EXPECT_GE(event.bytes, 16 * 4096);
+}
+
+TEST(MemoryTimelineProfilerTest, CountsDroppedEvents) {
+  MemoryTimelineProfiler profiler(/*max_num_events=*/1);
+  profiler.StartProfiling();
+  AddAllocation(&profiler, "ArenaRw", kTfLiteArenaRw, 100);
+  AddAllocation(&profiler, "ArenaRwPersistent", kTfLiteArenaRwPersistent, 50);
+
+  EXPECT_EQ(profiler.events().size(), 1);
+  EXPECT_EQ(profiler.num_dropped_events(), 1);
+  EXPECT_EQ(profiler.total_bytes(), 150);
+  EXPECT_EQ(profiler.peak_event_index(), -1);
+
+  profiler.Reset();
+  EXPECT_TRUE(profiler.events().empty());
+  EXPECT_EQ(profiler.total_bytes(), 150);
+}
+
+}  // namespace
+}  // namespace profiling
+}  // namespace tflite
@@ -0,0 +1,157 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "profiling/memory_timeline_summarizer.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "profiling/summarizer_util.h"
+
+namespace tflite {
+namespace profiling {
+namespace {
+
+constexpr char kNoOperator[] = "(none)";
+
+std::string FormatKb(int64_t bytes) { return FormatDouble(bytes / 1024.0, 3); }
+
+}  // namespace
+
+void MemoryTimelineSummarizer::ProcessEvents(
+    const std::vector<MemoryTimelineEvent>& events,
+    const tflite::Interpreter* interpreter) {
+  events_ = events;
+  op_names_.clear();
+  std::map<std::pair<int64_t, int64_t>, OpMemoryUsage> usages;
+  for (const MemoryTimelineEvent& event : events_) {
+    // The events attributed to no operator are summed up together.
+    const int64_t subgraph_index =
+        event.node_index < 0 ? -1 : event.subgraph_index;
+    OpMemoryUsage& usage = usages[{subgraph_index, event.node_index}];
+    if (usage.num_events == 0) {
+      usage.subgraph_index = subgraph_index;
+      usage.node_index = event.node_index;
+      usage.op_name =
+          event.node_index < 0
+              ? kNoOperator
+              : GetOpName(interpreter, event.subgraph_index, event.node_index);
+    }
+    usage.bytes[static_cast<int>(event.kind)] += event.bytes;
+    usage.total_bytes += event.bytes;
+    usage.num_events++;
+    op_names_.push_back(event.node_index < 0 ? "" : usage.op_name);
+  }
+
+  op_memory_usages_.clear();
+  for (auto& op_and_usage : usages) {
+    op_memory_usages_.push_back(std::move(op_and_usage.second));
+  }
+  std::stable_sort(op_memory_usages_.begin(), op_memory_usages_.end(),
+                   [](const OpMemoryUsage& a, const OpMemoryUsage& b) {
+                     return a.total_bytes > b.total_bytes;
+                   });
+}
+
+int64_t MemoryTimelineSummarizer::GetPeakBytes() const {
+  int64_t peak_bytes = 0;
+  for (const MemoryTimelineEvent& event : events_) {
+    peak_bytes = std::max(peak_bytes, event.total_bytes);
+  }
+  return peak_bytes;
+}
+
+std::string MemoryTimelineSummarizer::GetOutputString(
+    int max_num_ops, int max_num_events) const {
+  constexpr int kColumnWidth = 12;
+  std::stringstream stream;
+  stream << "============================== Memory by operator "
+            "=============================="
+         << std::endl;
+  std::vector<std::string> header = {"[node type]"};
+  for (int kind = 0; kind < MemoryTimelineEvent::kNumKinds; ++kind) {
+    header.push_back(
+        std::string("[") +
+        GetMemoryKindName(static_cast<MemoryTimelineEvent::Kind>(kind)) +
+        " KB]");
+  }
+  header.insert(header.end(), {"[total KB]", "[subgraph]", "[node]"});
+  WriteRow(header, kColumnWidth, &stream);
+  const int num_ops =
+      std::min<int>(max_num_ops, static_cast<int>(op_memory_usages_.size()));
+  for (int i = 0; i < num_ops; ++i) {
+    const OpMemoryUsage& usage = op_memory_usages_[i];
+    std::vector<std::string> row = {usage.op_name};
+    for (int64_t bytes : usage.bytes) row.push_back(FormatKb(bytes));
+    row.push_back(FormatKb(usage.total_bytes));
+    if (usage.node_index < 0) {
+      row.insert(row.end(), {"", ""});
+    } else {
+      row.insert(row.end(), {std::to_string(usage.subgraph_index),
+                             std::to_string(usage.node_index)});
+    }
+    WriteRow(row, kColumnWidth, &stream);
+  }
+
+  stream << std::endl
+         << "============================== Memory timeline "
+            "=============================="
+         << std::endl;
+  WriteRow({"[ms]", "[change KB]", "[total KB]", "[kind]", "[phase]",
+            "[node type]", "[subgraph]", "[node]", "[tensor]"},
+           kColumnWidth, &stream);
+  const int num_events =
+      std::min<int>(max_num_events, static_cast<int>(events_.size()));
+  const uint64_t start_us = events_.empty() ? 0 : events_[0].timestamp_us;
+  for (int i = 0; i < num_events; ++i) {
+    const MemoryTimelineEvent& event = events_[i];
+    WriteRow({FormatDouble((event.timestamp_us - start_us) * 1e-3, 3),
+              FormatKb(event.bytes), FormatKb(event.total_bytes),
+              GetMemoryKindName(event.kind), GetMemoryPhaseName(event.phase),
+              op_names_[i], std::to_string(event.subgraph_index),
+              event.node_index < 0 ? "" : std::to_string(event.node_index),
+              event.tag},
+             kColumnWidth, &stream);
+  }
+  if (num_events < static_cast<int>(events_.size())) {
+    stream << "... " << events_.size() - num_events << " more events."
+           << std::endl;
+  }
+  stream << "Peak: " << FormatKb(GetPeakBytes()) << " KB" << std::endl;
+  return stream.str();
+}
+
+std::string MemoryTimelineSummarizer::GetCsvString() const {
+  std::stringstream stream;
+  stream << "\"timestamp_us\",\"bytes\",\"total_bytes\",\"kind\",\"phase\","
+            "\"node type\",\"subgraph\",\"node\",\"tensor index\",\"tensor\""
+         << std::endl;
+  for (size_t i = 0; i < events_.size(); ++i) {
+    const MemoryTimelineEvent& event = events_[i];
+    stream << event.timestamp_us << "," << event.bytes << ","
+           << event.total_bytes << "," << GetMemoryKindName(event.kind) << ","
+           << GetMemoryPhaseName(event.phase) << ",\"" << op_names_[i]
+           << "\"," << event.subgraph_index << "," << event.node_index << ","
+           << event.tensor_index << ",\"" << event.tag << "\"" << std::endl;
+  }
+  return stream.str();
+}
+
+}  // namespace profiling
+}  // namespace tflite
@@ -0,0 +1,80 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_LITE_PROFILING_MEMORY_TIMELINE_SUMMARIZER_H_
+#define TENSORFLOW_LITE_PROFILING_MEMORY_TIMELINE_SUMMARIZER_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "core/interpreter.h"
+#include "profiling/memory_timeline_profiler.h"
+
+namespace tflite {
+namespace profiling {
+
+// The memory held by one operator, i.e. the sum of the bytes of the events
+// attributed to it.
+struct OpMemoryUsage {
+  int64_t subgraph_index = -1;
+  // -1 for the events attributed to no operator.
+  int64_t node_index = -1;
+  // The builtin code or custom name of the operator, e.g. "CONV_2D".
+  std::string op_name;
+  // The bytes of each MemoryTimelineEvent::Kind.
+  int64_t bytes[MemoryTimelineEvent::kNumKinds] = {};
+  int64_t total_bytes = 0;
+  int num_events = 0;
+};
+
+// Summarizes the timeline of a MemoryTimelineProfiler: the memory held by
+// each operator, and the events w/ the total memory held after each of them.
+class MemoryTimelineSummarizer {
+ public:
+  // Processes 'events' in the order they happened. 'interpreter' resolves the
+  // names of the operators, and may be null.
+  void ProcessEvents(const std::vector<MemoryTimelineEvent>& events,
+                     const tflite::Interpreter* interpreter);
+
+  // The memory held by each operator, most memory first.
+  const std::vector<OpMemoryUsage>& op_memory_usages() const {
+    return op_memory_usages_;
+  }
+
+  // Returns the highest total memory held, or 0 w/o events.
+  int64_t GetPeakBytes() const;
+
+  bool HasProfiles() const { return !events_.empty(); }
+
+  // Returns a table of the 'max_num_ops' operators holding the most memory,
+  // followed by the first 'max_num_events' events of the timeline and the
+  // peak.
+  std::string GetOutputString(int max_num_ops = 10,
+                              int max_num_events = 50) const;
+
+  // Returns the whole timeline as CSV, one line per event.
+  std::string GetCsvString() const;
+
+ private:
+  std::vector<MemoryTimelineEvent> events_;
+  // The name of the operator of each event, or empty.
+  std::vector<std::string> op_names_;
+  std::vector<OpMemoryUsage> op_memory_usages_;
+};
+
+}  // namespace profiling
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_PROFILING_MEMORY_TIMELINE_SUMMARIZER_H_
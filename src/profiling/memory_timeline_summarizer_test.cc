@@ -0,0 +1,103 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "profiling/memory_timeline_summarizer.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+namespace tflite {
+namespace profiling {
+namespace {
+
+using ::testing::HasSubstr;
+using Kind = MemoryTimelineEvent::Kind;
+
+class MemoryTimelineSummarizerTest : public ::testing::Test {
+ protected:
+  void AddEvent(Kind kind, int64_t bytes, int64_t node_index,
+                const std::string& tag = "") {
+    MemoryTimelineEvent event;
+    event.timestamp_us = 1000 * events_.size();
+    event.kind = kind;
+    event.bytes = bytes;
+    total_bytes_ += bytes;
+    event.total_bytes = total_bytes_;
+    event.subgraph_index = 0;
+    event.node_index = node_index;
+    event.tag = tag;
+    events_.push_back(event);
+  }
+
+  std::vector<MemoryTimelineEvent> events_;
+  int64_t total_bytes_ = 0;
+};
+
+TEST_F(MemoryTimelineSummarizerTest, SumsMemoryPerOperator) {
+  AddEvent(Kind::kArena, 4096, /*node_index=*/1, "ArenaRw");
+  AddEvent(Kind::kPersistentArena, 256, /*node_index=*/-1,
+           "ArenaRwPersistent");
+  AddEvent(Kind::kUntrackedHeap, 1024, /*node_index=*/0);
+  AddEvent(Kind::kDynamicTensor, 2048, /*node_index=*/0, "output");
+  AddEvent(Kind::kDynamicTensor, -2048, /*node_index=*/2, "output");
+
+  MemoryTimelineSummarizer summarizer;
+  summarizer.ProcessEvents(events_, /*interpreter=*/nullptr);
+
+  const std::vector<OpMemoryUsage>& usages = summarizer.op_memory_usages();
+  ASSERT_EQ(usages.size(), 4);
+  EXPECT_EQ(usages[0].node_index, 1);
+  EXPECT_EQ(usages[0].total_bytes, 4096);
+  EXPECT_EQ(usages[1].node_index, 0);
+  EXPECT_EQ(usages[1].total_bytes, 3072);
+  EXPECT_EQ(usages[1].bytes[static_cast<int>(Kind::kUntrackedHeap)], 1024);
+  EXPECT_EQ(usages[1].bytes[static_cast<int>(Kind::kDynamicTensor)], 2048);
+  EXPECT_EQ(usages[1].num_events, 2);
+  EXPECT_EQ(usages[1].op_name, "Unknown");
+  EXPECT_EQ(usages[2].node_index, -1);
+  EXPECT_EQ(usages[2].op_name, "(none)");
+  EXPECT_EQ(usages[3].total_bytes, -2048);
+  EXPECT_EQ(summarizer.GetPeakBytes(), 4096 + 256 + 1024 + 2048);
+}
+
+TEST_F(MemoryTimelineSummarizerTest, OutputsTablesAndCsv) {
+  AddEvent(Kind::kArena, 4096, /*node_index=*/1, "ArenaRw");
+  AddEvent(Kind::kDynamicTensor, 2048, /*node_index=*/0, "output");
+  AddEvent(Kind::kDynamicTensor, -2048, /*node_index=*/0, "output");
+
+  MemoryTimelineSummarizer summarizer;
+  EXPECT_FALSE(summarizer.HasProfiles());
+  summarizer.ProcessEvents(events_, /*interpreter=*/nullptr);
+  EXPECT_TRUE(summarizer.HasProfiles());
+
+  const std::string output =
+      summarizer.GetOutputString(/*max_num_ops=*/10, /*max_num_events=*/2);
+  EXPECT_THAT(output, HasSubstr("Memory by operator"));
+  EXPECT_THAT(output, HasSubstr("Memory timeline"));
+  EXPECT_THAT(output, HasSubstr("... 1 more events."));
+  EXPECT_THAT(output, HasSubstr("Peak: 6.000 KB"));
+
+  const std::string csv = summarizer.GetCsvString();
+  EXPECT_THAT(csv, HasSubstr("\"timestamp_us\""));
+  EXPECT_THAT(csv, HasSubstr("1000,2048,6144,dynamic,,\"Unknown\",0,0,-1,"
+                             "\"output\""));
+}
+
+}  // namespace
+}  // namespace profiling
+}  // namespace tflite
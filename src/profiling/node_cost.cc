@@ -0,0 +1,170 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "profiling/node_cost.h"
+
+#include <cstdint>
+
+#include "core/c/builtin_op_data.h"
+#include "core/c/common.h"
+#include "delegates/gpu/common/flops_util.h"
+#include "delegates/gpu/common/shape.h"
+
+namespace tflite {
+namespace profiling {
+namespace {
+
+uint64_t NumElements(const TfLiteTensor& tensor) {
+  uint64_t num_elements = 1;
+  for (int i = 0; i < tensor.dims->size; ++i) {
+    num_elements *= tensor.dims->data[i];
+  }
+  return num_elements;
+}
+
+int Dim(const TfLiteTensor& tensor, int index) {
+  return index < tensor.dims->size ? tensor.dims->data[index] : 1;
+}
+
+// Returns the tensor at 'index' in 'tensors' if it exists and has a shape.
+const TfLiteTensor* GetTensor(const Subgraph& subgraph,
+                              const TfLiteIntArray* tensors, int index) {
+  if (index >= tensors->size || tensors->data[index] == kTfLiteOptionalTensor) {
+    return nullptr;
+  }
+  const TfLiteTensor* tensor = subgraph.tensor(tensors->data[index]);
+  return tensor == nullptr || tensor->dims == nullptr ? nullptr : tensor;
+}
+
+// Views a 4D tensor as BHWC.
+gpu::BHWC GetBHWC(const TfLiteTensor& tensor) {
+  return gpu::BHWC(Dim(tensor, 0), Dim(tensor, 1), Dim(tensor, 2),
+                   Dim(tensor, 3));
+}
+
+// Views a [O, H, W, I] filter as OHWI.
+gpu::OHWI GetOHWI(const TfLiteTensor& tensor) {
+  return gpu::OHWI(Dim(tensor, 0), Dim(tensor, 1), Dim(tensor, 2),
+                   Dim(tensor, 3));
+}
+
+uint64_t EstimateFlops(const Subgraph& subgraph, const TfLiteNode& node,
+                       const TfLiteRegistration& registration) {
+  const TfLiteTensor* output = GetTensor(subgraph, node.outputs, 0);
+  if (output == nullptr) return 0;
+  switch (registration.builtin_code) {
+    case kTfLiteBuiltinConv2d: {
+      const TfLiteTensor* filter = GetTensor(subgraph, node.inputs, 1);
+      if (filter == nullptr || filter->dims->size != 4) return 0;
+      return gpu::GetConvolutionFlops(GetBHWC(*output), GetOHWI(*filter));
+    }
+    case kTfLiteBuiltinDepthwiseConv2d: {
+      // The filter is [1, H, W, O].
+      const TfLiteTensor* filter = GetTensor(subgraph, node.inputs, 1);
+      if (filter == nullptr || filter->dims->size != 4) return 0;
+      return gpu::GetDepthwiseConvolutionFlops(
+          GetBHWC(*output),
+          gpu::OHWI(Dim(*filter, 3), Dim(*filter, 1), Dim(*filter, 2), 1));
+    }
+    case kTfLiteBuiltinTransposeConv: {
+      // The inputs are the output shape, the filter and the input.
+      const TfLiteTensor* filter = GetTensor(subgraph, node.inputs, 1);
+      const TfLiteTensor* input = GetTensor(subgraph, node.inputs, 2);
+      if (filter == nullptr || filter->dims->size != 4 || input == nullptr) {
+        return 0;
+      }
+      return gpu::GetConvolutionTransposedFlops(GetBHWC(*input),
+                                                GetOHWI(*filter));
+    }
+    case kTfLiteBuiltinFullyConnected: {
+      // The weights are [O, I], and all the output dimensions but the last
+      // are batches.
+      const TfLiteTensor* weights = GetTensor(subgraph, node.inputs, 1);
+      if (weights == nullptr || weights->dims->size != 2) return 0;
+      const int output_depth = Dim(*weights, 0);
+      if (output_depth == 0) return 0;
+      const int batches = static_cast<int>(NumElements(*output) / output_depth);
+      return gpu::GetFullyConnectedFlops(
+          gpu::BHWC(batches, 1, 1, output_depth),
+          gpu::OHWI(output_depth, 1, 1, Dim(*weights, 1)));
+    }
+    case kTfLiteBuiltinBatchMatmul: {
+      const TfLiteTensor* lhs = GetTensor(subgraph, node.inputs, 0);
+      if (lhs == nullptr || lhs->dims->size < 2) return 0;
+      const auto* params =
+          static_cast<const TfLiteBatchMatMulParams*>(node.builtin_data);
+      const bool adj_x = params != nullptr && params->adj_x;
+      const int depth = Dim(*lhs, lhs->dims->size - (adj_x ? 2 : 1));
+      // 2 flops per operation( s = a * b + s);
+      return NumElements(*output) * depth * 2;
+    }
+    case kTfLiteBuiltinAveragePool2d:
+    case kTfLiteBuiltinMaxPool2d: {
+      const auto* params =
+          static_cast<const TfLitePoolParams*>(node.builtin_data);
+      if (params == nullptr) return 0;
+      return NumElements(*output) * params->filter_height *
+             params->filter_width;
+    }
+    case kTfLiteBuiltinAdd:
+    case kTfLiteBuiltinSub:
+    case kTfLiteBuiltinMul:
+    case kTfLiteBuiltinDiv:
+    case kTfLiteBuiltinSquaredDifference:
+    case kTfLiteBuiltinMaximum:
+    case kTfLiteBuiltinMinimum:
+    case kTfLiteBuiltinRelu:
+    case kTfLiteBuiltinRelu6:
+    case kTfLiteBuiltinReluN1To1:
+    case kTfLiteBuiltinLeakyRelu:
+    case kTfLiteBuiltinPrelu:
+    case kTfLiteBuiltinHardSwish:
+    case kTfLiteBuiltinLogistic:
+    case kTfLiteBuiltinTanh:
+    case kTfLiteBuiltinExp:
+    case kTfLiteBuiltinSqrt:
+    case kTfLiteBuiltinRsqrt:
+    case kTfLiteBuiltinAbs:
+    case kTfLiteBuiltinNeg:
+      return NumElements(*output);
+    default:
+      return 0;
+  }
+}
+
+uint64_t SumBytes(const Subgraph& subgraph, const TfLiteIntArray* tensors) {
+  uint64_t bytes = 0;
+  for (int i = 0; i < tensors->size; ++i) {
+    const TfLiteTensor* tensor = GetTensor(subgraph, tensors, i);
+    if (tensor != nullptr) bytes += tensor->bytes;
+  }
+  return bytes;
+}
+
+}  // namespace
+
+NodeCost EstimateNodeCost(const Subgraph& subgraph, int node_index) {
+  NodeCost cost;
+  const auto* node_and_registration =
+      subgraph.node_and_registration(node_index);
+  if (node_and_registration == nullptr) return cost;
+  const TfLiteNode& node = node_and_registration->first;
+  cost.flops = EstimateFlops(subgraph, node, node_and_registration->second);
+  cost.bytes =
+      SumBytes(subgraph, node.inputs) + SumBytes(subgraph, node.outputs);
+  return cost;
+}
+
+}  // namespace profiling
+}  // namespace tflite
@@ -0,0 +1,46 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_LITE_PROFILING_NODE_COST_H_
+#define TENSORFLOW_LITE_PROFILING_NODE_COST_H_
+
+#include <cstdint>
+
+#include "core/subgraph.h"
+
+namespace tflite {
+namespace profiling {
+
+// The arithmetic work and the memory traffic of one execution of a node.
+struct NodeCost {
+  // The number of arithmetic operations, a multiply-accumulate counting as 2
+  // whatever the data type.
+  uint64_t flops = 0;
+  // The bytes of the inputs and outputs, assuming each of them is moved once
+  // between memory and the core.
+  uint64_t bytes = 0;
+};
+
+// Estimates the cost of node 'node_index' of 'subgraph' from the current shapes
+// of its tensors. Convolutions and fully connected layers use the FLOP models
+// of the GPU delegate, batch matrix multiplications and pooling count their
+// multiply-accumulates and comparisons, and common elementwise ops count one
+// operation per output element. Other ops count no operation, i.e. they are
+// treated as pure data movement.
+NodeCost EstimateNodeCost(const Subgraph& subgraph, int node_index);
+
+}  // namespace profiling
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_PROFILING_NODE_COST_H_
@@ -0,0 +1,103 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "profiling/node_cost.h"
+
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "core/c/builtin_op_data.h"
+#include "core/c/common.h"
+#include "core/interpreter.h"
+
+namespace tflite {
+namespace profiling {
+
+namespace {
+
+// Adds float tensors of the given shapes to 'interpreter'.
+void AddFloatTensors(Interpreter* interpreter,
+                     const std::vector<std::vector<int>>& shapes) {
+  int first_tensor_index;
+  ASSERT_EQ(interpreter->AddTensors(shapes.size(), &first_tensor_index),
+            kTfLiteOk);
+  for (size_t i = 0; i < shapes.size(); ++i) {
+    ASSERT_EQ(interpreter->SetTensorParametersReadWrite(
+                  first_tensor_index + i, kTfLiteFloat32, "", shapes[i],
+                  TfLiteQuantization()),
+              kTfLiteOk);
+  }
+}
+
+TfLiteRegistration GetRegistration(int32_t builtin_code) {
+  TfLiteRegistration registration = {};
+  registration.builtin_code = builtin_code;
+  return registration;
+}
+
+TEST(NodeCostTest, Conv2d) {
+  Interpreter interpreter;
+  // The input, filter, bias and output.
+  AddFloatTensors(&interpreter,
+                  {{1, 8, 8, 4}, {16, 3, 3, 4}, {16}, {1, 8, 8, 16}});
+  const TfLiteRegistration registration =
+      GetRegistration(kTfLiteBuiltinConv2d);
+  ASSERT_EQ(interpreter.AddNodeWithParameters({0, 1, 2}, {3}, nullptr, 0,
+                                              nullptr, &registration),
+            kTfLiteOk);
+
+  const NodeCost cost =
+      EstimateNodeCost(interpreter.primary_subgraph(), /*node_index=*/0);
+  // 2 flops for each of the 3x3x4 multiply-accumulates of an output.
+  EXPECT_EQ(cost.flops, 8 * 8 * 16 * 3 * 3 * 4 * 2);
+  EXPECT_EQ(cost.bytes, (8 * 8 * 4 + 16 * 3 * 3 * 4 + 16 + 8 * 8 * 16) * 4);
+}
+
+TEST(NodeCostTest, SkipsOptionalTensors) {
+  Interpreter interpreter;
+  // The input, weights and output of a fully connected layer without bias.
+  AddFloatTensors(&interpreter, {{2, 3, 8}, {4, 8}, {2, 3, 4}});
+  const TfLiteRegistration registration =
+      GetRegistration(kTfLiteBuiltinFullyConnected);
+  ASSERT_EQ(
+      interpreter.AddNodeWithParameters({0, 1, kTfLiteOptionalTensor}, {2},
+                                        nullptr, 0, nullptr, &registration),
+      kTfLiteOk);
+
+  const NodeCost cost =
+      EstimateNodeCost(interpreter.primary_subgraph(), /*node_index=*/0);
+  EXPECT_EQ(cost.flops, 6 * 4 * 8 * 2);
+  EXPECT_EQ(cost.bytes, (2 * 3 * 8 + 4 * 8 + 2 * 3 * 4) * 4);
+}
+
+TEST(NodeCostTest, OpsWithoutFlopModelOnlyMoveData) {
+  Interpreter interpreter;
+  AddFloatTensors(&interpreter, {{2, 3}, {3, 2}});
+  const TfLiteRegistration registration =
+      GetRegistration(kTfLiteBuiltinTranspose);
+  ASSERT_EQ(interpreter.AddNodeWithParameters({0}, {1}, nullptr, 0, nullptr,
+                                              &registration),
+            kTfLiteOk);
+
+  const NodeCost cost =
+      EstimateNodeCost(interpreter.primary_subgraph(), /*node_index=*/0);
+  EXPECT_EQ(cost.flops, 0);
+  EXPECT_EQ(cost.bytes, 2 * 6 * 4);
+
+  EXPECT_EQ(EstimateNodeCost(interpreter.primary_subgraph(), 1).bytes, 0);
+}
+
+}  // namespace
+}  // namespace profiling
+}  // namespace tflite
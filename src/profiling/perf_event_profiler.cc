@@ -0,0 +1,209 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "profiling/perf_event_profiler.h"
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "minimal_logging.h"
+#include "profiling/time.h"
+
+namespace tflite {
+namespace profiling {
+namespace {
+
+bool IsOperatorEvent(Profiler::EventType event_type) {
+  return event_type == Profiler::EventType::OPERATOR_INVOKE_EVENT ||
+         event_type == Profiler::EventType::DELEGATE_OPERATOR_INVOKE_EVENT ||
+         event_type ==
+             Profiler::EventType::DELEGATE_PROFILED_OPERATOR_INVOKE_EVENT;
+}
+
+#if defined(__linux__)
+// Opens a user space only counter of the calling thread in the group of
+// 'group_fd', or as a new, disabled group leader if 'group_fd' is -1.
+int OpenCounter(uint32_t type, uint64_t config, int group_fd) {
+  struct perf_event_attr attr;
+  std::memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = type;
+  attr.config = config;
+  attr.disabled = group_fd == -1 ? 1 : 0;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  attr.read_format = PERF_FORMAT_GROUP;
+  return static_cast<int>(syscall(__NR_perf_event_open, &attr, /*pid=*/0,
+                                  /*cpu=*/-1, group_fd, /*flags=*/0));
+}
+#endif  // defined(__linux__)
+
+}  // namespace
+
+PerfEventProfiler::PerfEventProfiler(uint32_t max_num_entries)
+    : max_num_entries_(max_num_entries) {
+  for (int& index : read_index_) {
+    index = -1;
+  }
+  events_.reserve(max_num_entries);
+  begin_counters_.reserve(max_num_entries);
+#if defined(__linux__)
+  struct CounterConfig {
+    HardwareCounters::Counter counter;
+    uint32_t type;
+    uint64_t config;
+  };
+  const CounterConfig kCounterConfigs[] = {
+      {HardwareCounters::kCycles, PERF_TYPE_HARDWARE,
+       PERF_COUNT_HW_CPU_CYCLES},
+      {HardwareCounters::kInstructions, PERF_TYPE_HARDWARE,
+       PERF_COUNT_HW_INSTRUCTIONS},
+      {HardwareCounters::kLlcMisses, PERF_TYPE_HW_CACHE,
+       PERF_COUNT_HW_CACHE_LL | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+           (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+      {HardwareCounters::kBranchMisses, PERF_TYPE_HARDWARE,
+       PERF_COUNT_HW_BRANCH_MISSES},
+      {HardwareCounters::kBackendStallCycles, PERF_TYPE_HARDWARE,
+       PERF_COUNT_HW_STALLED_CYCLES_BACKEND},
+  };
+  // All counters are read at once as a group. Counters that can't be opened
+  // are skipped, the first one that can becomes the group leader.
+  for (const CounterConfig& config : kCounterConfigs) {
+    const int fd = OpenCounter(config.type, config.config, group_fd_);
+    if (fd < 0) continue;
+    if (group_fd_ < 0) group_fd_ = fd;
+    read_index_[config.counter] = static_cast<int>(counter_fds_.size());
+    counter_fds_.push_back(fd);
+  }
+  if (group_fd_ < 0) {
+    TFLITE_LOG_PROD(TFLITE_LOG_WARNING,
+                    "No hardware performance counter is available.");
+  }
+#endif  // defined(__linux__)
+}
+
+PerfEventProfiler::~PerfEventProfiler() {
+#if defined(__linux__)
+  // Closing the leader last keeps the group valid while members are removed.
+  for (auto it = counter_fds_.rbegin(); it != counter_fds_.rend(); ++it) {
+    close(*it);
+  }
+#endif  // defined(__linux__)
+}
+
+void PerfEventProfiler::StartProfiling() {
+  enabled_ = true;
+#if defined(__linux__)
+  if (group_fd_ >= 0) {
+    ioctl(group_fd_, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+  }
+#endif  // defined(__linux__)
+}
+
+void PerfEventProfiler::StopProfiling() {
+  enabled_ = false;
+#if defined(__linux__)
+  if (group_fd_ >= 0) {
+    ioctl(group_fd_, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+  }
+#endif  // defined(__linux__)
+}
+
+void PerfEventProfiler::Reset() {
+  events_.clear();
+  begin_counters_.clear();
+}
+
+uint32_t PerfEventProfiler::BeginEvent(const char* tag, EventType event_type,
+                                       int64_t event_metadata1,
+                                       int64_t event_metadata2) {
+  if (!enabled_ || !IsOperatorEvent(event_type)) {
+    return kInvalidEventHandle;
+  }
+  if (events_.size() >= max_num_entries_) {
+    TFLITE_LOG_PROD_ONCE(TFLITE_LOG_INFO,
+                         "Warning: Dropping PerfEventProfiler event.");
+    return kInvalidEventHandle;
+  }
+  const uint32_t handle = static_cast<uint32_t>(events_.size());
+  events_.emplace_back();
+  ProfileEvent& event = events_.back();
+  event.tag = tag;
+  event.event_type = event_type;
+  event.event_metadata = event_metadata1;
+  event.extra_event_metadata = event_metadata2;
+  event.elapsed_time = 0;
+  begin_counters_.emplace_back();
+  // Read the counters last so that they count as little of the profiler as
+  // possible.
+  event.begin_timestamp_us = time::NowMicros();
+  ReadCounters(&begin_counters_.back());
+  return handle;
+}
+
+void PerfEventProfiler::EndEvent(uint32_t event_handle) {
+  if (event_handle >= events_.size()) {
+    return;
+  }
+  HardwareCounters end_counters;
+  ReadCounters(&end_counters);
+  ProfileEvent& event = events_[event_handle];
+  event.elapsed_time = time::NowMicros() - event.begin_timestamp_us;
+  const HardwareCounters& begin_counters = begin_counters_[event_handle];
+  for (int i = 0; i < HardwareCounters::kNumCounters; ++i) {
+    if (begin_counters.values[i] >= 0 && end_counters.values[i] >= 0) {
+      event.hw_counters.values[i] =
+          end_counters.values[i] - begin_counters.values[i];
+    }
+  }
+}
+
+std::vector<const ProfileEvent*> PerfEventProfiler::GetProfileEvents() const {
+  std::vector<const ProfileEvent*> profile_events;
+  profile_events.reserve(events_.size());
+  for (const ProfileEvent& event : events_) {
+    profile_events.push_back(&event);
+  }
+  return profile_events;
+}
+
+void PerfEventProfiler::ReadCounters(HardwareCounters* counters) const {
+#if defined(__linux__)
+  if (group_fd_ < 0) return;
+  // With PERF_FORMAT_GROUP, the read returns the number of counters followed
+  // by their values in the order they were added to the group.
+  uint64_t data[1 + HardwareCounters::kNumCounters];
+  const ssize_t size = read(group_fd_, data, sizeof(data));
+  if (size < static_cast<ssize_t>(sizeof(uint64_t)) ||
+      size < static_cast<ssize_t>(sizeof(uint64_t) * (1 + data[0]))) {
+    return;
+  }
+  for (int i = 0; i < HardwareCounters::kNumCounters; ++i) {
+    if (read_index_[i] >= 0) {
+      counters->values[i] = static_cast<int64_t>(data[1 + read_index_[i]]);
+    }
+  }
+#endif  // defined(__linux__)
+}
+
+}  // namespace profiling
+}  // namespace tflite
@@ -0,0 +1,86 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_LITE_PROFILING_PERF_EVENT_PROFILER_H_
+#define TENSORFLOW_LITE_PROFILING_PERF_EVENT_PROFILER_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "core/api/profiler.h"
+#include "profiling/profile_buffer.h"
+
+namespace tflite {
+namespace profiling {
+
+// Records the hardware performance counters (cycles, instructions, last level
+// cache misses, branch misses and backend stall cycles) of each operator
+// invoke event, using Linux perf_event_open(2).
+//
+// The counters count the user space work of the thread that created the
+// profiler, so the profiler must be created on the thread invoking the
+// interpreter, and work done by intra-op thread pool threads isn't counted.
+// Counters the CPU or the kernel doesn't provide (e.g. in VMs, or with
+// kernel.perf_event_paranoid > 2) are left at -1 in the recorded events; on
+// other platforms than Linux no counter is ever recorded.
+//
+// It's meant to be added next to a BufferedProfiler through
+// Interpreter::AddProfiler, with its events passed to
+// ProfileSummarizer::ProcessHardwareCounters.
+//
+// This class is *not thread safe*.
+class PerfEventProfiler : public tflite::Profiler {
+ public:
+  explicit PerfEventProfiler(uint32_t max_num_entries);
+  ~PerfEventProfiler() override;
+
+  PerfEventProfiler(const PerfEventProfiler&) = delete;
+  PerfEventProfiler& operator=(const PerfEventProfiler&) = delete;
+
+  uint32_t BeginEvent(const char* tag, EventType event_type,
+                      int64_t event_metadata1,
+                      int64_t event_metadata2) override;
+
+  void EndEvent(uint32_t event_handle) override;
+
+  // Returns true if at least one hardware counter could be opened.
+  bool HasCounters() const { return group_fd_ >= 0; }
+
+  void StartProfiling();
+  void StopProfiling();
+  void Reset();
+
+  std::vector<const ProfileEvent*> GetProfileEvents() const;
+
+ private:
+  // Reads the current values of the counters into 'counters'.
+  void ReadCounters(HardwareCounters* counters) const;
+
+  const uint32_t max_num_entries_;
+  bool enabled_ = false;
+  // The group leader, or -1 if no counter could be opened.
+  int group_fd_ = -1;
+  std::vector<int> counter_fds_;
+  // The position of each HardwareCounters::Counter in the group read, or -1
+  // if the counter couldn't be opened.
+  int read_index_[HardwareCounters::kNumCounters];
+  std::vector<ProfileEvent> events_;
+  // The counter values at the beginning of each event in 'events_'.
+  std::vector<HardwareCounters> begin_counters_;
+};
+
+}  // namespace profiling
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_PROFILING_PERF_EVENT_PROFILER_H_
@@ -0,0 +1,107 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "profiling/perf_event_profiler.h"
+
+#include <cstdint>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "core/api/profiler.h"
+
+namespace tflite {
+namespace profiling {
+
+namespace {
+
+using EventType = Profiler::EventType;
+
+// Keeps the CPU busy for a while.
+int64_t Spin() {
+  volatile int64_t sum = 0;
+  for (int64_t i = 0; i < 1000000; ++i) {
+    sum = sum + i;
+  }
+  return sum;
+}
+
+TEST(PerfEventProfilerTest, RecordsOnlyOperatorEventsWhileProfiling) {
+  PerfEventProfiler profiler(/*max_num_entries=*/16);
+  EXPECT_EQ(profiler.BeginEvent("op", EventType::OPERATOR_INVOKE_EVENT, 0, 0),
+            kInvalidEventHandle);
+
+  profiler.StartProfiling();
+  EXPECT_EQ(profiler.BeginEvent("Invoke", EventType::DEFAULT, 0, 0),
+            kInvalidEventHandle);
+  const uint32_t handle =
+      profiler.BeginEvent("op", EventType::OPERATOR_INVOKE_EVENT, 3, 1);
+  Spin();
+  profiler.EndEvent(handle);
+  profiler.StopProfiling();
+
+  std::vector<const ProfileEvent*> events = profiler.GetProfileEvents();
+  ASSERT_EQ(events.size(), 1);
+  EXPECT_STREQ(events[0]->tag.c_str(), "op");
+  EXPECT_EQ(events[0]->event_type, EventType::OPERATOR_INVOKE_EVENT);
+  EXPECT_EQ(events[0]->event_metadata, 3);
+  EXPECT_EQ(events[0]->extra_event_metadata, 1);
+  EXPECT_EQ(events[0]->hw_counters.HasValues(), profiler.HasCounters());
+
+  profiler.Reset();
+  EXPECT_TRUE(profiler.GetProfileEvents().empty());
+}
+
+TEST(PerfEventProfilerTest, CountsNestedEvents) {
+  PerfEventProfiler profiler(/*max_num_entries=*/16);
+  if (!profiler.HasCounters()) {
+    GTEST_SKIP() << "Hardware performance counters are not available.";
+  }
+  profiler.StartProfiling();
+  const uint32_t outer = profiler.BeginEvent(
+      "delegate", EventType::DELEGATE_PROFILED_OPERATOR_INVOKE_EVENT, 0, 0);
+  const uint32_t inner = profiler.BeginEvent(
+      "op", EventType::DELEGATE_OPERATOR_INVOKE_EVENT, 0, 0);
+  Spin();
+  profiler.EndEvent(inner);
+  Spin();
+  profiler.EndEvent(outer);
+  profiler.StopProfiling();
+
+  std::vector<const ProfileEvent*> events = profiler.GetProfileEvents();
+  ASSERT_EQ(events.size(), 2);
+  for (int i = 0; i < HardwareCounters::kNumCounters; ++i) {
+    if (events[0]->hw_counters.values[i] >= 0) {
+      EXPECT_GE(events[0]->hw_counters.values[i],
+                events[1]->hw_counters.values[i]);
+    }
+  }
+}
+
+TEST(PerfEventProfilerTest, DropsEventsWhenFull) {
+  PerfEventProfiler profiler(/*max_num_entries=*/1);
+  profiler.StartProfiling();
+  const uint32_t first =
+      profiler.BeginEvent("op", EventType::OPERATOR_INVOKE_EVENT, 0, 0);
+  profiler.EndEvent(first);
+  EXPECT_EQ(profiler.BeginEvent("op", EventType::OPERATOR_INVOKE_EVENT, 1, 0),
+            kInvalidEventHandle);
+  profiler.StopProfiling();
+
+  EXPECT_EQ(profiler.GetProfileEvents().size(), 1);
+}
+
+}  // namespace
+}  // namespace profiling
+}  // namespace tflite
@@ -31,6 +31,29 @@ namespace profiling {
 
 constexpr uint32_t kInvalidEventHandle = static_cast<uint32_t>(~0) - 1;
 
+// Hardware performance counter values of an event, see PerfEventProfiler.
+struct HardwareCounters {
+  enum Counter {
+    kCycles = 0,
+    kInstructions,
+    kLlcMisses,
+    kBranchMisses,
+    kBackendStallCycles,
+    kNumCounters
+  };
+
+  // Returns true if any counter was recorded.
+  bool HasValues() const {
+    for (int64_t value : values) {
+      if (value >= 0) return true;
+    }
+    return false;
+  }
+
+  // Counter values indexed by Counter, -1 for counters that weren't recorded.
+  int64_t values[kNumCounters] = {-1, -1, -1, -1, -1};
+};
+
 // A profiling event.
 struct ProfileEvent {
   // Describes the type of event.
@@ -58,6 +81,10 @@ struct ProfileEvent {
   // Note: if this is an OPERATOR_INVOKE_EVENT, 'extra_event_metadata' will
   // represent the index of the subgraph that this event comes from.
   int64_t extra_event_metadata;
+
+  // The hardware counter deltas over the event. Only recorded by profilers
+  // reading hardware counters.
+  HardwareCounters hw_counters;
 };
 
 // A buffer of profile events. In general, the buffer works like a ring buffer.
@@ -15,11 +15,16 @@ limitations under the License.
 
 #include "profiling/profile_summarizer.h"
 
+#include <algorithm>
+#include <cstdint>
 #include <memory>
 #include <sstream>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "profiling/memory_info.h"
+#include "profiling/node_cost.h"
 #include "schema/schema_generated.h"
 
 namespace tflite {
@@ -87,6 +92,41 @@ OperatorDetails GetOperatorDetails(const tflite::Interpreter& interpreter,
   return details;
 }
 
+// Returns the node name and type an operator invoke event is reported under.
+std::pair<std::string, std::string> GetNodeNameAndType(
+    const tflite::Interpreter& interpreter, const ProfileEvent& event) {
+  if (event.event_type == Profiler::EventType::OPERATOR_INVOKE_EVENT) {
+    // When recording an OPERATOR_INVOKE_EVENT, we have recorded the node
+    // index as event_metadata. See the macro
+    // TFLITE_SCOPED_TAGGED_OPERATOR_PROFILE defined in
+    // core/api/profiler.h for details.
+    const auto node_index = event.event_metadata;
+
+    const auto op_details = GetOperatorDetails(
+        interpreter, event.extra_event_metadata, node_index);
+    std::string type_in_stats(event.tag);
+    if (!op_details.op_description.empty()) {
+      type_in_stats += "/" + op_details.op_description;
+    }
+
+    const auto node_name = ToString(op_details.outputs);
+    // Append node index to node name because 'stats_calculator' can not
+    // distinguish two nodes w/ the same 'node_name'.
+    return {node_name + ":" + std::to_string(node_index), type_in_stats};
+  }
+  const std::string node_name(event.tag);
+  // Append event_metadata to node name because 'stats_calculator' can not
+  // distinguish two nodes w/ the same 'node_name'.
+  const auto node_name_in_stats =
+      "Delegate/" + node_name + ":" + std::to_string(event.event_metadata);
+  if (event.event_type ==
+      Profiler::EventType::DELEGATE_PROFILED_OPERATOR_INVOKE_EVENT) {
+    // For delegate op, node name is treated as the type in stats.
+    return {node_name_in_stats, node_name};
+  }
+  return {node_name_in_stats, "DelegateOpInvoke"};
+}
+
 }  // namespace
 
 ProfileSummarizer::ProfileSummarizer(
@@ -117,53 +157,25 @@ void ProfileSummarizer::ProcessProfiles(
     const auto subgraph_index = event->extra_event_metadata;
     auto stats_calculator = GetStatsCalculator(subgraph_index);
     int64_t node_exec_time = event->elapsed_time;
-    if (event->event_type == Profiler::EventType::OPERATOR_INVOKE_EVENT) {
-      // When recording an OPERATOR_INVOKE_EVENT, we have recorded the node
-      // index as event_metadata. See the macro
-      // TFLITE_SCOPED_TAGGED_OPERATOR_PROFILE defined in
-      // core/api/profiler.h for details.
-      const auto node_index = event->event_metadata;
-
-      const auto op_details =
-          GetOperatorDetails(interpreter, subgraph_index, node_index);
-      std::string type_in_stats(event->tag);
-      if (!op_details.op_description.empty()) {
-        type_in_stats += "/" + op_details.op_description;
-      }
-
-      const auto node_name = ToString(op_details.outputs);
-      // Append node index to node name because 'stats_calculator' can not
-      // distinguish two nodes w/ the same 'node_name'.
-      const auto node_name_in_stats =
-          node_name + ":" + std::to_string(node_index);
-
-      stats_calculator->AddNodeStats(node_name_in_stats, type_in_stats,
+    if (event->event_type == Profiler::EventType::OPERATOR_INVOKE_EVENT ||
+        event->event_type ==
+            Profiler::EventType::DELEGATE_PROFILED_OPERATOR_INVOKE_EVENT) {
+      // DELEGATE_PROFILED_OPERATOR_INVOKE_EVENT handles the delegate ops that
+      // are profiled in the Operator-wise Profiling section, not in the
+      // Delegate internal section.
+      const auto name_and_type = GetNodeNameAndType(interpreter, *event);
+      stats_calculator->AddNodeStats(name_and_type.first, name_and_type.second,
                                      node_num, node_exec_time, 0 /*memory */);
+      if (roofline_enabled_ &&
+          event->event_type == Profiler::EventType::OPERATOR_INVOKE_EVENT) {
+        AddRooflineStats(*event, interpreter, node_num);
+      }
     } else if (event->event_type ==
                Profiler::EventType::DELEGATE_OPERATOR_INVOKE_EVENT) {
-      const std::string node_name(event->tag);
-      // Append event_metadata to node name because 'stats_calculator' can not
-      // distinguish two nodes w/ the same 'node_name'.
-      const auto node_name_in_stats =
-          "Delegate/" + node_name + ":" + std::to_string(event->event_metadata);
-
-      delegate_stats_calculator_->AddNodeStats(node_name_in_stats,
-                                               "DelegateOpInvoke", node_num,
-                                               node_exec_time, 0 /*memory */);
-    } else if (event->event_type ==
-               Profiler::EventType::DELEGATE_PROFILED_OPERATOR_INVOKE_EVENT) {
-      // This event type handles the delegate ops that are profiled in the
-      // Operator-wise Profiling section, not in the Delegate internal section.
-      const std::string node_name(event->tag);
-      // For delegate op, node name is treated as the type in stats.
-      const std::string type_in_stats(node_name);
-      // Append event_metadata to node name because 'stats_calculator' can not
-      // distinguish two nodes w/ the same 'node_name'.
-      const auto node_name_in_stats =
-          "Delegate/" + node_name + ":" + std::to_string(event->event_metadata);
-
-      stats_calculator->AddNodeStats(node_name_in_stats, type_in_stats,
-                                     node_num, node_exec_time, 0 /*memory */);
+      const auto name_and_type = GetNodeNameAndType(interpreter, *event);
+      delegate_stats_calculator_->AddNodeStats(
+          name_and_type.first, name_and_type.second, node_num, node_exec_time,
+          0 /*memory */);
     } else {
       // Note: a different stats_calculator could be used to record
       // non-op-invoke events so that these could be separated from
@@ -175,6 +187,12 @@ void ProfileSummarizer::ProcessProfiles(
         // Don't count the overall Invoke for profiling.
         continue;
       }
+      if (event->event_type == Profiler::EventType::DEFAULT &&
+          (node_name == "OpInit" || node_name == "OpPrepare")) {
+        // The per node init and prepare costs are reported by the startup
+        // profiling, not mixed w/ the run time of the operators.
+        continue;
+      }
       node_name += "/" + std::to_string(event->extra_event_metadata);
       stats_calculator->AddNodeStats(node_name, event->tag, node_num,
                                      node_exec_time,
@@ -203,6 +221,71 @@ void ProfileSummarizer::ProcessProfiles(
   }
 }
 
+void ProfileSummarizer::ProcessHardwareCounters(
+    const std::vector<const ProfileEvent*>& profile_events,
+    const tflite::Interpreter& interpreter) {
+  int64_t run_order = 0;
+  for (const ProfileEvent* event : profile_events) {
+    if ((event->event_type != Profiler::EventType::OPERATOR_INVOKE_EVENT &&
+         event->event_type !=
+             Profiler::EventType::DELEGATE_OPERATOR_INVOKE_EVENT &&
+         event->event_type !=
+             Profiler::EventType::DELEGATE_PROFILED_OPERATOR_INVOKE_EVENT) ||
+        !event->hw_counters.HasValues()) {
+      continue;
+    }
+    auto name_and_type = GetNodeNameAndType(interpreter, *event);
+    if (event->event_type == Profiler::EventType::OPERATOR_INVOKE_EVENT &&
+        event->extra_event_metadata != 0) {
+      name_and_type.first = "Subgraph " +
+                            std::to_string(event->extra_event_metadata) + "/" +
+                            name_and_type.first;
+    }
+    auto inserted = hw_counter_stats_.emplace(name_and_type.first,
+                                              HardwareCounterStats());
+    HardwareCounterStats& stats = inserted.first->second;
+    if (inserted.second) {
+      stats.type = name_and_type.second;
+      stats.run_order = run_order;
+    }
+    ++stats.num_runs;
+    for (int i = 0; i < HardwareCounters::kNumCounters; ++i) {
+      const int64_t value = event->hw_counters.values[i];
+      if (value >= 0) {
+        stats.totals[i] = std::max<int64_t>(stats.totals[i], 0) + value;
+      }
+    }
+    ++run_order;
+  }
+}
+
+void ProfileSummarizer::AddRooflineStats(
+    const ProfileEvent& event, const tflite::Interpreter& interpreter,
+    int64_t run_order) {
+  const uint32_t subgraph_index = event.extra_event_metadata;
+  const Subgraph* subgraph =
+      const_cast<tflite::Interpreter&>(interpreter).subgraph(subgraph_index);
+  if (subgraph == nullptr) return;
+  auto name_and_type = GetNodeNameAndType(interpreter, event);
+  if (subgraph_index != 0) {
+    name_and_type.first = "Subgraph " + std::to_string(subgraph_index) + "/" +
+                          name_and_type.first;
+  }
+  auto inserted =
+      roofline_stats_.emplace(name_and_type.first, RooflineStats());
+  RooflineStats& stats = inserted.first->second;
+  if (inserted.second) {
+    stats.type = name_and_type.second;
+    stats.run_order = run_order;
+  }
+  // The shapes may change between runs, so the cost is estimated each time.
+  const NodeCost cost = EstimateNodeCost(*subgraph, event.event_metadata);
+  ++stats.num_runs;
+  stats.total_us += event.elapsed_time;
+  stats.total_flops += cost.flops;
+  stats.total_bytes += cost.bytes;
+}
+
 tensorflow::StatsCalculator* ProfileSummarizer::GetStatsCalculator(
     uint32_t subgraph_index) {
   if (stats_calculator_map_.count(subgraph_index) == 0) {
@@ -24,6 +24,7 @@ limitations under the License.
 
 #include "tensorflow/core/util/stats_calculator.h"
 #include "core/interpreter.h"
+#include "profiling/machine_peak.h"
 #include "profiling/profile_buffer.h"
 #include "profiling/profile_summary_formatter.h"
 
@@ -42,11 +43,29 @@ class ProfileSummarizer {
   void ProcessProfiles(const std::vector<const ProfileEvent*>& profile_stats,
                        const tflite::Interpreter& interpreter);
 
+  // Process profile events recorded with hardware counters (e.g. by
+  // PerfEventProfiler) to accumulate the counters of each operator.
+  void ProcessHardwareCounters(
+      const std::vector<const ProfileEvent*>& profile_events,
+      const tflite::Interpreter& interpreter);
+
+  // Enables accumulating the estimated flops and bytes of the operators
+  // processed from now on, to report them against the roofline of
+  // 'machine_peak'.
+  void EnableRoofline(const MachinePeak& machine_peak) {
+    machine_peak_ = machine_peak;
+    roofline_enabled_ = true;
+  }
+
   // Returns a string detailing the accumulated runtime stats in the format of
-  // summary_formatter_.
+  // summary_formatter_, followed by the accumulated hardware counters and
+  // roofline if any.
   std::string GetOutputString() {
     return summary_formatter_->GetOutputString(stats_calculator_map_,
-                                               *delegate_stats_calculator_);
+                                               *delegate_stats_calculator_) +
+           summary_formatter_->GetHardwareCounterString(hw_counter_stats_) +
+           summary_formatter_->GetRooflineString(roofline_stats_,
+                                                 machine_peak_);
   }
 
   std::string GetShortSummary() {
@@ -65,12 +84,25 @@ class ProfileSummarizer {
   }
 
  private:
+  // Accumulates the time and estimated cost of an OPERATOR_INVOKE_EVENT.
+  void AddRooflineStats(const ProfileEvent& event,
+                        const tflite::Interpreter& interpreter,
+                        int64_t run_order);
+
   // Map storing stats per subgraph.
   std::map<uint32_t, std::unique_ptr<tensorflow::StatsCalculator>>
       stats_calculator_map_;
 
   std::unique_ptr<tensorflow::StatsCalculator> delegate_stats_calculator_;
 
+  // Map storing the hardware counters per node name.
+  std::map<std::string, HardwareCounterStats> hw_counter_stats_;
+
+  bool roofline_enabled_ = false;
+  MachinePeak machine_peak_;
+  // Map storing the roofline stats per node name.
+  std::map<std::string, RooflineStats> roofline_stats_;
+
   // Summary formatter for customized output formats.
   std::shared_ptr<ProfileSummaryFormatter> summary_formatter_;
 };
@@ -149,6 +149,92 @@ TEST(ProfileSummarizerTest, InterpreterPlusProfilingDetails) {
       << output;
 }
 
+TEST(ProfileSummarizerTest, SkipsInitAndPrepareEvents) {
+  BufferedProfiler profiler(1024);
+  SimpleOpModel m;
+  m.Init(RegisterSimpleOp);
+  auto interpreter = m.GetInterpreter();
+  interpreter->SetProfiler(&profiler);
+  profiler.StartProfiling();
+  // Stand for the per node events of a subgraph initialized and prepared
+  // while profiling.
+  profiler.EndEvent(profiler.BeginEvent("OpInit", Profiler::EventType::DEFAULT,
+                                        /*node_index=*/0, 0));
+  profiler.EndEvent(profiler.BeginEvent(
+      "OpPrepare", Profiler::EventType::DEFAULT, /*node_index=*/0, 0));
+  m.SetInputs(1, 2);
+  ASSERT_EQ(m.Invoke(), kTfLiteOk);
+  profiler.StopProfiling();
+  ProfileSummarizer summarizer;
+  EXPECT_EQ(4, profiler.GetProfileEvents().size());
+  summarizer.ProcessProfiles(profiler.GetProfileEvents(), *interpreter);
+  auto output = summarizer.GetOutputString();
+  ASSERT_TRUE(output.find("SimpleOpEval") != std::string::npos) << output;
+  ASSERT_TRUE(output.find("OpInit") == std::string::npos) << output;
+  ASSERT_TRUE(output.find("OpPrepare") == std::string::npos) << output;
+}
+
+TEST(ProfileSummarizerTest, InterpreterPlusHardwareCounters) {
+  BufferedProfiler profiler(1024);
+  SimpleOpModel m;
+  m.Init(RegisterSimpleOp);
+  auto interpreter = m.GetInterpreter();
+  interpreter->SetProfiler(&profiler);
+  profiler.StartProfiling();
+  m.SetInputs(1, 2);
+  ASSERT_EQ(m.Invoke(), kTfLiteOk);
+  profiler.StopProfiling();
+  ProfileSummarizer summarizer;
+  summarizer.ProcessProfiles(profiler.GetProfileEvents(), *interpreter);
+  EXPECT_TRUE(summarizer.GetOutputString().find("Hardware counters") ==
+              std::string::npos);
+
+  // Events without hardware counters, like the BufferedProfiler ones, are
+  // ignored.
+  summarizer.ProcessHardwareCounters(profiler.GetProfileEvents(),
+                                     *interpreter);
+  EXPECT_TRUE(summarizer.GetOutputString().find("Hardware counters") ==
+              std::string::npos);
+
+  ProfileEvent event;
+  event.tag = kOpName;
+  event.event_type = Profiler::EventType::OPERATOR_INVOKE_EVENT;
+  event.event_metadata = 0;
+  event.extra_event_metadata = 0;
+  event.hw_counters.values[HardwareCounters::kCycles] = 100;
+  event.hw_counters.values[HardwareCounters::kInstructions] = 250;
+  summarizer.ProcessHardwareCounters({&event}, *interpreter);
+  auto output = summarizer.GetOutputString();
+  ASSERT_TRUE(output.find("Hardware counters") != std::string::npos) << output;
+  // IPC = 250 / 100.
+  ASSERT_TRUE(output.find("2.500") != std::string::npos) << output;
+}
+
+TEST(ProfileSummarizerTest, InterpreterPlusRoofline) {
+  BufferedProfiler profiler(1024);
+  SimpleOpModel m;
+  m.Init(RegisterSimpleOp);
+  auto interpreter = m.GetInterpreter();
+  interpreter->SetProfiler(&profiler);
+  profiler.StartProfiling();
+  ASSERT_EQ(m.Invoke(), kTfLiteOk);
+  profiler.StopProfiling();
+  ProfileSummarizer summarizer;
+  summarizer.ProcessProfiles(profiler.GetProfileEvents(), *interpreter);
+  EXPECT_TRUE(summarizer.GetOutputString().find("Roofline") ==
+              std::string::npos);
+
+  MachinePeak machine_peak;
+  machine_peak.gflops = 10;
+  machine_peak.gbytes_per_second = 10;
+  summarizer.EnableRoofline(machine_peak);
+  summarizer.ProcessProfiles(profiler.GetProfileEvents(), *interpreter);
+  auto output = summarizer.GetOutputString();
+  ASSERT_TRUE(output.find("Roofline") != std::string::npos) << output;
+  // The custom op has no flop model, so it's treated as data movement.
+  ASSERT_TRUE(output.find("memory") != std::string::npos) << output;
+}
+
 // A simple test that performs `ADD` if condition is true, and `MUL` otherwise.
 // The computation is: `cond ? a + b : a * b`.
 class ProfileSummarizerIfOpTest : public subgraph_test_util::ControlFlowOpTest {
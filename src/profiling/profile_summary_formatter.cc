@@ -15,13 +15,65 @@ limitations under the License.
 
 #include "profiling/profile_summary_formatter.h"
 
+#include <algorithm>
+#include <cstdint>
+#include <iomanip>
 #include <map>
 #include <memory>
 #include <sstream>
 #include <string>
+#include <utility>
+#include <vector>
 
 namespace tflite {
 namespace profiling {
+namespace {
+
+// Formats 'numerator' / 'denominator' * 'scale' with 'precision' decimals, or
+// "n/a" if either counter wasn't recorded.
+std::string FormatRatio(int64_t numerator, int64_t denominator, double scale,
+                        int precision) {
+  if (numerator < 0 || denominator <= 0) {
+    return "n/a";
+  }
+  std::stringstream stream;
+  stream << std::fixed << std::setprecision(precision)
+         << scale * numerator / denominator;
+  return stream.str();
+}
+
+std::string FormatDouble(double value, int precision) {
+  std::stringstream stream;
+  stream << std::fixed << std::setprecision(precision) << value;
+  return stream.str();
+}
+
+// Writes 'row' as CSV or as tab separated columns of 'column_width'.
+void WriteRow(const std::vector<std::string>& row, bool csv, int column_width,
+              std::stringstream* stream) {
+  for (size_t i = 0; i < row.size(); ++i) {
+    if (csv) {
+      (*stream) << (i == 0 ? "" : ", ") << row[i];
+    } else if (i + 1 == row.size()) {
+      (*stream) << row[i];
+    } else {
+      (*stream) << std::setw(column_width) << row[i] << "\t";
+    }
+  }
+  (*stream) << std::endl;
+}
+
+// Writes the header row of a table, in brackets unless 'csv' is set.
+void WriteHeader(const std::vector<std::string>& header, bool csv,
+                 int column_width, std::stringstream* stream) {
+  std::vector<std::string> header_row;
+  for (const std::string& column : header) {
+    header_row.push_back(csv ? column : "[" + column + "]");
+  }
+  WriteRow(header_row, csv, column_width, stream);
+}
+
+}  // namespace
 
 std::string ProfileSummaryDefaultFormatter::GetOutputString(
     const std::map<uint32_t, std::unique_ptr<tensorflow::StatsCalculator>>&
@@ -78,6 +130,125 @@ std::string ProfileSummaryDefaultFormatter::GenerateReport(
   return stream.str();
 }
 
+std::string ProfileSummaryDefaultFormatter::GetHardwareCounterString(
+    const std::map<std::string, HardwareCounterStats>& hw_counter_stats)
+    const {
+  if (hw_counter_stats.empty()) {
+    return "";
+  }
+  std::vector<std::pair<std::string, const HardwareCounterStats*>> nodes;
+  nodes.reserve(hw_counter_stats.size());
+  for (const auto& node : hw_counter_stats) {
+    nodes.emplace_back(node.first, &node.second);
+  }
+  std::stable_sort(nodes.begin(), nodes.end(),
+                   [](const auto& a, const auto& b) {
+                     return a.second->run_order < b.second->run_order;
+                   });
+
+  const bool csv = GetStatSummarizerOptions().format_as_csv;
+  const std::vector<std::string> header = {
+      "node type", "cycles",      "instructions",    "IPC",
+      "LLC MPKI",  "branch MPKI", "backend stall %", "name"};
+  constexpr int kColumnWidth = 16;
+  std::stringstream stream;
+
+  if (!csv) {
+    stream << "============================== Hardware counters per run "
+              "=============================="
+           << std::endl;
+  }
+  WriteHeader(header, csv, kColumnWidth, &stream);
+  for (const auto& node : nodes) {
+    const HardwareCounterStats& stats = *node.second;
+    const int64_t* totals = stats.totals;
+    const int64_t cycles = totals[HardwareCounters::kCycles];
+    const int64_t instructions = totals[HardwareCounters::kInstructions];
+    WriteRow({stats.type, FormatRatio(cycles, stats.num_runs, 1.0, 0),
+               FormatRatio(instructions, stats.num_runs, 1.0, 0),
+               FormatRatio(instructions, cycles, 1.0, 3),
+               FormatRatio(totals[HardwareCounters::kLlcMisses], instructions,
+                           1000.0, 3),
+               FormatRatio(totals[HardwareCounters::kBranchMisses],
+                           instructions, 1000.0, 3),
+               FormatRatio(totals[HardwareCounters::kBackendStallCycles],
+                           cycles, 100.0, 2),
+               node.first},
+             csv, kColumnWidth, &stream);
+  }
+  return stream.str();
+}
+
+std::string ProfileSummaryDefaultFormatter::GetRooflineString(
+    const std::map<std::string, RooflineStats>& roofline_stats,
+    const MachinePeak& machine_peak) const {
+  if (roofline_stats.empty() || machine_peak.gflops <= 0 ||
+      machine_peak.gbytes_per_second <= 0) {
+    return "";
+  }
+  struct Row {
+    std::string name;
+    const RooflineStats* stats;
+    // The time of a run at the roofline.
+    double roofline_ms;
+    double headroom_ms;
+  };
+  std::vector<Row> rows;
+  rows.reserve(roofline_stats.size());
+  for (const auto& node : roofline_stats) {
+    const RooflineStats& stats = node.second;
+    if (stats.num_runs <= 0) continue;
+    const double avg_ms = stats.total_us * 1e-3 / stats.num_runs;
+    // Flops per ms are 1e6 times GFLOP/s.
+    const double roofline_ms =
+        std::max(stats.total_flops / (machine_peak.gflops * 1e6),
+                 stats.total_bytes / (machine_peak.gbytes_per_second * 1e6)) /
+        stats.num_runs;
+    rows.push_back({node.first, &stats, roofline_ms,
+                    std::max(avg_ms - roofline_ms, 0.0)});
+  }
+  std::stable_sort(rows.begin(), rows.end(), [](const Row& a, const Row& b) {
+    if (a.headroom_ms != b.headroom_ms) return a.headroom_ms > b.headroom_ms;
+    return a.stats->run_order < b.stats->run_order;
+  });
+
+  const bool csv = GetStatSummarizerOptions().format_as_csv;
+  const std::vector<std::string> header = {
+      "node type", "avg ms", "MFLOP",      "MB",          "FLOP/byte",
+      "GFLOP/s",   "GB/s",   "bound",      "% of roof",   "headroom ms",
+      "name"};
+  constexpr int kColumnWidth = 12;
+  std::stringstream stream;
+  if (!csv) {
+    stream << "============================== Roofline (peak "
+           << FormatDouble(machine_peak.gflops, 1) << " GFLOP/s, "
+           << FormatDouble(machine_peak.gbytes_per_second, 1)
+           << " GB/s) ==============================" << std::endl;
+  }
+  WriteHeader(header, csv, kColumnWidth, &stream);
+  for (const Row& row : rows) {
+    const RooflineStats& stats = *row.stats;
+    const bool compute_bound =
+        stats.total_bytes > 0 &&
+        static_cast<double>(stats.total_flops) / stats.total_bytes >=
+            machine_peak.RidgePoint();
+    const double avg_ms = stats.total_us * 1e-3 / stats.num_runs;
+    WriteRow(
+        {stats.type, FormatDouble(avg_ms, 3),
+         FormatDouble(stats.total_flops * 1e-6 / stats.num_runs, 3),
+         FormatDouble(stats.total_bytes * 1e-6 / stats.num_runs, 3),
+         FormatRatio(stats.total_flops, stats.total_bytes, 1.0, 2),
+         FormatRatio(stats.total_flops, stats.total_us, 1e-3, 2),
+         FormatRatio(stats.total_bytes, stats.total_us, 1e-3, 2),
+         compute_bound ? "compute" : "memory",
+         avg_ms > 0 ? FormatDouble(100.0 * row.roofline_ms / avg_ms, 1)
+                    : "n/a",
+         FormatDouble(row.headroom_ms, 3), row.name},
+        csv, kColumnWidth, &stream);
+  }
+  return stream.str();
+}
+
 tensorflow::StatSummarizerOptions
 ProfileSummaryDefaultFormatter::GetStatSummarizerOptions() const {
   auto options = tensorflow::StatSummarizerOptions();
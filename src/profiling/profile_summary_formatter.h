@@ -24,10 +24,33 @@ limitations under the License.
 #include <vector>
 
 #include "tensorflow/core/util/stats_calculator.h"
+#include "profiling/machine_peak.h"
+#include "profiling/profile_buffer.h"
 
 namespace tflite {
 namespace profiling {
 
+// The hardware counters of a node accumulated over all the runs.
+struct HardwareCounterStats {
+  std::string type;
+  // The position of the node in the first run it was seen in.
+  int64_t run_order = 0;
+  int64_t num_runs = 0;
+  // The sum of each counter over all runs, -1 if it wasn't recorded.
+  int64_t totals[HardwareCounters::kNumCounters] = {-1, -1, -1, -1, -1};
+};
+
+// The estimated work of a node and its time accumulated over all the runs.
+struct RooflineStats {
+  std::string type;
+  // The position of the node in the first run it was seen in.
+  int64_t run_order = 0;
+  int64_t num_runs = 0;
+  int64_t total_us = 0;
+  uint64_t total_flops = 0;
+  uint64_t total_bytes = 0;
+};
+
 // Formats the profile summary in a certain way.
 class ProfileSummaryFormatter {
  public:
@@ -47,6 +70,22 @@ class ProfileSummaryFormatter {
       const tensorflow::StatsCalculator& delegate_stats_calculator) const = 0;
   virtual tensorflow::StatSummarizerOptions GetStatSummarizerOptions()
       const = 0;
+  // Returns a string detailing the hardware counters accumulated per node by
+  // ProfileSummarizer, keyed by node name. Returns an empty string if no
+  // hardware counters were recorded.
+  virtual std::string GetHardwareCounterString(
+      const std::map<std::string, HardwareCounterStats>& hw_counter_stats)
+      const {
+    return "";
+  }
+  // Returns a string placing the nodes accumulated by ProfileSummarizer,
+  // keyed by node name, on the roofline of 'machine_peak'. Returns an empty
+  // string if there are no stats.
+  virtual std::string GetRooflineString(
+      const std::map<std::string, RooflineStats>& roofline_stats,
+      const MachinePeak& machine_peak) const {
+    return "";
+  }
 };
 
 class ProfileSummaryDefaultFormatter : public ProfileSummaryFormatter {
@@ -64,6 +103,20 @@ class ProfileSummaryDefaultFormatter : public ProfileSummaryFormatter {
       const tensorflow::StatsCalculator& delegate_stats_calculator)
       const override;
   tensorflow::StatSummarizerOptions GetStatSummarizerOptions() const override;
+  // Reports the per-run averages of the counters along with the IPC, the
+  // last level cache and branch misses per thousand instructions, and the
+  // share of cycles stalled in the backend, in the order the nodes run.
+  std::string GetHardwareCounterString(
+      const std::map<std::string, HardwareCounterStats>& hw_counter_stats)
+      const override;
+  // Reports the per-run averages of the time, flops and bytes of each node,
+  // its arithmetic intensity, achieved throughput and bandwidth, whether it's
+  // compute or bandwidth bound, and how close it runs to the roofline. The
+  // nodes are sorted by headroom, i.e. the time they would save running at
+  // the roofline.
+  std::string GetRooflineString(
+      const std::map<std::string, RooflineStats>& roofline_stats,
+      const MachinePeak& machine_peak) const override;
 
  private:
   std::string GenerateReport(
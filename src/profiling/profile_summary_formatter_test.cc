@@ -154,6 +154,96 @@ TEST(SummaryWriterTest, DelegationShortSummary) {
   ASSERT_TRUE(absl::StrContains(output, "Delegate internal"));
 }
 
+TEST(SummaryWriterTest, EmptyHardwareCounterString) {
+  ProfileSummaryDefaultFormatter writer;
+  EXPECT_EQ(writer.GetHardwareCounterString({}).size(), 0);
+}
+
+TEST(SummaryWriterTest, HardwareCounterString) {
+  std::map<std::string, HardwareCounterStats> hw_counter_stats;
+  HardwareCounterStats& conv = hw_counter_stats["[conv]:0"];
+  conv.type = "CONV_2D";
+  conv.run_order = 0;
+  conv.num_runs = 2;
+  conv.totals[HardwareCounters::kCycles] = 2000;
+  conv.totals[HardwareCounters::kInstructions] = 4000;
+  conv.totals[HardwareCounters::kLlcMisses] = 8;
+  HardwareCounterStats& add = hw_counter_stats["[add]:1"];
+  add.type = "ADD";
+  add.run_order = 1;
+  add.num_runs = 2;
+  add.totals[HardwareCounters::kCycles] = 100;
+
+  std::string output =
+      ProfileSummaryDefaultFormatter().GetHardwareCounterString(
+          hw_counter_stats);
+  ASSERT_TRUE(absl::StrContains(output, "Hardware counters per run"));
+  ASSERT_TRUE(absl::StrContains(output, "[IPC]"));
+  // Nodes are listed in run order, not in name order.
+  ASSERT_LT(output.find("CONV_2D"), output.find("ADD"));
+
+  output = ProfileSummaryCSVFormatter().GetHardwareCounterString(
+      hw_counter_stats);
+  ASSERT_TRUE(absl::StrContains(
+      output, "CONV_2D, 1000, 2000, 2.000, 2.000, n/a, n/a, [conv]:0"));
+  ASSERT_TRUE(
+      absl::StrContains(output, "ADD, 50, n/a, n/a, n/a, n/a, n/a, [add]:1"));
+}
+
+TEST(SummaryWriterTest, EmptyRooflineString) {
+  ProfileSummaryDefaultFormatter writer;
+  MachinePeak machine_peak;
+  machine_peak.gflops = 10;
+  machine_peak.gbytes_per_second = 10;
+  EXPECT_EQ(writer.GetRooflineString({}, machine_peak).size(), 0);
+  std::map<std::string, RooflineStats> roofline_stats;
+  roofline_stats["[add]:1"].num_runs = 1;
+  // Without a calibrated peak there is no roofline.
+  EXPECT_EQ(writer.GetRooflineString(roofline_stats, MachinePeak()).size(), 0);
+}
+
+TEST(SummaryWriterTest, RooflineString) {
+  MachinePeak machine_peak;
+  machine_peak.gflops = 10;
+  machine_peak.gbytes_per_second = 10;
+  std::map<std::string, RooflineStats> roofline_stats;
+  // 5 MFLOP in 1 ms per run, i.e. 5 GFLOP/s or half the compute roof.
+  RooflineStats& conv = roofline_stats["[conv]:0"];
+  conv.type = "CONV_2D";
+  conv.run_order = 0;
+  conv.num_runs = 2;
+  conv.total_us = 2000;
+  conv.total_flops = 10000000;
+  conv.total_bytes = 20000;
+  // 1 MB in 0.2 ms per run, i.e. 5 GB/s or half the bandwidth roof.
+  RooflineStats& add = roofline_stats["[add]:1"];
+  add.type = "ADD";
+  add.run_order = 1;
+  add.num_runs = 2;
+  add.total_us = 400;
+  add.total_bytes = 2000000;
+
+  std::string output = ProfileSummaryDefaultFormatter().GetRooflineString(
+      roofline_stats, machine_peak);
+  ASSERT_TRUE(absl::StrContains(output, "Roofline")) << output;
+  ASSERT_TRUE(absl::StrContains(output, "[headroom ms]")) << output;
+  // Nodes are listed by decreasing headroom, not in name order.
+  ASSERT_LT(output.find("CONV_2D"), output.find("ADD"));
+
+  output = ProfileSummaryCSVFormatter().GetRooflineString(roofline_stats,
+                                                          machine_peak);
+  ASSERT_TRUE(absl::StrContains(
+      output,
+      "CONV_2D, 1.000, 5.000, 0.010, 500.00, 5.00, 0.01, compute, 50.0, "
+      "0.500, [conv]:0"))
+      << output;
+  ASSERT_TRUE(absl::StrContains(
+      output,
+      "ADD, 0.200, 0.000, 1.000, 0.00, 0.00, 5.00, memory, 50.0, 0.100, "
+      "[add]:1"))
+      << output;
+}
+
 }  // namespace
 }  // namespace profiling
 }  // namespace tflite
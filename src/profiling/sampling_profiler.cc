@@ -0,0 +1,359 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "profiling/sampling_profiler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>  // NOLINT(build/c++11)
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <mutex>  // NOLINT(build/c++11)
+#include <set>
+#include <string>
+#include <thread>  // NOLINT(build/c++11)
+#include <tuple>
+#include <vector>
+
+#include "profiling/profile_buffer.h"
+#include "profiling/time.h"
+
+namespace tflite {
+namespace profiling {
+namespace {
+
+bool IsOperatorEvent(Profiler::EventType event_type) {
+  return event_type == Profiler::EventType::OPERATOR_INVOKE_EVENT ||
+         event_type == Profiler::EventType::DELEGATE_OPERATOR_INVOKE_EVENT ||
+         event_type ==
+             Profiler::EventType::DELEGATE_PROFILED_OPERATOR_INVOKE_EVENT;
+}
+
+bool IsTelemetryEvent(Profiler::EventType event_type) {
+  return static_cast<int>(event_type) >=
+         static_cast<int>(Profiler::EventType::TELEMETRY_EVENT);
+}
+
+uint32_t RoundUpToPowerOfTwo(uint32_t value) {
+  uint32_t result = 1;
+  while (result < value) result <<= 1;
+  return result;
+}
+
+std::atomic<uint64_t> next_profiler_id{1};
+
+constexpr int kThreadBufferCacheSize = 4;
+
+// The live profilers, whose buffers of the exiting threads are released. They
+// are leaked, as threads may exit during the static destruction.
+std::mutex& GetLiveProfilersMutex() {
+  static std::mutex* mutex = new std::mutex;
+  return *mutex;
+}
+
+std::set<SamplingProfiler*>& GetLiveProfilers() {
+  static std::set<SamplingProfiler*>* profilers =
+      new std::set<SamplingProfiler*>;
+  return *profilers;
+}
+
+}  // namespace
+
+// Lets the threads shared by a few profilers skip the lookup of their buffers.
+struct SamplingProfiler::ThreadBufferCache {
+  ~ThreadBufferCache() {
+    // Profilers unregister before being destroyed, so the live ones can't go
+    // away while their buffers are released.
+    std::lock_guard<std::mutex> lock(GetLiveProfilersMutex());
+    for (SamplingProfiler* profiler : GetLiveProfilers()) {
+      profiler->ReleaseThreadBuffer(std::this_thread::get_id());
+    }
+  }
+
+  uint64_t profiler_ids[kThreadBufferCacheSize] = {};
+  ThreadBuffer* buffers[kThreadBufferCacheSize] = {};
+  int next_entry = 0;
+};
+
+void LatencyHistogram::Add(uint64_t latency_us) {
+  int bucket = 0;
+  while (bucket < kNumBuckets - 1 && (uint64_t{1} << bucket) <= latency_us) {
+    ++bucket;
+  }
+  ++bucket_counts[bucket];
+  min_us = count == 0 ? latency_us : std::min(min_us, latency_us);
+  max_us = std::max(max_us, latency_us);
+  sum_us += latency_us;
+  ++count;
+}
+
+void LatencyHistogram::Merge(const LatencyHistogram& other) {
+  if (other.count == 0) return;
+  min_us = count == 0 ? other.min_us : std::min(min_us, other.min_us);
+  max_us = std::max(max_us, other.max_us);
+  sum_us += other.sum_us;
+  count += other.count;
+  for (int i = 0; i < kNumBuckets; ++i) {
+    bucket_counts[i] += other.bucket_counts[i];
+  }
+}
+
+uint64_t LatencyHistogram::Percentile(double percentile) const {
+  if (count == 0) return 0;
+  const uint64_t rank = std::max<uint64_t>(
+      1, static_cast<uint64_t>(std::ceil(percentile / 100.0 * count - 1e-9)));
+  uint64_t seen = 0;
+  for (int i = 0; i < kNumBuckets - 1; ++i) {
+    seen += bucket_counts[i];
+    if (seen >= rank) {
+      // Bucket i holds latencies below 2^i us.
+      return std::min(max_us, (uint64_t{1} << i) - 1);
+    }
+  }
+  return max_us;
+}
+
+SamplingProfiler::ThreadBuffer::ThreadBuffer(uint32_t size)
+    : events(new Event[RoundUpToPowerOfTwo(std::max<uint32_t>(size, 1))]),
+      mask(RoundUpToPowerOfTwo(std::max<uint32_t>(size, 1)) - 1) {}
+
+SamplingProfiler::SamplingProfiler(const Options& options)
+    : id_(next_profiler_id.fetch_add(1)), options_(options) {
+  {
+    std::lock_guard<std::mutex> lock(GetLiveProfilersMutex());
+    GetLiveProfilers().insert(this);
+  }
+  if (options_.aggregation_interval_ms > 0) {
+    aggregation_thread_ = std::thread([this]() { AggregationLoop(); });
+  }
+}
+
+SamplingProfiler::~SamplingProfiler() {
+  {
+    std::lock_guard<std::mutex> lock(GetLiveProfilersMutex());
+    GetLiveProfilers().erase(this);
+  }
+  if (aggregation_thread_.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock(aggregation_mutex_);
+      stop_aggregation_ = true;
+    }
+    aggregation_cv_.notify_one();
+    aggregation_thread_.join();
+  }
+}
+
+SamplingProfiler::ThreadBufferCache&
+SamplingProfiler::GetThreadBufferCache() {
+  thread_local ThreadBufferCache cache;
+  return cache;
+}
+
+SamplingProfiler::ThreadBuffer* SamplingProfiler::GetThreadBuffer() {
+  ThreadBufferCache& cache = GetThreadBufferCache();
+  for (int i = 0; i < kThreadBufferCacheSize; ++i) {
+    if (cache.profiler_ids[i] == id_) {
+      return cache.buffers[i];
+    }
+  }
+  std::lock_guard<std::mutex> lock(threads_mutex_);
+  std::unique_ptr<ThreadBuffer>& buffer = threads_[std::this_thread::get_id()];
+  if (buffer == nullptr) {
+    buffer = std::make_unique<ThreadBuffer>(options_.ring_buffer_size);
+  }
+  cache.profiler_ids[cache.next_entry] = id_;
+  cache.buffers[cache.next_entry] = buffer.get();
+  cache.next_entry = (cache.next_entry + 1) % kThreadBufferCacheSize;
+  return buffer.get();
+}
+
+void SamplingProfiler::ReleaseThreadBuffer(std::thread::id thread_id) {
+  std::lock_guard<std::mutex> lock(threads_mutex_);
+  auto it = threads_.find(thread_id);
+  if (it == threads_.end()) return;
+  exited_threads_.push_back(std::move(it->second));
+  threads_.erase(it);
+}
+
+const char* SamplingProfiler::InternTag(ThreadBuffer* buffer,
+                                        const char* tag) {
+  auto it = buffer->tags.find(tag);
+  if (it == buffer->tags.end()) {
+    it = buffer->tags.emplace(tag).first;
+  }
+  return it->c_str();
+}
+
+uint32_t SamplingProfiler::BeginEvent(const char* tag, EventType event_type,
+                                      int64_t event_metadata1,
+                                      int64_t event_metadata2) {
+  if (IsTelemetryEvent(event_type)) {
+    return kInvalidEventHandle;
+  }
+  ThreadBuffer* buffer = GetThreadBuffer();
+  if (buffer->depth >= kMaxDepth) {
+    return kInvalidEventHandle;
+  }
+  if (buffer->depth == 0) {
+    const uint32_t period = std::max<uint32_t>(options_.sampling_period, 1);
+    buffer->sampled = buffer->num_invokes++ % period == 0;
+  }
+  const uint32_t handle = buffer->depth++;
+  OpenEvent& event = buffer->open_events[handle];
+  // Sampled invokes record their operators, and themselves.
+  event.record =
+      buffer->sampled && (handle == 0 || IsOperatorEvent(event_type));
+  if (!event.record) {
+    return handle;
+  }
+  event.tag = InternTag(buffer, tag);
+  event.event_type = event_type;
+  event.event_metadata1 = event_metadata1;
+  event.event_metadata2 = event_metadata2;
+  event.begin_us = time::NowMicros();
+  return handle;
+}
+
+void SamplingProfiler::EndEvent(uint32_t event_handle) {
+  ThreadBuffer* buffer = GetThreadBuffer();
+  if (event_handle >= buffer->depth) {
+    return;
+  }
+  // Events end in the reverse order they began, unless one of them was
+  // dropped on the way, in which case its nested events end with it.
+  buffer->depth = event_handle;
+  const OpenEvent& event = buffer->open_events[event_handle];
+  if (event.record) {
+    Push(buffer, {event.tag, event.event_type, event.event_metadata1,
+                  event.event_metadata2, time::NowMicros() - event.begin_us});
+  }
+}
+
+void SamplingProfiler::AddEvent(const char* tag, EventType event_type,
+                                uint64_t elapsed_time, int64_t event_metadata1,
+                                int64_t event_metadata2) {
+  if (!IsOperatorEvent(event_type)) {
+    return;
+  }
+  ThreadBuffer* buffer = GetThreadBuffer();
+  if (buffer->depth == 0 || !buffer->sampled) {
+    return;
+  }
+  Push(buffer, {InternTag(buffer, tag), event_type, event_metadata1,
+                event_metadata2, elapsed_time});
+}
+
+void SamplingProfiler::Push(ThreadBuffer* buffer, const Event& event) {
+  const uint64_t head = buffer->head.load(std::memory_order_relaxed);
+  if (head - buffer->tail.load(std::memory_order_acquire) > buffer->mask) {
+    buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  buffer->events[head & buffer->mask] = event;
+  buffer->head.store(head + 1, std::memory_order_release);
+}
+
+void SamplingProfiler::AggregateLocked() {
+  std::vector<ThreadBuffer*> buffers;
+  // Freed once drained. Their threads are gone, so nothing is pushed anymore.
+  std::vector<std::unique_ptr<ThreadBuffer>> exited_threads;
+  {
+    std::lock_guard<std::mutex> lock(threads_mutex_);
+    for (const auto& thread : threads_) {
+      buffers.push_back(thread.second.get());
+    }
+    exited_threads.swap(exited_threads_);
+    for (const auto& buffer : exited_threads) {
+      buffers.push_back(buffer.get());
+      dropped_by_exited_threads_ +=
+          buffer->dropped.load(std::memory_order_relaxed);
+    }
+  }
+  for (ThreadBuffer* buffer : buffers) {
+    const uint64_t tail = buffer->tail.load(std::memory_order_relaxed);
+    const uint64_t head = buffer->head.load(std::memory_order_acquire);
+    for (uint64_t i = tail; i < head; ++i) {
+      const Event& event = buffer->events[i & buffer->mask];
+      // OPERATOR_INVOKE_EVENT is the only type with a subgraph index.
+      const int64_t subgraph_index =
+          event.event_type == EventType::OPERATOR_INVOKE_EVENT
+              ? event.event_metadata2
+              : 0;
+      const auto pointer_key =
+          std::make_tuple(event.tag, static_cast<int>(event.event_type),
+                          event.event_metadata1, subgraph_index);
+      OpLatencyStats*& stats = stats_by_tag_pointer_[pointer_key];
+      if (stats == nullptr) {
+        const auto key = std::make_tuple(std::string(event.tag),
+                                         static_cast<int>(event.event_type),
+                                         event.event_metadata1, subgraph_index);
+        stats = &stats_[key];
+        stats->tag = event.tag;
+        stats->event_type = event.event_type;
+        stats->node_index = event.event_metadata1;
+        stats->subgraph_index = subgraph_index;
+      }
+      stats->histogram.Add(event.elapsed_us);
+    }
+    buffer->tail.store(head, std::memory_order_release);
+  }
+  if (!exited_threads.empty()) {
+    // The tags interned by the freed buffers may be reused by other ones.
+    stats_by_tag_pointer_.clear();
+  }
+}
+
+void SamplingProfiler::AggregationLoop() {
+  std::unique_lock<std::mutex> lock(aggregation_mutex_);
+  while (!stop_aggregation_) {
+    aggregation_cv_.wait_for(
+        lock, std::chrono::milliseconds(options_.aggregation_interval_ms));
+    std::lock_guard<std::mutex> stats_lock(stats_mutex_);
+    AggregateLocked();
+  }
+}
+
+std::vector<OpLatencyStats> SamplingProfiler::GetOpLatencyStats() {
+  std::lock_guard<std::mutex> lock(stats_mutex_);
+  AggregateLocked();
+  std::vector<OpLatencyStats> result;
+  result.reserve(stats_.size());
+  for (const auto& stats : stats_) {
+    result.push_back(stats.second);
+  }
+  return result;
+}
+
+void SamplingProfiler::ResetStats() {
+  std::lock_guard<std::mutex> lock(stats_mutex_);
+  AggregateLocked();
+  stats_by_tag_pointer_.clear();
+  stats_.clear();
+}
+
+uint64_t SamplingProfiler::NumDroppedEvents() const {
+  std::lock_guard<std::mutex> lock(threads_mutex_);
+  uint64_t dropped = dropped_by_exited_threads_;
+  for (const auto& thread : threads_) {
+    dropped += thread.second->dropped.load(std::memory_order_relaxed);
+  }
+  for (const auto& buffer : exited_threads_) {
+    dropped += buffer->dropped.load(std::memory_order_relaxed);
+  }
+  return dropped;
+}
+
+}  // namespace profiling
+}  // namespace tflite
@@ -0,0 +1,222 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_LITE_PROFILING_SAMPLING_PROFILER_H_
+#define TENSORFLOW_LITE_PROFILING_SAMPLING_PROFILER_H_
+
+#include <atomic>
+#include <condition_variable>  // NOLINT(build/c++11)
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>  // NOLINT(build/c++11)
+#include <set>
+#include <string>
+#include <thread>  // NOLINT(build/c++11)
+#include <tuple>
+#include <vector>
+
+#include "core/api/profiler.h"
+
+namespace tflite {
+namespace profiling {
+
+// A histogram of latencies with power of two buckets: bucket 0 counts the
+// latencies under 1us, bucket i the ones in [2^(i-1), 2^i) us, and the last
+// bucket everything above.
+struct LatencyHistogram {
+  static constexpr int kNumBuckets = 32;
+
+  void Add(uint64_t latency_us);
+
+  // Adds the latencies of 'other'.
+  void Merge(const LatencyHistogram& other);
+
+  // Returns an upper bound of the 'percentile'th percentile, i.e. the upper
+  // bound of the bucket containing it, capped by the maximum latency.
+  uint64_t Percentile(double percentile) const;
+
+  uint64_t count = 0;
+  uint64_t sum_us = 0;
+  uint64_t min_us = 0;
+  uint64_t max_us = 0;
+  uint64_t bucket_counts[kNumBuckets] = {};
+};
+
+// The latencies of one operator, or of one top level event such as an
+// interpreter invoke.
+struct OpLatencyStats {
+  std::string tag;
+  Profiler::EventType event_type;
+  // The node index, for operator events.
+  int64_t node_index;
+  // The subgraph index, for OPERATOR_INVOKE_EVENT events.
+  int64_t subgraph_index;
+  LatencyHistogram histogram;
+};
+
+// A profiler meant to stay on in production: it only times 1 in
+// 'sampling_period' invokes of each thread, and records the latencies of the
+// operators of these invokes, and of the invokes themselves, into per-thread
+// lock free ring buffers. The buffers are drained into per-operator latency
+// histograms in the background or when the stats are pulled with
+// GetOpLatencyStats. Each thread caches its buffers of the last 4 profilers it
+// reported to: it only takes a lock to look up its buffer on a cache miss,
+// i.e. when it first reports to a profiler or alternates between more than 4
+// of them, and only allocates when it first reports to a profiler or sees a
+// new tag. The buffer of a thread is freed by the first aggregation after the
+// thread exits.
+//
+// Invokes are the top level events of each thread. Events of invokes that
+// aren't sampled are only counted to track the nesting, without reading the
+// clock. Events a full ring buffer can't take are dropped and counted.
+//
+// Unlike the other profilers, an instance can be shared by several
+// interpreters invoked from different threads, and the stats can be pulled
+// from any thread. Events must end on the thread that began them.
+class SamplingProfiler : public tflite::Profiler {
+ public:
+  struct Options {
+    // Times 1 in 'sampling_period' invokes of each thread.
+    uint32_t sampling_period = 100;
+    // The number of events each thread can buffer between two aggregations,
+    // rounded up to a power of two.
+    uint32_t ring_buffer_size = 4096;
+    // If positive, a background thread aggregates the buffered events with
+    // this period. Otherwise they are only aggregated by GetOpLatencyStats.
+    int aggregation_interval_ms = 0;
+  };
+
+  explicit SamplingProfiler(const Options& options);
+  ~SamplingProfiler() override;
+
+  SamplingProfiler(const SamplingProfiler&) = delete;
+  SamplingProfiler& operator=(const SamplingProfiler&) = delete;
+
+  uint32_t BeginEvent(const char* tag, EventType event_type,
+                      int64_t event_metadata1,
+                      int64_t event_metadata2) override;
+
+  void EndEvent(uint32_t event_handle) override;
+
+  void AddEvent(const char* tag, EventType event_type, uint64_t elapsed_time,
+                int64_t event_metadata1, int64_t event_metadata2) override;
+
+  // Aggregates the buffered events and returns the latencies recorded since
+  // the last ResetStats, in no particular order.
+  std::vector<OpLatencyStats> GetOpLatencyStats();
+
+  // Clears the aggregated latencies. Buffered events are dropped too.
+  void ResetStats();
+
+  // Returns the number of events dropped because a ring buffer was full.
+  uint64_t NumDroppedEvents() const;
+
+ private:
+  struct Event {
+    const char* tag;
+    EventType event_type;
+    int64_t event_metadata1;
+    int64_t event_metadata2;
+    uint64_t elapsed_us;
+  };
+
+  struct OpenEvent {
+    const char* tag;
+    EventType event_type;
+    int64_t event_metadata1;
+    int64_t event_metadata2;
+    uint64_t begin_us;
+    bool record;
+  };
+
+  static constexpr uint32_t kMaxDepth = 16;
+
+  // The state of a recording thread. Everything but the ring buffer indices
+  // and the dropped count is only accessed by that thread.
+  struct ThreadBuffer {
+    explicit ThreadBuffer(uint32_t size);
+
+    // Single producer, single consumer ring buffer of 'mask + 1' events.
+    std::unique_ptr<Event[]> events;
+    const uint64_t mask;
+    std::atomic<uint64_t> head{0};
+    std::atomic<uint64_t> tail{0};
+    std::atomic<uint64_t> dropped{0};
+
+    OpenEvent open_events[kMaxDepth];
+    uint32_t depth = 0;
+    uint64_t num_invokes = 0;
+    bool sampled = false;
+    // Copies of the tags of the recorded events, which may not outlive their
+    // interpreter, or even the AddEvent call. They are only added to, so the
+    // buffered events can point to them.
+    std::set<std::string, std::less<>> tags;
+  };
+
+  // The buffers of the calling thread for the last profilers it reported to.
+  // Releases the buffers of the thread from all the profilers when it exits.
+  struct ThreadBufferCache;
+
+  static ThreadBufferCache& GetThreadBufferCache();
+
+  // Returns the buffer of the calling thread, creating it on first use.
+  ThreadBuffer* GetThreadBuffer();
+
+  // Hands the buffer of the exited thread 'thread_id', if any, over to the
+  // next aggregation, which drains and frees it.
+  void ReleaseThreadBuffer(std::thread::id thread_id);
+
+  // Returns the copy of 'tag' owned by 'buffer'.
+  static const char* InternTag(ThreadBuffer* buffer, const char* tag);
+
+  void Push(ThreadBuffer* buffer, const Event& event);
+
+  // Drains the ring buffers into the histograms, and frees the buffers of the
+  // exited threads. Must be called with stats_mutex_ held.
+  void AggregateLocked();
+
+  void AggregationLoop();
+
+  // Identifies this instance in the per-thread buffer caches, which may
+  // outlive it.
+  const uint64_t id_;
+  const Options options_;
+
+  mutable std::mutex threads_mutex_;
+  std::map<std::thread::id, std::unique_ptr<ThreadBuffer>> threads_;
+  // The buffers of the exited threads that weren't drained yet.
+  std::vector<std::unique_ptr<ThreadBuffer>> exited_threads_;
+  // The events dropped by the buffers of the exited threads already freed.
+  uint64_t dropped_by_exited_threads_ = 0;
+
+  std::mutex stats_mutex_;
+  // Histograms by tag, event type, node and subgraph index.
+  std::map<std::tuple<std::string, int, int64_t, int64_t>, OpLatencyStats>
+      stats_;
+  // Resolves the interned tags of the buffered events to their histogram.
+  std::map<std::tuple<const char*, int, int64_t, int64_t>, OpLatencyStats*>
+      stats_by_tag_pointer_;
+
+  std::mutex aggregation_mutex_;
+  std::condition_variable aggregation_cv_;
+  bool stop_aggregation_ = false;
+  std::thread aggregation_thread_;
+};
+
+}  // namespace profiling
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_PROFILING_SAMPLING_PROFILER_H_
@@ -0,0 +1,80 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+// Measures the overhead SamplingProfiler adds to each invoke, i.e. the time
+// the events of an invoke of 'num_ops' operators take to be reported, for a
+// few sampling periods, e.g.
+//
+//   sampling_profiler_benchmark --benchmark_filter='/ops:64/'
+//
+// The time per invoke divided by the latency of the model is the overhead.
+// 'period:1' times every invoke, which is the cost of a sampled invoke.
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"  // from @com_google_benchmark
+#include "core/api/profiler.h"
+#include "profiling/sampling_profiler.h"
+
+namespace tflite {
+namespace profiling {
+namespace {
+
+using EventType = Profiler::EventType;
+
+// Reports the events of an invoke like the interpreter does.
+void Invoke(Profiler* profiler, const std::vector<std::string>& op_names) {
+  const uint32_t invoke = profiler->BeginEvent(
+      "invoke", EventType::GENERAL_RUNTIME_INSTRUMENTATION_EVENT, -1, 0);
+  const uint32_t subgraph_invoke =
+      profiler->BeginEvent("Invoke", EventType::DEFAULT, 0, 0);
+  for (int i = 0; i < static_cast<int>(op_names.size()); ++i) {
+    profiler->EndEvent(profiler->BeginEvent(
+        op_names[i].c_str(), EventType::OPERATOR_INVOKE_EVENT, i,
+        /*subgraph=*/0));
+  }
+  profiler->EndEvent(subgraph_invoke);
+  profiler->EndEvent(invoke);
+}
+
+void BM_SamplingProfilerInvoke(benchmark::State& state) {
+  SamplingProfiler::Options options;
+  options.sampling_period = static_cast<uint32_t>(state.range(0));
+  // Large enough for the background aggregation to keep up, as the dropped
+  // events would be cheaper than the recorded ones.
+  options.ring_buffer_size = 1 << 16;
+  options.aggregation_interval_ms = 1;
+  SamplingProfiler profiler(options);
+  std::vector<std::string> op_names;
+  for (int i = 0; i < state.range(1); ++i) {
+    op_names.push_back("OP_" + std::to_string(i));
+  }
+  for (auto _ : state) {
+    Invoke(&profiler, op_names);
+  }
+  state.counters["events_per_invoke"] = op_names.size() + 2;
+  state.counters["dropped_events"] = profiler.NumDroppedEvents();
+}
+
+BENCHMARK(BM_SamplingProfilerInvoke)
+    ->ArgNames({"period", "ops"})
+    ->ArgsProduct({{1, 100}, {8, 64, 512}});
+
+}  // namespace
+}  // namespace profiling
+}  // namespace tflite
+
+BENCHMARK_MAIN();
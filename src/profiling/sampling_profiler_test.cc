@@ -0,0 +1,205 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "profiling/sampling_profiler.h"
+
+#include <chrono>  // NOLINT(build/c++11)
+#include <cstdint>
+#include <string>
+#include <thread>  // NOLINT(build/c++11)
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "core/api/profiler.h"
+
+namespace tflite {
+namespace profiling {
+
+namespace {
+
+using EventType = Profiler::EventType;
+
+// Reports an invoke of 'num_ops' operators, with a nested subgraph invoke
+// event like the interpreter does.
+void Invoke(Profiler* profiler, int num_ops) {
+  const uint32_t invoke = profiler->BeginEvent(
+      "invoke", EventType::GENERAL_RUNTIME_INSTRUMENTATION_EVENT, -1, 0);
+  const uint32_t subgraph_invoke =
+      profiler->BeginEvent("Invoke", EventType::DEFAULT, 0, 0);
+  for (int i = 0; i < num_ops; ++i) {
+    std::string tag = "OP_" + std::to_string(i);
+    profiler->EndEvent(profiler->BeginEvent(
+        tag.c_str(), EventType::OPERATOR_INVOKE_EVENT, i, /*subgraph=*/0));
+  }
+  profiler->EndEvent(subgraph_invoke);
+  profiler->EndEvent(invoke);
+}
+
+const OpLatencyStats* FindStats(const std::vector<OpLatencyStats>& stats,
+                                const std::string& tag) {
+  for (const OpLatencyStats& op_stats : stats) {
+    if (op_stats.tag == tag) return &op_stats;
+  }
+  return nullptr;
+}
+
+TEST(LatencyHistogramTest, Percentiles) {
+  LatencyHistogram histogram;
+  EXPECT_EQ(histogram.Percentile(50), 0);
+  for (uint64_t latency_us : {0, 1, 3, 5, 100, 1000}) {
+    histogram.Add(latency_us);
+  }
+  EXPECT_EQ(histogram.count, 6);
+  EXPECT_EQ(histogram.sum_us, 1109);
+  EXPECT_EQ(histogram.min_us, 0);
+  EXPECT_EQ(histogram.max_us, 1000);
+  EXPECT_EQ(histogram.bucket_counts[0], 1);
+  EXPECT_EQ(histogram.bucket_counts[1], 1);
+  EXPECT_EQ(histogram.bucket_counts[2], 1);
+  EXPECT_EQ(histogram.bucket_counts[3], 1);
+  EXPECT_EQ(histogram.Percentile(50), 3);
+  EXPECT_EQ(histogram.Percentile(60), 7);
+  EXPECT_EQ(histogram.Percentile(100), 1000);
+
+  LatencyHistogram other;
+  other.Add(2000);
+  histogram.Merge(other);
+  EXPECT_EQ(histogram.count, 7);
+  EXPECT_EQ(histogram.max_us, 2000);
+}
+
+TEST(SamplingProfilerTest, SamplesOneInvokeInN) {
+  SamplingProfiler::Options options;
+  options.sampling_period = 4;
+  SamplingProfiler profiler(options);
+  for (int i = 0; i < 10; ++i) {
+    Invoke(&profiler, /*num_ops=*/3);
+  }
+
+  // Invokes 0, 4 and 8 are sampled.
+  const std::vector<OpLatencyStats> stats = profiler.GetOpLatencyStats();
+  ASSERT_EQ(stats.size(), 4);
+  const OpLatencyStats* invoke = FindStats(stats, "invoke");
+  ASSERT_NE(invoke, nullptr);
+  EXPECT_EQ(invoke->histogram.count, 3);
+  const OpLatencyStats* op = FindStats(stats, "OP_2");
+  ASSERT_NE(op, nullptr);
+  EXPECT_EQ(op->event_type, EventType::OPERATOR_INVOKE_EVENT);
+  EXPECT_EQ(op->node_index, 2);
+  EXPECT_EQ(op->subgraph_index, 0);
+  EXPECT_EQ(op->histogram.count, 3);
+  EXPECT_EQ(FindStats(stats, "Invoke"), nullptr);
+  EXPECT_EQ(profiler.NumDroppedEvents(), 0);
+
+  profiler.ResetStats();
+  EXPECT_TRUE(profiler.GetOpLatencyStats().empty());
+}
+
+TEST(SamplingProfilerTest, RecordsAddedDelegateEvents) {
+  SamplingProfiler::Options options;
+  options.sampling_period = 1;
+  SamplingProfiler profiler(options);
+  // Events added outside of an invoke are ignored.
+  profiler.AddEvent("Convolution", EventType::DELEGATE_OPERATOR_INVOKE_EVENT,
+                    10, 0, 0);
+  const uint32_t invoke = profiler.BeginEvent(
+      "invoke", EventType::GENERAL_RUNTIME_INSTRUMENTATION_EVENT, -1, 0);
+  {
+    // The tag doesn't need to outlive the call.
+    std::string tag = "Convolution";
+    profiler.AddEvent(tag.c_str(), EventType::DELEGATE_OPERATOR_INVOKE_EVENT,
+                      /*elapsed_time=*/10, 0, 0);
+  }
+  profiler.EndEvent(invoke);
+
+  const std::vector<OpLatencyStats> stats = profiler.GetOpLatencyStats();
+  const OpLatencyStats* convolution = FindStats(stats, "Convolution");
+  ASSERT_NE(convolution, nullptr);
+  EXPECT_EQ(convolution->histogram.count, 1);
+  EXPECT_EQ(convolution->histogram.sum_us, 10);
+}
+
+TEST(SamplingProfilerTest, DropsEventsWhenRingBufferIsFull) {
+  SamplingProfiler::Options options;
+  options.sampling_period = 1;
+  options.ring_buffer_size = 4;
+  SamplingProfiler profiler(options);
+  Invoke(&profiler, /*num_ops=*/5);
+
+  // The 5 ops fill the buffer before the invoke ends.
+  EXPECT_EQ(profiler.NumDroppedEvents(), 2);
+  const std::vector<OpLatencyStats> stats = profiler.GetOpLatencyStats();
+  EXPECT_EQ(stats.size(), 4);
+  EXPECT_EQ(FindStats(stats, "invoke"), nullptr);
+
+  // Aggregating frees the buffer.
+  Invoke(&profiler, /*num_ops=*/1);
+  EXPECT_NE(FindStats(profiler.GetOpLatencyStats(), "invoke"), nullptr);
+}
+
+TEST(SamplingProfilerTest, KeepsTheEventsOfExitedThreads) {
+  SamplingProfiler::Options options;
+  options.sampling_period = 1;
+  options.ring_buffer_size = 4;
+  SamplingProfiler profiler(options);
+  // The buffer of the thread is handed over when it exits.
+  std::thread([&profiler]() { Invoke(&profiler, /*num_ops=*/5); }).join();
+  EXPECT_EQ(profiler.NumDroppedEvents(), 2);
+
+  // Aggregating frees the buffer, but keeps its events and dropped count.
+  std::vector<OpLatencyStats> stats = profiler.GetOpLatencyStats();
+  EXPECT_EQ(stats.size(), 4);
+  EXPECT_EQ(profiler.NumDroppedEvents(), 2);
+
+  std::thread([&profiler]() { Invoke(&profiler, /*num_ops=*/1); }).join();
+  stats = profiler.GetOpLatencyStats();
+  const OpLatencyStats* op = FindStats(stats, "OP_0");
+  ASSERT_NE(op, nullptr);
+  EXPECT_EQ(op->histogram.count, 2);
+  EXPECT_NE(FindStats(stats, "invoke"), nullptr);
+}
+
+TEST(SamplingProfilerTest, AggregatesThreadsInTheBackground) {
+  SamplingProfiler::Options options;
+  options.sampling_period = 2;
+  // Without the background aggregation, each thread would buffer 300 events.
+  options.ring_buffer_size = 256;
+  options.aggregation_interval_ms = 1;
+  SamplingProfiler profiler(options);
+  constexpr int kNumThreads = 4;
+  constexpr int kNumInvokes = 200;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kNumThreads; ++i) {
+    threads.emplace_back([&profiler]() {
+      for (int j = 0; j < kNumInvokes; ++j) {
+        Invoke(&profiler, /*num_ops=*/2);
+        // Leaves time to the background aggregation.
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  const std::vector<OpLatencyStats> stats = profiler.GetOpLatencyStats();
+  const OpLatencyStats* invoke = FindStats(stats, "invoke");
+  ASSERT_NE(invoke, nullptr);
+  EXPECT_EQ(invoke->histogram.count, kNumThreads * kNumInvokes / 2);
+  EXPECT_EQ(profiler.NumDroppedEvents(), 0);
+}
+
+}  // namespace
+}  // namespace profiling
+}  // namespace tflite
@@ -0,0 +1,191 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "profiling/startup_time_summarizer.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "profiling/summarizer_util.h"
+
+namespace tflite {
+namespace profiling {
+namespace {
+
+constexpr char kOpPrepareTag[] = "OpPrepare";
+constexpr char kInvokeTag[] = "Invoke";
+
+// A phase and its children, before they're flattened.
+struct PhaseNode {
+  std::string tag;
+  StartupPhase phase;
+  std::vector<int> children;
+};
+
+// A phase whose children are still being recorded.
+struct OpenPhase {
+  uint64_t end_us;
+  int node;
+};
+
+void Flatten(const std::vector<PhaseNode>& nodes,
+             const std::vector<int>& indices,
+             std::vector<StartupPhase>* phases) {
+  for (int index : indices) {
+    phases->push_back(nodes[index].phase);
+    Flatten(nodes, nodes[index].children, phases);
+  }
+}
+
+}  // namespace
+
+void StartupTimeSummarizer::ProcessProfiles(
+    const std::vector<const ProfileEvent*>& events,
+    const tflite::Interpreter* interpreter) {
+  std::vector<PhaseNode> nodes;
+  std::vector<int> roots;
+  std::vector<OpenPhase> open_phases;
+  std::map<std::pair<int64_t, int64_t>, OpPrepareCost> op_prepare_costs;
+  bool invoked = false;
+  uint64_t invoke_end_us = 0;
+
+  for (const ProfileEvent* event : events) {
+    if (event->event_type != Profiler::EventType::DEFAULT) continue;
+    const uint64_t begin_us = event->begin_timestamp_us;
+    const uint64_t end_us = begin_us + event->elapsed_time;
+    if (invoked && begin_us >= invoke_end_us) break;
+
+    while (!open_phases.empty() && (begin_us >= open_phases.back().end_us ||
+                                    end_us > open_phases.back().end_us)) {
+      open_phases.pop_back();
+    }
+
+    if (event->tag == kOpPrepareTag) {
+      OpPrepareCost& cost = op_prepare_costs[{event->extra_event_metadata,
+                                              event->event_metadata}];
+      cost.subgraph_index = event->extra_event_metadata;
+      cost.node_index = event->event_metadata;
+      cost.count++;
+      cost.elapsed_us += event->elapsed_time;
+      continue;
+    }
+    if (std::any_of(open_phases.begin(), open_phases.end(),
+                    [&nodes, event](const OpenPhase& open_phase) {
+                      return nodes[open_phase.node].tag == event->tag;
+                    })) {
+      continue;
+    }
+
+    const int parent = open_phases.empty() ? -1 : open_phases.back().node;
+    if (parent < 0 && event->tag == kInvokeTag) {
+      invoked = true;
+      invoke_end_us = end_us;
+    }
+    const std::vector<int>& siblings =
+        parent < 0 ? roots : nodes[parent].children;
+    auto sibling = std::find_if(
+        siblings.begin(), siblings.end(),
+        [&nodes, event](int node) { return nodes[node].tag == event->tag; });
+    int node;
+    if (sibling != siblings.end()) {
+      node = *sibling;
+    } else {
+      node = nodes.size();
+      PhaseNode phase_node;
+      phase_node.tag = event->tag;
+      phase_node.phase.name =
+          event->tag == kInvokeTag && parent < 0 ? "Invoke (first)"
+                                                 : event->tag;
+      phase_node.phase.depth = parent < 0 ? 0 : nodes[parent].phase.depth + 1;
+      nodes.push_back(std::move(phase_node));
+      (parent < 0 ? roots : nodes[parent].children).push_back(node);
+    }
+    nodes[node].phase.count++;
+    nodes[node].phase.elapsed_us += event->elapsed_time;
+    open_phases.push_back({end_us, node});
+  }
+
+  phases_.clear();
+  Flatten(nodes, roots, &phases_);
+
+  op_prepare_costs_.clear();
+  for (auto& op_and_cost : op_prepare_costs) {
+    OpPrepareCost& cost = op_and_cost.second;
+    cost.op_name =
+        GetOpName(interpreter, cost.subgraph_index, cost.node_index);
+    op_prepare_costs_.push_back(std::move(cost));
+  }
+  std::stable_sort(op_prepare_costs_.begin(), op_prepare_costs_.end(),
+                   [](const OpPrepareCost& a, const OpPrepareCost& b) {
+                     return a.elapsed_us > b.elapsed_us;
+                   });
+}
+
+uint64_t StartupTimeSummarizer::GetTotalUs() const {
+  uint64_t total_us = 0;
+  for (const StartupPhase& phase : phases_) {
+    if (phase.depth == 0) total_us += phase.elapsed_us;
+  }
+  return total_us;
+}
+
+std::string StartupTimeSummarizer::GetOutputString(int max_num_ops) const {
+  constexpr int kColumnWidth = 12;
+  const uint64_t total_us = GetTotalUs();
+  std::stringstream stream;
+  stream << "============================== Startup time breakdown "
+            "=============================="
+         << std::endl;
+  WriteRow({"[ms]", "[% of total]", "[count]", "[phase]"}, kColumnWidth,
+           &stream);
+  for (const StartupPhase& phase : phases_) {
+    WriteRow({FormatDouble(phase.elapsed_us * 1e-3, 3),
+              total_us > 0
+                  ? FormatDouble(100.0 * phase.elapsed_us / total_us, 2) + "%"
+                  : "n/a",
+              std::to_string(phase.count),
+              std::string(2 * phase.depth, ' ') + phase.name},
+             kColumnWidth, &stream);
+  }
+  WriteRow({FormatDouble(total_us * 1e-3, 3), "100.00%", "", "Total"},
+           kColumnWidth, &stream);
+
+  if (op_prepare_costs_.empty() || max_num_ops <= 0) {
+    return stream.str();
+  }
+  stream << std::endl
+         << "============================== Top operators by prepare time "
+            "=============================="
+         << std::endl;
+  WriteRow({"[node type]", "[ms]", "[count]", "[subgraph]", "[node]"},
+           kColumnWidth, &stream);
+  const int num_ops =
+      std::min<int>(max_num_ops, static_cast<int>(op_prepare_costs_.size()));
+  for (int i = 0; i < num_ops; ++i) {
+    const OpPrepareCost& cost = op_prepare_costs_[i];
+    WriteRow({cost.op_name, FormatDouble(cost.elapsed_us * 1e-3, 3),
+              std::to_string(cost.count), std::to_string(cost.subgraph_index),
+              std::to_string(cost.node_index)},
+             kColumnWidth, &stream);
+  }
+  return stream.str();
+}
+
+}  // namespace profiling
+}  // namespace tflite
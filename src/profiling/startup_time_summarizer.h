@@ -0,0 +1,93 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_LITE_PROFILING_STARTUP_TIME_SUMMARIZER_H_
+#define TENSORFLOW_LITE_PROFILING_STARTUP_TIME_SUMMARIZER_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "core/interpreter.h"
+#include "profiling/profile_buffer.h"
+
+namespace tflite {
+namespace profiling {
+
+// The time spent in one phase of the startup, e.g. "AllocateTensors".
+struct StartupPhase {
+  std::string name;
+  // 0 for the top level phases, and one more than the enclosing phase for the
+  // others.
+  int depth = 0;
+  // The number of events merged into the phase, e.g. one per subgraph.
+  int count = 0;
+  uint64_t elapsed_us = 0;
+};
+
+// The time spent preparing one operator, summed over its OpPrepare calls.
+struct OpPrepareCost {
+  int64_t subgraph_index = 0;
+  int64_t node_index = 0;
+  // The builtin code or custom name of the operator, e.g. "CONV_2D".
+  std::string op_name;
+  int count = 0;
+  uint64_t elapsed_us = 0;
+};
+
+// Breaks the startup time of a model down into phases, from the DEFAULT events
+// recorded between the loading of the model and the end of its first invoke:
+// e.g. "LoadModel" and its "MapModelFile" and "VerifyAndBuildModel" steps, the
+// "ResolveOps" and "ParseSubgraphs" steps of building the interpreter, the
+// application of each delegate, "AllocateTensors" and the first "Invoke".
+//
+// Phases nest by time: an event is a child of the latest phase that encloses
+// it. Events enclosed by a phase of the same tag, e.g. the AllocateTensors of a
+// control flow subgraph, are part of it and aren't reported. Sibling events of
+// the same tag are merged. The events that begin after the first top level
+// "Invoke" are ignored. "OpPrepare" events, whose metadata are the node and
+// subgraph indices, are reported per operator instead.
+class StartupTimeSummarizer {
+ public:
+  // Processes 'events' in the order they began. 'interpreter' resolves the
+  // names of the prepared operators, and may be null.
+  void ProcessProfiles(const std::vector<const ProfileEvent*>& events,
+                       const tflite::Interpreter* interpreter);
+
+  // The phases in the order they began, each followed by its children.
+  const std::vector<StartupPhase>& phases() const { return phases_; }
+
+  // The costs of the prepared operators, most expensive first.
+  const std::vector<OpPrepareCost>& op_prepare_costs() const {
+    return op_prepare_costs_;
+  }
+
+  // Returns the sum of the top level phases.
+  uint64_t GetTotalUs() const;
+
+  bool HasProfiles() const { return !phases_.empty(); }
+
+  // Returns a table of the phases, w/ their share of the total, followed by
+  // the 'max_num_ops' most expensive operators to prepare.
+  std::string GetOutputString(int max_num_ops = 10) const;
+
+ private:
+  std::vector<StartupPhase> phases_;
+  std::vector<OpPrepareCost> op_prepare_costs_;
+};
+
+}  // namespace profiling
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_PROFILING_STARTUP_TIME_SUMMARIZER_H_
@@ -0,0 +1,141 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "profiling/startup_time_summarizer.h"
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+namespace tflite {
+namespace profiling {
+namespace {
+
+using ::testing::HasSubstr;
+
+class StartupTimeSummarizerTest : public ::testing::Test {
+ protected:
+  void AddEvent(const std::string& tag, uint64_t begin_us, uint64_t end_us,
+                int64_t event_metadata = 0, int64_t extra_event_metadata = 0,
+                Profiler::EventType event_type =
+                    Profiler::EventType::DEFAULT) {
+    ProfileEvent event = {};
+    event.tag = tag;
+    event.begin_timestamp_us = begin_us;
+    event.elapsed_time = end_us - begin_us;
+    event.event_type = event_type;
+    event.event_metadata = event_metadata;
+    event.extra_event_metadata = extra_event_metadata;
+    events_.push_back(event);
+  }
+
+  std::vector<const ProfileEvent*> GetEvents() const {
+    std::vector<const ProfileEvent*> events;
+    for (const ProfileEvent& event : events_) events.push_back(&event);
+    return events;
+  }
+
+  std::deque<ProfileEvent> events_;
+};
+
+TEST_F(StartupTimeSummarizerTest, NestsAndMergesPhases) {
+  AddEvent("LoadModel", 0, 100);
+  AddEvent("MapModelFile", 0, 10);
+  AddEvent("VerifyAndBuildModel", 10, 100);
+  AddEvent("BuildInterpreter", 100, 200);
+  AddEvent("ResolveOps", 100, 120);
+  AddEvent("ParseSubgraphs", 120, 200);
+  AddEvent("AllocateTensors", 200, 300);
+  // The allocation of a control flow subgraph is part of the outer one.
+  AddEvent("AllocateTensors", 250, 260, 0, 1);
+  AddEvent("Invoke", 300, 400);
+  AddEvent("SimpleOp", 310, 320, 0, 0,
+           Profiler::EventType::OPERATOR_INVOKE_EVENT);
+  AddEvent("Invoke", 320, 330, 0, 1);
+  // Only the first invoke is reported.
+  AddEvent("Invoke", 400, 500);
+
+  StartupTimeSummarizer summarizer;
+  summarizer.ProcessProfiles(GetEvents(), /*interpreter=*/nullptr);
+
+  const std::vector<StartupPhase>& phases = summarizer.phases();
+  ASSERT_EQ(phases.size(), 8);
+  EXPECT_EQ(phases[0].name, "LoadModel");
+  EXPECT_EQ(phases[0].depth, 0);
+  EXPECT_EQ(phases[0].elapsed_us, 100);
+  EXPECT_EQ(phases[1].name, "MapModelFile");
+  EXPECT_EQ(phases[1].depth, 1);
+  EXPECT_EQ(phases[2].name, "VerifyAndBuildModel");
+  EXPECT_EQ(phases[2].depth, 1);
+  EXPECT_EQ(phases[3].name, "BuildInterpreter");
+  EXPECT_EQ(phases[4].name, "ResolveOps");
+  EXPECT_EQ(phases[5].name, "ParseSubgraphs");
+  EXPECT_EQ(phases[6].name, "AllocateTensors");
+  EXPECT_EQ(phases[6].depth, 0);
+  EXPECT_EQ(phases[6].count, 1);
+  EXPECT_EQ(phases[7].name, "Invoke (first)");
+  EXPECT_EQ(phases[7].elapsed_us, 100);
+  EXPECT_EQ(summarizer.GetTotalUs(), 400);
+}
+
+TEST_F(StartupTimeSummarizerTest, MergesSiblingsOfTheSameTag) {
+  AddEvent("ApplyDelegate/XNNPACK", 0, 100);
+  AddEvent("ModifyGraphWithDelegate", 0, 40);
+  AddEvent("ModifyGraphWithDelegate", 40, 90, 0, 1);
+
+  StartupTimeSummarizer summarizer;
+  summarizer.ProcessProfiles(GetEvents(), /*interpreter=*/nullptr);
+
+  const std::vector<StartupPhase>& phases = summarizer.phases();
+  ASSERT_EQ(phases.size(), 2);
+  EXPECT_EQ(phases[1].name, "ModifyGraphWithDelegate");
+  EXPECT_EQ(phases[1].count, 2);
+  EXPECT_EQ(phases[1].elapsed_us, 90);
+}
+
+TEST_F(StartupTimeSummarizerTest, SumsOpPrepareCostsPerNode) {
+  AddEvent("AllocateTensors", 0, 100);
+  AddEvent("OpPrepare", 0, 10, /*node_index=*/0);
+  AddEvent("OpPrepare", 10, 60, /*node_index=*/1);
+  AddEvent("OpPrepare", 60, 80, /*node_index=*/0);
+  AddEvent("OpPrepare", 80, 85, /*node_index=*/0, /*subgraph_index=*/1);
+
+  StartupTimeSummarizer summarizer;
+  summarizer.ProcessProfiles(GetEvents(), /*interpreter=*/nullptr);
+
+  ASSERT_EQ(summarizer.phases().size(), 1);
+  const std::vector<OpPrepareCost>& costs = summarizer.op_prepare_costs();
+  ASSERT_EQ(costs.size(), 3);
+  EXPECT_EQ(costs[0].node_index, 1);
+  EXPECT_EQ(costs[0].elapsed_us, 50);
+  EXPECT_EQ(costs[1].node_index, 0);
+  EXPECT_EQ(costs[1].subgraph_index, 0);
+  EXPECT_EQ(costs[1].count, 2);
+  EXPECT_EQ(costs[1].elapsed_us, 30);
+  EXPECT_EQ(costs[2].subgraph_index, 1);
+  EXPECT_EQ(costs[2].op_name, "Unknown");
+
+  const std::string output = summarizer.GetOutputString(/*max_num_ops=*/2);
+  EXPECT_THAT(output, HasSubstr("Startup time breakdown"));
+  EXPECT_THAT(output, HasSubstr("AllocateTensors"));
+  EXPECT_THAT(output, HasSubstr("Top operators by prepare time"));
+}
+
+}  // namespace
+}  // namespace profiling
+}  // namespace tflite
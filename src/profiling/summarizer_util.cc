@@ -0,0 +1,66 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "profiling/summarizer_util.h"
+
+#include <cstdint>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "schema/schema_generated.h"
+
+namespace tflite {
+namespace profiling {
+
+std::string GetOpName(const tflite::Interpreter* interpreter,
+                      int64_t subgraph_index, int64_t node_index) {
+  if (interpreter == nullptr || subgraph_index < 0 ||
+      subgraph_index >= static_cast<int64_t>(interpreter->subgraphs_size())) {
+    return "Unknown";
+  }
+  const Subgraph* subgraph =
+      const_cast<tflite::Interpreter*>(interpreter)->subgraph(subgraph_index);
+  if (node_index < 0 ||
+      node_index >= static_cast<int64_t>(subgraph->nodes_size())) {
+    return "Unknown";
+  }
+  const TfLiteRegistration& registration =
+      subgraph->node_and_registration(node_index)->second;
+  if (registration.builtin_code == BuiltinOperator_CUSTOM ||
+      registration.builtin_code == BuiltinOperator_DELEGATE) {
+    return registration.custom_name ? registration.custom_name
+                                    : "UnknownCustomOp";
+  }
+  return EnumNameBuiltinOperator(
+      static_cast<BuiltinOperator>(registration.builtin_code));
+}
+
+std::string FormatDouble(double value, int precision) {
+  std::stringstream stream;
+  stream << std::fixed << std::setprecision(precision) << value;
+  return stream.str();
+}
+
+void WriteRow(const std::vector<std::string>& row, int column_width,
+              std::stringstream* stream) {
+  for (size_t i = 0; i + 1 < row.size(); ++i) {
+    (*stream) << std::setw(column_width) << row[i] << "\t";
+  }
+  (*stream) << row.back() << std::endl;
+}
+
+}  // namespace profiling
+}  // namespace tflite
@@ -0,0 +1,44 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_LITE_PROFILING_SUMMARIZER_UTIL_H_
+#define TENSORFLOW_LITE_PROFILING_SUMMARIZER_UTIL_H_
+
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "core/interpreter.h"
+
+namespace tflite {
+namespace profiling {
+
+// Returns the builtin code or custom name of the operator of node
+// 'node_index' of subgraph 'subgraph_index', e.g. "CONV_2D", or "Unknown" if
+// 'interpreter' is null or has no such node.
+std::string GetOpName(const tflite::Interpreter* interpreter,
+                      int64_t subgraph_index, int64_t node_index);
+
+// Returns 'value' w/ 'precision' digits after the decimal point.
+std::string FormatDouble(double value, int precision);
+
+// Writes 'row' as tab separated columns of 'column_width', except the last.
+void WriteRow(const std::vector<std::string>& row, int column_width,
+              std::stringstream* stream);
+
+}  // namespace profiling
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_PROFILING_SUMMARIZER_UTIL_H_
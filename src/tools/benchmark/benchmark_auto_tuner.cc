@@ -0,0 +1,426 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tools/benchmark/benchmark_auto_tuner.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <thread>  // NOLINT(build/c++11)
+#include <utility>
+#include <vector>
+
+#include "core/c/c_api_types.h"
+#include "tools/benchmark/benchmark_params.h"
+#include "tools/benchmark/benchmark_utils.h"
+#include "tools/command_line_flags.h"
+#include "tools/logging.h"
+
+namespace tflite {
+namespace benchmark {
+namespace {
+
+// Records the average inference latency of each benchmark run.
+class LatencyListener : public BenchmarkListener {
+ public:
+  explicit LatencyListener(double* latency_us) : latency_us_(latency_us) {}
+
+  void OnBenchmarkEnd(const BenchmarkResults& results) override {
+    *latency_us_ = results.inference_time_us().avg();
+  }
+
+ private:
+  double* const latency_us_;  // Not own the memory.
+};
+
+int NumCpus() {
+  return std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+}
+
+// Returns the settings of 'candidate' as cmdline flags, one per element.
+std::vector<std::string> ToFlags(const TunerCandidate& candidate,
+                                 bool has_xnnpack) {
+  std::vector<std::string> flags = {
+      "--num_threads=" + std::to_string(candidate.num_threads),
+      "--cpu_affinity=" + candidate.cpu_affinity};
+  if (has_xnnpack) {
+    flags.push_back(std::string("--use_xnnpack=") +
+                    (candidate.use_xnnpack ? "true" : "false"));
+  }
+  flags.push_back(std::string("--use_caching=") +
+                  (candidate.use_caching ? "true" : "false"));
+  return flags;
+}
+
+}  // namespace
+
+std::string TunerCandidate::ToString() const {
+  std::stringstream sstm;
+  sstm << num_threads << (num_threads == 1 ? " thread" : " threads") << " on "
+       << cpu_affinity;
+  if (use_xnnpack) sstm << " w/ xnnpack";
+  if (use_caching) sstm << " w/ caching";
+  return sstm.str();
+}
+
+std::vector<int> SelectSurvivors(const std::vector<TunerCandidate>& candidates,
+                                 const std::vector<int>& indices) {
+  std::vector<int> survivors;
+  for (const int index : indices) {
+    if (candidates[index].latency_us >= 0) survivors.push_back(index);
+  }
+  std::stable_sort(survivors.begin(), survivors.end(),
+                   [&candidates](int a, int b) {
+                     return candidates[a].latency_us < candidates[b].latency_us;
+                   });
+  survivors.resize((survivors.size() + 1) / 2);
+  return survivors;
+}
+
+std::vector<int> GetParetoFront(const std::vector<TunerCandidate>& candidates) {
+  std::vector<int> measured;
+  for (int i = 0; i < static_cast<int>(candidates.size()); ++i) {
+    if (candidates[i].latency_us >= 0) measured.push_back(i);
+  }
+  std::stable_sort(measured.begin(), measured.end(),
+                   [&candidates](int a, int b) {
+                     const TunerCandidate& x = candidates[a];
+                     const TunerCandidate& y = candidates[b];
+                     if (x.num_cores != y.num_cores) {
+                       return x.num_cores < y.num_cores;
+                     }
+                     return x.latency_us < y.latency_us;
+                   });
+  // Sweeping in the order of cores used, a candidate is on the front iff it's
+  // faster than every candidate using fewer cores.
+  std::vector<int> front;
+  for (const int index : measured) {
+    if (front.empty() ||
+        candidates[index].latency_us < candidates[front.back()].latency_us) {
+      front.push_back(index);
+    }
+  }
+  return front;
+}
+
+std::vector<std::vector<int>> GetCpuClusters() {
+  std::map<int64_t, std::vector<int>> cpus_by_max_freq;
+  for (int cpu = 0; cpu < NumCpus(); ++cpu) {
+    std::ifstream file("/sys/devices/system/cpu/cpu" + std::to_string(cpu) +
+                       "/cpufreq/cpuinfo_max_freq");
+    int64_t max_freq_khz = 0;
+    if (!(file >> max_freq_khz)) return {};
+    cpus_by_max_freq[max_freq_khz].push_back(cpu);
+  }
+  if (cpus_by_max_freq.size() < 2) return {};
+
+  std::vector<std::vector<int>> clusters;
+  for (auto& entry : cpus_by_max_freq) {
+    clusters.push_back(std::move(entry.second));
+  }
+  return clusters;
+}
+
+BenchmarkAutoTuner::BenchmarkAutoTuner(BenchmarkModel* benchmark)
+    : params_(DefaultParams()),
+      benchmark_(benchmark),
+      benchmark_params_(benchmark->mutable_params()),
+      latency_listener_(std::make_unique<LatencyListener>(&last_latency_us_)) {
+  benchmark_->AddListener(latency_listener_.get());
+}
+
+BenchmarkParams BenchmarkAutoTuner::DefaultParams() {
+  BenchmarkParams params;
+  params.AddParam("tuner_output_file", BenchmarkParam::Create<std::string>(""));
+  params.AddParam("tuner_num_threads", BenchmarkParam::Create<std::string>(""));
+  params.AddParam("tuner_cpu_affinities",
+                  BenchmarkParam::Create<std::string>(""));
+  params.AddParam("tuner_initial_runs", BenchmarkParam::Create<int32_t>(5));
+  params.AddParam("tuner_run_delay", BenchmarkParam::Create<float>(-1.0f));
+  return params;
+}
+
+std::vector<Flag> BenchmarkAutoTuner::GetFlags() {
+  return {
+      CreateFlag<std::string>(
+          "tuner_output_file", &params_,
+          "The file to write the best settings to, one flag per line, to be "
+          "passed to benchmark_model via --settings_file. The Pareto front of "
+          "latency vs. cores used is appended as comments."),
+      CreateFlag<std::string>(
+          "tuner_num_threads", &params_,
+          "A comma-separated list of thread counts to search. By default, the "
+          "powers of two up to the number of CPUs, and that number."),
+      CreateFlag<std::string>(
+          "tuner_cpu_affinities", &params_,
+          "A semicolon-separated list of CPU lists to search, each in the "
+          "`taskset -c` format, e.g. '0-7;4-7'. By default, all the CPUs and "
+          "each cluster of CPUs with the same maximum frequency."),
+      CreateFlag<int32_t>(
+          "tuner_initial_runs", &params_,
+          "The number of runs each candidate is measured with in the first "
+          "round of the search. Each following round keeps the faster half of "
+          "the candidates and doubles the number of runs."),
+      CreateFlag<float>("tuner_run_delay", &params_,
+                        "The delay between two consecutive candidate runs in "
+                        "seconds, e.g. to let the device cool down.")};
+}
+
+TfLiteStatus BenchmarkAutoTuner::ParseFlags(int* argc, char** argv) {
+  auto flag_list = GetFlags();
+  const bool parse_result =
+      Flags::Parse(argc, const_cast<const char**>(argv), flag_list);
+  if (!parse_result) {
+    std::string usage = Flags::Usage(argv[0], flag_list);
+    TFLITE_LOG(ERROR) << usage;
+    return kTfLiteError;
+  }
+  if (params_.Get<int32_t>("tuner_initial_runs") <= 0) {
+    TFLITE_LOG(ERROR) << "--tuner_initial_runs must be positive.";
+    return kTfLiteError;
+  }
+  return kTfLiteOk;
+}
+
+TfLiteStatus BenchmarkAutoTuner::CreateCandidates() {
+  candidates_.clear();
+  const int num_cpus = NumCpus();
+
+  std::vector<int> thread_counts;
+  const auto& num_threads_list = params_.Get<std::string>("tuner_num_threads");
+  if (num_threads_list.empty()) {
+    for (int count = 1; count < num_cpus; count *= 2) {
+      thread_counts.push_back(count);
+    }
+    thread_counts.push_back(num_cpus);
+  } else if (!util::SplitAndParse(num_threads_list, ',', &thread_counts) ||
+             std::any_of(thread_counts.begin(), thread_counts.end(),
+                         [](int count) { return count <= 0; })) {
+    TFLITE_LOG(ERROR) << "Cannot parse --tuner_num_threads: '"
+                      << num_threads_list
+                      << "'. Please double-check its value.";
+    return kTfLiteError;
+  }
+
+  std::vector<std::vector<int>> affinities;
+  const auto& affinity_list = params_.Get<std::string>("tuner_cpu_affinities");
+  if (affinity_list.empty()) {
+    std::vector<int> all_cpus(num_cpus);
+    std::iota(all_cpus.begin(), all_cpus.end(), 0);
+    affinities.push_back(std::move(all_cpus));
+    for (auto& cluster : GetCpuClusters()) {
+      affinities.push_back(std::move(cluster));
+    }
+  } else {
+    std::vector<std::string> cpu_lists;
+    util::SplitAndParse(affinity_list, ';', &cpu_lists);
+    for (const auto& cpu_list : cpu_lists) {
+      std::vector<int> cpus;
+      if (!util::ParseCpuList(cpu_list, &cpus)) {
+        TFLITE_LOG(ERROR) << "Cannot parse --tuner_cpu_affinities: '"
+                          << affinity_list
+                          << "'. Please double-check its value.";
+        return kTfLiteError;
+      }
+      affinities.push_back(std::move(cpus));
+    }
+  }
+
+  // XNNPACK can only be searched when its delegate provider is linked in.
+  std::vector<bool> xnnpack_options = {false};
+  if (benchmark_params_->HasParam("use_xnnpack")) {
+    xnnpack_options.push_back(true);
+  }
+
+  for (const auto& cpus : affinities) {
+    for (const int num_threads : thread_counts) {
+      // Oversubscribing the CPUs only adds contention.
+      if (num_threads > static_cast<int>(cpus.size())) continue;
+      for (const bool use_xnnpack : xnnpack_options) {
+        for (const bool use_caching : {false, true}) {
+          TunerCandidate candidate;
+          candidate.num_threads = num_threads;
+          candidate.cpu_affinity = util::FormatCpuList(cpus);
+          candidate.use_xnnpack = use_xnnpack;
+          candidate.use_caching = use_caching;
+          candidate.num_cores = num_threads;
+          candidates_.push_back(std::move(candidate));
+        }
+      }
+    }
+  }
+
+  if (candidates_.empty()) {
+    TFLITE_LOG(ERROR) << "No candidate settings to search: every thread count "
+                         "exceeds the CPUs of every affinity.";
+    return kTfLiteError;
+  }
+  return kTfLiteOk;
+}
+
+void BenchmarkAutoTuner::MeasureCandidate(int num_runs,
+                                          TunerCandidate* candidate) {
+  BenchmarkParams params;
+  params.Merge(base_params_);
+  *benchmark_params_ = std::move(params);
+  // The number of runs is driven by the search rather than by time.
+  benchmark_params_->Set<int32_t>("num_runs", num_runs);
+  benchmark_params_->Set<float>("min_secs", 0.0f);
+  benchmark_params_->Set<int32_t>("num_threads", candidate->num_threads);
+  benchmark_params_->Set<std::string>("cpu_affinity", candidate->cpu_affinity);
+  benchmark_params_->Set<bool>("use_caching", candidate->use_caching);
+  if (benchmark_params_->HasParam("use_xnnpack")) {
+    benchmark_params_->Set<bool>("use_xnnpack", candidate->use_xnnpack);
+  }
+
+  util::SleepForSeconds(params_.Get<float>("tuner_run_delay"));
+  TFLITE_LOG(INFO) << "Measuring " << candidate->ToString() << " with "
+                   << num_runs << " runs.";
+  last_latency_us_ = -1.0;
+  const TfLiteStatus status = benchmark_->Run();
+  candidate->latency_us = status == kTfLiteOk ? last_latency_us_ : -1.0;
+  ++candidate->num_rounds;
+  if (status != kTfLiteOk) {
+    TFLITE_LOG(WARN) << "Failed to run " << candidate->ToString()
+                     << ", dropping it from the search.";
+  }
+}
+
+TfLiteStatus BenchmarkAutoTuner::WriteSettingsFile(
+    const TunerCandidate& best, const std::vector<int>& pareto_front) const {
+  const auto& path = params_.Get<std::string>("tuner_output_file");
+  if (path.empty()) return kTfLiteOk;
+
+  std::ofstream file(path);
+  if (!file.is_open()) {
+    TFLITE_LOG(ERROR) << "Failed to open the tuner output file: " << path;
+    return kTfLiteError;
+  }
+  const bool has_xnnpack = base_params_.HasParam("use_xnnpack");
+  file << "# Written by benchmark_auto_tuner";
+  if (base_params_.HasParam("graph")) {
+    file << " for " << base_params_.Get<std::string>("graph");
+  }
+  file << " on a host with " << NumCpus() << " CPUs.\n";
+  file << "# Average latency: " << best.latency_us << " us.\n";
+  for (const auto& flag : ToFlags(best, has_xnnpack)) file << flag << "\n";
+
+  file << "\n# Pareto front of latency vs. cores used:\n";
+  for (const int index : pareto_front) {
+    const TunerCandidate& candidate = candidates_[index];
+    file << "#   cores=" << candidate.num_cores
+         << " latency_us=" << candidate.latency_us << ":";
+    for (const auto& flag : ToFlags(candidate, has_xnnpack)) {
+      file << " " << flag;
+    }
+    file << "\n";
+  }
+  if (!file.good()) {
+    TFLITE_LOG(ERROR) << "Failed to write the tuner output file: " << path;
+    return kTfLiteError;
+  }
+  TFLITE_LOG(INFO) << "The best settings are written to " << path;
+  return kTfLiteOk;
+}
+
+TfLiteStatus BenchmarkAutoTuner::Run() {
+  TF_LITE_ENSURE_STATUS(CreateCandidates());
+  TFLITE_LOG(INFO) << "Searching " << candidates_.size()
+                   << " candidate settings.";
+
+  base_params_ = BenchmarkParams();
+  base_params_.Merge(*benchmark_params_);
+
+  // We need to clean *internally* created benchmark listeners, like the
+  // profiling listener etc. in each Run() invoke because such listeners may be
+  // reset and become invalid in the next Run().
+  const int num_external_listeners = benchmark_->NumListeners();
+
+  std::vector<int> alive(candidates_.size());
+  std::iota(alive.begin(), alive.end(), 0);
+  int best = -1;
+  for (int num_runs = params_.Get<int32_t>("tuner_initial_runs");;
+       num_runs *= 2) {
+    for (const int index : alive) {
+      benchmark_->RemoveListeners(num_external_listeners);
+      MeasureCandidate(num_runs, &candidates_[index]);
+    }
+    const std::vector<int> survivors = SelectSurvivors(candidates_, alive);
+    if (survivors.size() <= 1) {
+      if (!survivors.empty()) best = survivors.front();
+      break;
+    }
+    alive = survivors;
+  }
+
+  // Leave the params as they were before the search.
+  BenchmarkParams params;
+  params.Merge(base_params_);
+  *benchmark_params_ = std::move(params);
+
+  if (best < 0) {
+    TFLITE_LOG(ERROR) << "None of the candidate settings ran successfully.";
+    return kTfLiteError;
+  }
+
+  // Candidates dropped in early rounds carry their noisier early measurement.
+  const std::vector<int> pareto_front = GetParetoFront(candidates_);
+  TFLITE_LOG(INFO) << "\n==============Auto-Tuner Results==============";
+  TFLITE_LOG(INFO) << "Best: " << candidates_[best].ToString() << ": "
+                   << candidates_[best].latency_us << " us";
+  TFLITE_LOG(INFO) << "Pareto front of latency vs. cores used:";
+  for (const int index : pareto_front) {
+    std::stringstream stream;
+    stream << std::setw(4) << candidates_[index].num_cores << " cores: "
+           << std::setw(12) << candidates_[index].latency_us << " us ("
+           << candidates_[index].ToString() << ")";
+    TFLITE_LOG(INFO) << stream.str();
+  }
+  return WriteSettingsFile(candidates_[best], pareto_front);
+}
+
+TfLiteStatus BenchmarkAutoTuner::Run(int argc, char** argv) {
+  // Parse flags that are supported by this particular binary first.
+  if (TfLiteStatus status = ParseFlags(&argc, argv); status != kTfLiteOk) {
+    TFLITE_LOG(ERROR) << "Error while parsing the flags for the auto-tuner: "
+                      << status;
+    return status;
+  }
+
+  // Then parse flags for single runs to get information like parameters of
+  // the input model etc.
+  if (TfLiteStatus status = benchmark_->ParseFlags(&argc, argv);
+      status != kTfLiteOk) {
+    TFLITE_LOG(ERROR) << "Error while parsing the flags for single runs: "
+                      << status;
+    return status;
+  }
+
+  // Now, the remaining are unrecognized flags and we simply print them out.
+  for (int i = 1; i < argc; ++i) {
+    TFLITE_LOG(WARN) << "WARNING: unrecognized commandline flag: " << argv[i];
+  }
+
+  return Run();
+}
+
+}  // namespace benchmark
+}  // namespace tflite
@@ -0,0 +1,126 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_LITE_TOOLS_BENCHMARK_BENCHMARK_AUTO_TUNER_H_
+#define TENSORFLOW_LITE_TOOLS_BENCHMARK_BENCHMARK_AUTO_TUNER_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/c/c_api_types.h"
+#include "tools/benchmark/benchmark_model.h"
+#include "tools/benchmark/benchmark_params.h"
+
+namespace tflite {
+namespace benchmark {
+
+// A point of the searched space of runtime settings.
+struct TunerCandidate {
+  int32_t num_threads = 1;
+  // The CPUs to run on, in the `taskset -c` format.
+  std::string cpu_affinity;
+  bool use_xnnpack = false;
+  bool use_caching = false;
+
+  // The number of cores the candidate keeps busy, i.e. the smaller of
+  // 'num_threads' and the number of CPUs in 'cpu_affinity'.
+  int num_cores = 1;
+  // The average inference latency of the latest measurement, or a negative
+  // value if the candidate hasn't been measured or failed to run.
+  double latency_us = -1.0;
+  // The number of rounds of the search the candidate was measured in.
+  int num_rounds = 0;
+
+  // Returns a short human readable description, e.g. "4 threads on 4-7 w/
+  // xnnpack".
+  std::string ToString() const;
+};
+
+// Returns the indices, among 'indices', of the candidates that successive
+// halving keeps for the next round: the faster half, rounded up, of those that
+// ran successfully, sorted by latency.
+std::vector<int> SelectSurvivors(const std::vector<TunerCandidate>& candidates,
+                                 const std::vector<int>& indices);
+
+// Returns the indices of the successfully measured candidates on the Pareto
+// front of latency vs. cores used, i.e. those that no other candidate beats on
+// latency without using more cores, sorted by the number of cores.
+std::vector<int> GetParetoFront(const std::vector<TunerCandidate>& candidates);
+
+// Groups the CPUs by their maximum frequency, slowest first, to find the
+// clusters of heterogeneous (e.g. big.LITTLE) SoCs. Returns an empty list if
+// the frequencies can't be read or all the CPUs are alike.
+std::vector<std::vector<int>> GetCpuClusters();
+
+// Searches the runtime settings - number of threads, CPU affinity, XNNPACK and
+// weight caching - for the fastest configuration of a model on this host by
+// repeatedly invoking a passed-in 'BenchmarkModel' object. The search uses
+// successive halving: all candidates are first measured with few runs, then
+// the faster half is measured again with twice as many runs, until one
+// candidate remains. The winner is written as a settings file that
+// benchmark_model and other tools accept via --settings_file.
+class BenchmarkAutoTuner {
+ public:
+  // Doesn't own the memory of 'benchmark'.
+  explicit BenchmarkAutoTuner(BenchmarkModel* benchmark);
+
+  virtual ~BenchmarkAutoTuner() = default;
+
+  // Just run the search w/ default parameter values.
+  TfLiteStatus Run();
+  TfLiteStatus Run(int argc, char** argv);
+
+  // The candidates of the latest search, valid after Run().
+  const std::vector<TunerCandidate>& candidates() const { return candidates_; }
+
+ protected:
+  static BenchmarkParams DefaultParams();
+
+  // Unparsable flags will remain in 'argv' in the original order and 'argc'
+  // will be updated accordingly.
+  TfLiteStatus ParseFlags(int* argc, char** argv);
+  virtual std::vector<Flag> GetFlags();
+
+  virtual TfLiteStatus CreateCandidates();
+
+  // Measures 'candidate' with 'num_runs' runs and updates its latency.
+  virtual void MeasureCandidate(int num_runs, TunerCandidate* candidate);
+
+  TfLiteStatus WriteSettingsFile(const TunerCandidate& best,
+                                 const std::vector<int>& pareto_front) const;
+
+  BenchmarkParams params_;
+  std::vector<TunerCandidate> candidates_;
+
+  // The params of 'benchmark_' before the search, which every candidate starts
+  // from.
+  BenchmarkParams base_params_;
+
+  // The object that drives a single run.
+  BenchmarkModel* const benchmark_;          // Doesn't own the memory.
+  BenchmarkParams* const benchmark_params_;  // Doesn't own the memory.
+
+  // The average inference latency of the latest run, or a negative value if it
+  // didn't complete.
+  double last_latency_us_ = -1.0;
+  std::unique_ptr<BenchmarkListener> latency_listener_;
+};
+
+}  // namespace benchmark
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_TOOLS_BENCHMARK_BENCHMARK_AUTO_TUNER_H_
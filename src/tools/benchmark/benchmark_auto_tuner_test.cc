@@ -0,0 +1,68 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tools/benchmark/benchmark_auto_tuner.h"
+
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+namespace tflite {
+namespace benchmark {
+namespace {
+
+TunerCandidate CreateCandidate(int num_cores, double latency_us) {
+  TunerCandidate candidate;
+  candidate.num_threads = num_cores;
+  candidate.cpu_affinity = "0-7";
+  candidate.num_cores = num_cores;
+  candidate.latency_us = latency_us;
+  return candidate;
+}
+
+TEST(BenchmarkAutoTunerTest, SelectSurvivors) {
+  const std::vector<TunerCandidate> candidates = {
+      CreateCandidate(1, 400), CreateCandidate(2, 250), CreateCandidate(4, -1),
+      CreateCandidate(8, 300), CreateCandidate(1, 100)};
+
+  // The failed candidate is dropped, then the faster half of the rest is kept.
+  EXPECT_THAT(SelectSurvivors(candidates, {0, 1, 2, 3, 4}),
+              testing::ElementsAre(4, 1));
+  EXPECT_THAT(SelectSurvivors(candidates, {0, 1, 3}),
+              testing::ElementsAre(1, 3));
+  EXPECT_THAT(SelectSurvivors(candidates, {2}), testing::IsEmpty());
+}
+
+TEST(BenchmarkAutoTunerTest, GetParetoFront) {
+  const std::vector<TunerCandidate> candidates = {
+      CreateCandidate(1, 400), CreateCandidate(2, 250), CreateCandidate(2, 300),
+      CreateCandidate(4, 260), CreateCandidate(8, 120), CreateCandidate(4, -1)};
+
+  // 4 cores at 260us is beaten by 2 cores at 250us.
+  EXPECT_THAT(GetParetoFront(candidates), testing::ElementsAre(0, 1, 4));
+}
+
+TEST(BenchmarkAutoTunerTest, CandidateToString) {
+  TunerCandidate candidate = CreateCandidate(4, 100);
+  candidate.cpu_affinity = "4-7";
+  candidate.use_xnnpack = true;
+  EXPECT_EQ("4 threads on 4-7 w/ xnnpack", candidate.ToString());
+}
+
+}  // namespace
+}  // namespace benchmark
+}  // namespace tflite
@@ -25,6 +25,7 @@ limitations under the License.
 #include <memory>
 #include <sstream>
 #include <string>
+#include <vector>
 
 #include "profiling/memory_info.h"
 #include "profiling/time.h"
@@ -63,6 +64,8 @@ BenchmarkParams BenchmarkModel::DefaultParams() {
   params.AddParam("run_frequency", BenchmarkParam::Create<float>(-1.0f));
   params.AddParam("num_threads", BenchmarkParam::Create<int32_t>(-1));
   params.AddParam("use_caching", BenchmarkParam::Create<bool>(false));
+  params.AddParam("cpu_affinity", BenchmarkParam::Create<std::string>(""));
+  params.AddParam("settings_file", BenchmarkParam::Create<std::string>(""));
   params.AddParam("benchmark_name", BenchmarkParam::Create<std::string>(""));
   params.AddParam("output_prefix", BenchmarkParam::Create<std::string>(""));
   params.AddParam("warmup_runs", BenchmarkParam::Create<int32_t>(1));
@@ -145,6 +148,16 @@ std::vector<Flag> BenchmarkModel::GetFlags() {
           "Enable caching of prepacked weights matrices in matrix "
           "multiplication routines. Currently implies the use of the Ruy "
           "library."),
+      CreateFlag<std::string>(
+          "cpu_affinity", &params_,
+          "CPUs to run the benchmark and the threads it creates on, as a list "
+          "in the `taskset -c` format, e.g. '4-7' or '0,2', until the run is "
+          "done. If empty, the affinity is left unchanged."),
+      CreateFlag<std::string>(
+          "settings_file", &params_,
+          "A file holding one '--flag=value' per line, e.g. as written by the "
+          "auto-tuner. Flags given on the command line take precedence over "
+          "those in the file."),
       CreateFlag<std::string>("benchmark_name", &params_, "benchmark name"),
       CreateFlag<std::string>("output_prefix", &params_,
                               "benchmark output prefix"),
@@ -196,6 +209,8 @@ void BenchmarkModel::LogParams() {
                       "Number of prorated runs per second", verbose);
   LOG_BENCHMARK_PARAM(int32_t, "num_threads", "Num threads", verbose);
   LOG_BENCHMARK_PARAM(bool, "use_caching", "Use caching", verbose);
+  LOG_BENCHMARK_PARAM(std::string, "cpu_affinity", "CPU affinity", verbose);
+  LOG_BENCHMARK_PARAM(std::string, "settings_file", "Settings file", verbose);
   LOG_BENCHMARK_PARAM(std::string, "benchmark_name", "Benchmark name", verbose);
   LOG_BENCHMARK_PARAM(std::string, "output_prefix", "Output prefix", verbose);
   LOG_BENCHMARK_PARAM(int32_t, "warmup_runs", "Min warmup runs", verbose);
@@ -276,6 +291,13 @@ Stat<int64_t> BenchmarkModel::Run(int min_num_times, float min_secs,
 }
 
 TfLiteStatus BenchmarkModel::ValidateParams() {
+  const auto& cpu_affinity = params_.Get<std::string>("cpu_affinity");
+  std::vector<int> cpus;
+  if (!cpu_affinity.empty() && !util::ParseCpuList(cpu_affinity, &cpus)) {
+    TFLITE_LOG(ERROR) << "Cannot parse --cpu_affinity: '" << cpu_affinity
+                      << "'. Please double-check its value.";
+    return kTfLiteError;
+  }
   if (params_.Get<bool>("report_peak_memory_footprint")) {
     const int32_t interval =
         params_.Get<int32_t>("memory_footprint_check_interval_ms");
@@ -302,6 +324,19 @@ TfLiteStatus BenchmarkModel::Run() {
 
   LogParams();
 
+  // Set the affinity before Init() so that the threads created by the
+  // interpreter and the delegates inherit it.
+  // The affinity of the calling thread is restored after the run.
+  std::unique_ptr<util::ScopedCpuAffinity> cpu_affinity;
+  std::vector<int> cpus;
+  if (util::ParseCpuList(params_.Get<std::string>("cpu_affinity"), &cpus)) {
+    cpu_affinity = std::make_unique<util::ScopedCpuAffinity>(cpus);
+    if (!cpu_affinity->ok()) {
+      TFLITE_LOG(WARN) << "Failed to set the CPU affinity to "
+                       << params_.Get<std::string>("cpu_affinity") << ".";
+    }
+  }
+
   auto peak_memory_reporter = MayCreateMemoryUsageMonitor();
   if (peak_memory_reporter != nullptr) peak_memory_reporter->Start();
   const double model_size_mb = MayGetModelFileSize() / 1e6;
@@ -358,13 +393,26 @@ TfLiteStatus BenchmarkModel::Run() {
   listeners_.OnBenchmarkEnd({model_size_mb, startup_latency_us, input_bytes,
                              warmup_time_us, inference_time_us, init_mem_usage,
                              overall_mem_usage, peak_mem_mb});
-  return status;
+  if (status != kTfLiteOk) {
+    return status;
+  }
+  TF_LITE_ENSURE_STATUS(RunThroughputBenchmark());
+  return RunComparisonBenchmark();
 }
 
 TfLiteStatus BenchmarkModel::ParseFlags(int* argc, char** argv) {
   auto flag_list = GetFlags();
-  const bool parse_result =
+  // Keep a copy of the cmdline as Flags::Parse removes the consumed flags.
+  std::vector<const char*> cmdline(argv, argv + *argc);
+  bool parse_result =
       Flags::Parse(argc, const_cast<const char**>(argv), flag_list);
+  const std::string settings_file = params_.Get<std::string>("settings_file");
+  if (parse_result && !settings_file.empty()) {
+    // Parse the cmdline once more after the file so that it takes precedence.
+    int cmdline_argc = static_cast<int>(cmdline.size());
+    parse_result = Flags::ParseFile(settings_file, flag_list) &&
+                   Flags::Parse(&cmdline_argc, cmdline.data(), flag_list);
+  }
   // "--help" flag is added in tools/delegates/default_execution_provider.cc. As
   // this is an optional dependency, we need to check whether "--help" exists or
   // not first.
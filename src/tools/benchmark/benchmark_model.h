@@ -226,6 +226,15 @@ class BenchmarkModel {
   virtual TfLiteStatus ResetInputsAndOutputs();
   virtual TfLiteStatus RunImpl() = 0;
 
+  // Runs once the regular benchmark results have been reported, for
+  // benchmark modes that drive the model differently (e.g. from several
+  // threads at once). Does nothing by default.
+  virtual TfLiteStatus RunThroughputBenchmark() { return kTfLiteOk; }
+
+  // Runs after the throughput benchmark, for benchmark modes comparing the
+  // model against another configuration of it. Does nothing by default.
+  virtual TfLiteStatus RunComparisonBenchmark() { return kTfLiteOk; }
+
   // Create a MemoryUsageMonitor to report peak memory footprint if specified.
   virtual std::unique_ptr<profiling::memory::MemoryUsageMonitor>
   MayCreateMemoryUsageMonitor() const;
@@ -16,17 +16,22 @@ limitations under the License.
 #include "tools/benchmark/benchmark_tflite_model.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cstdarg>
 #include <cstdint>
 #include <cstdlib>
 #include <cstring>
 #include <fstream>
 #include <functional>
+#include <iomanip>
 #include <iostream>
+#include <map>
 #include <memory>
 #include <random>
+#include <set>
 #include <sstream>
 #include <string>
+#include <thread>  // NOLINT(build/c++11)
 #include <unordered_set>
 #include <utility>
 #include <vector>
@@ -48,6 +53,8 @@ limitations under the License.
 #include "kernels/cpu_backend_context.h"
 #include "op_resolver.h"
 #include "optional_debug_tools.h"
+#include "profiling/machine_peak.h"
+#include "profiling/time.h"
 #include "profiling/profile_summary_formatter.h"
 #include "string_util.h"
 #include "tools/benchmark/benchmark_utils.h"
@@ -78,6 +85,14 @@ constexpr bool kOpProfilingEnabledDefault = true;
 constexpr bool kOpProfilingEnabledDefault = false;
 #endif
 
+// The number of events a Chrome trace keeps, after which events are dropped.
+constexpr uint32_t kMaxChromeTraceEvents = 1 << 20;
+
+// The confidence level of the intervals of the A/B comparison, and the
+// number of bootstrap resamples they're estimated from.
+constexpr double kComparisonConfidence = 0.95;
+constexpr int kComparisonBootstrapResamples = 2000;
+
 // Dumps ruy profiling events if the ruy profiler is enabled.
 class RuyProfileListener : public BenchmarkListener {
  public:
@@ -316,6 +331,51 @@ CreateProfileSummaryFormatter(bool format_as_csv) {
              : std::make_shared<profiling::ProfileSummaryDefaultFormatter>();
 }
 
+// Formats 'value_us' as a percentage of 'base_us', or in microseconds if
+// 'base_us' is 0.
+std::string FormatDelta(double value_us, double base_us) {
+  std::stringstream stream;
+  stream << std::showpos << std::fixed << std::setprecision(1);
+  if (base_us > 0) {
+    stream << 100.0 * value_us / base_us << "%";
+  } else {
+    stream << value_us << "us";
+  }
+  return stream.str();
+}
+
+// Logs how the latencies of configuration B compare to those of A, measured
+// in the same rounds: their medians, the median of the paired differences
+// with its bootstrap confidence interval, and the Mann-Whitney p-value. The
+// delta is significant if both tests reject the hypothesis of no change.
+void LogComparison(const std::string& name,
+                   const std::vector<int64_t>& latencies_a_us,
+                   const std::vector<int64_t>& latencies_b_us,
+                   std::mt19937* random_engine) {
+  std::vector<int64_t> differences_us(latencies_a_us.size());
+  for (size_t i = 0; i < differences_us.size(); ++i) {
+    differences_us[i] = latencies_b_us[i] - latencies_a_us[i];
+  }
+  const double median_a_us = util::Median(latencies_a_us);
+  const std::pair<double, double> interval_us =
+      util::BootstrapMedianDifferenceInterval(
+          latencies_a_us, latencies_b_us, kComparisonConfidence,
+          kComparisonBootstrapResamples, random_engine);
+  const double p_value =
+      util::MannWhitneyUPValue(latencies_a_us, latencies_b_us);
+  const bool significant = p_value < 1.0 - kComparisonConfidence &&
+                           (interval_us.first > 0 || interval_us.second < 0);
+  TFLITE_LOG(INFO) << name << ": A=" << median_a_us
+                   << "us B=" << util::Median(latencies_b_us)
+                   << "us delta=" << FormatDelta(util::Median(differences_us),
+                                                 median_a_us)
+                   << " (" << kComparisonConfidence * 100 << "% CI ["
+                   << FormatDelta(interval_us.first, median_a_us) << ", "
+                   << FormatDelta(interval_us.second, median_a_us)
+                   << "]) p=" << p_value
+                   << (significant ? " significant" : " not significant");
+}
+
 }  // namespace
 
 TfLiteStatus SplitInputLayerNameAndValueFile(
@@ -485,6 +545,24 @@ BenchmarkParams BenchmarkTfLiteModel::DefaultParams() {
                           BenchmarkParam::Create<bool>(false));
   default_params.AddParam("profiling_output_csv_file",
                           BenchmarkParam::Create<std::string>(""));
+  default_params.AddParam("enable_op_hardware_counters",
+                          BenchmarkParam::Create<bool>(false));
+  default_params.AddParam("enable_op_roofline",
+                          BenchmarkParam::Create<bool>(false));
+  default_params.AddParam("roofline_peak_gflops",
+                          BenchmarkParam::Create<float>(-1.0f));
+  default_params.AddParam("roofline_peak_gbps",
+                          BenchmarkParam::Create<float>(-1.0f));
+  default_params.AddParam("chrome_trace_output_file",
+                          BenchmarkParam::Create<std::string>(""));
+  default_params.AddParam("sampling_profiler_period",
+                          BenchmarkParam::Create<int32_t>(0));
+  default_params.AddParam("enable_startup_profiling",
+                          BenchmarkParam::Create<bool>(false));
+  default_params.AddParam("enable_memory_timeline",
+                          BenchmarkParam::Create<bool>(false));
+  default_params.AddParam("memory_timeline_output_file",
+                          BenchmarkParam::Create<std::string>(""));
 
   default_params.AddParam("print_preinvoke_state",
                           BenchmarkParam::Create<bool>(false));
@@ -507,6 +585,17 @@ BenchmarkParams BenchmarkTfLiteModel::DefaultParams() {
                           BenchmarkParam::Create<int32_t>(15));
   default_params.AddParam("alloc_type_display_length",
                           BenchmarkParam::Create<int32_t>(18));
+  default_params.AddParam("throughput_threads",
+                          BenchmarkParam::Create<int32_t>(0));
+  default_params.AddParam("throughput_arrival_rate",
+                          BenchmarkParam::Create<float>(-1.0f));
+  default_params.AddParam("throughput_secs",
+                          BenchmarkParam::Create<float>(10.0f));
+  default_params.AddParam("ab_compare_flags",
+                          BenchmarkParam::Create<std::string>(""));
+  default_params.AddParam("ab_rounds", BenchmarkParam::Create<int32_t>(50));
+  default_params.AddParam("ab_warmup_rounds",
+                          BenchmarkParam::Create<int32_t>(5));
 
   tools::ProvidedDelegateList delegate_providers(&default_params);
   delegate_providers.AddAllDelegateParams();
@@ -573,6 +662,42 @@ std::vector<Flag> BenchmarkTfLiteModel::GetFlags() {
           "profiling_output_csv_file", &params_,
           "File path to export profile data as CSV, if not set "
           "prints to stdout."),
+      CreateFlag<bool>(
+          "enable_op_hardware_counters", &params_,
+          "record the hardware performance counters of each op (Linux only), "
+          "requires enable_op_profiling"),
+      CreateFlag<bool>(
+          "enable_op_roofline", &params_,
+          "report the estimated flops and bytes of each op against the peak "
+          "of the machine, requires enable_op_profiling"),
+      CreateFlag<float>("roofline_peak_gflops", &params_,
+                        "peak arithmetic throughput of the roofline in "
+                        "GFLOP/s, measured at startup if not positive"),
+      CreateFlag<float>("roofline_peak_gbps", &params_,
+                        "peak memory bandwidth of the roofline in GB/s, "
+                        "measured at startup if not positive"),
+      CreateFlag<std::string>(
+          "chrome_trace_output_file", &params_,
+          "File path to write a Chrome trace (JSON, viewable in Perfetto) of "
+          "the regular runs to, with one track per thread"),
+      CreateFlag<int32_t>(
+          "sampling_profiler_period", &params_,
+          "if positive, keep the low overhead production profiler on, timing "
+          "1 in this many invokes, and log the sampled op latencies"),
+      CreateFlag<bool>(
+          "enable_startup_profiling", &params_,
+          "log the time spent loading the model, building the interpreter, "
+          "applying each delegate, allocating the tensors and in the first "
+          "invoke, and preparing each op"),
+      CreateFlag<bool>(
+          "enable_memory_timeline", &params_,
+          "log the memory the runtime allocates, i.e. the growth of the "
+          "arenas, the heap allocated tensors and the other heap growth of "
+          "each op, per op and over time"),
+      CreateFlag<std::string>(
+          "memory_timeline_output_file", &params_,
+          "File path to export the whole memory timeline to as CSV, if "
+          "enable_memory_timeline is true."),
       CreateFlag<bool>(
           "print_preinvoke_state", &params_,
           "print out the interpreter internals just before calling Invoke. The "
@@ -618,7 +743,33 @@ std::vector<Flag> BenchmarkTfLiteModel::GetFlags() {
           "default signature will be used."),
       CreateFlag<bool>("list_signatures", &params_,
                        "Displays all signatures present in the model and then "
-                       "terminates the program.")};
+                       "terminates the program."),
+      CreateFlag<int32_t>(
+          "throughput_threads", &params_,
+          "If positive, after the regular benchmark runs the model from this "
+          "many threads at once, each owning its own interpreter, and reports "
+          "the aggregate throughput and latency percentiles."),
+      CreateFlag<float>(
+          "throughput_arrival_rate", &params_,
+          "The rate in requests per second at which requests arrive in the "
+          "throughput benchmark, independently of how fast they are served "
+          "(open loop). A non-positive value means each thread starts its "
+          "next request as soon as the previous one completes (closed loop)."),
+      CreateFlag<float>("throughput_secs", &params_,
+                        "The duration of the throughput benchmark in "
+                        "seconds."),
+      CreateFlag<std::string>(
+          "ab_compare_flags", &params_,
+          "If set, after the regular benchmark compares the model as "
+          "configured (A) with the configuration these space separated flags "
+          "give on top of it (B), e.g. '--use_xnnpack=false' or "
+          "'--graph=/tmp/model_v2.tflite'."),
+      CreateFlag<int32_t>("ab_rounds", &params_,
+                          "The number of measured rounds of the A/B "
+                          "comparison, each running A and B once."),
+      CreateFlag<int32_t>("ab_warmup_rounds", &params_,
+                          "The number of rounds of the A/B comparison run "
+                          "before the measured ones.")};
 
   flags.insert(flags.end(), specific_flags.begin(), specific_flags.end());
 
@@ -657,6 +808,24 @@ void BenchmarkTfLiteModel::LogParams() {
                       verbose);
   LOG_BENCHMARK_PARAM(std::string, "profiling_output_csv_file",
                       "CSV File to export profiling data to", verbose);
+  LOG_BENCHMARK_PARAM(bool, "enable_op_hardware_counters",
+                      "Enable op hardware counters", verbose);
+  LOG_BENCHMARK_PARAM(bool, "enable_op_roofline", "Enable op roofline",
+                      verbose);
+  LOG_BENCHMARK_PARAM(float, "roofline_peak_gflops",
+                      "Roofline peak GFLOP/s", verbose);
+  LOG_BENCHMARK_PARAM(float, "roofline_peak_gbps", "Roofline peak GB/s",
+                      verbose);
+  LOG_BENCHMARK_PARAM(std::string, "chrome_trace_output_file",
+                      "Chrome trace output file", verbose);
+  LOG_BENCHMARK_PARAM(int32_t, "sampling_profiler_period",
+                      "Sampling profiler period", verbose);
+  LOG_BENCHMARK_PARAM(bool, "enable_startup_profiling",
+                      "Enable startup profiling", verbose);
+  LOG_BENCHMARK_PARAM(bool, "enable_memory_timeline",
+                      "Enable memory timeline", verbose);
+  LOG_BENCHMARK_PARAM(std::string, "memory_timeline_output_file",
+                      "Memory timeline output file", verbose);
   LOG_BENCHMARK_PARAM(bool, "print_preinvoke_state",
                       "Print pre-invoke interpreter state", verbose);
   LOG_BENCHMARK_PARAM(bool, "print_postinvoke_state",
@@ -677,6 +846,18 @@ void BenchmarkTfLiteModel::LogParams() {
                       "Tensor type display length", verbose);
   LOG_BENCHMARK_PARAM(int32_t, "alloc_type_display_length",
                       "Tensor allocation type display length", verbose);
+  LOG_BENCHMARK_PARAM(int32_t, "throughput_threads",
+                      "Throughput benchmark threads", verbose);
+  LOG_BENCHMARK_PARAM(float, "throughput_arrival_rate",
+                      "Throughput benchmark arrival rate (requests/s)",
+                      verbose);
+  LOG_BENCHMARK_PARAM(float, "throughput_secs",
+                      "Throughput benchmark duration (s)", verbose);
+  LOG_BENCHMARK_PARAM(std::string, "ab_compare_flags",
+                      "A/B comparison flags of B", verbose);
+  LOG_BENCHMARK_PARAM(int32_t, "ab_rounds", "A/B comparison rounds", verbose);
+  LOG_BENCHMARK_PARAM(int32_t, "ab_warmup_rounds",
+                      "A/B comparison warmup rounds", verbose);
 
   for (const auto& delegate_provider :
        tools::GetRegisteredDelegateProviders()) {
@@ -693,6 +874,22 @@ TfLiteStatus BenchmarkTfLiteModel::ValidateParams() {
     return kTfLiteError;
   }
 
+  if (params_.Get<int32_t>("throughput_threads") > 0 &&
+      params_.Get<float>("throughput_secs") <= 0) {
+    TFLITE_LOG(ERROR) << "--throughput_secs must be positive when "
+                         "--throughput_threads is set.";
+    return kTfLiteError;
+  }
+
+  if (!params_.Get<std::string>("ab_compare_flags").empty() &&
+      (params_.Get<int32_t>("ab_rounds") < 2 ||
+       params_.Get<int32_t>("ab_warmup_rounds") < 0)) {
+    TFLITE_LOG(ERROR) << "--ab_rounds must be at least 2 and "
+                         "--ab_warmup_rounds non-negative when "
+                         "--ab_compare_flags is set.";
+    return kTfLiteError;
+  }
+
   return PopulateInputLayerInfo(
       params_.Get<std::string>("input_layer"),
       params_.Get<std::string>("input_layer_shape"),
@@ -829,11 +1026,28 @@ TfLiteStatus BenchmarkTfLiteModel::PrepareInputData() {
 }
 
 TfLiteStatus BenchmarkTfLiteModel::ResetInputsAndOutputs() {
-  const std::vector<int>& runner_inputs = interpreter_runner_->inputs();
+  return CopyInputsTo(interpreter_runner_.get());
+}
+
+TfLiteStatus BenchmarkTfLiteModel::CopyInputsTo(
+    BenchmarkInterpreterRunner* runner) {
+  const std::vector<int>& runner_inputs = runner->inputs();
+  if (runner_inputs.size() != inputs_data_.size()) {
+    TFLITE_LOG(ERROR) << "The model has " << runner_inputs.size()
+                      << " inputs but " << inputs_data_.size()
+                      << " were prepared.";
+    return kTfLiteError;
+  }
   // Set the values of the input tensors from inputs_data_.
   for (int j = 0; j < runner_inputs.size(); ++j) {
     int i = runner_inputs[j];
-    TfLiteTensor* t = interpreter_runner_->tensor(i);
+    TfLiteTensor* t = runner->tensor(i);
+    if (t->type != kTfLiteString && t->bytes != inputs_data_[j].bytes) {
+      TFLITE_LOG(ERROR) << "Input tensor #" << i << " has " << t->bytes
+                        << " bytes but " << inputs_data_[j].bytes
+                        << " were prepared.";
+      return kTfLiteError;
+    }
     if (t->type == kTfLiteString) {
       if (inputs_data_[j].data) {
         static_cast<DynamicBuffer*>(inputs_data_[j].data.get())
@@ -856,11 +1070,9 @@ TfLiteStatus BenchmarkTfLiteModel::ResetInputsAndOutputs() {
   return kTfLiteOk;
 }
 
-TfLiteStatus BenchmarkTfLiteModel::InitInterpreter() {
-  auto resolver = GetOpResolver();
-  const int32_t num_threads = params_.Get<int32_t>("num_threads");
-  const bool use_caching = params_.Get<bool>("use_caching");
-
+TfLiteStatus BenchmarkTfLiteModel::BuildInterpreter(
+    const tflite::OpResolver& resolver,
+    std::unique_ptr<Interpreter>* interpreter, Profiler* profiler) {
   InterpreterOptions options;
   options.SetEnsureDynamicTensorsAreReleased(
       params_.Get<bool>("release_dynamic_tensors"));
@@ -871,23 +1083,42 @@ TfLiteStatus BenchmarkTfLiteModel::InitInterpreter() {
   options.SetCacheConstantCastOp(
       params_.Get<bool>("enable_builtin_cast_constant_cache"));
 
-  tflite::InterpreterBuilder builder(*model_, *resolver, &options);
-  if (builder.SetNumThreads(num_threads) != kTfLiteOk) {
+  tflite::InterpreterBuilder builder(*model_, resolver, &options);
+  builder.SetProfiler(profiler);
+  if (builder.SetNumThreads(params_.Get<int32_t>("num_threads")) !=
+      kTfLiteOk) {
     TFLITE_LOG(ERROR) << "Failed to set thread number";
     return kTfLiteError;
   }
 
-  builder(&interpreter_);
-  if (!interpreter_) {
+  builder(interpreter);
+  if (!*interpreter) {
     TFLITE_LOG(ERROR) << "Failed to initialize the interpreter";
     return kTfLiteError;
   }
-  // Manually enable caching behavior in TF Lite interpreter.
-  if (use_caching) {
+  return kTfLiteOk;
+}
+
+TfLiteStatus BenchmarkTfLiteModel::InitInterpreter() {
+  auto resolver = GetOpResolver();
+  const int32_t num_threads = params_.Get<int32_t>("num_threads");
+  const bool use_caching = params_.Get<bool>("use_caching");
+
+  {
+    TFLITE_SCOPED_TAGGED_DEFAULT_PROFILE(startup_profiler(),
+                                         "BuildInterpreter");
+    TF_LITE_ENSURE_STATUS(
+        BuildInterpreter(*resolver, &interpreter_, build_profiler()));
+  }
+
+  // Manually enable caching behavior in TF Lite interpreter. Tracing also
+  // needs access to the CPU backend context, to record its threadpool tasks.
+  if (use_caching ||
+      !params_.Get<std::string>("chrome_trace_output_file").empty()) {
     external_context_ = std::make_unique<tflite::ExternalCpuBackendContext>();
     std::unique_ptr<tflite::CpuBackendContext> cpu_backend_context(
         new tflite::CpuBackendContext());
-    cpu_backend_context->SetUseCaching(true);
+    cpu_backend_context->SetUseCaching(use_caching);
     cpu_backend_context->SetMaxNumThreads(num_threads);
     external_context_->set_internal_backend_context(
         std::move(cpu_backend_context));
@@ -899,6 +1130,33 @@ TfLiteStatus BenchmarkTfLiteModel::InitInterpreter() {
 }
 
 TfLiteStatus BenchmarkTfLiteModel::Init() {
+  // The startup is recorded from the loading of the model to the end of the
+  // first invoke.
+  startup_profiling_listener_ = nullptr;
+  if (params_.Get<bool>("enable_startup_profiling")) {
+    auto listener = std::make_unique<StartupProfilingListener>(
+        params_.Get<int32_t>("max_profiling_buffer_entries"));
+    startup_profiling_listener_ = listener.get();
+    AddOwnedListener(std::move(listener));
+  }
+  // The memory is recorded from the build of the interpreter, so that the
+  // memory the kernels allocate on init is attributed to them.
+  memory_timeline_listener_ = nullptr;
+  if (params_.Get<bool>("enable_memory_timeline")) {
+    auto listener = std::make_unique<MemoryTimelineListener>(
+        params_.Get<std::string>("memory_timeline_output_file"),
+        params_.Get<int32_t>("max_profiling_buffer_entries"));
+    memory_timeline_listener_ = listener.get();
+    AddOwnedListener(std::move(listener));
+  }
+  build_root_profiler_ = nullptr;
+  if (startup_profiling_listener_ != nullptr &&
+      memory_timeline_listener_ != nullptr) {
+    build_root_profiler_ = std::make_unique<profiling::RootProfiler>();
+    build_root_profiler_->AddProfiler(startup_profiling_listener_->profiler());
+    build_root_profiler_->AddProfiler(memory_timeline_listener_->profiler());
+  }
+
   TF_LITE_ENSURE_STATUS(LoadModel());
   TF_LITE_ENSURE_STATUS(InitInterpreter());
 
@@ -933,6 +1191,19 @@ TfLiteStatus BenchmarkTfLiteModel::Init() {
   }
 
   AddOwnedListener(MayCreateProfilingListener());
+  AddOwnedListener(MayCreateChromeTraceListener());
+  if (params_.Get<int32_t>("sampling_profiler_period") > 0) {
+    AddOwnedListener(std::unique_ptr<BenchmarkListener>(
+        new SamplingProfilerListener(
+            interpreter_.get(),
+            params_.Get<int32_t>("sampling_profiler_period"))));
+  }
+  if (startup_profiling_listener_ != nullptr) {
+    startup_profiling_listener_->AttachInterpreter(interpreter_.get());
+  }
+  if (memory_timeline_listener_ != nullptr) {
+    memory_timeline_listener_->AttachInterpreter(interpreter_.get());
+  }
   AddOwnedListener(std::unique_ptr<BenchmarkListener>(
       new InterpreterStatePrinter(interpreter_.get())));
 
@@ -1010,7 +1281,13 @@ TfLiteStatus BenchmarkTfLiteModel::Init() {
     // delegate later. Moving the delegate to a list of owned delegates to
     // guarantee that.
     owned_delegates_.emplace_back(std::move(created_delegate.delegate));
-    if (interpreter_->ModifyGraphWithDelegate(delegate) != kTfLiteOk) {
+    TfLiteStatus delegate_status;
+    {
+      const std::string tag = "ApplyDelegate/" + delegate_provider->GetName();
+      TFLITE_SCOPED_TAGGED_DEFAULT_PROFILE(startup_profiler(), tag.c_str());
+      delegate_status = interpreter_->ModifyGraphWithDelegate(delegate);
+    }
+    if (delegate_status != kTfLiteOk) {
       TFLITE_LOG(ERROR) << "Failed to apply " << delegate_provider->GetName()
                         << " delegate.";
       return kTfLiteError;
@@ -1078,6 +1355,19 @@ TfLiteStatus BenchmarkTfLiteModel::Init() {
   return kTfLiteOk;
 }
 
+Profiler* BenchmarkTfLiteModel::startup_profiler() const {
+  return startup_profiling_listener_ ? startup_profiling_listener_->profiler()
+                                     : nullptr;
+}
+
+Profiler* BenchmarkTfLiteModel::build_profiler() const {
+  if (build_root_profiler_ != nullptr) return build_root_profiler_.get();
+  if (memory_timeline_listener_ != nullptr) {
+    return memory_timeline_listener_->profiler();
+  }
+  return startup_profiler();
+}
+
 TfLiteStatus BenchmarkTfLiteModel::LoadModel() {
   std::string fd_or_graph_path = params_.Get<std::string>("graph");
   model_loader_ = tools::CreateModelLoaderFromPath(fd_or_graph_path);
@@ -1086,7 +1376,13 @@ TfLiteStatus BenchmarkTfLiteModel::LoadModel() {
                       << fd_or_graph_path;
     return kTfLiteError;
   }
-  if (!model_loader_->Init()) {
+  model_loader_->SetProfiler(startup_profiler());
+  bool loaded;
+  {
+    TFLITE_SCOPED_TAGGED_DEFAULT_PROFILE(startup_profiler(), "LoadModel");
+    loaded = model_loader_->Init();
+  }
+  if (!loaded) {
     TFLITE_LOG(ERROR) << "Failed to load model " << fd_or_graph_path;
     return kTfLiteError;
   }
@@ -1120,17 +1416,387 @@ std::unique_ptr<BenchmarkListener>
 BenchmarkTfLiteModel::MayCreateProfilingListener() const {
   if (!params_.Get<bool>("enable_op_profiling")) return nullptr;
 
-  return std::unique_ptr<BenchmarkListener>(new ProfilingListener(
+  auto listener = std::make_unique<ProfilingListener>(
       interpreter_.get(), params_.Get<int32_t>("max_profiling_buffer_entries"),
       params_.Get<bool>("allow_dynamic_profiling_buffer_increase"),
       params_.Get<std::string>("profiling_output_csv_file"),
       CreateProfileSummaryFormatter(
-          !params_.Get<std::string>("profiling_output_csv_file").empty())));
+          !params_.Get<std::string>("profiling_output_csv_file").empty()),
+      params_.Get<bool>("enable_op_hardware_counters"));
+  if (params_.Get<bool>("enable_op_roofline")) {
+    profiling::MachinePeak machine_peak;
+    const float peak_gflops = params_.Get<float>("roofline_peak_gflops");
+    const float peak_gbps = params_.Get<float>("roofline_peak_gbps");
+    if (peak_gflops <= 0 || peak_gbps <= 0) {
+      // Measured on as many threads as the interpreter uses.
+      machine_peak = profiling::MeasureMachinePeak(
+          std::max(params_.Get<int32_t>("num_threads"), 1));
+    }
+    if (peak_gflops > 0) machine_peak.gflops = peak_gflops;
+    if (peak_gbps > 0) machine_peak.gbytes_per_second = peak_gbps;
+    TFLITE_LOG(INFO) << "Roofline peak: " << machine_peak.gflops
+                     << " GFLOP/s, " << machine_peak.gbytes_per_second
+                     << " GB/s";
+    listener->EnableRoofline(machine_peak);
+  }
+  return listener;
+}
+
+std::unique_ptr<BenchmarkListener>
+BenchmarkTfLiteModel::MayCreateChromeTraceListener() const {
+  const std::string trace_file_path =
+      params_.Get<std::string>("chrome_trace_output_file");
+  if (trace_file_path.empty()) return nullptr;
+
+  // Subclasses initializing their own interpreter may not have set up a CPU
+  // backend context, in which case the threadpool tasks aren't traced.
+  CpuBackendContext* cpu_backend_context =
+      external_context_ == nullptr
+          ? nullptr
+          : static_cast<CpuBackendContext*>(
+                external_context_->internal_backend_context());
+  return std::unique_ptr<BenchmarkListener>(
+      new ChromeTraceListener(interpreter_.get(), cpu_backend_context,
+                              trace_file_path, kMaxChromeTraceEvents));
 }
 
 TfLiteStatus BenchmarkTfLiteModel::RunImpl() {
   return interpreter_runner_->Invoke();
 }
 
+TfLiteStatus BenchmarkTfLiteModel::InitThroughputWorker(
+    ThroughputWorker* worker) {
+  auto resolver = GetOpResolver();
+  TF_LITE_ENSURE_STATUS(BuildInterpreter(*resolver, &worker->interpreter));
+  worker->interpreter->SetAllowFp16PrecisionForFp32(
+      params_.Get<bool>("allow_fp16"));
+
+  std::pair<TfLiteStatus, std::unique_ptr<BenchmarkInterpreterRunner>>
+      status_and_runner = BenchmarkInterpreterRunner::Create(
+          worker->interpreter.get(),
+          params_.Get<std::string>("signature_to_run_for"));
+  TF_LITE_ENSURE_STATUS(status_and_runner.first);
+  worker->runner = std::move(status_and_runner.second);
+
+  const std::vector<int>& runner_inputs = worker->runner->inputs();
+  for (int j = 0; j < inputs_.size(); ++j) {
+    int i = runner_inputs[j];
+    if (worker->runner->tensor(i)->type != kTfLiteString) {
+      worker->runner->ResizeInputTensor(i, inputs_[j].shape);
+    }
+  }
+
+  // Delegate instances may only be applied to a single interpreter, so each
+  // worker gets its own.
+  tools::ProvidedDelegateList delegate_providers(&params_);
+  auto created_delegates = delegate_providers.CreateAllRankedDelegates();
+  for (auto& created_delegate : created_delegates) {
+    TfLiteDelegate* delegate = created_delegate.delegate.get();
+    worker->delegates.emplace_back(std::move(created_delegate.delegate));
+    if (worker->interpreter->ModifyGraphWithDelegate(delegate) != kTfLiteOk) {
+      TFLITE_LOG(ERROR) << "Failed to apply "
+                        << created_delegate.provider->GetName()
+                        << " delegate to a throughput benchmark thread.";
+      return kTfLiteError;
+    }
+  }
+
+  if (worker->runner->AllocateTensors() != kTfLiteOk) {
+    TFLITE_LOG(ERROR) << "Failed to allocate tensors!";
+    return kTfLiteError;
+  }
+  return CopyInputsTo(worker->runner.get());
+}
+
+TfLiteStatus BenchmarkTfLiteModel::RunThroughputBenchmark() {
+  const int32_t num_workers = params_.Get<int32_t>("throughput_threads");
+  if (num_workers <= 0 || params_.Get<bool>("dry_run")) {
+    return kTfLiteOk;
+  }
+  const float arrival_rate = params_.Get<float>("throughput_arrival_rate");
+  const bool open_loop = arrival_rate > 0;
+  const int64_t duration_us =
+      static_cast<int64_t>(params_.Get<float>("throughput_secs") * 1e6);
+
+  // All workers share the weights of 'model_' but own their interpreters, so
+  // nothing but the CPU is contended while they run.
+  std::vector<ThroughputWorker> workers(num_workers);
+  for (ThroughputWorker& worker : workers) {
+    TF_LITE_ENSURE_STATUS(InitThroughputWorker(&worker));
+  }
+
+  // In open loop, requests arrive as a Poisson process whatever the service
+  // rate is, and the latency of a request includes the time it waited for a
+  // free worker. Requests not started by the end of the run are dropped.
+  std::vector<int64_t> arrival_offsets_us;
+  if (open_loop) {
+    std::exponential_distribution<double> inter_arrival_us(arrival_rate /
+                                                           1e6);
+    for (double offset_us = inter_arrival_us(random_engine_);
+         offset_us < duration_us;
+         offset_us += inter_arrival_us(random_engine_)) {
+      arrival_offsets_us.push_back(static_cast<int64_t>(offset_us));
+    }
+  }
+  std::atomic<size_t> next_request(0);
+  std::atomic<int64_t> num_dropped(0);
+
+  auto wait_until = [](int64_t time_us) {
+    const int64_t now_us = profiling::time::NowMicros();
+    if (now_us < time_us) {
+      profiling::time::SleepForMicros(time_us - now_us);
+    }
+  };
+
+  // Leave the threads some time to spawn so that they all start together.
+  constexpr int64_t kStartDelayUs = 10000;
+  const int64_t start_us = profiling::time::NowMicros() + kStartDelayUs;
+  const int64_t end_us = start_us + duration_us;
+  std::vector<std::thread> threads;
+  threads.reserve(workers.size());
+  for (ThroughputWorker& worker : workers) {
+    threads.emplace_back([&, w = &worker]() {
+      wait_until(start_us);
+      const int64_t cpu_start_us = util::ThreadCpuTimeMicros();
+      while (w->status == kTfLiteOk) {
+        int64_t request_start_us;
+        if (open_loop) {
+          const size_t request = next_request++;
+          if (request >= arrival_offsets_us.size()) break;
+          request_start_us = start_us + arrival_offsets_us[request];
+          wait_until(request_start_us);
+          if (profiling::time::NowMicros() >= end_us) {
+            ++num_dropped;
+            continue;
+          }
+        } else {
+          request_start_us = profiling::time::NowMicros();
+          if (request_start_us >= end_us) break;
+        }
+        w->status = w->runner->Invoke();
+        w->latencies_us.push_back(profiling::time::NowMicros() -
+                                  request_start_us);
+      }
+      w->end_us = profiling::time::NowMicros();
+      w->cpu_time_us = cpu_start_us < 0
+                           ? -1
+                           : util::ThreadCpuTimeMicros() - cpu_start_us;
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  std::vector<int64_t> latencies_us;
+  int64_t last_end_us = start_us;
+  for (const ThroughputWorker& worker : workers) {
+    if (worker.status != kTfLiteOk) {
+      TFLITE_LOG(ERROR) << "Throughput benchmark thread failed to invoke the "
+                           "model.";
+      return worker.status;
+    }
+    latencies_us.insert(latencies_us.end(), worker.latencies_us.begin(),
+                        worker.latencies_us.end());
+    last_end_us = std::max(last_end_us, worker.end_us);
+  }
+  std::sort(latencies_us.begin(), latencies_us.end());
+
+  const double elapsed_secs = (last_end_us - start_us) / 1e6;
+  if (open_loop) {
+    TFLITE_LOG(INFO) << "Throughput benchmark: " << num_workers
+                     << " threads, open loop at " << arrival_rate
+                     << " requests/s.";
+  } else {
+    TFLITE_LOG(INFO) << "Throughput benchmark: " << num_workers
+                     << " threads, closed loop.";
+  }
+  TFLITE_LOG(INFO) << "Completed " << latencies_us.size() << " requests in "
+                   << elapsed_secs << "s, QPS="
+                   << (elapsed_secs > 0 ? latencies_us.size() / elapsed_secs
+                                        : 0);
+  TFLITE_MAY_LOG(WARN, num_dropped > 0)
+      << "Dropped " << num_dropped.load()
+      << " requests that could not be started before the end of the run.";
+  TFLITE_LOG(INFO) << "Latency (us): p50=" << util::Percentile(latencies_us, 50)
+                   << " p90=" << util::Percentile(latencies_us, 90)
+                   << " p99=" << util::Percentile(latencies_us, 99)
+                   << " p99.9=" << util::Percentile(latencies_us, 99.9)
+                   << " max=" << util::Percentile(latencies_us, 100);
+  for (int i = 0; i < workers.size(); ++i) {
+    if (workers[i].cpu_time_us < 0) {
+      TFLITE_LOG(INFO) << "Thread #" << i << ": "
+                       << workers[i].latencies_us.size() << " requests";
+    } else {
+      TFLITE_LOG(INFO) << "Thread #" << i << ": "
+                       << workers[i].latencies_us.size()
+                       << " requests, CPU time (ms)="
+                       << workers[i].cpu_time_us / 1e3;
+    }
+  }
+  return kTfLiteOk;
+}
+
+TfLiteStatus BenchmarkTfLiteModel::InitComparisonConfig(
+    BenchmarkParams* params, std::unique_ptr<FlatBufferModel>* model,
+    ComparisonConfig* config) {
+  // The params and model of the configuration are temporarily swapped in, as
+  // all the helpers building interpreters use the members of the benchmark.
+  if (params != nullptr) std::swap(params_, *params);
+  if (model != nullptr) std::swap(model_, *model);
+  TfLiteStatus status = InitThroughputWorker(&config->worker);
+  if (status == kTfLiteOk && params_.Get<bool>("enable_op_profiling")) {
+    config->profiler = std::make_unique<profiling::BufferedProfiler>(
+        params_.Get<int32_t>("max_profiling_buffer_entries"),
+        /*allow_dynamic_buffer_increase=*/true);
+    config->worker.interpreter->SetProfiler(config->profiler.get());
+  }
+  if (model != nullptr) std::swap(model_, *model);
+  if (params != nullptr) std::swap(params_, *params);
+  return status;
+}
+
+TfLiteStatus BenchmarkTfLiteModel::RunComparisonRound(
+    bool measured, ComparisonConfig* config) {
+  if (config->profiler) {
+    config->profiler->Reset();
+    config->profiler->StartProfiling();
+  }
+  const int64_t start_us = profiling::time::NowMicros();
+  const TfLiteStatus status = config->worker.runner->Invoke();
+  const int64_t latency_us = profiling::time::NowMicros() - start_us;
+  if (config->profiler) config->profiler->StopProfiling();
+  if (status != kTfLiteOk) {
+    TFLITE_LOG(ERROR) << "A/B comparison failed to invoke the model.";
+    return status;
+  }
+  if (!measured) return kTfLiteOk;
+
+  config->worker.latencies_us.push_back(latency_us);
+  if (!config->profiler) return kTfLiteOk;
+  std::map<std::string, int64_t> op_type_totals_us;
+  for (const profiling::ProfileEvent* event :
+       config->profiler->GetProfileEvents()) {
+    if (event->event_type == Profiler::EventType::OPERATOR_INVOKE_EVENT) {
+      op_type_totals_us[event->tag] += event->elapsed_time;
+    }
+  }
+  // Op types missing from earlier rounds ran for 0us in them.
+  const size_t round = config->worker.latencies_us.size() - 1;
+  for (const auto& op_type_total_us : op_type_totals_us) {
+    std::vector<int64_t>& latencies_us =
+        config->op_type_latencies_us[op_type_total_us.first];
+    latencies_us.resize(round, 0);
+    latencies_us.push_back(op_type_total_us.second);
+  }
+  return kTfLiteOk;
+}
+
+TfLiteStatus BenchmarkTfLiteModel::ParseComparisonFlags(
+    BenchmarkParams* params_b) {
+  // B is configured by parsing its flags over the current params, with the
+  // same flags as the command line, then swapping the params of A back in.
+  // The settings file of A was applied under its command line, so applying it
+  // again would override the command line flags of A in B.
+  params_b->Merge(params_);
+  params_.Set<std::string>("settings_file", "");
+  std::vector<std::string> args = {"ab_compare_flags"};
+  for (absl::string_view arg :
+       absl::StrSplit(params_.Get<std::string>("ab_compare_flags"), ' ',
+                      absl::SkipEmpty())) {
+    args.emplace_back(arg);
+  }
+  std::vector<char*> argv;
+  for (std::string& arg : args) {
+    argv.push_back(&arg[0]);
+  }
+  int argc = static_cast<int>(argv.size());
+  const TfLiteStatus status = ParseFlags(&argc, argv.data());
+  std::swap(params_, *params_b);
+  if (status != kTfLiteOk) {
+    TFLITE_LOG(ERROR) << "Failed to parse --ab_compare_flags.";
+  }
+  return status;
+}
+
+TfLiteStatus BenchmarkTfLiteModel::RunComparisonBenchmark() {
+  const std::string ab_compare_flags =
+      params_.Get<std::string>("ab_compare_flags");
+  if (ab_compare_flags.empty() || params_.Get<bool>("dry_run")) {
+    return kTfLiteOk;
+  }
+  const int32_t num_rounds = params_.Get<int32_t>("ab_rounds");
+  const int32_t num_warmup_rounds = params_.Get<int32_t>("ab_warmup_rounds");
+
+  BenchmarkParams params_b;
+  TF_LITE_ENSURE_STATUS(ParseComparisonFlags(&params_b));
+
+  // B may benchmark another model, fed with the same inputs as A.
+  std::unique_ptr<tools::ModelLoader> model_loader_b;
+  std::unique_ptr<FlatBufferModel> model_b;
+  const std::string graph_b = params_b.Get<std::string>("graph");
+  if (graph_b != params_.Get<std::string>("graph")) {
+    model_loader_b = tools::CreateModelLoaderFromPath(graph_b);
+    if (!model_loader_b || !model_loader_b->Init()) {
+      TFLITE_LOG(ERROR) << "Failed to load model " << graph_b;
+      return kTfLiteError;
+    }
+    model_b = tflite::FlatBufferModel::BuildFromBuffer(
+        reinterpret_cast<const char*>(
+            model_loader_b->GetModel()->allocation()->base()),
+        model_loader_b->GetModel()->allocation()->bytes());
+  }
+
+  ComparisonConfig config_a;
+  ComparisonConfig config_b;
+  TF_LITE_ENSURE_STATUS(InitComparisonConfig(nullptr, nullptr, &config_a));
+  TF_LITE_ENSURE_STATUS(InitComparisonConfig(
+      &params_b, model_b ? &model_b : nullptr, &config_b));
+
+  // Both configurations run in every round, in a random order, so that a slow
+  // drift like thermal throttling affects them equally and a fixed order
+  // doesn't favor either of them.
+  const float run_delay = params_.Get<float>("run_delay");
+  std::bernoulli_distribution a_goes_first(0.5);
+  for (int32_t round = -num_warmup_rounds; round < num_rounds; ++round) {
+    const bool measured = round >= 0;
+    ComparisonConfig* first = &config_a;
+    ComparisonConfig* second = &config_b;
+    if (!a_goes_first(random_engine_)) std::swap(first, second);
+    TF_LITE_ENSURE_STATUS(RunComparisonRound(measured, first));
+    util::SleepForSeconds(run_delay);
+    TF_LITE_ENSURE_STATUS(RunComparisonRound(measured, second));
+    util::SleepForSeconds(run_delay);
+  }
+
+  TFLITE_LOG(INFO) << "A/B comparison of " << num_rounds
+                   << " interleaved rounds after " << num_warmup_rounds
+                   << " warmup rounds, B adding: " << ab_compare_flags;
+  LogComparison("End-to-end", config_a.worker.latencies_us,
+                config_b.worker.latencies_us, &random_engine_);
+  if (!config_a.profiler || !config_b.profiler) return kTfLiteOk;
+
+  // Compares op types rather than nodes, as B may have a different graph.
+  std::set<std::string> op_types;
+  for (ComparisonConfig* config : {&config_a, &config_b}) {
+    for (auto& op_type_latencies_us : config->op_type_latencies_us) {
+      op_type_latencies_us.second.resize(num_rounds, 0);
+      op_types.insert(op_type_latencies_us.first);
+    }
+  }
+  const std::vector<int64_t> not_run(num_rounds, 0);
+  auto latencies_us = [&not_run](const ComparisonConfig& config,
+                                 const std::string& op_type) {
+    auto it = config.op_type_latencies_us.find(op_type);
+    return it == config.op_type_latencies_us.end() ? &not_run : &it->second;
+  };
+  TFLITE_LOG(INFO) << "A/B comparison per op type, summing the latencies of "
+                      "the nodes of each type in a round:";
+  for (const std::string& op_type : op_types) {
+    LogComparison(op_type, *latencies_us(config_a, op_type),
+                  *latencies_us(config_b, op_type), &random_engine_);
+  }
+  return kTfLiteOk;
+}
+
 }  // namespace benchmark
 }  // namespace tflite
@@ -26,7 +26,9 @@ limitations under the License.
 
 #include "core/model.h"
 #include "core/subgraph.h"
+#include "profiling/buffered_profiler.h"
 #include "profiling/profiler.h"
+#include "profiling/root_profiler.h"
 #include "signature_runner.h"
 #include "tools/benchmark/benchmark_model.h"
 #include "tools/model_loader.h"
@@ -35,6 +37,9 @@ limitations under the License.
 namespace tflite {
 namespace benchmark {
 
+class MemoryTimelineListener;
+class StartupProfilingListener;
+
 // Splits the input_layer_name and input_layer_value_files and stores them in
 // the name_file_pair. In the case of failures, return an error status, and the
 // the state of name_file_pair is unchanged.
@@ -173,6 +178,21 @@ class BenchmarkTfLiteModel : public BenchmarkModel {
   TfLiteStatus PrepareInputData() override;
   TfLiteStatus ResetInputsAndOutputs() override;
 
+  // Runs the model from --throughput_threads threads at once, each owning an
+  // interpreter built from the shared 'model_', and reports the aggregate
+  // QPS, the latency percentiles and the CPU time of each thread.
+  TfLiteStatus RunThroughputBenchmark() override;
+
+  // Interleaves --ab_rounds runs of the model as configured on the command
+  // line (A) and with --ab_compare_flags applied on top (B), in a random order
+  // in each round, and reports the end-to-end and per op type latency deltas
+  // with their confidence intervals and significance.
+  TfLiteStatus RunComparisonBenchmark() override;
+
+  // Fills 'params_b' with the params of B in the A/B comparison, i.e. the
+  // current params with --ab_compare_flags applied on top.
+  TfLiteStatus ParseComparisonFlags(BenchmarkParams* params_b);
+
   int64_t MayGetModelFileSize() override;
 
   virtual TfLiteStatus LoadModel();
@@ -187,6 +207,10 @@ class BenchmarkTfLiteModel : public BenchmarkModel {
   // necessary.
   virtual std::unique_ptr<BenchmarkListener> MayCreateProfilingListener() const;
 
+  // Create a BenchmarkListener writing a Chrome trace of the benchmark runs if
+  // requested.
+  std::unique_ptr<BenchmarkListener> MayCreateChromeTraceListener() const;
+
   void CleanUp();
 
   utils::InputTensorData LoadInputTensorData(
@@ -200,6 +224,53 @@ class BenchmarkTfLiteModel : public BenchmarkModel {
   std::unique_ptr<tflite::ExternalCpuBackendContext> external_context_;
 
  private:
+  // An interpreter driven by one thread of the throughput benchmark. Members
+  // are destroyed in reverse order, so the runner goes before the interpreter
+  // and the interpreter before its delegates.
+  struct ThroughputWorker {
+    std::vector<Interpreter::TfLiteDelegatePtr> delegates;
+    std::unique_ptr<tflite::Interpreter> interpreter;
+    std::unique_ptr<BenchmarkInterpreterRunner> runner;
+    std::vector<int64_t> latencies_us;
+    int64_t cpu_time_us = 0;
+    int64_t end_us = 0;
+    TfLiteStatus status = kTfLiteOk;
+  };
+
+  // Builds an interpreter for 'model_' with the interpreter options taken
+  // from the benchmark params. 'profiler', if set, records the phases of the
+  // build.
+  TfLiteStatus BuildInterpreter(const tflite::OpResolver& resolver,
+                                std::unique_ptr<Interpreter>* interpreter,
+                                Profiler* profiler = nullptr);
+
+  // One of the two configurations of the A/B comparison. The profiler is only
+  // set with --enable_op_profiling, and outlives the interpreter using it.
+  struct ComparisonConfig {
+    std::unique_ptr<profiling::BufferedProfiler> profiler;
+    ThroughputWorker worker;
+    // The total latency of each op type in each measured round, 0 if the op
+    // type didn't run.
+    std::map<std::string, std::vector<int64_t>> op_type_latencies_us;
+  };
+
+  // Builds the interpreter of 'worker' the way Init() builds 'interpreter_',
+  // with its own instances of the requested delegates, and fills its inputs.
+  TfLiteStatus InitThroughputWorker(ThroughputWorker* worker);
+
+  // Builds the interpreter of 'config' like InitThroughputWorker() does, but
+  // with 'params' and 'model', if set, instead of those of the benchmark.
+  TfLiteStatus InitComparisonConfig(BenchmarkParams* params,
+                                    std::unique_ptr<FlatBufferModel>* model,
+                                    ComparisonConfig* config);
+
+  // Invokes the model of 'config' once, recording its latencies if
+  // 'measured' is set.
+  TfLiteStatus RunComparisonRound(bool measured, ComparisonConfig* config);
+
+  // Copies 'inputs_data_' into the input tensors of 'runner'.
+  TfLiteStatus CopyInputsTo(BenchmarkInterpreterRunner* runner);
+
   utils::InputTensorData CreateRandomTensorData(
       const TfLiteTensor& t, const InputLayerInfo* layer_info);
 
@@ -215,6 +286,19 @@ class BenchmarkTfLiteModel : public BenchmarkModel {
   // Always TFLITE_LOG the benchmark result.
   BenchmarkLoggingListener log_output_;
   std::unique_ptr<tools::ModelLoader> model_loader_;
+
+  // Set w/ --enable_startup_profiling. Owned by 'owned_listeners_'.
+  StartupProfilingListener* startup_profiling_listener_ = nullptr;
+  // Returns the profiler recording the startup phases, or null.
+  Profiler* startup_profiler() const;
+
+  // Set w/ --enable_memory_timeline. Owned by 'owned_listeners_'.
+  MemoryTimelineListener* memory_timeline_listener_ = nullptr;
+  // Forwards the events of the interpreter build to both the startup and the
+  // memory timeline profilers, when both are set.
+  std::unique_ptr<profiling::RootProfiler> build_root_profiler_;
+  // Returns the profiler recording the interpreter build, or null.
+  Profiler* build_profiler() const;
 };
 
 }  // namespace benchmark
@@ -18,6 +18,7 @@ limitations under the License.
 #include <fcntl.h>
 #include <sys/stat.h>
 
+#include <fstream>
 #include <string>
 #include <utility>
 
@@ -92,6 +93,94 @@ TEST(BenchmarkTfLiteModelTest, ResizeInputWithDelegate) {
   EXPECT_EQ(benchmark.Run(), kTfLiteOk);
 }
 
+TEST(BenchmarkTfLiteModelTest, ThroughputClosedLoop) {
+  BenchmarkParams params = BenchmarkTfLiteModel::DefaultParams();
+  params.Set<std::string>("graph", kModelPath);
+  params.Set<int>("num_runs", 1);
+  params.Set<int>("warmup_runs", 0);
+  params.Set<int>("throughput_threads", 2);
+  params.Set<float>("throughput_secs", 0.5f);
+
+  BenchmarkTfLiteModel benchmark = BenchmarkTfLiteModel(std::move(params));
+
+  EXPECT_EQ(benchmark.Run(), kTfLiteOk);
+}
+
+TEST(BenchmarkTfLiteModelTest, ThroughputOpenLoop) {
+  BenchmarkParams params = BenchmarkTfLiteModel::DefaultParams();
+  params.Set<std::string>("graph", kModelPath);
+  params.Set<int>("num_runs", 1);
+  params.Set<int>("warmup_runs", 0);
+  params.Set<int>("throughput_threads", 2);
+  params.Set<float>("throughput_arrival_rate", 20.0f);
+  params.Set<float>("throughput_secs", 0.5f);
+
+  BenchmarkTfLiteModel benchmark = BenchmarkTfLiteModel(std::move(params));
+
+  EXPECT_EQ(benchmark.Run(), kTfLiteOk);
+}
+
+TEST(BenchmarkTfLiteModelTest, ABComparison) {
+  BenchmarkParams params = BenchmarkTfLiteModel::DefaultParams();
+  params.Set<std::string>("graph", kModelPath);
+  params.Set<int>("num_runs", 1);
+  params.Set<int>("warmup_runs", 0);
+  params.Set<bool>("enable_op_profiling", true);
+  params.Set<std::string>("ab_compare_flags",
+                          " --num_threads=2  --use_caching=true");
+  params.Set<int>("ab_rounds", 4);
+  params.Set<int>("ab_warmup_rounds", 1);
+
+  BenchmarkTfLiteModel benchmark = BenchmarkTfLiteModel(std::move(params));
+
+  EXPECT_EQ(benchmark.Run(), kTfLiteOk);
+}
+
+TEST(BenchmarkTfLiteModelTest, ABComparisonWithInvalidFlags) {
+  BenchmarkParams params = BenchmarkTfLiteModel::DefaultParams();
+  params.Set<std::string>("graph", kModelPath);
+  params.Set<int>("num_runs", 1);
+  params.Set<int>("warmup_runs", 0);
+  params.Set<std::string>("ab_compare_flags", "--num_threads=two");
+
+  BenchmarkTfLiteModel benchmark = BenchmarkTfLiteModel(std::move(params));
+
+  EXPECT_EQ(benchmark.Run(), kTfLiteError);
+}
+
+class ComparisonFlagsBenchmark : public BenchmarkTfLiteModel {
+ public:
+  using BenchmarkTfLiteModel::BenchmarkTfLiteModel;
+  using BenchmarkTfLiteModel::ParseComparisonFlags;
+};
+
+TEST(BenchmarkTfLiteModelTest, ABComparisonKeepsCommandLineOverSettingsFile) {
+  const std::string settings_file =
+      ::testing::TempDir() + "/ab_comparison.settings";
+  {
+    std::ofstream file(settings_file);
+    file << "--num_threads=2\n"
+         << "--warmup_runs=3\n";
+  }
+  ComparisonFlagsBenchmark benchmark;
+  std::string settings_file_flag = "--settings_file=" + settings_file;
+  const char* args[] = {"benchmark", settings_file_flag.c_str(),
+                        "--num_threads=4",
+                        "--ab_compare_flags=--use_caching=true"};
+  int argc = 4;
+  ASSERT_EQ(benchmark.ParseFlags(&argc, const_cast<char**>(args)), kTfLiteOk);
+
+  BenchmarkParams params_b;
+  ASSERT_EQ(benchmark.ParseComparisonFlags(&params_b), kTfLiteOk);
+
+  // The command line of A takes precedence over the settings file in B too.
+  EXPECT_EQ(params_b.Get<int32_t>("num_threads"), 4);
+  EXPECT_EQ(params_b.Get<int32_t>("warmup_runs"), 3);
+  EXPECT_TRUE(params_b.Get<bool>("use_caching"));
+  EXPECT_EQ(benchmark.mutable_params()->Get<int32_t>("num_threads"), 4);
+  EXPECT_FALSE(benchmark.mutable_params()->Get<bool>("use_caching"));
+}
+
 }  // namespace
 }  // namespace benchmark
 }  // namespace tflite
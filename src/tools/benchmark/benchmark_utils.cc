@@ -15,6 +15,20 @@ limitations under the License.
 
 #include "tools/benchmark/benchmark_utils.h"
 
+#include <time.h>
+
+#if defined(__linux__) || defined(__ANDROID__)
+#include <sched.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
 #include "profiling/time.h"
 
 namespace tflite {
@@ -32,6 +46,191 @@ void SleepForSeconds(double sleep_seconds) {
       static_cast<uint64_t>(sleep_seconds * 1e6));
 }
 
+int64_t ThreadCpuTimeMicros() {
+#if defined(CLOCK_THREAD_CPUTIME_ID)
+  struct timespec ts;
+  if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) == 0) {
+    return static_cast<int64_t>(ts.tv_sec) * 1000000 + ts.tv_nsec / 1000;
+  }
+#endif
+  return -1;
+}
+
+int64_t Percentile(const std::vector<int64_t>& sorted_values,
+                   double percentile) {
+  if (sorted_values.empty()) {
+    return 0;
+  }
+  const int64_t count = static_cast<int64_t>(sorted_values.size());
+  // The epsilon keeps e.g. the 99.9th percentile of 1000 values at rank 999
+  // despite 99.9 not being exactly representable.
+  const int64_t rank =
+      static_cast<int64_t>(std::ceil(percentile / 100.0 * count - 1e-9));
+  return sorted_values[std::min(std::max<int64_t>(rank, 1), count) - 1];
+}
+
+double Median(std::vector<int64_t> values) {
+  if (values.empty()) {
+    return 0;
+  }
+  const size_t middle = values.size() / 2;
+  std::nth_element(values.begin(), values.begin() + middle, values.end());
+  const double upper = values[middle];
+  if (values.size() % 2 == 1) {
+    return upper;
+  }
+  const double lower =
+      *std::max_element(values.begin(), values.begin() + middle);
+  return (lower + upper) / 2;
+}
+
+double MannWhitneyUPValue(const std::vector<int64_t>& a,
+                          const std::vector<int64_t>& b) {
+  if (a.empty() || b.empty()) {
+    return 1.0;
+  }
+  // Ranks the pooled samples, giving tied values their average rank.
+  std::vector<std::pair<int64_t, bool>> pooled;
+  pooled.reserve(a.size() + b.size());
+  for (int64_t value : a) pooled.emplace_back(value, true);
+  for (int64_t value : b) pooled.emplace_back(value, false);
+  std::sort(pooled.begin(), pooled.end());
+  const double n = pooled.size();
+  double rank_sum_a = 0;
+  double tie_correction = 0;
+  for (size_t begin = 0; begin < pooled.size();) {
+    size_t end = begin + 1;
+    while (end < pooled.size() && pooled[end].first == pooled[begin].first) {
+      ++end;
+    }
+    const double num_ties = end - begin;
+    // Ranks start at 1.
+    const double average_rank = (begin + 1 + end) / 2.0;
+    for (size_t i = begin; i < end; ++i) {
+      if (pooled[i].second) rank_sum_a += average_rank;
+    }
+    tie_correction += num_ties * num_ties * num_ties - num_ties;
+    begin = end;
+  }
+
+  const double n_a = a.size();
+  const double n_b = b.size();
+  const double u_a = rank_sum_a - n_a * (n_a + 1) / 2;
+  const double mean = n_a * n_b / 2;
+  const double variance =
+      n_a * n_b / 12 * ((n + 1) - tie_correction / (n * (n - 1)));
+  if (variance <= 0) {
+    return 1.0;
+  }
+  const double z =
+      std::max(std::abs(u_a - mean) - 0.5, 0.0) / std::sqrt(variance);
+  return std::erfc(z / std::sqrt(2.0));
+}
+
+std::pair<double, double> BootstrapMedianDifferenceInterval(
+    const std::vector<int64_t>& a, const std::vector<int64_t>& b,
+    double confidence, int num_resamples, std::mt19937* engine) {
+  const size_t num_pairs = std::min(a.size(), b.size());
+  if (num_pairs == 0 || num_resamples <= 0) {
+    return {0, 0};
+  }
+  std::vector<int64_t> differences(num_pairs);
+  for (size_t i = 0; i < num_pairs; ++i) {
+    differences[i] = b[i] - a[i];
+  }
+  std::uniform_int_distribution<size_t> pick(0, num_pairs - 1);
+  std::vector<int64_t> resample(num_pairs);
+  std::vector<double> medians(num_resamples);
+  for (double& median : medians) {
+    for (int64_t& difference : resample) {
+      difference = differences[pick(*engine)];
+    }
+    median = Median(resample);
+  }
+  std::sort(medians.begin(), medians.end());
+  const double tail = (1.0 - confidence) / 2;
+  const int last = num_resamples - 1;
+  const int lower = std::clamp(static_cast<int>(tail * num_resamples), 0, last);
+  const int upper =
+      std::clamp(static_cast<int>((1.0 - tail) * num_resamples), 0, last);
+  return {medians[lower], medians[upper]};
+}
+
+bool ParseCpuList(const std::string& str, std::vector<int>* cpus) {
+  std::vector<std::string> ranges;
+  if (str.empty() || !SplitAndParse(str, ',', &ranges)) return false;
+  std::vector<int> result;
+  for (const auto& range : ranges) {
+    std::vector<int> bounds;
+    if (range.empty() || range.front() == '-' || range.back() == '-' ||
+        !SplitAndParse(range, '-', &bounds) || bounds.empty() ||
+        bounds.size() > 2) {
+      return false;
+    }
+    const int first = bounds.front();
+    const int last = bounds.back();
+    if (first < 0 || last < first) return false;
+    for (int cpu = first; cpu <= last; ++cpu) result.push_back(cpu);
+  }
+  std::sort(result.begin(), result.end());
+  result.erase(std::unique(result.begin(), result.end()), result.end());
+  *cpus = std::move(result);
+  return true;
+}
+
+std::string FormatCpuList(std::vector<int> cpus) {
+  std::sort(cpus.begin(), cpus.end());
+  cpus.erase(std::unique(cpus.begin(), cpus.end()), cpus.end());
+  std::string result;
+  for (size_t i = 0; i < cpus.size();) {
+    size_t j = i;
+    while (j + 1 < cpus.size() && cpus[j + 1] == cpus[j] + 1) ++j;
+    if (!result.empty()) result += ",";
+    result += std::to_string(cpus[i]);
+    if (j > i) result += "-" + std::to_string(cpus[j]);
+    i = j + 1;
+  }
+  return result;
+}
+
+bool SetCurrentThreadCpuAffinity(const std::vector<int>& cpus) {
+#if defined(__linux__) || defined(__ANDROID__)
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  for (const int cpu : cpus) {
+    if (cpu < 0 || cpu >= CPU_SETSIZE) return false;
+    CPU_SET(cpu, &cpu_set);
+  }
+  return sched_setaffinity(0, sizeof(cpu_set), &cpu_set) == 0;
+#else
+  return false;
+#endif
+}
+
+bool GetCurrentThreadCpuAffinity(std::vector<int>* cpus) {
+#if defined(__linux__) || defined(__ANDROID__)
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  if (sched_getaffinity(0, sizeof(cpu_set), &cpu_set) != 0) return false;
+  cpus->clear();
+  for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+    if (CPU_ISSET(cpu, &cpu_set)) cpus->push_back(cpu);
+  }
+  return true;
+#else
+  return false;
+#endif
+}
+
+ScopedCpuAffinity::ScopedCpuAffinity(const std::vector<int>& cpus) {
+  ok_ = GetCurrentThreadCpuAffinity(&previous_cpus_) &&
+        SetCurrentThreadCpuAffinity(cpus);
+}
+
+ScopedCpuAffinity::~ScopedCpuAffinity() {
+  if (ok_) SetCurrentThreadCpuAffinity(previous_cpus_);
+}
+
 }  // namespace util
 }  // namespace benchmark
 }  // namespace tflite
@@ -16,8 +16,11 @@ limitations under the License.
 #ifndef TENSORFLOW_LITE_TOOLS_BENCHMARK_BENCHMARK_UTILS_H_
 #define TENSORFLOW_LITE_TOOLS_BENCHMARK_BENCHMARK_UTILS_H_
 
+#include <cstdint>
+#include <random>
 #include <sstream>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace tflite {
@@ -28,6 +31,72 @@ namespace util {
 // simply return if 'sleep_seconds' is negative.
 void SleepForSeconds(double sleep_seconds);
 
+// Returns the CPU time in microseconds consumed so far by the calling thread,
+// or -1 if the platform doesn't provide per-thread CPU clocks.
+int64_t ThreadCpuTimeMicros();
+
+// Returns the 'percentile'-th percentile (0 < percentile <= 100) of
+// 'sorted_values' using the nearest-rank method, or 0 if 'sorted_values' is
+// empty. 'sorted_values' must be sorted in ascending order.
+int64_t Percentile(const std::vector<int64_t>& sorted_values,
+                   double percentile);
+
+// Returns the median of 'values', the mean of the two middle values if their
+// number is even, or 0 if 'values' is empty.
+double Median(std::vector<int64_t> values);
+
+// Returns the two-sided p-value of the Mann-Whitney U test of 'a' and 'b'
+// coming from the same distribution, using the normal approximation with tie
+// and continuity corrections. Returns 1 if either sample is empty or all the
+// values are equal.
+double MannWhitneyUPValue(const std::vector<int64_t>& a,
+                          const std::vector<int64_t>& b);
+
+// Returns the bootstrap percentile interval, at the 'confidence' level (e.g.
+// 0.95), of the median of the paired differences b[i] - a[i], drawing
+// 'num_resamples' resamples of the pairs with 'engine'. 'a' and 'b' must have
+// the same size; returns {0, 0} if they're empty.
+std::pair<double, double> BootstrapMedianDifferenceInterval(
+    const std::vector<int64_t>& a, const std::vector<int64_t>& b,
+    double confidence, int num_resamples, std::mt19937* engine);
+
+// Parses a list of CPU ids in the format taken by `taskset -c`, e.g. "0-3,6",
+// into 'cpus' in ascending order without duplicates. Returns false if 'str' is
+// malformed or empty.
+bool ParseCpuList(const std::string& str, std::vector<int>* cpus);
+
+// The inverse of ParseCpuList, collapsing consecutive ids into ranges.
+std::string FormatCpuList(std::vector<int> cpus);
+
+// Restricts the calling thread, and the threads it creates from now on, to
+// run on 'cpus'. Returns false if the platform doesn't support setting the CPU
+// affinity or the call fails.
+bool SetCurrentThreadCpuAffinity(const std::vector<int>& cpus);
+
+// Returns in 'cpus' the CPUs the calling thread may run on, in ascending
+// order. Returns false if the platform doesn't support getting the CPU
+// affinity or the call fails.
+bool GetCurrentThreadCpuAffinity(std::vector<int>* cpus);
+
+// Restricts the calling thread to 'cpus' like SetCurrentThreadCpuAffinity()
+// and restores its previous affinity when destroyed. Threads created in the
+// meantime keep the restricted affinity.
+class ScopedCpuAffinity {
+ public:
+  explicit ScopedCpuAffinity(const std::vector<int>& cpus);
+  ~ScopedCpuAffinity();
+
+  ScopedCpuAffinity(const ScopedCpuAffinity&) = delete;
+  ScopedCpuAffinity& operator=(const ScopedCpuAffinity&) = delete;
+
+  // Whether the affinity was set, and so will be restored.
+  bool ok() const { return ok_; }
+
+ private:
+  std::vector<int> previous_cpus_;
+  bool ok_ = false;
+};
+
 // Split the 'str' according to 'delim', and store each splitted element into
 // 'values'.
 template <typename T>
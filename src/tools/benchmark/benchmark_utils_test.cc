@@ -14,6 +14,7 @@ limitations under the License.
 ==============================================================================*/
 #include "tools/benchmark/benchmark_utils.h"
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -46,6 +47,81 @@ TEST(BenchmarkHelpersTest, SleepForSomeSeconds) {
   EXPECT_GT(end_ts - start_ts, 1900000);
 }
 
+TEST(BenchmarkHelpersTest, ThreadCpuTimeIsMonotonic) {
+  const int64_t start_us = util::ThreadCpuTimeMicros();
+  if (start_us < 0) {
+    GTEST_SKIP() << "Per-thread CPU clocks are not supported.";
+  }
+  // Burn some CPU time on this thread.
+  volatile int64_t sum = 0;
+  for (int64_t i = 0; i < 10000000; ++i) {
+    sum = sum + i;
+  }
+  EXPECT_GE(util::ThreadCpuTimeMicros(), start_us);
+}
+
+TEST(BenchmarkHelpersTest, Percentile) {
+  std::vector<int64_t> values;
+  for (int64_t i = 1; i <= 1000; ++i) {
+    values.push_back(i);
+  }
+
+  EXPECT_EQ(util::Percentile(values, 50.0), 500);
+  EXPECT_EQ(util::Percentile(values, 90.0), 900);
+  EXPECT_EQ(util::Percentile(values, 99.0), 990);
+  EXPECT_EQ(util::Percentile(values, 99.9), 999);
+  EXPECT_EQ(util::Percentile(values, 100.0), 1000);
+  EXPECT_EQ(util::Percentile({42}, 99.9), 42);
+  EXPECT_EQ(util::Percentile({}, 50.0), 0);
+}
+
+TEST(BenchmarkHelpersTest, Median) {
+  EXPECT_EQ(util::Median({}), 0);
+  EXPECT_EQ(util::Median({5, 1, 3}), 3);
+  EXPECT_EQ(util::Median({4, 1, 3, 2}), 2.5);
+}
+
+TEST(BenchmarkHelpersTest, MannWhitneyUPValue) {
+  EXPECT_EQ(util::MannWhitneyUPValue({}, {1, 2}), 1.0);
+  EXPECT_EQ(util::MannWhitneyUPValue({3, 3, 3}, {3, 3}), 1.0);
+
+  std::vector<int64_t> a;
+  std::vector<int64_t> shifted;
+  std::vector<int64_t> interleaved;
+  for (int64_t i = 0; i < 20; ++i) {
+    a.push_back(100 + i);
+    shifted.push_back(110 + i);
+    interleaved.push_back(100 + i + (i % 2 == 0 ? 1 : -1));
+  }
+  // The 10 overlapping values are ties, so U = 45 + 10 / 2 = 50 against a
+  // mean of 200 and a tie corrected variance of 1365.4, and z = 4.05.
+  EXPECT_NEAR(util::MannWhitneyUPValue(a, shifted), 5.2e-5, 1e-6);
+  EXPECT_NEAR(util::MannWhitneyUPValue(shifted, a),
+              util::MannWhitneyUPValue(a, shifted), 1e-12);
+  EXPECT_GT(util::MannWhitneyUPValue(a, interleaved), 0.5);
+}
+
+TEST(BenchmarkHelpersTest, BootstrapMedianDifferenceInterval) {
+  std::mt19937 engine(0);
+  EXPECT_EQ(util::BootstrapMedianDifferenceInterval({}, {}, 0.95, 100, &engine),
+            std::make_pair(0.0, 0.0));
+
+  std::vector<int64_t> a;
+  std::vector<int64_t> b;
+  for (int64_t i = 0; i < 50; ++i) {
+    // A drift common to both configurations doesn't widen the interval of
+    // the paired differences.
+    a.push_back(1000 + 10 * i);
+    b.push_back(1000 + 10 * i + 20 + i % 5);
+  }
+  const std::pair<double, double> interval =
+      util::BootstrapMedianDifferenceInterval(a, b, 0.95, 1000, &engine);
+  EXPECT_GE(interval.first, 20);
+  EXPECT_LE(interval.first, 22);
+  EXPECT_GE(interval.second, 22);
+  EXPECT_LE(interval.second, 24);
+}
+
 TEST(BenchmarkHelpersTest, SplitAndParseFailed) {
   std::vector<int> results;
   const bool splitted = util::SplitAndParse("hello;world", ';', &results);
@@ -75,6 +151,42 @@ TEST(BenchmarkHelpersTest, SplitAndParseInts) {
   EXPECT_EQ(2, results[1]);
 }
 
+TEST(BenchmarkHelpersTest, ParseCpuList) {
+  std::vector<int> cpus;
+  EXPECT_TRUE(util::ParseCpuList("6,0-3,2", &cpus));
+  EXPECT_EQ(std::vector<int>({0, 1, 2, 3, 6}), cpus);
+
+  EXPECT_FALSE(util::ParseCpuList("", &cpus));
+  EXPECT_FALSE(util::ParseCpuList("3-1", &cpus));
+  EXPECT_FALSE(util::ParseCpuList("1-", &cpus));
+  EXPECT_FALSE(util::ParseCpuList("1-2-3", &cpus));
+  EXPECT_FALSE(util::ParseCpuList("a", &cpus));
+}
+
+TEST(BenchmarkHelpersTest, FormatCpuList) {
+  EXPECT_EQ("", util::FormatCpuList({}));
+  EXPECT_EQ("0-3,6", util::FormatCpuList({6, 0, 1, 2, 3}));
+  EXPECT_EQ("1,3,5-6", util::FormatCpuList({1, 3, 5, 6, 6}));
+}
+
+TEST(BenchmarkHelpersTest, ScopedCpuAffinityRestoresTheAffinity) {
+  std::vector<int> cpus;
+  if (!util::GetCurrentThreadCpuAffinity(&cpus)) {
+    GTEST_SKIP() << "Getting the CPU affinity is not supported";
+  }
+  ASSERT_FALSE(cpus.empty());
+  {
+    util::ScopedCpuAffinity cpu_affinity({cpus.back()});
+    ASSERT_TRUE(cpu_affinity.ok());
+    std::vector<int> scoped_cpus;
+    ASSERT_TRUE(util::GetCurrentThreadCpuAffinity(&scoped_cpus));
+    EXPECT_THAT(scoped_cpus, ::testing::ElementsAre(cpus.back()));
+  }
+  std::vector<int> restored_cpus;
+  ASSERT_TRUE(util::GetCurrentThreadCpuAffinity(&restored_cpus));
+  EXPECT_EQ(restored_cpus, cpus);
+}
+
 }  // namespace
 }  // namespace benchmark
 }  // namespace tflite
@@ -15,8 +15,15 @@ limitations under the License.
 
 #include "tools/benchmark/profiling_listener.h"
 
+#include <algorithm>
+#include <cstdint>
 #include <fstream>
+#include <iomanip>
+#include <memory>
+#include <sstream>
 #include <string>
+#include <tuple>
+#include <vector>
 
 #include "tools/logging.h"
 
@@ -26,7 +33,8 @@ namespace benchmark {
 ProfilingListener::ProfilingListener(
     Interpreter* interpreter, uint32_t max_num_initial_entries,
     bool allow_dynamic_buffer_increase, const std::string& csv_file_path,
-    std::shared_ptr<profiling::ProfileSummaryFormatter> summarizer_formatter)
+    std::shared_ptr<profiling::ProfileSummaryFormatter> summarizer_formatter,
+    bool enable_hardware_counters)
     : run_summarizer_(summarizer_formatter),
       init_summarizer_(summarizer_formatter),
       csv_file_path_(csv_file_path),
@@ -34,6 +42,13 @@ ProfilingListener::ProfilingListener(
       profiler_(max_num_initial_entries, allow_dynamic_buffer_increase) {
   TFLITE_TOOLS_CHECK(interpreter);
   interpreter_->SetProfiler(&profiler_);
+  if (enable_hardware_counters) {
+    // The counters count the thread creating them, which is the one invoking
+    // the interpreter.
+    perf_event_profiler_ = std::make_unique<profiling::PerfEventProfiler>(
+        max_num_initial_entries);
+    interpreter_->AddProfiler(perf_event_profiler_.get());
+  }
 
   // We start profiling here in order to catch events that are recorded during
   // the benchmark run preparation stage where TFLite interpreter is
@@ -56,6 +71,10 @@ void ProfilingListener::OnSingleRunStart(RunType run_type) {
   if (run_type == REGULAR) {
     profiler_.Reset();
     profiler_.StartProfiling();
+    if (perf_event_profiler_) {
+      perf_event_profiler_->Reset();
+      perf_event_profiler_->StartProfiling();
+    }
   }
 }
 
@@ -63,6 +82,12 @@ void ProfilingListener::OnSingleRunEnd() {
   profiler_.StopProfiling();
   auto profile_events = profiler_.GetProfileEvents();
   run_summarizer_.ProcessProfiles(profile_events, *interpreter_);
+  if (perf_event_profiler_) {
+    perf_event_profiler_->StopProfiling();
+    run_summarizer_.ProcessHardwareCounters(
+        perf_event_profiler_->GetProfileEvents(), *interpreter_);
+    perf_event_profiler_->Reset();
+  }
 }
 
 void ProfilingListener::OnBenchmarkEnd(const BenchmarkResults& results) {
@@ -83,6 +108,162 @@ void ProfilingListener::OnBenchmarkEnd(const BenchmarkResults& results) {
   }
 }
 
+ChromeTraceListener::ChromeTraceListener(
+    Interpreter* interpreter, CpuBackendContext* cpu_backend_context,
+    const std::string& trace_file_path, uint32_t max_num_entries)
+    : cpu_backend_context_(cpu_backend_context),
+      trace_file_path_(trace_file_path),
+      profiler_(max_num_entries) {
+  TFLITE_TOOLS_CHECK(interpreter);
+  interpreter->AddProfiler(&profiler_);
+  if (cpu_backend_context_ != nullptr) {
+    cpu_backend_context_->SetThreadpoolProfiler(&profiler_);
+  }
+}
+
+ChromeTraceListener::~ChromeTraceListener() {
+  if (cpu_backend_context_ != nullptr) {
+    cpu_backend_context_->SetThreadpoolProfiler(nullptr);
+  }
+}
+
+void ChromeTraceListener::OnSingleRunStart(RunType run_type) {
+  if (run_type == REGULAR) {
+    profiler_.StartProfiling();
+  }
+}
+
+void ChromeTraceListener::OnSingleRunEnd() { profiler_.StopProfiling(); }
+
+void ChromeTraceListener::OnBenchmarkEnd(const BenchmarkResults& results) {
+  std::ofstream output_file(trace_file_path_);
+  if (!output_file.good()) {
+    TFLITE_LOG(ERROR) << "Failed to open the trace file " << trace_file_path_;
+    return;
+  }
+  profiler_.WriteTrace(&output_file);
+  TFLITE_LOG(INFO) << "Wrote " << profiler_.NumEvents()
+                   << " trace events to " << trace_file_path_;
+}
+
+namespace {
+
+profiling::SamplingProfiler::Options GetSamplingProfilerOptions(
+    uint32_t sampling_period) {
+  profiling::SamplingProfiler::Options options;
+  options.sampling_period = sampling_period;
+  // Aggregates in the background as in production.
+  options.aggregation_interval_ms = 100;
+  return options;
+}
+
+}  // namespace
+
+SamplingProfilerListener::SamplingProfilerListener(Interpreter* interpreter,
+                                                   uint32_t sampling_period)
+    : profiler_(GetSamplingProfilerOptions(sampling_period)) {
+  TFLITE_TOOLS_CHECK(interpreter);
+  interpreter->AddProfiler(&profiler_);
+}
+
+void SamplingProfilerListener::OnBenchmarkEnd(
+    const BenchmarkResults& results) {
+  std::vector<profiling::OpLatencyStats> stats = profiler_.GetOpLatencyStats();
+  // Lists the ops by event type, subgraph and node.
+  auto sort_key = [](const profiling::OpLatencyStats& op_stats) {
+    return std::make_tuple(static_cast<int>(op_stats.event_type),
+                           op_stats.subgraph_index, op_stats.node_index);
+  };
+  std::sort(stats.begin(), stats.end(),
+            [&sort_key](const profiling::OpLatencyStats& a,
+                        const profiling::OpLatencyStats& b) {
+              return sort_key(a) < sort_key(b);
+            });
+  std::stringstream table;
+  table << std::setw(8) << "[count]" << std::setw(10) << "[avg us]"
+        << std::setw(10) << "[p50 us]" << std::setw(10) << "[p99 us]"
+        << std::setw(10) << "[max us]"
+        << "  [name]\n";
+  for (const profiling::OpLatencyStats& op_stats : stats) {
+    const profiling::LatencyHistogram& histogram = op_stats.histogram;
+    table << std::setw(8) << histogram.count << std::setw(10)
+          << histogram.sum_us / std::max<uint64_t>(histogram.count, 1)
+          << std::setw(10) << histogram.Percentile(50) << std::setw(10)
+          << histogram.Percentile(99) << std::setw(10) << histogram.max_us
+          << "  " << op_stats.tag << "\n";
+  }
+  TFLITE_LOG(INFO) << "Sampled operator latencies (percentiles are bucket "
+                      "upper bounds), "
+                   << profiler_.NumDroppedEvents() << " events dropped:\n"
+                   << table.str();
+}
+
+StartupProfilingListener::StartupProfilingListener(
+    uint32_t max_num_initial_entries)
+    : profiler_(max_num_initial_entries,
+                /*allow_dynamic_buffer_increase=*/true) {
+  profiler_.StartProfiling();
+}
+
+void StartupProfilingListener::AttachInterpreter(Interpreter* interpreter) {
+  TFLITE_TOOLS_CHECK(interpreter);
+  interpreter_ = interpreter;
+  interpreter_->AddProfiler(&profiler_);
+}
+
+void StartupProfilingListener::OnSingleRunEnd() {
+  // The first run, warmup or not, is the first invoke of the model.
+  if (!recording_) return;
+  recording_ = false;
+  profiler_.StopProfiling();
+  summarizer_.ProcessProfiles(profiler_.GetProfileEvents(), interpreter_);
+  profiler_.Reset();
+}
+
+void StartupProfilingListener::OnBenchmarkEnd(
+    const BenchmarkResults& results) {
+  if (!summarizer_.HasProfiles()) return;
+  TFLITE_LOG(INFO) << "Startup time breakdown, up to the end of the first "
+                      "invoke:\n"
+                   << summarizer_.GetOutputString();
+}
+
+MemoryTimelineListener::MemoryTimelineListener(
+    const std::string& csv_file_path, uint32_t max_num_events)
+    : csv_file_path_(csv_file_path), profiler_(max_num_events) {
+  profiler_.StartProfiling();
+}
+
+void MemoryTimelineListener::AttachInterpreter(Interpreter* interpreter) {
+  TFLITE_TOOLS_CHECK(interpreter);
+  interpreter_ = interpreter;
+  interpreter_->AddProfiler(&profiler_);
+}
+
+void MemoryTimelineListener::OnBenchmarkEnd(const BenchmarkResults& results) {
+  profiler_.StopProfiling();
+  profiling::MemoryTimelineSummarizer summarizer;
+  summarizer.ProcessEvents(profiler_.events(), interpreter_);
+  if (!summarizer.HasProfiles()) return;
+  TFLITE_LOG(INFO) << "Memory allocated by the runtime, per operator and over "
+                      "time:\n"
+                   << summarizer.GetOutputString();
+  TFLITE_MAY_LOG(WARN, profiler_.num_dropped_events() > 0)
+      << "Dropped " << profiler_.num_dropped_events()
+      << " memory events, the peak of " << profiler_.peak_bytes() / 1024.0
+      << " KB may be missing from the timeline.";
+  if (csv_file_path_.empty()) return;
+  std::ofstream output_file(csv_file_path_);
+  if (!output_file.good()) {
+    TFLITE_LOG(ERROR) << "Failed to open the memory timeline file "
+                      << csv_file_path_;
+    return;
+  }
+  output_file << summarizer.GetCsvString();
+  TFLITE_LOG(INFO) << "Wrote " << profiler_.events().size()
+                   << " memory events to " << csv_file_path_;
+}
+
 void ProfilingListener::WriteOutput(const std::string& header,
                                     const string& data, std::ostream* stream) {
   (*stream) << header << std::endl;
@@ -20,21 +20,33 @@ limitations under the License.
 #include <string>
 
 #include "profiling/buffered_profiler.h"
+#include "profiling/chrome_trace_profiler.h"
+#include "profiling/machine_peak.h"
+#include "profiling/memory_timeline_profiler.h"
+#include "profiling/memory_timeline_summarizer.h"
+#include "profiling/perf_event_profiler.h"
 #include "profiling/profile_summarizer.h"
 #include "profiling/profile_summary_formatter.h"
+#include "profiling/sampling_profiler.h"
+#include "profiling/startup_time_summarizer.h"
+#include "kernels/cpu_backend_context.h"
 #include "tools/benchmark/benchmark_model.h"
 
 namespace tflite {
 namespace benchmark {
 
-// Dumps profiling events if profiling is enabled.
+// Dumps profiling events if profiling is enabled. If
+// 'enable_hardware_counters' is set, the hardware performance counters of
+// each operator are also recorded during the regular runs and summarized
+// after the operator timings.
 class ProfilingListener : public BenchmarkListener {
  public:
   ProfilingListener(
       Interpreter* interpreter, uint32_t max_num_initial_entries,
       bool allow_dynamic_buffer_increase, const std::string& csv_file_path = "",
       std::shared_ptr<profiling::ProfileSummaryFormatter> summarizer_formatter =
-          std::make_shared<profiling::ProfileSummaryDefaultFormatter>());
+          std::make_shared<profiling::ProfileSummaryDefaultFormatter>(),
+      bool enable_hardware_counters = false);
 
   void OnBenchmarkStart(const BenchmarkParams& params) override;
 
@@ -44,6 +56,12 @@ class ProfilingListener : public BenchmarkListener {
 
   void OnBenchmarkEnd(const BenchmarkResults& results) override;
 
+  // Also reports the estimated flops and bytes of each operator of the
+  // regular runs against the roofline of 'machine_peak'.
+  void EnableRoofline(const profiling::MachinePeak& machine_peak) {
+    run_summarizer_.EnableRoofline(machine_peak);
+  }
+
  protected:
   profiling::ProfileSummarizer run_summarizer_;
   profiling::ProfileSummarizer init_summarizer_;
@@ -54,6 +72,99 @@ class ProfilingListener : public BenchmarkListener {
                    std::ostream* stream);
   Interpreter* interpreter_;
   profiling::BufferedProfiler profiler_;
+  std::unique_ptr<profiling::PerfEventProfiler> perf_event_profiler_;
+};
+
+// Writes a Chrome trace of the regular benchmark runs to 'trace_file_path',
+// with the events of the interpreter and, if 'cpu_backend_context' is set, of
+// the cpu_backend_threadpool tasks of its kernels. Must be created after any
+// ProfilingListener, which replaces the profilers of the interpreter.
+class ChromeTraceListener : public BenchmarkListener {
+ public:
+  ChromeTraceListener(Interpreter* interpreter,
+                      CpuBackendContext* cpu_backend_context,
+                      const std::string& trace_file_path,
+                      uint32_t max_num_entries);
+  ~ChromeTraceListener() override;
+
+  void OnSingleRunStart(RunType run_type) override;
+
+  void OnSingleRunEnd() override;
+
+  void OnBenchmarkEnd(const BenchmarkResults& results) override;
+
+ private:
+  CpuBackendContext* cpu_backend_context_;
+  std::string trace_file_path_;
+  profiling::ChromeTraceProfiler profiler_;
+};
+
+// Keeps a SamplingProfiler, the profiler meant for production, on for the
+// whole benchmark and logs the per operator latencies it pulled at the end, so
+// that its overhead can be measured against a run without it. Must be created
+// after any ProfilingListener, which replaces the profilers of the
+// interpreter.
+class SamplingProfilerListener : public BenchmarkListener {
+ public:
+  SamplingProfilerListener(Interpreter* interpreter, uint32_t sampling_period);
+
+  void OnBenchmarkEnd(const BenchmarkResults& results) override;
+
+ private:
+  profiling::SamplingProfiler profiler_;
+};
+
+// Records the startup of the model, from its loading to the end of its first
+// invoke, and logs the time spent in each phase and in preparing each
+// operator at the end of the benchmark. Must be created before the model is
+// loaded, w/ its profiler passed to the model loader and the interpreter
+// builder.
+class StartupProfilingListener : public BenchmarkListener {
+ public:
+  explicit StartupProfilingListener(uint32_t max_num_initial_entries);
+
+  Profiler* profiler() { return &profiler_; }
+
+  // Records the events of 'interpreter' too. Must be called after any
+  // ProfilingListener is created, which replaces the profilers of the
+  // interpreter.
+  void AttachInterpreter(Interpreter* interpreter);
+
+  void OnSingleRunEnd() override;
+
+  void OnBenchmarkEnd(const BenchmarkResults& results) override;
+
+ private:
+  Interpreter* interpreter_ = nullptr;
+  profiling::BufferedProfiler profiler_;
+  profiling::StartupTimeSummarizer summarizer_;
+  bool recording_ = true;
+};
+
+// Records the memory allocated by the runtime for the whole benchmark, from
+// the creation of the listener, and logs the memory held by each operator and
+// the timeline of the allocations at the end. The whole timeline is also
+// written to 'csv_file_path' if it's set. Must be created before the
+// interpreter is built, w/ its profiler passed to the interpreter builder so
+// that the memory the kernels allocate on init is recorded.
+class MemoryTimelineListener : public BenchmarkListener {
+ public:
+  MemoryTimelineListener(const std::string& csv_file_path,
+                         uint32_t max_num_events);
+
+  Profiler* profiler() { return &profiler_; }
+
+  // Records the events of 'interpreter' too. Must be called after any
+  // ProfilingListener is created, which replaces the profilers of the
+  // interpreter.
+  void AttachInterpreter(Interpreter* interpreter);
+
+  void OnBenchmarkEnd(const BenchmarkResults& results) override;
+
+ private:
+  Interpreter* interpreter_ = nullptr;
+  std::string csv_file_path_;
+  profiling::MemoryTimelineProfiler profiler_;
 };
 
 }  // namespace benchmark
@@ -14,6 +14,7 @@ limitations under the License.
 
 #include <algorithm>
 #include <cstring>
+#include <fstream>
 #include <functional>
 #include <iomanip>
 #include <numeric>
@@ -257,6 +258,44 @@ std::string Flag::GetTypeName() const {
   return result && (*argc < 2 || std::strcmp(argv[1], "--help") != 0);
 }
 
+/*static*/ bool Flags::ParseFile(const std::string& path,
+                                 const std::vector<Flag>& flag_list) {
+  std::ifstream file(path);
+  if (!file.is_open()) {
+    TFLITE_LOG(ERROR) << "Failed to open the settings file: " << path;
+    return false;
+  }
+
+  // Keep argv[0] as a placeholder for the program name, like a real cmdline.
+  std::vector<std::string> args = {path};
+  std::string line;
+  while (std::getline(file, line)) {
+    const size_t begin = line.find_first_not_of(" \t\r");
+    if (begin == std::string::npos || line[begin] == '#') continue;
+    const size_t end = line.find_last_not_of(" \t\r");
+    std::string arg = line.substr(begin, end - begin + 1);
+    if (!absl::StartsWith(arg, "--")) arg = "--" + arg;
+    args.push_back(arg);
+  }
+
+  // Positional and required flags only make sense on the real cmdline.
+  std::vector<Flag> optional_flags;
+  for (const Flag& flag : flag_list) {
+    if (flag.flag_type_ == Flag::kOptional) optional_flags.push_back(flag);
+  }
+
+  std::vector<const char*> argv;
+  argv.reserve(args.size());
+  for (const auto& arg : args) argv.push_back(arg.c_str());
+  int argc = static_cast<int>(argv.size());
+  const bool result = Parse(&argc, argv.data(), optional_flags);
+  for (int i = 1; i < argc; ++i) {
+    TFLITE_LOG(WARN) << "Unrecognized flag in the settings file " << path
+                     << ": " << argv[i];
+  }
+  return result;
+}
+
 /*static*/ std::string Flags::Usage(const std::string& cmdline,
                                     const std::vector<Flag>& flag_list) {
   // Stores indexes of flag_list in a sorted order.
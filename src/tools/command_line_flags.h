@@ -162,6 +162,15 @@ class Flags {
   static bool Parse(int* argc, const char** argv,
                     const std::vector<Flag>& flag_list);
 
+  // Parse a settings file holding one "--flag=value" per line against the
+  // optional flags in flag_list[]. Empty lines and lines starting with '#' are
+  // ignored, and the leading "--" may be omitted. Lines that don't match any
+  // flag are logged and skipped so that a single file can be shared by tools
+  // with different flag sets. Return false if the file can't be read or any
+  // recognized flag value fails to parse.
+  static bool ParseFile(const std::string& path,
+                        const std::vector<Flag>& flag_list);
+
   // Return a usage message with command line cmdline, and the
   // usage_text strings in flag_list[].
   static std::string Usage(const std::string& cmdline,
@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "tools/command_line_flags.h"
 
+#include <fstream>
 #include <string>
 
 #include <gtest/gtest.h>
@@ -366,6 +367,47 @@ TEST(CommandLineFlagsTest, ArgsToString) {
   EXPECT_EQ("--some_int=1 --some_int=2", args);
 }
 
+TEST(CommandLineFlagsTest, ParseFile) {
+  const std::string path = ::testing::TempDir() + "/parse_file_settings.txt";
+  {
+    std::ofstream file(path);
+    file << "# Written by hand.\n"
+         << "--some_int=4\n"
+         << "\n"
+         << "  some_name=from_file  \n"
+         << "--unknown_flag=1\n";
+  }
+  int some_int = 1;
+  int positional_int = 2;
+  std::string some_name = "something";
+  bool parsed_ok = Flags::ParseFile(
+      path, {
+                Flag::CreateFlag("some_int", &some_int, "some int"),
+                Flag::CreateFlag("some_name", &some_name, "some name"),
+                Flag::CreateFlag("positional_int", &positional_int,
+                                 "positional int", Flag::kPositional),
+            });
+
+  EXPECT_TRUE(parsed_ok);
+  EXPECT_EQ(4, some_int);
+  EXPECT_EQ("from_file", some_name);
+  EXPECT_EQ(2, positional_int);
+}
+
+TEST(CommandLineFlagsTest, ParseFileWithBadValue) {
+  const std::string path = ::testing::TempDir() + "/parse_file_bad.txt";
+  {
+    std::ofstream file(path);
+    file << "--some_int=four\n";
+  }
+  int some_int = 1;
+  EXPECT_FALSE(Flags::ParseFile(
+      path, {Flag::CreateFlag("some_int", &some_int, "some int")}));
+  EXPECT_FALSE(
+      Flags::ParseFile(path + ".missing",
+                       {Flag::CreateFlag("some_int", &some_int, "some int")}));
+}
+
 TEST(CommandLineFlagsTest, ArgvPositions) {
   tools::ToolParams params;
   params.AddParam("some_int", tools::ToolParam::Create<int>(13));
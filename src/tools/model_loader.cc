@@ -23,6 +23,8 @@ limitations under the License.
 
 #include "absl/strings/numbers.h"
 #include "absl/strings/str_split.h"
+#include "allocation.h"
+#include "core/api/profiler.h"
 #include "core/model_builder.h"
 #include "minimal_logging.h"
 
@@ -48,7 +50,22 @@ bool PathModelLoader::InitInternal() {
     TFLITE_LOG_PROD(TFLITE_LOG_ERROR, "model_path is empty.");
     return false;
   }
-  model_ = FlatBufferModel::VerifyAndBuildFromFile(model_path_.c_str());
+  std::unique_ptr<Allocation> allocation;
+  {
+    TFLITE_SCOPED_TAGGED_DEFAULT_PROFILE(profiler_, "MapModelFile");
+    if (MMAPAllocation::IsSupported()) {
+      allocation = std::make_unique<MMAPAllocation>(
+          model_path_.c_str(), tflite::DefaultErrorReporter());
+    } else {
+      allocation = std::make_unique<FileCopyAllocation>(
+          model_path_.c_str(), tflite::DefaultErrorReporter());
+    }
+  }
+  TFLITE_SCOPED_TAGGED_DEFAULT_PROFILE(profiler_, "VerifyAndBuildModel");
+  model_ = FlatBufferModel::VerifyAndBuildFromAllocation(std::move(allocation));
+#if FLATBUFFERS_LITTLEENDIAN == 0
+  model_ = FlatBufferModel::ByteConvertModel(std::move(model_));
+#endif
   return true;
 }
 
@@ -60,6 +77,7 @@ bool BufferModelLoader::InitInternal() {
                     caller_owned_buffer_ ? "not null" : "null", model_size_);
     return false;
   }
+  TFLITE_SCOPED_TAGGED_DEFAULT_PROFILE(profiler_, "VerifyAndBuildModel");
   model_ = FlatBufferModel::VerifyAndBuildFromBuffer(caller_owned_buffer_,
                                                      model_size_);
   return true;
@@ -80,12 +98,17 @@ bool MmapModelLoader::InitInternal() {
     TFLITE_LOG_PROD(TFLITE_LOG_ERROR, "MMAPAllocation is not supported.");
     return false;
   }
-  auto allocation = std::make_unique<MMAPAllocation>(
-      model_fd_, model_offset_, model_size_, tflite::DefaultErrorReporter());
+  std::unique_ptr<MMAPAllocation> allocation;
+  {
+    TFLITE_SCOPED_TAGGED_DEFAULT_PROFILE(profiler_, "MapModelFile");
+    allocation = std::make_unique<MMAPAllocation>(
+        model_fd_, model_offset_, model_size_, tflite::DefaultErrorReporter());
+  }
   if (!allocation->valid()) {
     TFLITE_LOG_PROD(TFLITE_LOG_ERROR, "MMAPAllocation is not valid.");
     return false;
   }
+  TFLITE_SCOPED_TAGGED_DEFAULT_PROFILE(profiler_, "VerifyAndBuildModel");
   model_ = FlatBufferModel::VerifyAndBuildFromAllocation(std::move(allocation));
 #if FLATBUFFERS_LITTLEENDIAN == 0
   model_ = FlatBufferModel::ByteConvertModel(std::move(model_));
@@ -105,11 +128,14 @@ bool PipeModelLoader::InitInternal() {
 
   int read_bytes = 0;
   int remaining_bytes = model_size_;
-  uint8_t* buffer = model_buffer_;
-  while (remaining_bytes > 0 &&
-         (read_bytes = read(pipe_fd_, buffer, remaining_bytes)) > 0) {
-    remaining_bytes -= read_bytes;
-    buffer += read_bytes;
+  {
+    TFLITE_SCOPED_TAGGED_DEFAULT_PROFILE(profiler_, "ReadModelPipe");
+    uint8_t* buffer = model_buffer_;
+    while (remaining_bytes > 0 &&
+           (read_bytes = read(pipe_fd_, buffer, remaining_bytes)) > 0) {
+      remaining_bytes -= read_bytes;
+      buffer += read_bytes;
+    }
   }
   // Close the read pipe.
   close(pipe_fd_);
@@ -123,6 +149,7 @@ bool PipeModelLoader::InitInternal() {
     return false;
   }
 
+  TFLITE_SCOPED_TAGGED_DEFAULT_PROFILE(profiler_, "VerifyAndBuildModel");
   model_ = FlatBufferModel::VerifyAndBuildFromBuffer(
       reinterpret_cast<const char*>(model_buffer_), model_size_);
   return true;
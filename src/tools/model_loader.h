@@ -26,6 +26,7 @@ limitations under the License.
 #include <vector>
 
 #include "absl/strings/string_view.h"
+#include "core/api/profiler.h"
 #include "core/model_builder.h"
 
 namespace tflite {
@@ -51,6 +52,12 @@ class ModelLoader {
 
   const FlatBufferModel* GetModel() const { return model_.get(); }
 
+  // Sets a profiler that records the phases of Init(): getting the model bytes
+  // ("MapModelFile" or "ReadModelPipe") and verifying and building the model
+  // from them ("VerifyAndBuildModel"). Doesn't own 'profiler', which must
+  // outlive the calls to Init().
+  void SetProfiler(Profiler* profiler) { profiler_ = profiler; }
+
  protected:
   // Interface for subclass to create model_. Init() calls InitInternal(). If
   // InitInternal() returns false, or if it returns true but model_ remains
@@ -58,6 +65,7 @@ class ModelLoader {
   virtual bool InitInternal() = 0;
 
   std::unique_ptr<FlatBufferModel> model_;
+  Profiler* profiler_ = nullptr;  // Not owned.
 };
 
 // Load the Model from a file path.
@@ -20,12 +20,14 @@ limitations under the License.
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 #include "absl/strings/str_format.h"
 #include "flatbuffers/flatbuffers.h"  // from @flatbuffers
 #include "model_builder.h"
+#include "profiling/buffered_profiler.h"
 #include "schema/schema_generated.h"
 
 namespace tflite {
@@ -36,6 +38,7 @@ static constexpr char kModelPath[] =
     "../tflite_mobilenet_float/"
     "mobilenet_v1_1.0_224.tflite";
 
+using ::testing::ElementsAre;
 using ::testing::IsNull;
 using ::testing::Not;
 using ::testing::WhenDynamicCastTo;
@@ -49,6 +52,23 @@ TEST_F(ModelLoaderTest, CreateFromModelPath) {
   EXPECT_TRUE(model_loader->Init());
 }
 
+TEST_F(ModelLoaderTest, ProfilesInitPhases) {
+  profiling::BufferedProfiler profiler(/*max_num_initial_entries=*/16,
+                                       /*allow_dynamic_buffer_increase=*/true);
+  auto model_loader = std::make_unique<PathModelLoader>(kModelPath);
+  model_loader->SetProfiler(&profiler);
+
+  profiler.StartProfiling();
+  ASSERT_TRUE(model_loader->Init());
+  profiler.StopProfiling();
+
+  std::vector<std::string> tags;
+  for (const profiling::ProfileEvent* event : profiler.GetProfileEvents()) {
+    tags.push_back(event->tag);
+  }
+  EXPECT_THAT(tags, ElementsAre("MapModelFile", "VerifyAndBuildModel"));
+}
+
 TEST_F(ModelLoaderTest, CreateFromFdPath) {
   int fd = open(kModelPath, O_RDONLY);
   ASSERT_GE(fd, 0);
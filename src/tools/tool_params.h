@@ -101,8 +101,9 @@ class TypedToolParam : public ToolParam {
     SetPosition(other.AsConstTyped<T>()->GetPosition());
   }
 
+  // The clone keeps whether the value was set, e.g. by a commandline flag.
   std::unique_ptr<ToolParam> Clone() const override {
-    return ToolParam::Create<T>(value_, position_);
+    return std::unique_ptr<ToolParam>(new TypedToolParam<T>(*this));
   }
 
  private:
@@ -73,6 +73,20 @@ TEST(ToolParams, MergeTestOverwriteFalse) {
   EXPECT_EQ(17, params.Get<int>("some-int2"));
   EXPECT_TRUE(params.Get<bool>("some-bool"));
 }
+
+TEST(ToolParams, MergeTestKeepsValueSet) {
+  ToolParams others;
+  others.AddParam("some-int1", ToolParam::Create<int>(13 /*, position=0*/));
+  others.AddParam("some-int2", ToolParam::Create<int>(17 /*, position=0*/));
+  others.Set<int>("some-int1", 19, 5);
+
+  ToolParams params;
+  params.Merge(others);
+  EXPECT_EQ(19, params.Get<int>("some-int1"));
+  EXPECT_EQ(5, params.GetPosition<int>("some-int1"));
+  EXPECT_TRUE(params.HasValueSet<int>("some-int1"));
+  EXPECT_FALSE(params.HasValueSet<int>("some-int2"));
+}
 }  // namespace
 }  // namespace tools
 }  // namespace tflite